@@ -172,6 +172,7 @@ Status CarnotImpl::RegisterUDFsInPlanFragment(exec::ExecState* exec_state, plan:
         return WalkExpression(exec_state, *filter.expression());
       })
       .OnLimit(no_op)
+      .OnTopK(no_op)
       .OnMemorySink(no_op)
       .OnMemorySource(no_op)
       .OnUnion(no_op)
@@ -323,12 +324,15 @@ Status CarnotImpl::ExecutePlan(const planpb::Plan& logical_plan, const sole::uui
                     absl::Substitute("$0 (id=$1)", pf->nodes()[node_id]->DebugString(), node_id);
                 exec::ExecNodeStats* stats = exec_node->stats();
                 stats->AddExtraMetric("batches_output", stats->batches_output);
+                stats->AddExtraMetric("peak_memory_bytes", stats->peak_memory_bytes);
+                stats->AddExtraMetric("memory_allocated_bytes", stats->memory_allocated_bytes);
                 int64_t total_time_ns = stats->TotalExecTime();
                 int64_t self_time_ns = stats->SelfExecTime();
                 LOG(INFO) << absl::Substitute(
-                    "self_time:$1\ttotal_time: $2\tbytes_output: $3\trows_output: $4\tnode_id:$0",
+                    "self_time:$1\ttotal_time: $2\tself_cpu_time: $3\tbytes_output: $4\t"
+                    "rows_output: $5\tnode_id:$0",
                     node_name, PrettyDuration(self_time_ns), PrettyDuration(total_time_ns),
-                    stats->bytes_output, stats->rows_output);
+                    PrettyDuration(stats->SelfCPUTime()), stats->bytes_output, stats->rows_output);
 
                 queryresultspb::OperatorExecutionStats* stats_pb =
                     agent_operator_exec_stats.add_operator_execution_stats();
@@ -339,6 +343,22 @@ Status CarnotImpl::ExecutePlan(const planpb::Plan& logical_plan, const sole::uui
                 stats_pb->set_total_execution_time_ns(total_time_ns);
                 stats_pb->set_self_execution_time_ns(self_time_ns);
 
+                queryresultspb::OperatorProfile profile;
+                profile.set_total_cpu_time_ns(stats->TotalCPUTime());
+                profile.set_self_cpu_time_ns(stats->SelfCPUTime());
+                profile.set_allocations(stats->memory_allocations);
+                profile.set_bytes_allocated(stats->memory_allocated_bytes);
+                profile.set_peak_memory_bytes(stats->peak_memory_bytes);
+                profile.set_wait_time_ns(stats->wait_time_ns);
+                if (stats->hash_table_probes > 0 || stats->hash_table_size > 0) {
+                  auto* hash_table = profile.mutable_hash_table();
+                  hash_table->set_size(stats->hash_table_size);
+                  hash_table->set_capacity(stats->hash_table_capacity);
+                  hash_table->set_probes(stats->hash_table_probes);
+                  hash_table->set_hits(stats->hash_table_hits);
+                }
+                stats_pb->mutable_operator_stats()->PackFrom(profile);
+
                 for (const auto& [k, v] : stats->extra_metrics) {
                   (*stats_pb->mutable_extra_metrics())[k] = v;
                 }
@@ -359,6 +379,8 @@ Status CarnotImpl::ExecutePlan(const planpb::Plan& logical_plan, const sole::uui
   }
   timer.Stop();
   int64_t exec_time_ns = timer.ElapsedTime_us() * 1000;
+  LOG_IF(INFO, analyze) << absl::Substitute("Query $0 peak memory: $1 bytes", query_id.str(),
+                                            exec_state->memory_pool()->max_memory());
 
   std::vector<queryresultspb::AgentExecutionStats> input_agent_stats;
   if (HasGRPCServer() && !incoming_agents.empty()) {
@@ -29,6 +29,7 @@
 #include "src/carnot/carnot.h"
 #include "src/carnot/exec/local_grpc_result_server.h"
 #include "src/carnot/exec/test_utils.h"
+#include "src/carnot/queryresultspb/query_results.pb.h"
 #include "src/carnot/udf_exporter/udf_exporter.h"
 #include "src/common/testing/testing.h"
 #include "src/table_store/table_store.h"
@@ -612,6 +613,42 @@ TEST_F(CarnotTest, group_by_col_agg_test) {
   EXPECT_EQ(expected, actual);
 }
 
+TEST_F(CarnotTest, analyze_operator_profiles) {
+  auto query = absl::StrJoin(
+      {
+          "import px",
+          "queryDF = px.DataFrame(table='big_test_table', select=['time_', 'col3', 'num_groups'])",
+          "aggDF = queryDF.groupby('num_groups').agg(sum=('col3', px.sum))",
+          "px.display(aggDF, 'test_output')",
+      },
+      "\n");
+  ASSERT_OK(carnot_->ExecuteQuery(query, sole::uuid4(), 0, /* analyze */ true));
+
+  auto exec_stats = result_server_->exec_stats().ConsumeValueOrDie();
+  ASSERT_EQ(1, exec_stats.agent_execution_stats_size());
+  const auto& agent_stats = exec_stats.agent_execution_stats(0);
+  ASSERT_LT(0, agent_stats.operator_execution_stats_size());
+
+  int64_t num_hash_tables = 0;
+  for (const auto& op_stats : agent_stats.operator_execution_stats()) {
+    queryresultspb::OperatorProfile profile;
+    ASSERT_TRUE(op_stats.operator_stats().UnpackTo(&profile));
+    EXPECT_LE(profile.self_cpu_time_ns(), profile.total_cpu_time_ns());
+    EXPECT_EQ(0, profile.wait_time_ns());
+    if (!profile.has_hash_table()) {
+      continue;
+    }
+    ++num_hash_tables;
+    // The agg inserts each of the 3 groups on its first row, and finds it for the other rows.
+    const auto& hash_table = profile.hash_table();
+    EXPECT_EQ(3, hash_table.size());
+    EXPECT_LE(hash_table.size(), hash_table.capacity());
+    EXPECT_EQ(static_cast<int64_t>(CarnotTestUtils::big_test_groups.size()), hash_table.probes());
+    EXPECT_EQ(hash_table.probes() - hash_table.size(), hash_table.hits());
+  }
+  EXPECT_EQ(1, num_hash_tables);
+}
+
 TEST_F(CarnotTest, multiple_group_by_test) {
   auto query = absl::StrJoin(
       {
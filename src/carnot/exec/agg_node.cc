@@ -64,6 +64,23 @@ void AppendToBuilder(arrow::ArrayBuilder* builder, RowTuple* rt, size_t rt_idx)
   PL_UNUSED(status);
 }
 
+Status AppendTime(arrow::ArrayBuilder* builder, types::DataType dt, int64_t time) {
+  if (dt == types::TIME64NS) {
+    using ArrowBuilder = types::DataTypeTraits<types::TIME64NS>::arrow_builder_type;
+    return static_cast<ArrowBuilder*>(builder)->Append(time);
+  }
+  DCHECK_EQ(dt, types::INT64);
+  using ArrowBuilder = types::DataTypeTraits<types::INT64>::arrow_builder_type;
+  return static_cast<ArrowBuilder*>(builder)->Append(time);
+}
+
+int64_t GetTime(const arrow::Array* col, types::DataType dt, int64_t idx) {
+  if (dt == types::TIME64NS) {
+    return types::GetValueFromArrowArray<types::TIME64NS>(col, idx);
+  }
+  return types::GetValueFromArrowArray<types::INT64>(col, idx);
+}
+
 template <types::DataType DT>
 void ExtractToColumnWrapper(const std::vector<GroupArgs>& group_args,
                             const table_store::schema::RowBatch& rb, size_t col_idx,
@@ -106,12 +123,25 @@ Status AggNode::InitImpl(const plan::Operator& plan_node) {
     }
   }
 
-  size_t output_size = plan_node_->values().size() + plan_node_->groups().size();
+  // Rolling aggregates output the window start time before the groups.
+  size_t num_time_cols = plan_node_->rolling() ? 1 : 0;
+  size_t output_size = num_time_cols + plan_node_->values().size() + plan_node_->groups().size();
   if (output_size != output_descriptor_->size()) {
     return error::InvalidArgument("Output size mismatch in aggregate");
   }
 
-  if (HasNoGroups()) {
+  if (plan_node_->rolling()) {
+    auto time_col_idx = plan_node_->rolling_time_col_idx();
+    if (time_col_idx < 0 || static_cast<size_t>(time_col_idx) >= input_descriptor_->size()) {
+      return error::InvalidArgument("Rolling window column $0 is out of bounds", time_col_idx);
+    }
+    auto time_type = input_descriptor_->type(time_col_idx);
+    if (time_type != types::TIME64NS && time_type != types::INT64) {
+      return error::InvalidArgument("Rolling window column must be a time, got $0",
+                                    magic_enum::enum_name(time_type));
+    }
+    rolling_panes_per_window_ = plan_node_->rolling_window_size() / plan_node_->rolling_slide();
+  } else if (HasNoGroups()) {
     return Status::OK();
   }
 
@@ -130,7 +160,7 @@ Status AggNode::InitImpl(const plan::Operator& plan_node) {
 
   auto values_size = plan_node_->values().size();
   for (size_t i = 0; i < values_size; ++i) {
-    auto values_idx = i + groups_size;
+    auto values_idx = i + groups_size + num_time_cols;
     DCHECK(values_idx < output_descriptor_->size());
     value_data_types_.emplace_back(output_descriptor_->type(values_idx));
   }
@@ -139,11 +169,16 @@ Status AggNode::InitImpl(const plan::Operator& plan_node) {
 }
 
 Status AggNode::PrepareImpl(ExecState* exec_state) {
+  arena_ = exec_state->arena();
   function_ctx_ = exec_state->CreateFunctionContext();
   return Status::OK();
 }
 
 Status AggNode::OpenImpl(ExecState* exec_state) {
+  if (plan_node_->rolling()) {
+    rolling_late_rows_ = std::make_unique<AggHashValue>();
+    return InitAggHashValue(exec_state, rolling_late_rows_.get());
+  }
   if (HasNoGroups()) {
     PL_RETURN_IF_ERROR(CreateUDAInfoValues(&udas_no_groups_, exec_state));
   }
@@ -151,6 +186,9 @@ Status AggNode::OpenImpl(ExecState* exec_state) {
 }
 
 Status AggNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb, size_t) {
+  if (plan_node_->rolling()) {
+    return AggregateRolling(exec_state, rb);
+  }
   if (HasNoGroups()) {
     return AggregateGroupByNone(exec_state, rb);
   }
@@ -160,8 +198,9 @@ Status AggNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb, size_
 Status AggNode::CloseImpl(ExecState*) {
   udas_no_groups_.clear();
   group_args_chunk_.clear();
-  group_args_pool_.Clear();
-  udas_pool_.Clear();
+  // The group args and agg hash values are freed with the query arena.
+  rolling_panes_.clear();
+  rolling_late_rows_.reset();
 
   return Status::OK();
 }
@@ -236,6 +275,7 @@ Status AggNode::HashRowBatch(ExecState* exec_state, const RowBatch& rb) {
   PL_UNUSED(exec_state);
   // Loop through all the row and basically store the values into column chunk based on which
   // group they belong to.
+  int64_t num_inserts = 0;
   for (auto row_idx = 0; row_idx < rb.num_rows(); ++row_idx) {
     auto& ga = group_args_chunk_[row_idx];
     AggHashValue* val = nullptr;
@@ -249,14 +289,19 @@ Status AggNode::HashRowBatch(ExecState* exec_state, const RowBatch& rb) {
       agg_hash_map_[ga.rt] = val;
       // We have inserted this, so the stored RowTuple is now in the table.
       ga.rt = nullptr;
+      ++num_inserts;
     } else {
       val = it->second;
     }
     ga.av = val;
   }
+  stats()->AddHashTableProbes(rb.num_rows(), rb.num_rows() - num_inserts);
+  stats()->UpdateHashTableSize(agg_hash_map_.size(), agg_hash_map_.capacity());
+  return ExtractAggValues(rb);
+}
 
-  auto values = plan_node_->values();
-  // Now extract the values in the agg hash value.
+Status AggNode::ExtractAggValues(const RowBatch& rb) {
+  // Extract the values in the agg hash value.
   for (size_t i = 0; i < stored_cols_data_types_.size(); ++i) {
     const auto& rb_col_idx = stored_cols_to_plan_idx_[i];
     const auto& dt = input_descriptor_->type(rb_col_idx);
@@ -374,6 +419,176 @@ Status AggNode::AggregateGroupByClause(ExecState* exec_state, const RowBatch& rb
   return Status::OK();
 }
 
+Status AggNode::AggregateRolling(ExecState* exec_state, const RowBatch& rb) {
+  // Rows are aggregated into the pane of their time. Once the input moves on to a later pane, the
+  // windows ending at the earlier panes are complete: the partial aggregates of their panes are
+  // merged and emitted, and the panes that no later window covers are dropped. So each row is
+  // only aggregated once, however many windows it is part of.
+  PL_RETURN_IF_ERROR(ExtractRowTupleForBatch(rb));
+  PL_RETURN_IF_ERROR(HashRowBatchIntoPanes(exec_state, rb));
+  if (plan_node_->values().size() > 0) {
+    PL_RETURN_IF_ERROR(EvaluatePartialAggregates(exec_state, rb.num_rows()));
+  }
+  PL_RETURN_IF_ERROR(ResetGroupArgs());
+
+  // Every window with rows is emitted, including the partial ones at either end of the input.
+  int64_t last_complete_pane = max_pane_seen_;
+  if (max_pane_seen_ != std::numeric_limits<int64_t>::min()) {
+    if (rb.eos()) {
+      // No more rows are coming, so the windows that start at the latest panes are complete too.
+      last_complete_pane += rolling_panes_per_window_ - 1;
+    } else {
+      // The latest pane may still get rows.
+      --last_complete_pane;
+    }
+  }
+  return EmitRollingWindows(exec_state, last_complete_pane, rb.eos());
+}
+
+int64_t AggNode::PaneIndex(int64_t time) const {
+  int64_t slide = plan_node_->rolling_slide();
+  // Round down, also for negative times.
+  return time >= 0 ? time / slide : -((-time + slide - 1) / slide);
+}
+
+Status AggNode::HashRowBatchIntoPanes(ExecState* exec_state, const RowBatch& rb) {
+  auto time_col_idx = plan_node_->rolling_time_col_idx();
+  auto time_type = input_descriptor_->type(time_col_idx);
+  auto time_col = rb.ColumnAt(time_col_idx).get();
+
+  // Rows before the first pane of the next window to emit can't be part of any window anymore.
+  int64_t min_pane = std::numeric_limits<int64_t>::min();
+  if (next_window_end_pane_ != std::numeric_limits<int64_t>::min()) {
+    min_pane = next_window_end_pane_ - rolling_panes_per_window_ + 1;
+  }
+
+  RollingPane* pane = nullptr;
+  int64_t pane_idx = 0;
+  int64_t num_late_rows = 0;
+  int64_t num_hits = 0;
+  for (auto row_idx = 0; row_idx < rb.num_rows(); ++row_idx) {
+    auto& ga = group_args_chunk_[row_idx];
+    int64_t idx = PaneIndex(GetTime(time_col, time_type, row_idx));
+    if (idx < min_pane) {
+      ga.av = rolling_late_rows_.get();
+      ++num_late_rows;
+      continue;
+    }
+    // Rows mostly come in time order, so consecutive rows are usually in the same pane.
+    if (pane == nullptr || idx != pane_idx) {
+      pane = &rolling_panes_[idx];
+      pane_idx = idx;
+      max_pane_seen_ = std::max(max_pane_seen_, idx);
+    }
+
+    auto it = pane->groups.find(ga.rt);
+    if (it != pane->groups.end()) {
+      ga.av = it->second;
+      ++num_hits;
+      continue;
+    }
+    // The group args row tuples are reused for the next batch, so the pane keeps a copy.
+    auto key = std::make_unique<RowTuple>(&group_data_types_);
+    key->fixed_values = ga.rt->fixed_values;
+    key->variable_values = ga.rt->variable_values;
+    auto val = std::make_unique<AggHashValue>();
+    PL_RETURN_IF_ERROR(InitAggHashValue(exec_state, val.get()));
+    ga.av = val.get();
+    pane->groups[key.get()] = val.get();
+    pane->keys.push_back(std::move(key));
+    pane->values.push_back(std::move(val));
+    stats()->UpdateHashTableSize(pane->groups.size(), pane->groups.capacity());
+  }
+  stats()->AddHashTableProbes(rb.num_rows() - num_late_rows, num_hits);
+
+  PL_RETURN_IF_ERROR(ExtractAggValues(rb));
+  if (num_late_rows > 0) {
+    VLOG(1) << absl::Substitute("Dropped $0 rows that are too late for their rolling window",
+                                num_late_rows);
+    for (auto& col : rolling_late_rows_->agg_cols) {
+      col->Clear();
+    }
+  }
+  return Status::OK();
+}
+
+Status AggNode::EmitRollingWindows(ExecState* exec_state, int64_t last_pane, bool eos) {
+  std::vector<std::unique_ptr<arrow::ArrayBuilder>> builders;
+  for (const auto& dt : output_descriptor_->types()) {
+    builders.push_back(types::MakeArrowBuilder(dt, exec_state->exec_mem_pool()));
+  }
+
+  int64_t num_rows = 0;
+  while (!rolling_panes_.empty()) {
+    // Skip the windows that have no panes.
+    next_window_end_pane_ = std::max(next_window_end_pane_, rolling_panes_.begin()->first);
+    if (next_window_end_pane_ > last_pane) {
+      break;
+    }
+    PL_RETURN_IF_ERROR(
+        AppendRollingWindow(exec_state, next_window_end_pane_, &builders, &num_rows));
+    // The next window starts after the first pane of this one.
+    rolling_panes_.erase(rolling_panes_.begin(),
+                         rolling_panes_.upper_bound(next_window_end_pane_ -
+                                                    rolling_panes_per_window_ + 1));
+    ++next_window_end_pane_;
+  }
+
+  if (num_rows == 0 && !eos) {
+    return Status::OK();
+  }
+  RowBatch output_rb(*output_descriptor_, num_rows);
+  for (const auto& builder : builders) {
+    std::shared_ptr<arrow::Array> arr;
+    PL_RETURN_IF_ERROR(builder->Finish(&arr));
+    PL_RETURN_IF_ERROR(output_rb.AddColumn(arr));
+  }
+  output_rb.set_eow(eos);
+  output_rb.set_eos(eos);
+  return SendRowBatchToChildren(exec_state, output_rb);
+}
+
+Status AggNode::AppendRollingWindow(ExecState* exec_state, int64_t end_pane,
+                                    std::vector<std::unique_ptr<arrow::ArrayBuilder>>* builders,
+                                    int64_t* num_rows) {
+  int64_t start_pane = end_pane - rolling_panes_per_window_ + 1;
+  // Merge the partial aggregates of the window's panes, by group. The panes keep their own
+  // aggregates, as later windows merge them again.
+  AbslRowTupleHashMap<std::vector<UDAInfo>> window_aggs;
+  for (auto it = rolling_panes_.lower_bound(start_pane);
+       it != rolling_panes_.end() && it->first <= end_pane; ++it) {
+    for (const auto& [key, val] : it->second.groups) {
+      PL_RETURN_IF_ERROR(EvaluateAggHashValue(exec_state, val));
+      auto& udas = window_aggs[key];
+      if (udas.empty()) {
+        PL_RETURN_IF_ERROR(CreateUDAInfoValues(&udas, exec_state));
+      }
+      for (size_t i = 0; i < udas.size(); ++i) {
+        PL_RETURN_IF_ERROR(
+            udas[i].def->Merge(udas[i].uda.get(), val->udas[i].uda.get(), function_ctx_.get()));
+      }
+    }
+  }
+
+  auto time_type = output_descriptor_->type(0);
+  int64_t window_start = start_pane * plan_node_->rolling_slide();
+  size_t num_groups = group_data_types_.size();
+  for (const auto& [key, udas] : window_aggs) {
+    PL_RETURN_IF_ERROR(AppendTime((*builders)[0].get(), time_type, window_start));
+    for (size_t i = 0; i < num_groups; ++i) {
+#define TYPE_CASE(_dt_) AppendToBuilder<_dt_>((*builders)[1 + i].get(), key, i);
+      PL_SWITCH_FOREACH_DATATYPE(group_data_types_[i], TYPE_CASE);
+#undef TYPE_CASE
+    }
+    for (size_t i = 0; i < udas.size(); ++i) {
+      PL_RETURN_IF_ERROR(udas[i].def->FinalizeArrow(udas[i].uda.get(), function_ctx_.get(),
+                                                    (*builders)[1 + num_groups + i].get()));
+    }
+  }
+  *num_rows += window_aggs.size();
+  return Status::OK();
+}
+
 StatusOr<types::DataType> AggNode::GetTypeOfDep(const plan::ScalarExpression& expr) const {
   // Agg exprs can only be of type col, or  const.
   switch (expr.ExpressionType()) {
@@ -507,12 +722,17 @@ Status AggNode::CreateColumnMapping() {
 }
 
 AggHashValue* AggNode::CreateAggHashValue(ExecState* exec_state) {
-  auto* val = udas_pool_.Add(new AggHashValue);
-  PL_CHECK_OK(CreateUDAInfoValues(&(val->udas), exec_state));
+  auto* val = arena_->New<AggHashValue>();
+  PL_CHECK_OK(InitAggHashValue(exec_state, val));
+  return val;
+}
+
+Status AggNode::InitAggHashValue(ExecState* exec_state, AggHashValue* val) {
+  PL_RETURN_IF_ERROR(CreateUDAInfoValues(&(val->udas), exec_state));
   for (const auto& dt : stored_cols_data_types_) {
     val->agg_cols.emplace_back(types::ColumnWrapper::Make(dt, 0));
   }
-  return val;
+  return Status::OK();
 }
 
 Status AggNode::CreateUDAInfoValues(std::vector<UDAInfo>* val, ExecState* exec_state) {
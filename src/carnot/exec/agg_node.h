@@ -18,6 +18,7 @@
 
 #pragma once
 #include <cstddef>
+#include <limits>
 #include <map>
 #include <memory>
 #include <string>
@@ -73,6 +74,7 @@ class AggNode : public ProcessingNode {
  protected:
   Status AggregateGroupByNone(ExecState* exec_state, const table_store::schema::RowBatch& rb);
   Status AggregateGroupByClause(ExecState* exec_state, const table_store::schema::RowBatch& rb);
+  Status AggregateRolling(ExecState* exec_state, const table_store::schema::RowBatch& rb);
 
   std::string DebugStringImpl() override;
   Status InitImpl(const plan::Operator& plan_node) override;
@@ -121,31 +123,62 @@ class AggNode : public ProcessingNode {
   // 3. The data type of the stored colums, by the index they are stored at.
   std::vector<types::DataType> stored_cols_data_types_;
 
-  ObjectPool group_args_pool_{"group_args_pool"};
-  ObjectPool udas_pool_{"udas_pool"};
+  // The query arena, which holds the group args row tuples and the agg hash values.
+  Arena* arena_ = nullptr;
 
   std::vector<types::DataType> group_data_types_;
   std::vector<types::DataType> value_data_types_;
 
   // We construct row-tuples in a batch, chunked by each column.
-  // This vector holds pointers to the row_tuples which are managed by the group_args_pool_.
+  // This vector holds pointers to the row_tuples which are managed by the arena_.
 
   std::vector<GroupArgs> group_args_chunk_;
   // END: Variables specific to GroupBy Agg.
 
+  // Variables specific to rolling Agg.
+  // These also use the GroupBy Agg variables above, with no groups being a single empty group.
+
+  // A pane holds the partial aggregates of the rows in one slide of time, by group. The pane owns
+  // its keys and values, so that they are freed when it goes out of the window.
+  struct RollingPane {
+    AggHashMap groups;
+    std::vector<std::unique_ptr<RowTuple>> keys;
+    std::vector<std::unique_ptr<AggHashValue>> values;
+  };
+  // The panes of the current and upcoming windows, by pane index (time / slide).
+  std::map<int64_t, RollingPane> rolling_panes_;
+  int64_t rolling_panes_per_window_ = 1;
+  // The index of the last pane of the next window to emit. Panes before it have been emitted.
+  int64_t next_window_end_pane_ = std::numeric_limits<int64_t>::min();
+  int64_t max_pane_seen_ = std::numeric_limits<int64_t>::min();
+  // Rows that are too late for any window still to emit are extracted here, then discarded.
+  std::unique_ptr<AggHashValue> rolling_late_rows_;
+  // END: Variables specific to rolling Agg.
+
   // Creates a mapping between plan cols and stored cols (see above comment).
   Status CreateColumnMapping();
 
   Status ExtractRowTupleForBatch(const table_store::schema::RowBatch& rb);
   Status HashRowBatch(ExecState* exec_state, const table_store::schema::RowBatch& rb);
+  // Extracts the stored columns of each row into the agg hash value of its group args.
+  Status ExtractAggValues(const table_store::schema::RowBatch& rb);
   Status EvaluatePartialAggregates(ExecState* exec_state, size_t num_records);
   Status ResetGroupArgs();
   Status ConvertAggHashMapToRowBatch(ExecState* exec_state,
                                      table_store::schema::RowBatch* output_rb);
 
   AggHashValue* CreateAggHashValue(ExecState* exec_state);
+  Status InitAggHashValue(ExecState* exec_state, AggHashValue* val);
+
+  int64_t PaneIndex(int64_t time) const;
+  Status HashRowBatchIntoPanes(ExecState* exec_state, const table_store::schema::RowBatch& rb);
+  // Emits the windows ending at panes up to (and including) last_pane, skipping those without rows.
+  Status EmitRollingWindows(ExecState* exec_state, int64_t last_pane, bool eos);
+  Status AppendRollingWindow(ExecState* exec_state, int64_t end_pane,
+                             std::vector<std::unique_ptr<arrow::ArrayBuilder>>* builders,
+                             int64_t* num_rows);
   RowTuple* CreateGroupArgsRowTuple() {
-    return group_args_pool_.Add(new RowTuple(&group_data_types_));
+    return arena_->New<RowTuple>(&group_data_types_);
   }
 
   Status CreateUDAInfoValues(std::vector<UDAInfo>* val, ExecState* exec_state);
@@ -270,6 +270,40 @@ agg_op {
   value_names: "value1"
 })";
 
+constexpr char kRollingSingleGroupAgg[] = R"(
+op_type: AGGREGATE_OPERATOR
+agg_op {
+  values {
+    name: "minsum"
+    args {
+      column {
+        node:0
+        index: 2
+      }
+    }
+    args {
+      column {
+        node:0
+        index: 2
+      }
+    }
+  }
+  groups {
+     node: 0
+     index: 1
+  }
+  group_names: "g1"
+  value_names: "value1"
+  rolling_window {
+    time_col {
+      node: 0
+      index: 0
+    }
+    window_size: 20
+    slide: 10
+  }
+})";
+
 std::unique_ptr<ExecState> MakeTestExecState(udf::Registry* registry) {
   auto table_store = std::make_shared<table_store::TableStore>();
   return std::make_unique<ExecState>(registry, table_store, MockResultSinkStubGenerator,
@@ -382,6 +416,41 @@ TEST_F(AggNodeTest, single_group_blocking) {
       .Close();
 }
 
+TEST_F(AggNodeTest, exec_stats) {
+  auto plan_node = PlanNodeFromPbtxt(kBlockingSingleGroupAgg);
+  RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64});
+
+  RowDescriptor output_rd({types::DataType::INT64, types::DataType::INT64});
+
+  auto tester = exec::ExecNodeTester<AggNode, plan::AggregateOperator>(
+      *plan_node, output_rd, {input_rd}, exec_state_.get());
+
+  tester.CollectExecStats()
+      .ConsumeNext(RowBatchBuilder(input_rd, 4, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::Int64Value>({1, 1, 2, 2})
+                       .AddColumn<types::Int64Value>({2, 3, 3, 1})
+                       .get(),
+                   0, 0)
+      .ConsumeNext(RowBatchBuilder(input_rd, 4, true, true)
+                       .AddColumn<types::Int64Value>({5, 6, 3, 4})
+                       .AddColumn<types::Int64Value>({1, 5, 3, 8})
+                       .get(),
+                   0)
+      .Close();
+
+  // Each of the 8 rows looks up its group, and the 2 rows of the groups 1 and 2 that aren't
+  // their first rows find it.
+  auto stats = tester.node()->stats();
+  EXPECT_EQ(8, stats->hash_table_probes);
+  EXPECT_EQ(2, stats->hash_table_hits);
+  EXPECT_EQ(6, stats->hash_table_size);
+  EXPECT_GE(stats->hash_table_capacity, 6);
+
+  EXPECT_GT(stats->TotalCPUTime(), 0);
+  EXPECT_GE(stats->TotalCPUTime(), stats->ChildCPUTime());
+  EXPECT_LE(stats->SelfCPUTime(), stats->TotalCPUTime());
+}
+
 TEST_F(AggNodeTest, multiple_groups_blocking) {
   auto plan_node = PlanNodeFromPbtxt(kBlockingMultipleGroupAgg);
   RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64, types::DataType::INT64});
@@ -529,6 +598,49 @@ TEST_F(AggNodeTest, single_group_windowed) {
       .Close();
 }
 
+TEST_F(AggNodeTest, single_group_rolling) {
+  auto plan_node = PlanNodeFromPbtxt(kRollingSingleGroupAgg);
+  RowDescriptor input_rd(
+      {types::DataType::TIME64NS, types::DataType::INT64, types::DataType::INT64});
+
+  RowDescriptor output_rd(
+      {types::DataType::TIME64NS, types::DataType::INT64, types::DataType::INT64});
+
+  auto tester = exec::ExecNodeTester<AggNode, plan::AggregateOperator>(
+      *plan_node, output_rd, {input_rd}, exec_state_.get());
+
+  // Windows of 20 sliding by 10: each row is part of the windows starting in the two slides up to
+  // its time. The partial windows at both ends of the input are emitted, ie. the one starting at
+  // 90 before the first row, and the one starting at 130 after the last row.
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd, 4, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::Time64NSValue>({101, 105, 112, 115})
+                       .AddColumn<types::Int64Value>({1, 2, 1, 1})
+                       .AddColumn<types::Int64Value>({1, 2, 3, 4})
+                       .get(),
+                   0)
+      // Only the window ending with the slide [100, 110) is complete.
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 2, false, false)
+                          .AddColumn<types::Time64NSValue>({90, 90})
+                          .AddColumn<types::Int64Value>({1, 2})
+                          .AddColumn<types::Int64Value>({1, 2})
+                          .get(),
+                      false)
+      .ConsumeNext(RowBatchBuilder(input_rd, 2, true, true)
+                       .AddColumn<types::Time64NSValue>({121, 135})
+                       .AddColumn<types::Int64Value>({2, 1})
+                       .AddColumn<types::Int64Value>({5, 6})
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 7, true, true)
+                          .AddColumn<types::Time64NSValue>({100, 100, 110, 110, 120, 120, 130})
+                          .AddColumn<types::Int64Value>({1, 2, 1, 2, 1, 2, 1})
+                          .AddColumn<types::Int64Value>({8, 2, 7, 5, 6, 5, 6})
+                          .get(),
+                      false)
+      .Close();
+}
+
 TEST_F(AggNodeTest, no_aggregate_expressions) {
   auto plan_node = PlanNodeFromPbtxt(kSingleGroupNoValues);
   RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64});
@@ -115,18 +115,19 @@ Status EquijoinNode::InitImpl(const plan::Operator& plan_node) {
   return Status::OK();
 }
 
-Status EquijoinNode::InitializeColumnBuilders() {
+Status EquijoinNode::InitializeColumnBuilders(ExecState* exec_state) {
   for (size_t i = 0; i < output_descriptor_->size(); ++i) {
     column_builders_[i] =
-        MakeArrowBuilder(output_descriptor_->type(i), arrow::default_memory_pool());
+        MakeArrowBuilder(output_descriptor_->type(i), exec_state->exec_mem_pool());
     PL_RETURN_IF_ERROR(column_builders_[i]->Reserve(output_rows_per_batch_));
   }
   return Status::OK();
 }
 
-Status EquijoinNode::PrepareImpl(ExecState* /*exec_state*/) {
+Status EquijoinNode::PrepareImpl(ExecState* exec_state) {
+  arena_ = exec_state->arena();
   column_builders_.resize(output_descriptor_->size());
-  PL_RETURN_IF_ERROR(InitializeColumnBuilders());
+  PL_RETURN_IF_ERROR(InitializeColumnBuilders(exec_state));
 
   return Status::OK();
 }
@@ -137,7 +138,7 @@ Status EquijoinNode::CloseImpl(ExecState* /*exec_state*/) {
   join_keys_chunk_.clear();
   build_buffer_.clear();
   probed_keys_.clear();
-  key_values_pool_.Clear();
+  // The keys and values are freed with the query arena.
   return Status::OK();
 }
 
@@ -155,7 +156,7 @@ Status EquijoinNode::ExtractJoinKeysForBatch(const table_store::schema::RowBatch
   // Reset the row tuples
   for (auto& rt : join_keys_chunk_) {
     if (rt == nullptr) {
-      rt = key_values_pool_.Add(new RowTuple(&key_data_types_));
+      rt = arena_->New<RowTuple>(&key_data_types_);
     } else {
       rt->Reset();
     }
@@ -167,7 +168,7 @@ Status EquijoinNode::ExtractJoinKeysForBatch(const table_store::schema::RowBatch
     int prev_size = join_keys_chunk_.size();
     join_keys_chunk_.reserve(num_rows);
     for (size_t idx = prev_size; idx < num_rows; ++idx) {
-      auto tuple_ptr = key_values_pool_.Add(new RowTuple(&key_data_types_));
+      auto tuple_ptr = arena_->New<RowTuple>(&key_data_types_);
       join_keys_chunk_.emplace_back(tuple_ptr);
     }
   }
@@ -188,9 +189,9 @@ Status EquijoinNode::ExtractJoinKeysForBatch(const table_store::schema::RowBatch
   return Status::OK();
 }
 
-std::vector<types::SharedColumnWrapper>* CreateWrapper(ObjectPool* pool,
+std::vector<types::SharedColumnWrapper>* CreateWrapper(Arena* arena,
                                                        const std::vector<types::DataType>& types) {
-  auto ptr = pool->Add(new std::vector<types::SharedColumnWrapper>(types.size()));
+  auto ptr = arena->New<std::vector<types::SharedColumnWrapper>>(types.size());
   for (size_t col_idx = 0; col_idx < types.size(); ++col_idx) {
     (*ptr)[col_idx] = types::ColumnWrapper::Make(types[col_idx], 0);
   }
@@ -204,7 +205,7 @@ Status EquijoinNode::HashRowBatch(const table_store::schema::RowBatch& rb) {
   for (auto row_idx = 0; row_idx < rb.num_rows(); ++row_idx) {
     if (build_wrappers_chunk_[row_idx] == nullptr) {
       build_wrappers_chunk_[row_idx] =
-          CreateWrapper(&column_values_pool_, build_spec_.input_col_types);
+          CreateWrapper(arena_, build_spec_.input_col_types);
     }
   }
 
@@ -234,6 +235,7 @@ Status EquijoinNode::HashRowBatch(const table_store::schema::RowBatch& rb) {
       join_keys_chunk_[row_idx] = nullptr;
     }
   }
+  stats()->UpdateHashTableSize(build_buffer_.size(), build_buffer_.capacity());
 
   return Status::OK();
 }
@@ -272,7 +274,7 @@ Status EquijoinNode::NextOutputBatch(ExecState* exec_state) {
   }
   pending_output_batch_.swap(output_batch);
 
-  return InitializeColumnBuilders();
+  return InitializeColumnBuilders(exec_state);
 }
 
 Status EquijoinNode::FlushChunkedRows(ExecState* exec_state) {
@@ -357,15 +359,18 @@ Status EquijoinNode::DoProbe(ExecState* exec_state, const table_store::schema::R
     probe_wrappers_chunk_.resize(rb.num_rows());
   }
 
+  int64_t num_hits = 0;
   for (auto row_idx = 0; row_idx < rb.num_rows(); ++row_idx) {
     auto it = build_buffer_.find(join_keys_chunk_[row_idx]);
     if (it != build_buffer_.end()) {
       probe_wrappers_chunk_[row_idx] = it->second;
       probed_keys_.insert(it->first);
+      ++num_hits;
     } else {
       probe_wrappers_chunk_[row_idx] = nullptr;
     }
   }
+  stats()->AddHashTableProbes(rb.num_rows(), num_hits);
 
   auto rb_ptr = std::make_shared<RowBatch>(rb);
 
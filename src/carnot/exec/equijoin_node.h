@@ -74,7 +74,7 @@ class EquijoinNode : public ProcessingNode {
                          size_t parent_index) override;
 
  private:
-  Status InitializeColumnBuilders();
+  Status InitializeColumnBuilders(ExecState* exec_state);
   bool IsProbeTable(size_t parent_index);
   Status FlushChunkedRows(ExecState* exec_state);
   Status ExtractJoinKeysForBatch(const table_store::schema::RowBatch& rb, bool is_probe);
@@ -129,9 +129,9 @@ class EquijoinNode : public ProcessingNode {
   std::queue<table_store::schema::RowBatch> probe_batches_;
   // Column builders will flush a batch once they hit output_rows_per_batch_ rows.
   std::vector<std::unique_ptr<arrow::ArrayBuilder>> column_builders_;
-  // Manages the RowTuples containing the keys for the join.
-  ObjectPool key_values_pool_{"equijoin_kv_pool"};
-  ObjectPool column_values_pool_{"equijoin_col_vals_pool"};
+  // The query arena, which holds the RowTuples containing the keys for the join and the column
+  // wrappers of the build values.
+  Arena* arena_ = nullptr;
 
   // Chunk of data to use when extracting join keys.
   std::vector<RowTuple*> join_keys_chunk_;
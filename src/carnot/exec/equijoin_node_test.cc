@@ -150,6 +150,70 @@ TEST_F(JoinNodeTest, ordered_inner_join) {
       .Close();
 }
 
+TEST_F(JoinNodeTest, exec_stats) {
+  // Left table input: [left_0:Int, left_1:Float]
+  // Right table input: [time_:Time64Ns, right_1:Int]
+  // Output table: [left_1:Float, right_1:Int]
+  // Inner join on left_0=right_1.
+  const char* proto = R"(
+    type: INNER
+    equality_conditions {
+      left_column_index: 0
+      right_column_index: 1
+    }
+    output_columns: {
+      parent_index: 0
+      column_index: 1
+    }
+    output_columns: {
+      parent_index: 1
+      column_index: 1
+    }
+    column_names: "left_1"
+    column_names: "right_1"
+    rows_per_batch: 10
+  )";
+
+  auto plan_node = PlanNodeFromPbtxt(proto);
+  RowDescriptor input_rd_0({types::DataType::INT64, types::DataType::FLOAT64});
+  RowDescriptor input_rd_1({types::DataType::TIME64NS, types::DataType::INT64});
+  RowDescriptor output_rd({types::DataType::FLOAT64, types::DataType::INT64});
+  auto tester = exec::ExecNodeTester<EquijoinNode, plan::JoinOperator>(
+      *plan_node, output_rd, {input_rd_0, input_rd_1}, exec_state_.get());
+
+  tester.CollectExecStats()
+      // Build
+      .ConsumeNext(RowBatchBuilder(input_rd_0, 6, true, true)
+                       .AddColumn<types::Int64Value>({1, 2, 2, 9, 1, 1})
+                       .AddColumn<types::Float64Value>({1.0, 2.0, 2.1, 9.0, 1.1, 1.2})
+                       .get(),
+                   0, 0)
+      // Probe
+      .ConsumeNext(RowBatchBuilder(input_rd_1, 4, false, false)
+                       .AddColumn<types::Time64NSValue>({10, 20, 30, 31})
+                       .AddColumn<types::Int64Value>({1, 2, 3, 3})
+                       .get(),
+                   1, 0)
+      // Probe
+      .ConsumeNext(RowBatchBuilder(input_rd_1, 3, true, true)
+                       .AddColumn<types::Time64NSValue>({101, 150, 190})
+                       .AddColumn<types::Int64Value>({1, 5, 9})
+                       .get(),
+                   1)
+      .Close();
+
+  // The build side holds the keys 1, 2 and 9. The probe rows with the keys 1, 2, 1 and 9 find
+  // theirs.
+  auto stats = tester.node()->stats();
+  EXPECT_EQ(3, stats->hash_table_size);
+  EXPECT_GE(stats->hash_table_capacity, 3);
+  EXPECT_EQ(7, stats->hash_table_probes);
+  EXPECT_EQ(4, stats->hash_table_hits);
+
+  EXPECT_GT(stats->TotalCPUTime(), 0);
+  EXPECT_LE(stats->SelfCPUTime(), stats->TotalCPUTime());
+}
+
 TEST_F(JoinNodeTest, ordered_left_join) {
   // time_ from left (probe) table, batches interleaved
   // Left table input: [time_:Time64Ns, left_1:Int]
@@ -22,6 +22,7 @@
 #include <memory>
 #include <set>
 #include <unordered_map>
+#include <vector>
 
 #include "src/carnot/exec/agg_node.h"
 #include "src/carnot/exec/empty_source_node.h"
@@ -35,6 +36,7 @@
 #include "src/carnot/exec/map_node.h"
 #include "src/carnot/exec/memory_sink_node.h"
 #include "src/carnot/exec/memory_source_node.h"
+#include "src/carnot/exec/topk_node.h"
 #include "src/carnot/exec/udtf_source_node.h"
 #include "src/carnot/exec/union_node.h"
 #include "src/carnot/plan/operators.h"
@@ -81,6 +83,9 @@ Status ExecutionGraph::Init(table_store::schema::Schema* schema, plan::PlanState
       .OnLimit([&](auto& node) {
         return OnOperatorImpl<plan::LimitOperator, LimitNode>(node, &descriptors);
       })
+      .OnTopK([&](auto& node) {
+        return OnOperatorImpl<plan::TopKOperator, TopKNode>(node, &descriptors);
+      })
       .OnUnion([&](auto& node) {
         return OnOperatorImpl<plan::UnionOperator, UnionNode>(node, &descriptors);
       })
@@ -91,8 +96,10 @@ Status ExecutionGraph::Init(table_store::schema::Schema* schema, plan::PlanState
         auto s = OnOperatorImpl<plan::GRPCSourceOperator, GRPCSourceNode>(node, &descriptors);
         PL_RETURN_IF_ERROR(s);
         grpc_sources_.insert(node.id());
+        auto grpc_source = static_cast<GRPCSourceNode*>(nodes_[node.id()]);
+        grpc_source->set_mem_pool(exec_state->memory_pool());
         return exec_state->grpc_router()->AddGRPCSourceNode(
-            exec_state->query_id(), node.id(), static_cast<GRPCSourceNode*>(nodes_[node.id()]),
+            exec_state->query_id(), node.id(), grpc_source,
             std::bind(&ExecutionGraph::Continue, this));
       })
       .OnGRPCSink([&](auto& node) {
@@ -247,6 +254,19 @@ Status ExecutionGraph::ExecuteSources() {
       YieldWithTimeout();
       timer.Stop();
 
+      // None of the running sources had data, so the wait is split evenly among the remote
+      // sources. That way the wait times of the sources add up to the time the query waited.
+      std::vector<SourceNode*> waiting_grpc_sources;
+      for (SourceNode* source : running_sources) {
+        if (grpc_sources_.contains(source_to_id.at(source))) {
+          waiting_grpc_sources.push_back(source);
+        }
+      }
+      for (SourceNode* source : waiting_grpc_sources) {
+        source->stats()->AddWaitTime(timer.ElapsedTime_us() * 1000 /
+                                     static_cast<int64_t>(waiting_grpc_sources.size()));
+      }
+
       absl::flat_hash_set<SourceNode*> completed_sources_wait_loop;
 
       // This check is used for Memory sources that are waiting on data, because we don't currently
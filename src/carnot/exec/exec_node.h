@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
@@ -63,11 +64,13 @@ struct ExecNodeStats {
       return;
     }
     children_timer.Resume();
+    children_cpu_timer.Resume();
   }
   void StopChildTimer() {
     if (!collect_exec_stats) {
       return;
     }
+    children_cpu_timer.Stop();
     children_timer.Stop();
   }
   void ResumeTotalTimer() {
@@ -75,14 +78,73 @@ struct ExecNodeStats {
       return;
     }
     total_timer.Resume();
+    total_cpu_timer.Resume();
   }
   void StopTotalTimer() {
     if (!collect_exec_stats) {
       return;
     }
+    total_cpu_timer.Stop();
     total_timer.Stop();
   }
 
+  // The memory counters track the query memory (see QueryMemoryPool) that the node's own work
+  // allocates, both in total and net of what it frees. Children are excluded by pausing the
+  // tracking while they run. Buffers freed by another node are credited to that node. Memory that
+  // other threads allocate in the meantime is made in the background and isn't counted here.
+  void ResumeMemoryTracking(const QueryMemoryPool& pool) {
+    if (!collect_exec_stats) {
+      return;
+    }
+    memory_tracking_start = pool.foreground_bytes_used();
+    allocations_tracking_start = pool.num_allocations();
+    allocated_bytes_tracking_start = pool.total_bytes_allocated();
+  }
+  void PauseMemoryTracking(const QueryMemoryPool& pool) {
+    if (!collect_exec_stats) {
+      return;
+    }
+    memory_bytes += pool.foreground_bytes_used() - memory_tracking_start;
+    peak_memory_bytes = std::max(peak_memory_bytes, memory_bytes);
+    memory_allocations += pool.num_allocations() - allocations_tracking_start;
+    memory_allocated_bytes += pool.total_bytes_allocated() - allocated_bytes_tracking_start;
+  }
+  // Charges the node for memory allocated on its behalf in a QueryMemoryPool::BackgroundScope.
+  void AddBackgroundMemory(int64_t allocations, int64_t allocated_bytes, int64_t bytes) {
+    if (!collect_exec_stats) {
+      return;
+    }
+    memory_bytes += bytes;
+    peak_memory_bytes = std::max(peak_memory_bytes, memory_bytes);
+    memory_allocations += allocations;
+    memory_allocated_bytes += allocated_bytes;
+  }
+
+  // Nodes that build a hash table (eg. Agg and Join) report its largest size and capacity, and
+  // how many lookups they made into it and how many of those found their key.
+  void UpdateHashTableSize(int64_t size, int64_t capacity) {
+    if (!collect_exec_stats) {
+      return;
+    }
+    hash_table_size = std::max(hash_table_size, size);
+    hash_table_capacity = std::max(hash_table_capacity, capacity);
+  }
+  void AddHashTableProbes(int64_t probes, int64_t hits) {
+    if (!collect_exec_stats) {
+      return;
+    }
+    hash_table_probes += probes;
+    hash_table_hits += hits;
+  }
+
+  // Source nodes report the time the query waited on them for data, eg. from a remote agent.
+  void AddWaitTime(int64_t wait_time_ns) {
+    if (!collect_exec_stats) {
+      return;
+    }
+    this->wait_time_ns += wait_time_ns;
+  }
+
   void AddExtraMetric(std::string_view key, double value) {
     if (!collect_exec_stats) {
       return;
@@ -102,6 +164,9 @@ struct ExecNodeStats {
   int64_t ChildExecTime() const { return children_timer.ElapsedTime_us() * 1000; }
   int64_t TotalExecTime() const { return total_timer.ElapsedTime_us() * 1000; }
   int64_t SelfExecTime() const { return TotalExecTime() - ChildExecTime(); }
+  int64_t ChildCPUTime() const { return children_cpu_timer.ElapsedTime_ns(); }
+  int64_t TotalCPUTime() const { return total_cpu_timer.ElapsedTime_ns(); }
+  int64_t SelfCPUTime() const { return TotalCPUTime() - ChildCPUTime(); }
 
   // Total bytes input to this exec node.
   int64_t bytes_input = 0;
@@ -115,10 +180,33 @@ struct ExecNodeStats {
   int64_t rows_output = 0;
   // Total batches input to this exec node.
   int64_t batches_output = 0;
+  // The bytes of query memory this exec node currently holds.
+  int64_t memory_bytes = 0;
+  // The peak of memory_bytes.
+  int64_t peak_memory_bytes = 0;
+  // Total bytes of query memory allocated by this exec node.
+  int64_t memory_allocated_bytes = 0;
+  // Total number of query memory allocations made by this exec node.
+  int64_t memory_allocations = 0;
+  // The query memory counters when the memory tracking last resumed.
+  int64_t memory_tracking_start = 0;
+  int64_t allocations_tracking_start = 0;
+  int64_t allocated_bytes_tracking_start = 0;
+  // The largest size and capacity of the node's hash table, if it has one.
+  int64_t hash_table_size = 0;
+  int64_t hash_table_capacity = 0;
+  // The lookups into the node's hash table, and the lookups that found their key.
+  int64_t hash_table_probes = 0;
+  int64_t hash_table_hits = 0;
+  // Total time the query waited on this (source) node for data.
+  int64_t wait_time_ns = 0;
   // Total timer for the node = children_time + self_time.
   ElapsedTimer total_timer;
   // Total timer for the children of the ndoe.
   ElapsedTimer children_timer;
+  // The CPU time counterparts of the timers above. Time spent blocked is not counted.
+  ThreadCPUTimer total_cpu_timer;
+  ThreadCPUTimer children_cpu_timer;
   // Flag to determine whether to collect stats or not.
   bool collect_exec_stats;
 
@@ -195,9 +283,11 @@ class ExecNode {
     DCHECK(is_initialized_);
     DCHECK(type() == ExecNodeType::kSourceNode);
     stats_->ResumeTotalTimer();
+    stats_->ResumeMemoryTracking(*exec_state->memory_pool());
     PL_RETURN_IF_ERROR(GenerateNextImpl(exec_state));
+    stats_->PauseMemoryTracking(*exec_state->memory_pool());
     stats_->StopTotalTimer();
-    return Status::OK();
+    return exec_state->CheckMemoryLimit();
   }
 
   /**
@@ -220,9 +310,11 @@ class ExecNode {
     }
     stats_->AddInputStats(rb);
     stats_->ResumeTotalTimer();
+    stats_->ResumeMemoryTracking(*exec_state->memory_pool());
     PL_RETURN_IF_ERROR(ConsumeNextImpl(exec_state, rb, parent_index));
+    stats_->PauseMemoryTracking(*exec_state->memory_pool());
     stats_->StopTotalTimer();
-    return Status::OK();
+    return exec_state->CheckMemoryLimit();
   }
 
   /**
@@ -283,11 +375,13 @@ class ExecNode {
    * @return Status of children execution.
    */
   Status SendRowBatchToChildren(ExecState* exec_state, const table_store::schema::RowBatch& rb) {
+    stats_->PauseMemoryTracking(*exec_state->memory_pool());
     stats_->ResumeChildTimer();
     for (size_t i = 0; i < children_.size(); ++i) {
       PL_RETURN_IF_ERROR(children_[i]->ConsumeNext(exec_state, rb, parent_ids_for_children_[i]));
     }
     stats_->StopChildTimer();
+    stats_->ResumeMemoryTracking(*exec_state->memory_pool());
     stats_->AddOutputStats(rb);
     if (rb.eos()) {
       DCHECK(!sent_eos_);
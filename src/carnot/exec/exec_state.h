@@ -31,8 +31,10 @@
 #include "src/carnot/carnotpb/carnot.pb.h"
 #include "src/carnot/exec/grpc_router.h"
 #include "src/carnot/exec/ml/model_pool.h"
+#include "src/carnot/exec/query_memory_pool.h"
 #include "src/carnot/udf/registry.h"
 #include "src/common/base/base.h"
+#include "src/common/memory/memory.h"
 #include "src/shared/metadata/metadata_state.h"
 #include "src/table_store/table/table_store.h"
 
@@ -52,8 +54,11 @@ using ResultSinkStubGenerator =
  *
  * The purpose of this class is to keep track of resources required for the query
  * and provide common resources (UDFs, UDA, etc) the operators within the query.
+ *
+ * The memory of the query is accounted for (and limited) by its memory pool, which both the
+ * arrow buffers and the arena of the query allocate from.
  */
-class ExecState {
+class ExecState : public NotCopyable {
  public:
   ExecState() = delete;
   explicit ExecState(
@@ -67,17 +72,27 @@ class ExecState {
         query_id_(query_id),
         model_pool_(model_pool),
         grpc_router_(grpc_router),
-        add_auth_to_grpc_client_context_func_(add_auth_func) {}
+        add_auth_to_grpc_client_context_func_(add_auth_func),
+        memory_pool_(QueryMemoryPool::Create(FLAGS_carnot_query_memory_limit_bytes)),
+        arena_(Arena::kDefaultBlockSize,
+               [pool = memory_pool_](int64_t bytes) { pool->Reserve(bytes); }) {}
 
   ~ExecState() {
     if (grpc_router_ != nullptr) {
       grpc_router_->DeleteQuery(query_id_);
     }
+    // The arena returns its memory to the pool, so it goes first.
+    arena_.Reset();
+    memory_pool_->Detach();
   }
-  arrow::MemoryPool* exec_mem_pool() {
-    // TOOD(zasgar): Make this the correct pool.
-    return arrow::default_memory_pool();
-  }
+  arrow::MemoryPool* exec_mem_pool() { return memory_pool_; }
+  QueryMemoryPool* memory_pool() { return memory_pool_; }
+
+  // The arena for objects that live until the end of the query, such as per-group state.
+  Arena* arena() { return &arena_; }
+
+  // Returns an error once the query uses more memory than its limit.
+  Status CheckMemoryLimit() const { return memory_pool_->CheckLimit(); }
 
   udf::Registry* func_registry() { return func_registry_; }
 
@@ -150,6 +165,7 @@ class ExecState {
   void set_metadata_state(std::shared_ptr<const md::AgentMetadataState> metadata_state) {
     metadata_state_ = metadata_state;
   }
+  const md::AgentMetadataState* metadata_state() const { return metadata_state_.get(); }
 
   GRPCRouter* grpc_router() { return grpc_router_; }
 
@@ -183,6 +199,10 @@ class ExecState {
   // Mapping of remote address to stub that serves that address.
   absl::flat_hash_map<std::string, carnotpb::ResultSinkService::StubInterface*>
       result_sink_stub_map_;
+
+  // Owned until detached on destruction, see QueryMemoryPool.
+  QueryMemoryPool* memory_pool_;
+  Arena arena_;
 };
 
 }  // namespace exec
@@ -203,7 +203,7 @@ VectorNativeScalarExpressionEvaluator::EvaluateSingleExpression(
       [&](const plan::ScalarValue& val,
           const std::vector<types::SharedColumnWrapper>& children) -> types::SharedColumnWrapper {
         DCHECK_EQ(children.size(), 0ULL);
-        return EvalScalarToColumnWrapper(exec_state, val, num_rows);
+        return ScalarValueColumn(exec_state, val, num_rows);
       });
 
   walker.OnColumn(
@@ -230,7 +230,7 @@ VectorNativeScalarExpressionEvaluator::EvaluateSingleExpression(
         for (const auto& child : children) {
           raw_children.emplace_back(child.get());
         }
-        auto output = types::ColumnWrapper::Make(def->exec_return_type(), num_rows);
+        auto output = FuncOutputColumn(fn, def->exec_return_type(), num_rows);
         // TODO(zasgar): need a better way to handle errors.
         PL_CHECK_OK(def->ExecBatch(udf, function_ctx_, raw_children, output.get(), num_rows));
         return output;
@@ -239,6 +239,29 @@ VectorNativeScalarExpressionEvaluator::EvaluateSingleExpression(
   return walker.Walk(expr);
 }
 
+SharedColumnWrapper VectorNativeScalarExpressionEvaluator::FuncOutputColumn(
+    const plan::ScalarFunc& fn, types::DataType type, size_t num_rows) {
+  auto& col = intermediates_[&fn];
+  // The column is still in use if it was the result for the previous batch and the caller holds
+  // on to it.
+  if (col == nullptr || col.use_count() > 1) {
+    col = types::ColumnWrapper::Make(type, num_rows);
+  } else {
+    col->Resize(num_rows);
+  }
+  return col;
+}
+
+SharedColumnWrapper VectorNativeScalarExpressionEvaluator::ScalarValueColumn(
+    ExecState* exec_state, const plan::ScalarValue& val, size_t num_rows) {
+  // Inputs are never modified by the UDFs, so the column can be shared even while in use.
+  auto& col = intermediates_[&val];
+  if (col == nullptr || col->Size() != num_rows) {
+    col = EvalScalarToColumnWrapper(exec_state, val, num_rows);
+  }
+  return col;
+}
+
 Status VectorNativeScalarExpressionEvaluator::EvaluateSingleExpression(
     ExecState* exec_state, const RowBatch& input, const plan::ScalarExpression& expr,
     RowBatch* output) {
@@ -288,6 +311,15 @@ Status ArrowNativeScalarExpressionEvaluator::Close(ExecState*) {
   return Status();
 }
 
+std::shared_ptr<arrow::Array> ArrowNativeScalarExpressionEvaluator::ScalarValueArray(
+    ExecState* exec_state, const plan::ScalarValue& val, size_t num_rows) {
+  auto& arr = scalar_arrays_[&val];
+  if (arr == nullptr || static_cast<size_t>(arr->length()) != num_rows) {
+    arr = EvalScalarToArrow(exec_state, val, num_rows);
+  }
+  return arr;
+}
+
 Status exec::ArrowNativeScalarExpressionEvaluator::EvaluateSingleExpression(
     exec::ExecState* exec_state, const RowBatch& input, const plan::ScalarExpression& expr,
     RowBatch* output) {
@@ -297,7 +329,7 @@ Status exec::ArrowNativeScalarExpressionEvaluator::EvaluateSingleExpression(
       [&](const plan::ScalarValue& val, const std::vector<std::shared_ptr<arrow::Array>>& children)
           -> std::shared_ptr<arrow::Array> {
         DCHECK_EQ(children.size(), 0ULL);
-        return EvalScalarToArrow(exec_state, val, num_rows);
+        return ScalarValueArray(exec_state, val, num_rows);
       });
 
   walker.OnColumn(
@@ -26,6 +26,8 @@
 #include <utility>
 #include <vector>
 
+#include <absl/container/flat_hash_map.h>
+
 #include "src/carnot/exec/exec_state.h"
 #include "src/carnot/plan/scalar_expression.h"
 #include "src/carnot/udf/base.h"
@@ -149,6 +151,19 @@ class VectorNativeScalarExpressionEvaluator : public ScalarExpressionEvaluator {
   Status EvaluateSingleExpression(ExecState* exec_state, const table_store::schema::RowBatch& input,
                                   const plan::ScalarExpression& expr,
                                   table_store::schema::RowBatch* output) override;
+
+ private:
+  // Returns the output column for a function in the expression tree, reusing the column from the
+  // previous row batch if nothing else holds on to it.
+  types::SharedColumnWrapper FuncOutputColumn(const plan::ScalarFunc& fn, types::DataType type,
+                                              size_t num_rows);
+  // Returns the column for a scalar value, which is only rebuilt when the batch size changes.
+  types::SharedColumnWrapper ScalarValueColumn(ExecState* exec_state, const plan::ScalarValue& val,
+                                               size_t num_rows);
+
+  // Intermediate columns of the expressions, kept across row batches so that the evaluation does
+  // not allocate new columns for every batch.
+  absl::flat_hash_map<const plan::ScalarExpression*, types::SharedColumnWrapper> intermediates_;
 };
 
 /**
@@ -167,6 +182,15 @@ class ArrowNativeScalarExpressionEvaluator : public ScalarExpressionEvaluator {
   Status EvaluateSingleExpression(ExecState* exec_state, const table_store::schema::RowBatch& input,
                                   const plan::ScalarExpression& expr,
                                   table_store::schema::RowBatch* output) override;
+
+ private:
+  // Returns the array for a scalar value, which is only rebuilt when the batch size changes.
+  std::shared_ptr<arrow::Array> ScalarValueArray(ExecState* exec_state,
+                                                 const plan::ScalarValue& val, size_t num_rows);
+
+  // Arrays of the scalar values in the expressions. Arrow arrays are immutable, so they are
+  // shared by every row batch of the same size.
+  absl::flat_hash_map<const plan::ScalarValue*, std::shared_ptr<arrow::Array>> scalar_arrays_;
 };
 
 }  // namespace exec
@@ -22,6 +22,7 @@
 #include <arrow/array/builder_binary.h>
 #include <arrow/memory_pool.h>
 #include <arrow/status.h>
+#include <numeric>
 #include <ostream>
 #include <string>
 #include <utility>
@@ -47,6 +48,9 @@ using table_store::schema::RowBatch;
 using table_store::schema::RowDescriptor;
 
 std::string FilterNode::DebugStringImpl() {
+  if (fused_predicate_ != nullptr) {
+    return absl::Substitute("Exec::FilterNode<fused: $0>", plan_node_->expression()->DebugString());
+  }
   return absl::Substitute("Exec::FilterNode<$0>", evaluator_->DebugString());
 }
 
@@ -59,6 +63,10 @@ Status FilterNode::InitImpl(const plan::Operator& plan_node) {
 }
 
 Status FilterNode::PrepareImpl(ExecState* exec_state) {
+  fused_predicate_ = FusedPredicate::Create(*plan_node_->expression());
+  if (fused_predicate_ != nullptr) {
+    return Status::OK();
+  }
   function_ctx_ = exec_state->CreateFunctionContext();
   evaluator_ = std::make_unique<VectorNativeScalarExpressionEvaluator>(
       plan::ConstScalarExpressionVector{plan_node_->expression()}, function_ctx_.get());
@@ -66,29 +74,28 @@ Status FilterNode::PrepareImpl(ExecState* exec_state) {
 }
 
 Status FilterNode::OpenImpl(ExecState* exec_state) {
-  PL_RETURN_IF_ERROR(evaluator_->Open(exec_state));
+  if (evaluator_ != nullptr) {
+    PL_RETURN_IF_ERROR(evaluator_->Open(exec_state));
+  }
   return Status::OK();
 }
 
 Status FilterNode::CloseImpl(ExecState* exec_state) {
-  PL_RETURN_IF_ERROR(evaluator_->Close(exec_state));
+  if (evaluator_ != nullptr) {
+    PL_RETURN_IF_ERROR(evaluator_->Close(exec_state));
+  }
   return Status::OK();
 }
 
 template <types::DataType T>
-Status PredicateCopyValues(const types::BoolValueColumnWrapper& pred, const arrow::Array* input_col,
-                           RowBatch* output_rb) {
-  DCHECK_EQ(pred.Size(), static_cast<size_t>(input_col->length()));
-  size_t num_output_records = output_rb->num_rows();
-  size_t num_input_records = input_col->length();
+Status GatherValues(const std::vector<int64_t>& selection, const arrow::Array* input_col,
+                    RowBatch* output_rb) {
   auto output_col_builder_generic = MakeArrowBuilder(T, arrow::default_memory_pool());
   auto* output_col_builder = static_cast<typename types::DataTypeTraits<T>::arrow_builder_type*>(
       output_col_builder_generic.get());
-  PL_RETURN_IF_ERROR(output_col_builder->Reserve(num_output_records));
-  for (size_t idx = 0; idx < num_input_records; ++idx) {
-    if (udf::UnWrap(pred[idx])) {
-      output_col_builder->UnsafeAppend(types::GetValueFromArrowArray<T>(input_col, idx));
-    }
+  PL_RETURN_IF_ERROR(output_col_builder->Reserve(selection.size()));
+  for (int64_t idx : selection) {
+    output_col_builder->UnsafeAppend(types::GetValueFromArrowArray<T>(input_col, idx));
   }
   std::shared_ptr<arrow::Array> output_array;
   PL_RETURN_IF_ERROR(output_col_builder->Finish(&output_array));
@@ -97,31 +104,22 @@ Status PredicateCopyValues(const types::BoolValueColumnWrapper& pred, const arro
 }
 
 template <>
-Status PredicateCopyValues<types::STRING>(const types::BoolValueColumnWrapper& pred,
-                                          const arrow::Array* input_col, RowBatch* output_rb) {
-  DCHECK_EQ(pred.Size(), static_cast<size_t>(input_col->length()));
-  size_t num_output_records = output_rb->num_rows();
-  size_t num_input_records = input_col->length();
-  size_t reserved =
-      100;  // This can be an arbritrary number, since we do exponential doubling below.
-  size_t total_size = 0;
+Status GatherValues<types::STRING>(const std::vector<int64_t>& selection,
+                                   const arrow::Array* input_col, RowBatch* output_rb) {
+  const auto* input_strings = static_cast<const arrow::StringArray*>(input_col);
+  // The selected rows are known, so the string data can be reserved exactly.
+  int64_t total_size = 0;
+  for (int64_t idx : selection) {
+    total_size += input_strings->value_length(idx);
+  }
 
   auto output_col_builder_generic = MakeArrowBuilder(types::STRING, arrow::default_memory_pool());
   auto* output_col_builder = static_cast<types::DataTypeTraits<types::STRING>::arrow_builder_type*>(
       output_col_builder_generic.get());
-
-  PL_RETURN_IF_ERROR(output_col_builder->Reserve(num_output_records));
-  PL_RETURN_IF_ERROR(output_col_builder->ReserveData(reserved));
-  for (size_t idx = 0; idx < num_input_records; ++idx) {
-    if (udf::UnWrap(pred[idx])) {
-      auto res = types::GetValueFromArrowArray<types::STRING>(input_col, idx);
-      total_size += res.size();
-      while (total_size >= reserved) {
-        reserved *= 2;
-      }
-      PL_RETURN_IF_ERROR(output_col_builder->ReserveData(reserved));
-      output_col_builder->UnsafeAppend(std::move(res));
-    }
+  PL_RETURN_IF_ERROR(output_col_builder->Reserve(selection.size()));
+  PL_RETURN_IF_ERROR(output_col_builder->ReserveData(total_size));
+  for (int64_t idx : selection) {
+    output_col_builder->UnsafeAppend(input_strings->GetString(idx));
   }
   std::shared_ptr<arrow::Array> output_array;
   PL_RETURN_IF_ERROR(output_col_builder->Finish(&output_array));
@@ -129,9 +127,7 @@ Status PredicateCopyValues<types::STRING>(const types::BoolValueColumnWrapper& p
   return Status::OK();
 }
 
-Status FilterNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb, size_t) {
-  // Current implementation does not merge across row batches, we should
-  // consider this for cases where the filter has really low selectivity.
+Status FilterNode::SelectWithEvaluator(ExecState* exec_state, const RowBatch& rb) {
   PL_ASSIGN_OR_RETURN(auto pred_col, evaluator_->EvaluateSingleExpression(
                                          exec_state, rb, *plan_node_->expression()));
 
@@ -141,25 +137,54 @@ Status FilterNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb, si
   const types::BoolValueColumnWrapper& pred_col_wrapper =
       *static_cast<types::BoolValueColumnWrapper*>(pred_col.get());
   size_t num_pred = pred_col_wrapper.Size();
-
   DCHECK_EQ(static_cast<size_t>(rb.num_rows()), num_pred);
 
-  // Find out how many of them returned true;
-  size_t num_output_records = 0;
+  selection_.clear();
   for (size_t i = 0; i < num_pred; ++i) {
     if (pred_col_wrapper[i].val) {
-      ++num_output_records;
+      selection_.push_back(i);
     }
   }
+  return Status::OK();
+}
+
+Status FilterNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb, size_t) {
+  // Current implementation does not merge across row batches, we should
+  // consider this for cases where the filter has really low selectivity.
+  size_t num_rows = rb.num_rows();
+  if (fused_predicate_ != nullptr) {
+    if (all_rows_.size() != num_rows) {
+      all_rows_.resize(num_rows);
+      std::iota(all_rows_.begin(), all_rows_.end(), 0);
+    }
+    fused_predicate_->Select(rb, all_rows_, &selection_);
+  } else {
+    PL_RETURN_IF_ERROR(SelectWithEvaluator(exec_state, rb));
+  }
+  size_t num_output_records = selection_.size();
 
   RowBatch output_rb(*output_descriptor_, num_output_records);
   DCHECK_EQ(output_descriptor_->size(), plan_node_->selected_cols().size());
 
+  // When the selected rows are contiguous, the output columns are zero-copy slices of the input.
+  bool contiguous = num_output_records == 0 ||
+                    static_cast<size_t>(selection_.back() - selection_.front()) + 1 ==
+                        num_output_records;
+  int64_t offset = num_output_records == 0 ? 0 : selection_.front();
+
   for (const auto& [output_col_idx, input_col_idx] : Enumerate(plan_node_->selected_cols())) {
     auto input_col = rb.ColumnAt(input_col_idx);
+    if (num_output_records == num_rows) {
+      PL_RETURN_IF_ERROR(output_rb.AddColumn(input_col));
+      continue;
+    }
+    if (contiguous) {
+      PL_RETURN_IF_ERROR(output_rb.AddColumn(input_col->Slice(offset, num_output_records)));
+      continue;
+    }
     auto col_type = output_descriptor_->type(output_col_idx);
 #define TYPE_CASE(_dt_) \
-  PL_RETURN_IF_ERROR(PredicateCopyValues<_dt_>(pred_col_wrapper, input_col.get(), &output_rb));
+  PL_RETURN_IF_ERROR(GatherValues<_dt_>(selection_, input_col.get(), &output_rb));
     PL_SWITCH_FOREACH_DATATYPE(col_type, TYPE_CASE);
 #undef TYPE_CASE
   }
@@ -26,6 +26,7 @@
 #include "src/carnot/exec/exec_node.h"
 #include "src/carnot/exec/exec_state.h"
 #include "src/carnot/exec/expression_evaluator.h"
+#include "src/carnot/exec/fused_predicate.h"
 #include "src/carnot/plan/operators.h"
 #include "src/carnot/udf/base.h"
 #include "src/common/base/base.h"
@@ -51,9 +52,19 @@ class FilterNode : public ProcessingNode {
                          size_t parent_index) override;
 
  private:
+  // Sets selection_ to the rows of rb that pass the filter, by evaluating the predicate with UDFs.
+  Status SelectWithEvaluator(ExecState* exec_state, const table_store::schema::RowBatch& rb);
+
+  // Evaluates the predicate when it can't be fused.
   std::unique_ptr<VectorNativeScalarExpressionEvaluator> evaluator_;
+  std::unique_ptr<FusedPredicate> fused_predicate_;
+  // The indexes of all the rows of a row batch, which the fused predicate selects from.
+  std::vector<int64_t> all_rows_;
   std::unique_ptr<plan::FilterOperator> plan_node_;
   std::unique_ptr<udf::FunctionContext> function_ctx_;
+  // Indexes of the rows that pass the filter in the current row batch. Kept as a member so that
+  // its memory is reused across row batches.
+  std::vector<int64_t> selection_;
 };
 
 }  // namespace exec
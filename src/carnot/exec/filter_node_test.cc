@@ -18,8 +18,11 @@
 
 #include "src/carnot/exec/filter_node.h"
 
+#include <google/protobuf/text_format.h>
 #include <sole.hpp>
 
+#include <absl/strings/substitute.h>
+
 #include "src/carnot/exec/test_utils.h"
 #include "src/carnot/planpb/test_proto.h"
 #include "src/carnot/udf/registry.h"
@@ -139,6 +142,42 @@ TEST_F(FilterNodeTest, column_selection) {
       .Close();
 }
 
+TEST_F(FilterNodeTest, sparse_and_full_selection) {
+  auto op_proto = planpb::testutils::CreateTestFilterTwoCols();
+  plan_node_ = plan::FilterOperator::FromProto(op_proto, /*id*/ 1);
+
+  RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64, types::DataType::STRING});
+  RowDescriptor output_rd(
+      {types::DataType::INT64, types::DataType::INT64, types::DataType::STRING});
+
+  auto tester = exec::ExecNodeTester<FilterNode, plan::FilterOperator>(
+      *plan_node_, output_rd, {input_rd}, exec_state_.get());
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd, 4, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::Int64Value>({1, 2, 1, 1})
+                       .AddColumn<types::Int64Value>({1, 5, 3, 4})
+                       .AddColumn<types::StringValue>({"ABC", "DEF", "HELLO", "WORLD"})
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 3, false, false)
+                          .AddColumn<types::Int64Value>({1, 1, 1})
+                          .AddColumn<types::Int64Value>({1, 3, 4})
+                          .AddColumn<types::StringValue>({"ABC", "HELLO", "WORLD"})
+                          .get())
+      .ConsumeNext(RowBatchBuilder(input_rd, 2, true, true)
+                       .AddColumn<types::Int64Value>({1, 1})
+                       .AddColumn<types::Int64Value>({7, 8})
+                       .AddColumn<types::StringValue>({"Hello", "world"})
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 2, true, true)
+                          .AddColumn<types::Int64Value>({1, 1})
+                          .AddColumn<types::Int64Value>({7, 8})
+                          .AddColumn<types::StringValue>({"Hello", "world"})
+                          .get())
+      .Close();
+}
+
 TEST_F(FilterNodeTest, zero_row_row_batch) {
   auto op_proto = planpb::testutils::CreateTestFilterTwoCols();
   plan_node_ = plan::FilterOperator::FromProto(op_proto, /*id*/ 1);
@@ -222,6 +261,74 @@ TEST_F(FilterNodeTest, string_pred) {
       .Close();
 }
 
+// logicalAnd(greaterThan(col0, 1), equal(col2, "b")).
+constexpr char kFusedPredicatePbtxt[] = R"proto(
+func {
+  name: "logicalAnd"
+  args {
+    func {
+      name: "greaterThan"
+      args { column { index: 0 } }
+      args { constant { data_type: INT64 int64_value: 1 } }
+      args_data_types: INT64
+      args_data_types: INT64
+    }
+  }
+  args {
+    func {
+      name: "equal"
+      args { column { index: 2 } }
+      args { constant { data_type: STRING string_value: "b" } }
+      args_data_types: STRING
+      args_data_types: STRING
+    }
+  }
+  args_data_types: BOOLEAN
+  args_data_types: BOOLEAN
+})proto";
+
+TEST_F(FilterNodeTest, fused_predicate) {
+  planpb::Operator op_proto;
+  ASSERT_TRUE(google::protobuf::TextFormat::ParseFromString(
+      absl::Substitute(planpb::testutils::kOperatorProtoTmpl, "FILTER_OPERATOR", "filter_op",
+                       absl::Substitute(planpb::testutils::kFilterOperatorTmpl,
+                                        kFusedPredicatePbtxt)),
+      &op_proto));
+  plan_node_ = plan::FilterOperator::FromProto(op_proto, /*id*/ 1);
+
+  RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64, types::DataType::STRING});
+  RowDescriptor output_rd(
+      {types::DataType::INT64, types::DataType::INT64, types::DataType::STRING});
+
+  // The comparisons aren't registered as UDFs, so this only passes if the predicate is fused.
+  auto tester = exec::ExecNodeTester<FilterNode, plan::FilterOperator>(
+      *plan_node_, output_rd, {input_rd}, exec_state_.get());
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd, 4, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::Int64Value>({1, 2, 3, 4})
+                       .AddColumn<types::Int64Value>({5, 6, 7, 8})
+                       .AddColumn<types::StringValue>({"b", "b", "a", "b"})
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 2, false, false)
+                          .AddColumn<types::Int64Value>({2, 4})
+                          .AddColumn<types::Int64Value>({6, 8})
+                          .AddColumn<types::StringValue>({"b", "b"})
+                          .get())
+      .ConsumeNext(RowBatchBuilder(input_rd, 2, true, true)
+                       .AddColumn<types::Int64Value>({2, 3})
+                       .AddColumn<types::Int64Value>({6, 7})
+                       .AddColumn<types::StringValue>({"b", "b"})
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 2, true, true)
+                          .AddColumn<types::Int64Value>({2, 3})
+                          .AddColumn<types::Int64Value>({6, 7})
+                          .AddColumn<types::StringValue>({"b", "b"})
+                          .get())
+      .Close();
+}
+
 TEST_F(FilterNodeTest, child_fail) {
   auto op_proto = planpb::testutils::CreateTestFilterTwoCols();
   plan_node_ = plan::FilterOperator::FromProto(op_proto, /*id*/ 1);
@@ -0,0 +1,354 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/fused_predicate.h"
+
+#include <arrow/array.h>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "src/shared/types/types.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using table_store::schema::RowBatch;
+
+namespace {
+
+// An operand of a comparison: a column of the row batch, or a constant.
+template <types::DataType DT>
+class Operand {
+ public:
+  using ArrowArrayType = typename types::DataTypeTraits<DT>::arrow_array_type;
+  using NativeType = typename types::DataTypeTraits<DT>::native_type;
+  // Strings are compared in place in the arrow array.
+  using ValueType = std::conditional_t<DT == types::STRING, std::string_view, NativeType>;
+
+  // Returns false if the expression is neither a column nor a constant of type DT.
+  bool Init(const plan::ScalarExpression& expr) {
+    if (expr.ExpressionType() == plan::Expression::kColumn) {
+      col_idx_ = static_cast<const plan::Column&>(expr).Index();
+      return true;
+    }
+    if (expr.ExpressionType() != plan::Expression::kConstant) {
+      return false;
+    }
+    const auto& val = static_cast<const plan::ScalarValue&>(expr);
+    if (val.DataType() != DT) {
+      return false;
+    }
+    if constexpr (DT == types::BOOLEAN) {
+      constant_ = val.BoolValue();
+    } else if constexpr (DT == types::INT64) {
+      constant_ = val.Int64Value();
+    } else if constexpr (DT == types::FLOAT64) {
+      constant_ = val.Float64Value();
+    } else if constexpr (DT == types::STRING) {
+      constant_ = val.StringValue();
+    } else if constexpr (DT == types::TIME64NS) {
+      constant_ = val.Time64NSValue();
+    }
+    return true;
+  }
+
+  void Bind(const RowBatch& rb) {
+    if (col_idx_ >= 0) {
+      array_ = static_cast<const ArrowArrayType*>(rb.ColumnAt(col_idx_).get());
+    }
+  }
+
+  ValueType Value(int64_t row) const {
+    if (array_ == nullptr) {
+      return constant_;
+    }
+    if constexpr (DT == types::STRING) {
+      int32_t length;
+      const uint8_t* data = array_->GetValue(row, &length);
+      return std::string_view(reinterpret_cast<const char*>(data), length);
+    } else {
+      return array_->Value(row);
+    }
+  }
+
+ private:
+  int64_t col_idx_ = -1;
+  NativeType constant_{};
+  const ArrowArrayType* array_ = nullptr;
+};
+
+template <types::DataType DT, typename TCompare>
+class ComparisonPredicate : public FusedPredicate {
+ public:
+  bool Init(const plan::ScalarExpression& left, const plan::ScalarExpression& right) {
+    return left_.Init(left) && right_.Init(right);
+  }
+
+  void Select(const RowBatch& rb, const std::vector<int64_t>& rows,
+              std::vector<int64_t>* selection) override {
+    left_.Bind(rb);
+    right_.Bind(rb);
+    // Write every row and only advance past the ones that match, so the loop doesn't branch on
+    // the comparison.
+    selection->resize(rows.size());
+    int64_t* out = selection->data();
+    size_t num_selected = 0;
+    TCompare compare;
+    for (int64_t row : rows) {
+      out[num_selected] = row;
+      num_selected += compare(left_.Value(row), right_.Value(row));
+    }
+    selection->resize(num_selected);
+  }
+
+ private:
+  Operand<DT> left_;
+  Operand<DT> right_;
+};
+
+// Selects the rows where a boolean column is true.
+class BoolColumnPredicate : public FusedPredicate {
+ public:
+  explicit BoolColumnPredicate(int64_t col_idx) : col_idx_(col_idx) {}
+
+  void Select(const RowBatch& rb, const std::vector<int64_t>& rows,
+              std::vector<int64_t>* selection) override {
+    const auto* col = static_cast<const arrow::BooleanArray*>(rb.ColumnAt(col_idx_).get());
+    selection->resize(rows.size());
+    int64_t* out = selection->data();
+    size_t num_selected = 0;
+    for (int64_t row : rows) {
+      out[num_selected] = row;
+      num_selected += col->Value(row);
+    }
+    selection->resize(num_selected);
+  }
+
+ private:
+  int64_t col_idx_;
+};
+
+// Evaluates each operand only on the rows selected by the previous ones.
+class AndPredicate : public FusedPredicate {
+ public:
+  explicit AndPredicate(std::vector<std::unique_ptr<FusedPredicate>> operands)
+      : operands_(std::move(operands)) {}
+
+  void Select(const RowBatch& rb, const std::vector<int64_t>& rows,
+              std::vector<int64_t>* selection) override {
+    operands_[0]->Select(rb, rows, selection);
+    for (size_t i = 1; i < operands_.size() && !selection->empty(); ++i) {
+      std::swap(*selection, selected_);
+      operands_[i]->Select(rb, selected_, selection);
+    }
+  }
+
+ private:
+  std::vector<std::unique_ptr<FusedPredicate>> operands_;
+  std::vector<int64_t> selected_;
+};
+
+// Evaluates each operand only on the rows not selected by the previous ones.
+class OrPredicate : public FusedPredicate {
+ public:
+  explicit OrPredicate(std::vector<std::unique_ptr<FusedPredicate>> operands)
+      : operands_(std::move(operands)) {}
+
+  void Select(const RowBatch& rb, const std::vector<int64_t>& rows,
+              std::vector<int64_t>* selection) override {
+    operands_[0]->Select(rb, rows, selection);
+    for (size_t i = 1; i < operands_.size() && selection->size() < rows.size(); ++i) {
+      remaining_.clear();
+      std::set_difference(rows.begin(), rows.end(), selection->begin(), selection->end(),
+                          std::back_inserter(remaining_));
+      operands_[i]->Select(rb, remaining_, &matched_);
+      merged_.clear();
+      std::merge(selection->begin(), selection->end(), matched_.begin(), matched_.end(),
+                 std::back_inserter(merged_));
+      std::swap(*selection, merged_);
+    }
+  }
+
+ private:
+  std::vector<std::unique_ptr<FusedPredicate>> operands_;
+  std::vector<int64_t> remaining_;
+  std::vector<int64_t> matched_;
+  std::vector<int64_t> merged_;
+};
+
+class NotPredicate : public FusedPredicate {
+ public:
+  explicit NotPredicate(std::unique_ptr<FusedPredicate> operand) : operand_(std::move(operand)) {}
+
+  void Select(const RowBatch& rb, const std::vector<int64_t>& rows,
+              std::vector<int64_t>* selection) override {
+    operand_->Select(rb, rows, &matched_);
+    selection->clear();
+    std::set_difference(rows.begin(), rows.end(), matched_.begin(), matched_.end(),
+                        std::back_inserter(*selection));
+  }
+
+ private:
+  std::unique_ptr<FusedPredicate> operand_;
+  std::vector<int64_t> matched_;
+};
+
+// Whether the builtin comparison UDF of this name and argument type compares exactly. Float
+// equality is approximate, and greaterThanEqual is strict for strings and times, as is
+// lessThanEqual for strings. Those are left to the UDFs.
+bool IsExactComparison(const std::string& name, types::DataType type) {
+  switch (type) {
+    case types::INT64:
+      return name == "equal" || name == "notEqual" || name == "lessThan" ||
+             name == "lessThanEqual" || name == "greaterThan" || name == "greaterThanEqual";
+    case types::TIME64NS:
+      return name == "equal" || name == "notEqual" || name == "lessThanEqual";
+    case types::FLOAT64:
+      return name == "lessThan" || name == "lessThanEqual" || name == "greaterThan" ||
+             name == "greaterThanEqual";
+    case types::STRING:
+      return name == "equal" || name == "notEqual" || name == "lessThan" || name == "greaterThan";
+    case types::BOOLEAN:
+      return name == "equal" || name == "notEqual";
+    default:
+      return false;
+  }
+}
+
+template <types::DataType DT, typename TCompare>
+std::unique_ptr<FusedPredicate> CreateComparison(const plan::ScalarFunc& func) {
+  auto predicate = std::make_unique<ComparisonPredicate<DT, TCompare>>();
+  if (!predicate->Init(*func.arg_deps()[0], *func.arg_deps()[1])) {
+    return nullptr;
+  }
+  return predicate;
+}
+
+template <types::DataType DT>
+std::unique_ptr<FusedPredicate> CreateComparison(const plan::ScalarFunc& func) {
+  const std::string& name = func.name();
+  if (name == "equal") {
+    return CreateComparison<DT, std::equal_to<>>(func);
+  }
+  if (name == "notEqual") {
+    return CreateComparison<DT, std::not_equal_to<>>(func);
+  }
+  if (name == "lessThan") {
+    return CreateComparison<DT, std::less<>>(func);
+  }
+  if (name == "lessThanEqual") {
+    return CreateComparison<DT, std::less_equal<>>(func);
+  }
+  if (name == "greaterThan") {
+    return CreateComparison<DT, std::greater<>>(func);
+  }
+  if (name == "greaterThanEqual") {
+    return CreateComparison<DT, std::greater_equal<>>(func);
+  }
+  return nullptr;
+}
+
+bool HasArgTypes(const plan::ScalarFunc& func, size_t num_args, types::DataType type) {
+  const auto& arg_types = func.registry_arg_types();
+  return func.arg_deps().size() == num_args && arg_types.size() == num_args &&
+         std::all_of(arg_types.begin(), arg_types.end(),
+                     [type](types::DataType arg_type) { return arg_type == type; });
+}
+
+// Adds the operands of a chain of the logical function name to operands. Returns false if one of
+// them is not supported.
+bool AddLogicalOperands(const plan::ScalarExpression& expr, const std::string& name,
+                        std::vector<std::unique_ptr<FusedPredicate>>* operands) {
+  if (expr.ExpressionType() == plan::Expression::kFunc) {
+    const auto& func = static_cast<const plan::ScalarFunc&>(expr);
+    if (func.name() == name && HasArgTypes(func, 2, types::BOOLEAN)) {
+      return AddLogicalOperands(*func.arg_deps()[0], name, operands) &&
+             AddLogicalOperands(*func.arg_deps()[1], name, operands);
+    }
+  }
+  auto operand = FusedPredicate::Create(expr);
+  if (operand == nullptr) {
+    return false;
+  }
+  operands->push_back(std::move(operand));
+  return true;
+}
+
+}  // namespace
+
+std::unique_ptr<FusedPredicate> FusedPredicate::Create(const plan::ScalarExpression& expr) {
+  // The expression is a predicate, so a column on its own is a boolean column.
+  if (expr.ExpressionType() == plan::Expression::kColumn) {
+    return std::make_unique<BoolColumnPredicate>(static_cast<const plan::Column&>(expr).Index());
+  }
+  if (expr.ExpressionType() != plan::Expression::kFunc) {
+    return nullptr;
+  }
+  const auto& func = static_cast<const plan::ScalarFunc&>(expr);
+  const std::string& name = func.name();
+
+  if ((name == "logicalAnd" || name == "logicalOr") && HasArgTypes(func, 2, types::BOOLEAN)) {
+    std::vector<std::unique_ptr<FusedPredicate>> operands;
+    if (!AddLogicalOperands(expr, name, &operands)) {
+      return nullptr;
+    }
+    if (name == "logicalAnd") {
+      return std::make_unique<AndPredicate>(std::move(operands));
+    }
+    return std::make_unique<OrPredicate>(std::move(operands));
+  }
+  if (name == "logicalNot" && HasArgTypes(func, 1, types::BOOLEAN)) {
+    auto operand = Create(*func.arg_deps()[0]);
+    if (operand == nullptr) {
+      return nullptr;
+    }
+    return std::make_unique<NotPredicate>(std::move(operand));
+  }
+
+  if (func.registry_arg_types().empty()) {
+    return nullptr;
+  }
+  types::DataType type = func.registry_arg_types()[0];
+  if (!HasArgTypes(func, 2, type) || !IsExactComparison(name, type)) {
+    return nullptr;
+  }
+  switch (type) {
+    case types::BOOLEAN:
+      return CreateComparison<types::BOOLEAN>(func);
+    case types::INT64:
+      return CreateComparison<types::INT64>(func);
+    case types::FLOAT64:
+      return CreateComparison<types::FLOAT64>(func);
+    case types::STRING:
+      return CreateComparison<types::STRING>(func);
+    case types::TIME64NS:
+      return CreateComparison<types::TIME64NS>(func);
+    default:
+      return nullptr;
+  }
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
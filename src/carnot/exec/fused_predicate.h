@@ -0,0 +1,65 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "src/carnot/plan/scalar_expression.h"
+#include "src/table_store/table_store.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+/**
+ * FusedPredicate evaluates a filter predicate directly on the columns of a row batch, without
+ * calling UDFs or materializing intermediate columns. Each comparison is a single loop over the
+ * rows that are still selected, and logical operators combine the selections of their operands.
+ *
+ * Only comparisons of columns and constants, combined with logicalAnd, logicalOr and logicalNot,
+ * are supported. They give the same results as the builtin UDFs of the same name.
+ */
+class FusedPredicate {
+ public:
+  virtual ~FusedPredicate() = default;
+
+  /**
+   * Creates the fused predicate for the expression.
+   *
+   * @return The predicate, or nullptr if the expression is not supported.
+   */
+  static std::unique_ptr<FusedPredicate> Create(const plan::ScalarExpression& expr);
+
+  /**
+   * Selects the rows of the row batch that satisfy the predicate.
+   *
+   * @param rb The row batch.
+   * @param rows The indexes of the rows to evaluate, in increasing order.
+   * @param selection Set to the indexes in rows that satisfy the predicate, in increasing order.
+   *                  Must not be rows.
+   */
+  virtual void Select(const table_store::schema::RowBatch& rb, const std::vector<int64_t>& rows,
+                      std::vector<int64_t>* selection) = 0;
+};
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
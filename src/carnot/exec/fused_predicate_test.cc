@@ -0,0 +1,188 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/fused_predicate.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <google/protobuf/text_format.h>
+#include <gtest/gtest.h>
+
+#include <absl/strings/substitute.h>
+
+#include "src/carnot/exec/test_utils.h"
+#include "src/carnot/planpb/plan.pb.h"
+#include "src/common/testing/testing.h"
+#include "src/shared/types/types.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using table_store::schema::RowDescriptor;
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+// A comparison of column $1 with an int64 constant.
+constexpr char kInt64ComparisonTmpl[] = R"proto(
+func {
+  name: "$0"
+  args { column { index: $1 } }
+  args { constant { data_type: INT64 int64_value: $2 } }
+  args_data_types: INT64
+  args_data_types: INT64
+})proto";
+
+constexpr char kStringEqualPbtxt[] = R"proto(
+func {
+  name: "equal"
+  args { constant { data_type: STRING string_value: "b" } }
+  args { column { index: 2 } }
+  args_data_types: STRING
+  args_data_types: STRING
+})proto";
+
+constexpr char kLogicalTmpl[] = R"proto(
+func {
+  name: "$0"
+  args { $1 }
+  args { $2 }
+  args_data_types: BOOLEAN
+  args_data_types: BOOLEAN
+})proto";
+
+constexpr char kLogicalNotTmpl[] = R"proto(
+func {
+  name: "logicalNot"
+  args { $0 }
+  args_data_types: BOOLEAN
+})proto";
+
+class FusedPredicateTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    RowDescriptor rd({types::INT64, types::INT64, types::STRING, types::BOOLEAN});
+    rb_builder_ = std::make_unique<RowBatchBuilder>(rd, 6, /*eow*/ false, /*eos*/ false);
+    rb_builder_->AddColumn<types::Int64Value>({1, 2, 3, 4, 5, 6})
+        .AddColumn<types::Int64Value>({6, 5, 4, 3, 2, 1})
+        .AddColumn<types::StringValue>({"a", "b", "c", "a", "b", "c"})
+        .AddColumn<types::BoolValue>({true, false, true, false, true, false});
+  }
+
+  std::unique_ptr<plan::ScalarExpression> Expr(const std::string& pbtxt) {
+    planpb::ScalarExpression pb;
+    CHECK(google::protobuf::TextFormat::ParseFromString(pbtxt, &pb)) << pbtxt;
+    auto expr_or_s = plan::ScalarExpression::FromProto(pb);
+    CHECK(expr_or_s.ok());
+    return expr_or_s.ConsumeValueOrDie();
+  }
+
+  std::string Compare(const std::string& name, int64_t col_idx, int64_t value) {
+    return absl::Substitute(kInt64ComparisonTmpl, name, col_idx, value);
+  }
+
+  std::vector<int64_t> Select(const std::string& pbtxt) {
+    auto predicate = FusedPredicate::Create(*Expr(pbtxt));
+    EXPECT_NE(nullptr, predicate);
+    if (predicate == nullptr) {
+      return {};
+    }
+    std::vector<int64_t> selection;
+    predicate->Select(rb_builder_->get(), {0, 1, 2, 3, 4, 5}, &selection);
+    return selection;
+  }
+
+  std::unique_ptr<RowBatchBuilder> rb_builder_;
+};
+
+TEST_F(FusedPredicateTest, comparisons) {
+  EXPECT_THAT(Select(Compare("equal", 0, 3)), ElementsAre(2));
+  EXPECT_THAT(Select(Compare("notEqual", 0, 3)), ElementsAre(0, 1, 3, 4, 5));
+  EXPECT_THAT(Select(Compare("lessThan", 0, 3)), ElementsAre(0, 1));
+  EXPECT_THAT(Select(Compare("lessThanEqual", 0, 3)), ElementsAre(0, 1, 2));
+  EXPECT_THAT(Select(Compare("greaterThan", 1, 3)), ElementsAre(0, 1, 2));
+  EXPECT_THAT(Select(Compare("greaterThanEqual", 1, 3)), ElementsAre(0, 1, 2, 3));
+  EXPECT_THAT(Select(Compare("greaterThan", 1, 10)), IsEmpty());
+  EXPECT_THAT(Select(kStringEqualPbtxt), ElementsAre(1, 4));
+}
+
+TEST_F(FusedPredicateTest, logical_operators) {
+  std::string bool_col = "column { index: 3 }";
+  EXPECT_THAT(Select(bool_col), ElementsAre(0, 2, 4));
+
+  std::string and_expr = absl::Substitute(kLogicalTmpl, "logicalAnd", Compare("greaterThan", 0, 1),
+                                          Compare("lessThan", 1, 4));
+  EXPECT_THAT(Select(and_expr), ElementsAre(3, 4, 5));
+  // Nested ands are flattened into a single chain.
+  EXPECT_THAT(Select(absl::Substitute(kLogicalTmpl, "logicalAnd", and_expr, bool_col)),
+              ElementsAre(4));
+
+  std::string or_expr = absl::Substitute(kLogicalTmpl, "logicalOr", Compare("lessThan", 0, 2),
+                                         kStringEqualPbtxt);
+  EXPECT_THAT(Select(or_expr), ElementsAre(0, 1, 4));
+  EXPECT_THAT(Select(absl::Substitute(kLogicalTmpl, "logicalOr", or_expr, bool_col)),
+              ElementsAre(0, 1, 2, 4));
+
+  EXPECT_THAT(Select(absl::Substitute(kLogicalNotTmpl, or_expr)), ElementsAre(2, 3, 5));
+  EXPECT_THAT(
+      Select(absl::Substitute(kLogicalTmpl, "logicalAnd",
+                              absl::Substitute(kLogicalNotTmpl, bool_col), kStringEqualPbtxt)),
+      ElementsAre(1));
+}
+
+TEST_F(FusedPredicateTest, selects_from_given_rows) {
+  auto predicate = FusedPredicate::Create(*Expr(absl::Substitute(
+      kLogicalTmpl, "logicalOr", Compare("lessThan", 0, 2), Compare("greaterThan", 0, 4))));
+  ASSERT_NE(nullptr, predicate);
+  std::vector<int64_t> selection;
+  predicate->Select(rb_builder_->get(), {0, 2, 3, 5}, &selection);
+  EXPECT_THAT(selection, ElementsAre(0, 5));
+}
+
+TEST_F(FusedPredicateTest, unsupported_expressions) {
+  // Not a builtin comparison.
+  EXPECT_EQ(nullptr, FusedPredicate::Create(*Expr(Compare("add", 0, 1))));
+  // Float equality is approximate in the builtin UDF.
+  EXPECT_EQ(nullptr, FusedPredicate::Create(*Expr(R"proto(
+func {
+  name: "equal"
+  args { column { index: 0 } }
+  args { constant { data_type: FLOAT64 float64_value: 1.0 } }
+  args_data_types: FLOAT64
+  args_data_types: FLOAT64
+})proto")));
+  // The builtin greaterThanEqual of strings is strict.
+  EXPECT_EQ(nullptr, FusedPredicate::Create(*Expr(R"proto(
+func {
+  name: "greaterThanEqual"
+  args { column { index: 2 } }
+  args { constant { data_type: STRING string_value: "b" } }
+  args_data_types: STRING
+  args_data_types: STRING
+})proto")));
+  // An operand is not supported.
+  EXPECT_EQ(nullptr,
+            FusedPredicate::Create(*Expr(absl::Substitute(
+                kLogicalTmpl, "logicalAnd", Compare("lessThan", 0, 2), Compare("add", 0, 1)))));
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
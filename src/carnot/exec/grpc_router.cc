@@ -22,6 +22,7 @@
 #include <ostream>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <absl/base/internal/spinlock.h>
 #include <absl/container/flat_hash_map.h>
@@ -52,6 +53,7 @@ Status GRPCRouter::EnqueueRowBatch(QueryTracker* query_tracker,
   }
 
   auto snt = GetSourceNodeTracker(query_tracker, req->query_result().grpc_source_id());
+  GRPCSourceNode* source_node;
   {
     absl::base_internal::SpinLockHolder snt_lock(&snt->node_lock);
     // It's possible that we see row batches before we have gotten information about the query. To
@@ -60,8 +62,12 @@ Status GRPCRouter::EnqueueRowBatch(QueryTracker* query_tracker,
       snt->response_backlog.emplace_back(std::move(req));
       return Status::OK();
     }
-    PL_RETURN_IF_ERROR(snt->source_node->EnqueueRowBatch(std::move(req)));
+    source_node = snt->source_node;
   }
+  // The node decodes the batch, which is done outside of the lock so that the other threads
+  // spinning on it don't wait for the decoding. The batches of a source all come from the same
+  // stream, so they are still enqueued in order.
+  PL_RETURN_IF_ERROR(source_node->EnqueueRowBatch(std::move(req)));
   query_tracker->RestartExecution();
   return Status::OK();
 }
@@ -267,22 +273,29 @@ Status GRPCRouter::AddGRPCSourceNode(sole::uuid query_id, int64_t source_id,
   }
   auto snt = GetSourceNodeTracker(query_tracker.get(), source_id);
 
-  absl::base_internal::SpinLockHolder snt_lock(&snt->node_lock);
-  snt->source_node = source_node;
-  if (snt->connection_initiated_by_sink) {
-    source_node->set_upstream_initiated_connection();
-  }
-  if (snt->response_backlog.size() > 0) {
-    for (auto& rb : snt->response_backlog) {
-      PL_RETURN_IF_ERROR(snt->source_node->EnqueueRowBatch(std::move(rb)));
+  // The backlog is decoded outside of the lock. Batches that arrive meanwhile join the backlog,
+  // since the node isn't set until the backlog is empty, which keeps them in order.
+  std::vector<std::unique_ptr<carnotpb::TransferResultChunkRequest>> backlog;
+  while (true) {
+    {
+      absl::base_internal::SpinLockHolder snt_lock(&snt->node_lock);
+      if (snt->response_backlog.empty()) {
+        snt->source_node = source_node;
+        if (snt->connection_initiated_by_sink) {
+          source_node->set_upstream_initiated_connection();
+        }
+        if (snt->connection_closed_by_sink) {
+          source_node->set_upstream_closed_connection();
+        }
+        return Status::OK();
+      }
+      backlog.swap(snt->response_backlog);
     }
-    snt->response_backlog.clear();
-  }
-  if (snt->connection_closed_by_sink) {
-    source_node->set_upstream_closed_connection();
+    for (auto& rb : backlog) {
+      PL_RETURN_IF_ERROR(source_node->EnqueueRowBatch(std::move(rb)));
+    }
+    backlog.clear();
   }
-
-  return Status::OK();
 }
 
 StatusOr<std::vector<queryresultspb::AgentExecutionStats>> GRPCRouter::GetIncomingWorkerExecStats(
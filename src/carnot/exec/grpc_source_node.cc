@@ -18,6 +18,7 @@
 
 #include "src/carnot/exec/grpc_source_node.h"
 
+#include <functional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -57,7 +58,40 @@ Status GRPCSourceNode::GenerateNextImpl(ExecState* exec_state) {
 
 Status GRPCSourceNode::EnqueueRowBatch(
     std::unique_ptr<carnotpb::TransferResultChunkRequest> row_batch) {
-  if (!row_batch_queue_.enqueue(std::move(row_batch))) {
+  if (!row_batch->has_query_result() || !row_batch->query_result().has_row_batch()) {
+    return error::Internal(
+        "GRPCSourceNode::EnqueueRowBatch expected TransferResultChunkRequest to have RowBatch "
+        "message.");
+  }
+  // The request is dropped once decoded, so the fixed-width columns are moved out of it rather
+  // than copied. Their memory isn't allocated from the pool, so it is reserved instead.
+  arrow::MemoryPool* pool = arrow::default_memory_pool();
+  std::function<void(int64_t bytes)> reserve_fn;
+  if (mem_pool_ != nullptr) {
+    pool = mem_pool_;
+    reserve_fn = [mem_pool = mem_pool_](int64_t bytes) { mem_pool->ReserveBuffer(bytes); };
+  }
+  StatusOr<std::unique_ptr<RowBatch>> rb_or_s;
+  {
+    // This runs on a GRPC router thread, concurrently with the execution thread, so the
+    // allocations are counted here and charged to this node rather than to the running one.
+    QueryMemoryPool::BackgroundScope scope(mem_pool_);
+    rb_or_s = RowBatch::FromMutableProto(row_batch->mutable_query_result()->mutable_row_batch(),
+                                         pool, std::move(reserve_fn));
+    decode_allocations_ += scope.num_allocations();
+    decode_allocated_bytes_ += scope.total_bytes_allocated();
+    decode_bytes_ += scope.bytes();
+  }
+  std::unique_ptr<RowBatch> rb;
+  if (rb_or_s.ok()) {
+    rb = rb_or_s.ConsumeValueOrDie();
+  } else {
+    absl::MutexLock lock(&decode_status_lock_);
+    if (decode_status_.ok()) {
+      decode_status_ = rb_or_s.status();
+    }
+  }
+  if (!row_batch_queue_.enqueue(std::move(rb))) {
     return error::Internal("Failed to enqueue RowBatch");
   }
   return Status::OK();
@@ -65,20 +99,18 @@ Status GRPCSourceNode::EnqueueRowBatch(
 
 Status GRPCSourceNode::PopRowBatch() {
   DCHECK(NextBatchReady());
-  std::unique_ptr<carnotpb::TransferResultChunkRequest> rb_request;
-  bool got_one = row_batch_queue_.try_dequeue(rb_request);
+  bool got_one = row_batch_queue_.try_dequeue(rb_);
   if (!got_one) {
     return error::Internal(
         "Called GRPCSourceNode::OptionallyPopRowBatch but there was no available row batch in the "
         "queue.");
   }
-  if (!rb_request->has_query_result() || !rb_request->query_result().has_row_batch()) {
-    return error::Internal(
-        "GRPCSourceNode::PopRowBatch expected TransferResultChunkRequest to have RowBatch "
-        "message.");
+  stats()->AddBackgroundMemory(decode_allocations_.exchange(0), decode_allocated_bytes_.exchange(0),
+                               decode_bytes_.exchange(0));
+  if (rb_ == nullptr) {
+    absl::MutexLock lock(&decode_status_lock_);
+    return decode_status_;
   }
-
-  PL_ASSIGN_OR_RETURN(rb_, RowBatch::FromProto(rb_request->query_result().row_batch()));
   return Status::OK();
 }
 
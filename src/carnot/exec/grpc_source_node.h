@@ -18,6 +18,10 @@
 
 #pragma once
 
+#include <absl/synchronization/mutex.h>
+#include <arrow/memory_pool.h>
+
+#include <atomic>
 #include <chrono>
 #include <memory>
 #include <string>
@@ -26,6 +30,7 @@
 #include "src/carnot/carnotpb/carnot.pb.h"
 #include "src/carnot/exec/exec_node.h"
 #include "src/carnot/exec/exec_state.h"
+#include "src/carnot/exec/query_memory_pool.h"
 #include "src/carnot/plan/operators.h"
 #include "src/common/base/base.h"
 #include "src/table_store/table_store.h"
@@ -42,8 +47,18 @@ class GRPCSourceNode : public SourceNode {
   virtual ~GRPCSourceNode() = default;
 
   bool NextBatchReady() override;
+
+  /**
+   * Decodes the row batch of the request and queues it for the execution thread. Called from the
+   * GRPC router's threads, so that the execution thread only has to dequeue decoded batches.
+   */
   virtual Status EnqueueRowBatch(std::unique_ptr<carnotpb::TransferResultChunkRequest> row_batch);
 
+  // Sets the query's pool, which the decoded row batches are allocated from and accounted to. Must
+  // be called before the node is registered with the GRPC router. Without it, the batches are
+  // allocated from arrow's default pool.
+  void set_mem_pool(QueryMemoryPool* mem_pool) { mem_pool_ = mem_pool; }
+
   // Tracks whether the upstream sink node has successfully initiated the connection to
   // this remote source. Used by the exec graph to determine whether or not any sources have
   // taken too long for their connection to be established with the sinks.
@@ -68,8 +83,18 @@ class GRPCSourceNode : public SourceNode {
   Status PopRowBatch();
 
   std::unique_ptr<table_store::schema::RowBatch> rb_;
-  moodycamel::BlockingConcurrentQueue<std::unique_ptr<carnotpb::TransferResultChunkRequest>>
+  // Batches that failed to decode are queued as nullptr, and their error is kept in decode_status_
+  // to fail the query once the execution thread reaches them.
+  moodycamel::BlockingConcurrentQueue<std::unique_ptr<table_store::schema::RowBatch>>
       row_batch_queue_;
+  absl::Mutex decode_status_lock_;
+  Status decode_status_ ABSL_GUARDED_BY(decode_status_lock_);
+  QueryMemoryPool* mem_pool_ = nullptr;
+  // The query memory that decoding allocated on the GRPC router's threads, which is charged to the
+  // node's stats by the execution thread.
+  std::atomic<int64_t> decode_allocations_ = 0;
+  std::atomic<int64_t> decode_allocated_bytes_ = 0;
+  std::atomic<int64_t> decode_bytes_ = 0;
 
   std::unique_ptr<plan::GRPCSourceOperator> plan_node_;
   bool upstream_initiated_connection_ = false;
@@ -18,14 +18,21 @@
 
 #include "src/carnot/exec/memory_source_node.h"
 
+#include <arrow/array/concatenate.h>
+#include <algorithm>
 #include <limits>
+#include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include <absl/container/flat_hash_set.h>
 #include <absl/strings/substitute.h>
 
 #include "src/carnot/planpb/plan.pb.h"
 #include "src/common/base/base.h"
+#include "src/shared/types/arrow_adapter.h"
+#include "src/table_store/table/time_index.h"
 
 namespace px {
 namespace carnot {
@@ -47,32 +54,130 @@ Status MemorySourceNode::InitImpl(const plan::Operator& plan_node) {
 
 Status MemorySourceNode::PrepareImpl(ExecState*) { return Status::OK(); }
 
-Status MemorySourceNode::OpenImpl(ExecState* exec_state) {
-  table_ = exec_state->table_store()->GetTable(plan_node_->TableName(), plan_node_->Tablet());
-  DCHECK(table_ != nullptr);
+namespace {
 
-  infinite_stream_ = plan_node_->infinite_stream();
+// The most rows in a batch of merged tablet rows.
+constexpr int64_t kMergedRowBatchSize = 1024;
+
+/**
+ * Gets the UPIDs of the rows that the partition filter keeps. Pods are resolved to the UPIDs of
+ * their processes in the same way that upid_to_pod_name resolves UPIDs to pods, so the filter
+ * keeps exactly the rows that the query's pod filter can pass. Returns nullopt if the pods can't
+ * be resolved, in which case all the partitions must be read.
+ */
+std::optional<std::vector<absl::uint128>> PartitionFilterUPIDs(
+    const planpb::MemorySourceOperator::PartitionFilter& filter,
+    const md::AgentMetadataState* md_state) {
+  std::vector<absl::uint128> upids;
+  for (const auto& upid : filter.upids()) {
+    upids.push_back(absl::MakeUint128(upid.high(), upid.low()));
+  }
+  if (filter.pod_names_size() == 0) {
+    return upids;
+  }
+  if (md_state == nullptr) {
+    return std::nullopt;
+  }
+  absl::flat_hash_set<std::string> pod_names(filter.pod_names().begin(),
+                                             filter.pod_names().end());
+  const auto& k8s_state = md_state->k8s_metadata_state();
+  for (const auto& [upid, pid_info] : md_state->pids_by_upid()) {
+    if (pid_info == nullptr) {
+      continue;
+    }
+    const auto* container_info = k8s_state.ContainerInfoByID(pid_info->cid());
+    if (container_info == nullptr) {
+      continue;
+    }
+    const auto* pod_info = k8s_state.PodInfoByID(container_info->pod_id());
+    if (pod_info != nullptr &&
+        pod_names.contains(absl::Substitute("$0/$1", pod_info->ns(), pod_info->name()))) {
+      upids.push_back(upid.value());
+    }
+  }
+  return upids;
+}
+
+}  // namespace
+
+StatusOr<std::vector<table_store::Table*>> MemorySourceNode::GetTablets(ExecState* exec_state) {
+  auto* table_store = exec_state->table_store();
+  const std::string& table_name = plan_node_->TableName();
+
+  std::vector<types::TabletID> tablet_ids;
+  if (plan_node_->Tablet().empty() && table_store->GetPartitioning(table_name) != nullptr) {
+    std::optional<std::vector<absl::uint128>> upids;
+    if (plan_node_->HasPartitionFilter()) {
+      upids = PartitionFilterUPIDs(plan_node_->partition_filter(), exec_state->metadata_state());
+    }
+    tablet_ids = table_store->GetPartitionTablets(table_name, upids);
+    stats()->AddExtraMetric("partitions_read", tablet_ids.size());
+  } else {
+    tablet_ids.push_back(plan_node_->Tablet());
+  }
 
-  if (table_ == nullptr) {
-    return error::NotFound("Table '$0' not found", plan_node_->TableName());
+  std::vector<table_store::Table*> tablets;
+  for (const auto& tablet_id : tablet_ids) {
+    table_store::Table* table = table_store->GetTable(table_name, tablet_id);
+    DCHECK(table != nullptr);
+    if (table == nullptr) {
+      return error::NotFound("Table '$0' not found", table_name);
+    }
+    tablets.push_back(table);
   }
+  return tablets;
+}
 
+Status MemorySourceNode::OpenCursor(ExecState* exec_state, table_store::Table* table) {
+  TabletCursor cursor;
+  cursor.table = table;
   if (plan_node_->HasStartTime()) {
-    PL_ASSIGN_OR_RETURN(current_batch_, table_->FindBatchSliceGreaterThanOrEqual(
-                                            plan_node_->start_time(), exec_state->exec_mem_pool()));
+    PL_ASSIGN_OR_RETURN(cursor.current_batch,
+                        table->FindBatchSliceGreaterThanOrEqual(plan_node_->start_time(),
+                                                                exec_state->exec_mem_pool()));
   } else {
-    current_batch_ = table_->FirstBatch();
+    cursor.current_batch = table->FirstBatch();
   }
 
   if (plan_node_->HasStopTime()) {
-    PL_ASSIGN_OR_RETURN(stop_, table_->FindStopPositionForTime(plan_node_->stop_time(),
-                                                               exec_state->exec_mem_pool()));
+    PL_ASSIGN_OR_RETURN(cursor.stop, table->FindStopPositionForTime(plan_node_->stop_time(),
+                                                                    exec_state->exec_mem_pool()));
   } else {
     // Determine table_end at Open() time because Stirling may be pushing to the table
-    stop_ = table_->End();
+    cursor.stop = table->End();
+  }
+  cursor.current_batch = table->SliceIfPastStop(cursor.current_batch, cursor.stop);
+  cursors_.push_back(std::move(cursor));
+  return Status::OK();
+}
+
+Status MemorySourceNode::OpenImpl(ExecState* exec_state) {
+  infinite_stream_ = plan_node_->infinite_stream();
+
+  PL_ASSIGN_OR_RETURN(auto tablets, GetTablets(exec_state));
+  for (table_store::Table* table : tablets) {
+    PL_RETURN_IF_ERROR(OpenCursor(exec_state, table));
   }
-  current_batch_ = table_->SliceIfPastStop(current_batch_, stop_);
 
+  // Infinite streams can't wait on idle tablets to merge them, so they take turns instead.
+  if (infinite_stream_ || cursors_.size() < 2) {
+    return Status::OK();
+  }
+  auto rel = cursors_[0].table->GetRelation();
+  if (!rel.HasColumn("time_") || rel.GetColumnType("time_") != types::DataType::TIME64NS) {
+    return Status::OK();
+  }
+  merge_by_time_ = true;
+  merge_cols_ = plan_node_->Columns();
+  int64_t time_col = rel.GetColumnIndex("time_");
+  auto it = std::find(merge_cols_.begin(), merge_cols_.end(), time_col);
+  merge_time_col_ = it - merge_cols_.begin();
+  if (it == merge_cols_.end()) {
+    merge_cols_.push_back(time_col);
+  }
+  for (auto& cursor : cursors_) {
+    PL_RETURN_IF_ERROR(LoadMergeBatch(exec_state, &cursor));
+  }
   return Status::OK();
 }
 
@@ -81,44 +186,169 @@ Status MemorySourceNode::CloseImpl(ExecState*) {
   return Status::OK();
 }
 
-StatusOr<std::unique_ptr<RowBatch>> MemorySourceNode::GetNextRowBatch(ExecState* exec_state) {
-  DCHECK(table_ != nullptr);
+bool MemorySourceNode::CursorReady(const TabletCursor& cursor) const {
+  if (!cursor.wait_for_valid_next) {
+    return cursor.current_batch.IsValid();
+  }
+  return cursor.table->NextBatch(cursor.current_batch).IsValid();
+}
 
-  if (infinite_stream_ && wait_for_valid_next_) {
-    // If it's an infinite_stream that has read out all the current data in the table, we have to
-    // keep around the last batch the infinite stream output and keep checking if the next batch
-    // after that is valid so that when stirling writes more data we are able to access it.
-    stop_ = table_->End();
-    auto next_batch = table_->NextBatch(current_batch_, stop_);
-    if (!next_batch.IsValid()) {
-      return RowBatch::WithZeroRows(*output_descriptor_, /* eow */ false, /* eos */ false);
+bool MemorySourceNode::AllCursorsDone() const {
+  for (const auto& cursor : cursors_) {
+    if (cursor.current_batch.IsValid()) {
+      return false;
     }
-    current_batch_ = next_batch;
-    wait_for_valid_next_ = false;
   }
+  return true;
+}
 
-  if (!current_batch_.IsValid()) {
+bool MemorySourceNode::FindReadyCursor() {
+  for (size_t i = 0; i < cursors_.size(); ++i) {
+    TabletCursor* cursor = &cursors_[current_cursor_];
+    if (infinite_stream_ && cursor->wait_for_valid_next) {
+      // If it's an infinite_stream that has read out all the current data in the tablet, we have
+      // to keep around the last batch the infinite stream output and keep checking if the next
+      // batch after that is valid so that when stirling writes more data we are able to access
+      // it.
+      cursor->stop = cursor->table->End();
+      auto next_batch = cursor->table->NextBatch(cursor->current_batch, cursor->stop);
+      if (next_batch.IsValid()) {
+        cursor->current_batch = next_batch;
+        cursor->wait_for_valid_next = false;
+      }
+    }
+    if (!cursor->wait_for_valid_next && cursor->current_batch.IsValid()) {
+      return true;
+    }
+    current_cursor_ = (current_cursor_ + 1) % cursors_.size();
+  }
+  return false;
+}
+
+Status MemorySourceNode::LoadMergeBatch(ExecState* exec_state, TabletCursor* cursor) {
+  cursor->merge_batch.reset();
+  cursor->merge_row = 0;
+  while (cursor->current_batch.IsValid()) {
+    PL_ASSIGN_OR_RETURN(auto row_batch,
+                        cursor->table->GetRowBatchSlice(cursor->current_batch, merge_cols_,
+                                                        exec_state->exec_mem_pool()));
+    cursor->current_batch = cursor->table->NextBatch(cursor->current_batch, cursor->stop);
+    if (row_batch->num_rows() > 0) {
+      cursor->merge_batch = std::move(row_batch);
+      break;
+    }
+  }
+  return Status::OK();
+}
+
+StatusOr<std::unique_ptr<RowBatch>> MemorySourceNode::MergeNextRowBatch(ExecState* exec_state) {
+  size_t num_cols = output_descriptor_->size();
+  std::vector<arrow::ArrayVector> slices(num_cols);
+  int64_t num_rows = 0;
+  while (num_rows < kMergedRowBatchSize) {
+    // Find the cursor with the earliest next row, and the earliest next row of the others. Ties go
+    // to the lower cursor index.
+    TabletCursor* first = nullptr;
+    TabletCursor* second = nullptr;
+    int64_t first_time = 0;
+    int64_t second_time = 0;
+    for (auto& cursor : cursors_) {
+      if (cursor.merge_batch == nullptr) {
+        continue;
+      }
+      int64_t time = types::GetValueFromArrowArray<types::TIME64NS>(
+          cursor.merge_batch->ColumnAt(merge_time_col_).get(), cursor.merge_row);
+      if (first == nullptr || time < first_time) {
+        second = first;
+        second_time = first_time;
+        first = &cursor;
+        first_time = time;
+      } else if (second == nullptr || time < second_time) {
+        second = &cursor;
+        second_time = time;
+      }
+    }
+    if (first == nullptr) {
+      break;
+    }
+
+    // Take the run of rows of the first cursor that go before the next row of the others. Those
+    // have a higher index than the first cursor when their time is the same, so the run includes
+    // the rows of that time.
+    auto time_col =
+        static_cast<const arrow::Time64Array*>(first->merge_batch->ColumnAt(merge_time_col_).get());
+    int64_t start = first->merge_row;
+    int64_t end = time_col->length();
+    if (second != nullptr) {
+      end = start + table_store::TimeUpperBound(time_col->raw_values() + start, end - start,
+                                                second_time);
+    }
+    end = std::min(end, start + kMergedRowBatchSize - num_rows);
+    DCHECK_GT(end, start);
+    for (size_t i = 0; i < num_cols; ++i) {
+      slices[i].push_back(first->merge_batch->ColumnAt(i)->Slice(start, end - start));
+    }
+    num_rows += end - start;
+    first->merge_row = end;
+    if (end == time_col->length()) {
+      PL_RETURN_IF_ERROR(LoadMergeBatch(exec_state, first));
+    }
+  }
+
+  auto row_batch = std::make_unique<RowBatch>(*output_descriptor_, num_rows);
+  for (size_t i = 0; i < num_cols; ++i) {
+    std::shared_ptr<arrow::Array> col;
+    if (slices[i].size() == 1) {
+      col = slices[i][0];
+    } else if (slices[i].empty()) {
+      auto builder = MakeArrowBuilder(output_descriptor_->type(i), exec_state->exec_mem_pool());
+      PL_RETURN_IF_ERROR(builder->Finish(&col));
+    } else {
+      PL_RETURN_IF_ERROR(arrow::Concatenate(slices[i], exec_state->exec_mem_pool(), &col));
+    }
+    PL_RETURN_IF_ERROR(row_batch->AddColumn(col));
+  }
+  rows_processed_ += row_batch->num_rows();
+  bytes_processed_ += row_batch->NumBytes();
+
+  bool done = std::all_of(cursors_.begin(), cursors_.end(),
+                          [](const TabletCursor& cursor) { return cursor.merge_batch == nullptr; });
+  row_batch->set_eow(done);
+  row_batch->set_eos(done);
+  return row_batch;
+}
+
+StatusOr<std::unique_ptr<RowBatch>> MemorySourceNode::GetNextRowBatch(ExecState* exec_state) {
+  if (merge_by_time_) {
+    return MergeNextRowBatch(exec_state);
+  }
+  if (!FindReadyCursor()) {
     return RowBatch::WithZeroRows(*output_descriptor_, /* eow */ !infinite_stream_,
                                   /* eos */ !infinite_stream_);
   }
+  TabletCursor* cursor = &cursors_[current_cursor_];
 
-  PL_ASSIGN_OR_RETURN(
-      auto row_batch,
-      table_->GetRowBatchSlice(current_batch_, plan_node_->Columns(), exec_state->exec_mem_pool()));
+  PL_ASSIGN_OR_RETURN(auto row_batch,
+                      cursor->table->GetRowBatchSlice(cursor->current_batch, plan_node_->Columns(),
+                                                      exec_state->exec_mem_pool()));
 
   rows_processed_ += row_batch->num_rows();
   bytes_processed_ += row_batch->NumBytes();
-  auto next_batch = table_->NextBatch(current_batch_, stop_);
+  auto next_batch = cursor->table->NextBatch(cursor->current_batch, cursor->stop);
   if (infinite_stream_ && !next_batch.IsValid()) {
-    wait_for_valid_next_ = true;
+    cursor->wait_for_valid_next = true;
   } else {
-    current_batch_ = next_batch;
+    cursor->current_batch = next_batch;
+  }
+  if (infinite_stream_) {
+    // Streams take turns between the tablets, so that a busy tablet doesn't hold back the others.
+    current_cursor_ = (current_cursor_ + 1) % cursors_.size();
   }
 
   // If infinite stream is set, we don't send Eow or Eos. Infinite streams therefore never cause
   // HasBatchesRemaining to be false. Instead the outer loop that calls GenerateNext() is
   // responsible for managing whether we continue the stream or end it.
-  if (!current_batch_.IsValid() && !infinite_stream_) {
+  if (!infinite_stream_ && AllCursorsDone()) {
     row_batch->set_eow(true);
     row_batch->set_eos(true);
   }
@@ -131,18 +361,21 @@ Status MemorySourceNode::GenerateNextImpl(ExecState* exec_state) {
   return Status::OK();
 }
 
-bool MemorySourceNode::InfiniteStreamNextBatchReady() {
-  if (!wait_for_valid_next_) {
-    return current_batch_.IsValid();
-  }
-  auto next_batch = table_->NextBatch(current_batch_);
-  return next_batch.IsValid();
-}
-
 bool MemorySourceNode::NextBatchReady() {
   // Next batch is ready if we haven't seen an eow and if it's an infinite_stream that has batches
   // to push.
-  return HasBatchesRemaining() && (!infinite_stream_ || InfiniteStreamNextBatchReady());
+  if (!HasBatchesRemaining()) {
+    return false;
+  }
+  if (!infinite_stream_) {
+    return true;
+  }
+  for (const auto& cursor : cursors_) {
+    if (CursorReady(cursor)) {
+      return true;
+    }
+  }
+  return false;
 }
 
 }  // namespace exec
@@ -53,19 +53,54 @@ class MemorySourceNode : public SourceNode {
   Status GenerateNextImpl(ExecState* exec_state) override;
 
  private:
+  // The read position in one of the tablets that the source reads.
+  struct TabletCursor {
+    table_store::Table* table = nullptr;
+    table_store::BatchSlice current_batch;
+    table_store::Table::StopPosition stop;
+    // An infinite stream will set this to true once its exceeded the current data in the
+    // tablet, and then will keep checking for new data.
+    bool wait_for_valid_next = false;
+    // When merging the tablets, the batch being merged and the next row of it to merge. Null once
+    // the tablet has no more rows.
+    std::unique_ptr<RowBatch> merge_batch;
+    int64_t merge_row = 0;
+  };
+
+  /**
+   * Gets the tablets to read. A partitioned table is read from the partitions that can hold
+   * the rows of the partition filter, others from the tablet of the plan.
+   */
+  StatusOr<std::vector<table_store::Table*>> GetTablets(ExecState* exec_state);
+  Status OpenCursor(ExecState* exec_state, table_store::Table* table);
   StatusOr<std::unique_ptr<RowBatch>> GetNextRowBatch(ExecState* exec_state);
-  bool InfiniteStreamNextBatchReady();
+  // Moves to the next cursor that has a batch to read, if there is one.
+  bool FindReadyCursor();
+  bool CursorReady(const TabletCursor& cursor) const;
+  bool AllCursorsDone() const;
+  // Reads the next non-empty batch of the cursor to merge, if there is one.
+  Status LoadMergeBatch(ExecState* exec_state, TabletCursor* cursor);
+  /**
+   * Merges the rows of the tablets by time, so that reading several partitions outputs rows in
+   * time order like reading a single tablet does.
+   */
+  StatusOr<std::unique_ptr<RowBatch>> MergeNextRowBatch(ExecState* exec_state);
   // Whether this memory source will stream infinitely. Can be stopped by the
   // exec_state_->keep_running() call in exec_graph.
   bool infinite_stream_ = false;
-  // An infinite stream will set this to true once its exceeded the current data in the table, and
-  // then will keep checking for new data.
-  bool wait_for_valid_next_ = false;
-  table_store::BatchSlice current_batch_;
-  table_store::Table::StopPosition stop_;
+  // The tablets are merged by time, or read in turns for an infinite stream.
+  std::vector<TabletCursor> cursors_;
+  size_t current_cursor_ = 0;
+  // Whether the rows of the tablets are merged by time, which is done for finite reads of several
+  // tablets with a time column.
+  bool merge_by_time_ = false;
+  // The columns read from the tablets when merging: the plan's columns, followed by the time
+  // column if the plan doesn't read it.
+  std::vector<int64_t> merge_cols_;
+  // The index of the time column in merge_cols_.
+  int64_t merge_time_col_ = -1;
 
   std::unique_ptr<plan::MemorySourceOperator> plan_node_;
-  table_store::Table* table_ = nullptr;
 };
 
 }  // namespace exec
@@ -25,6 +25,7 @@
 
 #include <absl/strings/substitute.h>
 #include <gmock/gmock.h>
+#include <google/protobuf/text_format.h>
 #include <gtest/gtest.h>
 #include <sole.hpp>
 
@@ -342,6 +343,129 @@ TEST_F(MemorySourceNodeTabletDeathTest, missing_tablet_fails) {
   EXPECT_DEBUG_DEATH(EXPECT_NOT_OK(exec_node_->Open(exec_state_.get())), "");
 }
 
+constexpr char kPartitionedSourceOperator[] = R"(
+op_type: MEMORY_SOURCE_OPERATOR
+mem_source_op {
+  name: "conn"
+  column_idxs: 1
+  column_names: "time_"
+  column_types: TIME64NS
+  $0
+})";
+
+class MemorySourceNodePartitionTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    func_registry_ = std::make_unique<udf::Registry>("test_registry");
+    auto table_store = std::make_shared<table_store::TableStore>();
+    exec_state_ = std::make_unique<ExecState>(func_registry_.get(), table_store,
+                                              MockResultSinkStubGenerator, sole::uuid4(), nullptr);
+
+    table_store::schema::Relation rel({types::DataType::UINT128, types::DataType::TIME64NS},
+                                      {"upid", "time_"});
+    table_store->AddTable(Table::Create(rel), "conn", table_id_);
+    EXPECT_OK(table_store->PartitionTable("conn", "upid", 4));
+
+    auto batch = std::make_unique<types::ColumnWrapperRecordBatch>();
+    auto upid_col = std::make_shared<types::UInt128ValueColumnWrapper>(0);
+    upid_col->AppendFromVector(
+        std::vector<types::UInt128Value>{{0, 1}, {0, 2}, {0, 1}, {0, 3}, {0, 1}});
+    auto time_col = std::make_shared<types::Time64NSValueColumnWrapper>(0);
+    time_col->AppendFromVector(std::vector<types::Time64NSValue>{1, 2, 3, 4, 5});
+    batch->push_back(upid_col);
+    batch->push_back(time_col);
+    EXPECT_OK(table_store->AppendData(table_id_, "", std::move(batch)));
+  }
+
+  // Reads the whole table with the given partition filter, and returns the rows read.
+  int64_t ReadRows(const std::string& partition_filter) {
+    planpb::Operator op_proto;
+    CHECK(google::protobuf::TextFormat::MergeFromString(
+        absl::Substitute(kPartitionedSourceOperator, partition_filter), &op_proto));
+    std::unique_ptr<plan::Operator> plan_node = plan::MemorySourceOperator::FromProto(op_proto, 1);
+    RowDescriptor output_rd({types::DataType::TIME64NS});
+
+    auto tester = exec::ExecNodeTester<MemorySourceNode, plan::MemorySourceOperator>(
+        *plan_node, output_rd, std::vector<RowDescriptor>({}), exec_state_.get());
+    while (tester.node()->HasBatchesRemaining()) {
+      tester.GenerateNextResult();
+    }
+    tester.Close();
+    return tester.node()->RowsProcessed();
+  }
+
+  std::unique_ptr<ExecState> exec_state_;
+  std::unique_ptr<udf::Registry> func_registry_;
+  uint64_t table_id_ = 987;
+};
+
+TEST_F(MemorySourceNodePartitionTest, reads_all_partitions) { EXPECT_EQ(5, ReadRows("")); }
+
+TEST_F(MemorySourceNodePartitionTest, prunes_partitions_by_upid) {
+  auto* table_store = exec_state_->table_store();
+  auto tablets = table_store->GetPartitionTablets("conn", std::vector<absl::uint128>{1});
+  ASSERT_EQ(1, tablets.size());
+  int64_t partition_rows = 0;
+  for (const auto& rb :
+       table_store->GetTable("conn", tablets[0])->GetTableAsRecordBatches().ConsumeValueOrDie()) {
+    partition_rows += rb->num_rows();
+  }
+  EXPECT_LE(3, partition_rows);
+
+  EXPECT_EQ(partition_rows, ReadRows("partition_filter { upids { high: 0 low: 1 } }"));
+}
+
+TEST_F(MemorySourceNodePartitionTest, empty_partition_filter) {
+  EXPECT_EQ(0, ReadRows("partition_filter {}"));
+}
+
+TEST_F(MemorySourceNodePartitionTest, pods_without_metadata_read_all_partitions) {
+  EXPECT_EQ(5, ReadRows("partition_filter { pod_names: \"pl/pod1\" }"));
+}
+
+TEST_F(MemorySourceNodePartitionTest, merges_partitions_by_time) {
+  planpb::Operator op_proto;
+  CHECK(google::protobuf::TextFormat::MergeFromString(
+      absl::Substitute(kPartitionedSourceOperator, ""), &op_proto));
+  std::unique_ptr<plan::Operator> plan_node = plan::MemorySourceOperator::FromProto(op_proto, 1);
+  RowDescriptor output_rd({types::DataType::TIME64NS});
+
+  auto tester = exec::ExecNodeTester<MemorySourceNode, plan::MemorySourceOperator>(
+      *plan_node, output_rd, std::vector<RowDescriptor>({}), exec_state_.get());
+  tester.GenerateNextResult().ExpectRowBatch(
+      RowBatchBuilder(output_rd, 5, /*eow*/ true, /*eos*/ true)
+          .AddColumn<types::Time64NSValue>({1, 2, 3, 4, 5})
+          .get());
+  EXPECT_FALSE(tester.node()->HasBatchesRemaining());
+  tester.Close();
+}
+
+constexpr char kPartitionedUPIDSourceOperator[] = R"(
+op_type: MEMORY_SOURCE_OPERATOR
+mem_source_op {
+  name: "conn"
+  column_idxs: 0
+  column_names: "upid"
+  column_types: UINT128
+})";
+
+// The partitions are merged by time even when the time column isn't read.
+TEST_F(MemorySourceNodePartitionTest, merges_partitions_without_time_column) {
+  planpb::Operator op_proto;
+  CHECK(google::protobuf::TextFormat::MergeFromString(kPartitionedUPIDSourceOperator, &op_proto));
+  std::unique_ptr<plan::Operator> plan_node = plan::MemorySourceOperator::FromProto(op_proto, 1);
+  RowDescriptor output_rd({types::DataType::UINT128});
+
+  auto tester = exec::ExecNodeTester<MemorySourceNode, plan::MemorySourceOperator>(
+      *plan_node, output_rd, std::vector<RowDescriptor>({}), exec_state_.get());
+  tester.GenerateNextResult().ExpectRowBatch(
+      RowBatchBuilder(output_rd, 5, /*eow*/ true, /*eos*/ true)
+          .AddColumn<types::UInt128Value>({{0, 1}, {0, 2}, {0, 1}, {0, 3}, {0, 1}})
+          .get());
+  EXPECT_FALSE(tester.node()->HasBatchesRemaining());
+  tester.Close();
+}
+
 TEST_F(MemorySourceNodeTest, infinite_stream) {
   auto op_proto = planpb::testutils::CreateTestStreamingSource1PB();
   std::unique_ptr<plan::Operator> plan_node = plan::MemorySourceOperator::FromProto(op_proto, 1);
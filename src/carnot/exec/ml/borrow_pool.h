@@ -21,7 +21,7 @@
 #include <utility>
 #include <vector>
 
-#include <absl/base/internal/spinlock.h>
+#include <absl/synchronization/mutex.h>
 
 namespace px {
 namespace carnot {
@@ -35,40 +35,56 @@ class BorrowPool {
   struct ReclaimDeleter {
     void operator()(T* ptr) {
       if (ptr != nullptr) {
-        absl::base_internal::SpinLockHolder l(pool_lock_);
+        absl::MutexLock l(pool_lock_);
         StoredPtrType stored_ptr(ptr);
         pool_->push_back(std::move(stored_ptr));
       }
     }
     std::vector<StoredPtrType>* pool_;
-    absl::base_internal::SpinLock* pool_lock_;
+    absl::Mutex* pool_lock_;
   };
   using BorrowedPtrType = std::unique_ptr<T, ReclaimDeleter>;
 
   void Add(StoredPtrType ptr) {
-    absl::base_internal::SpinLockHolder l(&pool_lock_);
+    absl::MutexLock l(&pool_lock_);
     pool_.push_back(std::move(ptr));
   }
 
+  /**
+   * Borrows an item from the pool, or returns nullptr if they are all borrowed.
+   */
   BorrowedPtrType Borrow() {
-    absl::base_internal::SpinLockHolder l(&pool_lock_);
+    absl::MutexLock l(&pool_lock_);
     if (pool_.size() == 0) {
       return nullptr;
     }
-    auto raw_ptr = pool_.back().release();
-    pool_.pop_back();
-    BorrowedPtrType ptr(raw_ptr, ReclaimDeleter{&pool_, &pool_lock_});
-    return ptr;
+    return BorrowLocked();
+  }
+
+  /**
+   * Borrows an item from the pool, blocking until one is returned if they are all borrowed.
+   */
+  BorrowedPtrType BorrowOrWait() {
+    absl::MutexLock l(&pool_lock_);
+    pool_lock_.Await(absl::Condition(
+        +[](std::vector<StoredPtrType>* pool) { return !pool->empty(); }, &pool_));
+    return BorrowLocked();
   }
 
   size_t Size() {
-    absl::base_internal::SpinLockHolder l(&pool_lock_);
+    absl::MutexLock l(&pool_lock_);
     return pool_.size();
   }
 
  private:
-  std::vector<StoredPtrType> pool_ GUARDED_BY(pool_lock_);
-  absl::base_internal::SpinLock pool_lock_;
+  BorrowedPtrType BorrowLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(pool_lock_) {
+    auto raw_ptr = pool_.back().release();
+    pool_.pop_back();
+    return BorrowedPtrType(raw_ptr, ReclaimDeleter{&pool_, &pool_lock_});
+  }
+
+  std::vector<StoredPtrType> pool_ ABSL_GUARDED_BY(pool_lock_);
+  absl::Mutex pool_lock_;
 };
 
 }  // namespace ml
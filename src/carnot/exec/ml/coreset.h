@@ -24,12 +24,14 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 #include <absl/strings/substitute.h>
 #include "third_party/eigen3/Eigen/Core"
 
+#include "src/carnot/exec/ml/float_vector.h"
 #include "src/common/base/base.h"
 
 namespace px {
@@ -125,6 +127,45 @@ class WeightedPointSet {
     return set;
   }
 
+  /**
+   * Binary counterparts of ToJSON/FromJSON: the dimensions, followed by the raw float values of
+   * the points (column major, as Eigen stores them) and of the weights.
+   */
+  void ToBytes(std::string* out) const {
+    AppendPOD<int32_t>(points_.rows(), out);
+    AppendPOD<int32_t>(points_.cols(), out);
+    AppendFloats(points_.data(), points_.size(), out);
+    AppendFloats(weights_.data(), weights_.size(), out);
+  }
+
+  bool FromBytes(std::string_view* in) {
+    int32_t rows;
+    int32_t cols;
+    if (!ReadPOD(in, &rows) || !ReadPOD(in, &cols) || rows < 0 || cols < 0) {
+      return false;
+    }
+    // Computed in 64 bits, so that large dimensions can't overflow past the size check.
+    int64_t num_floats = static_cast<int64_t>(rows) * (static_cast<int64_t>(cols) + 1);
+    if (static_cast<int64_t>(in->size() / sizeof(float)) < num_floats) {
+      return false;
+    }
+    points_.resize(rows, cols);
+    weights_.resize(rows);
+    ReadFloats(in, points_.data(), points_.size());
+    ReadFloats(in, weights_.data(), weights_.size());
+    size_ = rows;
+    point_size_ = cols;
+    return true;
+  }
+
+  static std::shared_ptr<WeightedPointSet> CreateFromBytes(std::string_view* in) {
+    auto set = std::make_shared<WeightedPointSet>();
+    if (!set->FromBytes(in)) {
+      return nullptr;
+    }
+    return set;
+  }
+
   const Eigen::MatrixXf& points() const { return points_; }
   const Eigen::VectorXf& weights() const { return weights_; }
   int point_size() const { return point_size_; }
@@ -273,6 +314,50 @@ class CoresetTree {
     }
   }
 
+  void ToBytes(std::string* out) const {
+    AppendPOD<uint64_t>(coreset_size_, out);
+    AppendPOD<uint64_t>(r_, out);
+    AppendPOD<uint64_t>(levels_.size(), out);
+    for (const auto& level : levels_) {
+      AppendPOD<uint64_t>(level.size(), out);
+      for (const auto& set : level) {
+        set->ToBytes(out);
+      }
+    }
+  }
+
+  /**
+   * Reads the tree written by ToBytes. Returns false if the input is malformed, or if it was
+   * written by a tree with different parameters, or with points of a size other than point_size,
+   * as those can't be merged into this tree.
+   */
+  bool FromBytes(std::string_view* in, int point_size) {
+    uint64_t coreset_size;
+    uint64_t r;
+    uint64_t num_levels;
+    if (!ReadPOD(in, &coreset_size) || !ReadPOD(in, &r) || !ReadPOD(in, &num_levels) ||
+        coreset_size != coreset_size_ || r != r_) {
+      return false;
+    }
+    std::vector<Level> levels;
+    for (uint64_t i = 0; i < num_levels; ++i) {
+      uint64_t num_sets;
+      if (!ReadPOD(in, &num_sets)) {
+        return false;
+      }
+      Level& level = levels.emplace_back();
+      for (uint64_t j = 0; j < num_sets; ++j) {
+        auto set = WeightedPointSet::CreateFromBytes(in);
+        if (set == nullptr || (set->size() > 0 && set->point_size() != point_size)) {
+          return false;
+        }
+        level.push_back(std::move(set));
+      }
+    }
+    levels_ = std::move(levels);
+    return true;
+  }
+
  private:
   size_t coreset_size_;
   size_t r_;
@@ -342,6 +427,31 @@ class CoresetDriver {
     coreset_data_.FromJSON(doc["coreset"]);
   }
 
+  /**
+   * Serializes the driver in a compact binary format, which is much cheaper to produce and parse
+   * than ToJSON for the float-heavy coreset state.
+   */
+  std::string Serialize() const {
+    std::string out(1, kSerializedVersion);
+    CurrentSet()->ToBytes(&out);
+    coreset_data_.ToBytes(&out);
+    return out;
+  }
+
+  Status Deserialize(std::string_view data) {
+    if (data.empty() || data[0] != kSerializedVersion) {
+      return error::InvalidArgument("Unknown serialized coreset version");
+    }
+    data.remove_prefix(1);
+    auto set = WeightedPointSet::CreateFromBytes(&data);
+    if (set == nullptr || set->size() >= m_ || (set->size() > 0 && set->point_size() != d_) ||
+        !coreset_data_.FromBytes(&data, d_)) {
+      return error::InvalidArgument("Malformed serialized coreset");
+    }
+    GatherPointsFromSet(set);
+    return Status::OK();
+  }
+
  private:
   std::shared_ptr<WeightedPointSet> CurrentSet() const {
     if (size_ == 0) {
@@ -360,6 +470,8 @@ class CoresetDriver {
       weights_(Eigen::seq(0, set->size() - 1)) = set->weights();
     }
   }
+  static constexpr char kSerializedVersion = '\x01';
+
   int m_;
   int d_;
   TCoresetStructure coreset_data_;
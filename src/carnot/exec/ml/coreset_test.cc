@@ -105,6 +105,54 @@ TEST(CoresetDriver, serialization) {
   EXPECT_EQ(256, point_set->size());
 }
 
+TEST(CoresetDriver, binary_serialization) {
+  int d = 64;
+  CoresetDriver<CoresetTree<KMeansCoreset>> driver(64, d, 4, 64);
+  Eigen::VectorXf point = Eigen::VectorXf::Random(d);
+  // Insert 10 buckets and a half worth of points, so that the base set is not empty.
+  for (int i = 0; i < 64 * 10 + 32; i++) {
+    driver.Update(point);
+  }
+  auto serialized = driver.Serialize();
+  // The raw floats are much smaller than their JSON encoding.
+  EXPECT_LT(serialized.size(), driver.ToJSON().size() / 2);
+
+  CoresetDriver<CoresetTree<KMeansCoreset>> driver2(64, d, 4, 64);
+  ASSERT_TRUE(driver2.Deserialize(serialized).ok());
+
+  auto expected = driver.Query();
+  auto point_set = driver2.Query();
+  EXPECT_EQ(256 + 32, point_set->size());
+  EXPECT_TRUE(point_set->points().isApprox(expected->points()));
+  EXPECT_TRUE(point_set->weights().isApprox(expected->weights()));
+
+  // Truncated or JSON input is rejected.
+  CoresetDriver<CoresetTree<KMeansCoreset>> driver3(64, d, 4, 64);
+  EXPECT_FALSE(driver3.Deserialize(serialized.substr(0, serialized.size() - 1)).ok());
+  EXPECT_FALSE(driver3.Deserialize(driver.ToJSON()).ok());
+}
+
+TEST(CoresetDriver, binary_serialization_rejects_mismatched_parameters) {
+  int d = 64;
+  CoresetDriver<CoresetTree<KMeansCoreset>> driver(64, d, 4, 64);
+  Eigen::VectorXf point = Eigen::VectorXf::Random(d);
+  // Insert whole buckets only, so that the points are all in the tree and the base set is empty.
+  for (int i = 0; i < 64 * 10; i++) {
+    driver.Update(point);
+  }
+  auto serialized = driver.Serialize();
+
+  CoresetDriver<CoresetTree<KMeansCoreset>> other_dims(64, d / 2, 4, 64);
+  EXPECT_FALSE(other_dims.Deserialize(serialized).ok());
+  CoresetDriver<CoresetTree<KMeansCoreset>> other_r(64, d, 2, 64);
+  EXPECT_FALSE(other_r.Deserialize(serialized).ok());
+  CoresetDriver<CoresetTree<KMeansCoreset>> other_coreset_size(64, d, 4, 32);
+  EXPECT_FALSE(other_coreset_size.Deserialize(serialized).ok());
+
+  CoresetDriver<CoresetTree<KMeansCoreset>> same(64, d, 4, 64);
+  EXPECT_TRUE(same.Deserialize(serialized).ok());
+}
+
 }  // namespace ml
 }  // namespace exec
 }  // namespace carnot
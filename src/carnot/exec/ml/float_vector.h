@@ -0,0 +1,104 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include <absl/strings/escaping.h>
+#include <absl/strings/match.h>
+#include <absl/strings/str_cat.h>
+
+namespace px {
+namespace carnot {
+namespace exec {
+namespace ml {
+
+/**
+ * Embeddings are passed between the ML UDFs as string values. Rather than as JSON arrays, they are
+ * encoded as a prefix followed by the base64 of the raw float32 values, which is much cheaper to
+ * decode. Unlike the raw bytes, the encoding is valid UTF-8, so it can be displayed and sent
+ * anywhere a string column goes. The prefix can't start a JSON array, which keeps the two
+ * encodings apart.
+ */
+constexpr std::string_view kFloatVectorPrefix = "f32:";
+
+inline std::string EncodeFloatVector(const float* data, size_t n) {
+  return absl::StrCat(kFloatVectorPrefix,
+                      absl::Base64Escape(std::string_view(reinterpret_cast<const char*>(data),
+                                                          n * sizeof(float))));
+}
+
+inline bool IsFloatVector(std::string_view in) { return absl::StartsWith(in, kFloatVectorPrefix); }
+
+/**
+ * Decodes up to max_num values of an encoded float vector to out.
+ * Returns the number of values decoded, which is 0 if the encoding is malformed.
+ */
+inline int DecodeFloatVector(std::string_view in, float* out, int max_num) {
+  std::string bytes;
+  if (!IsFloatVector(in) || !absl::Base64Unescape(in.substr(kFloatVectorPrefix.size()), &bytes) ||
+      bytes.size() % sizeof(float) != 0) {
+    return 0;
+  }
+  size_t n = std::min(bytes.size() / sizeof(float), static_cast<size_t>(max_num));
+  std::memcpy(out, bytes.data(), n * sizeof(float));
+  return n;
+}
+
+/**
+ * Helpers for the binary serialization of the ML state (eg. coresets).
+ */
+template <typename T>
+void AppendPOD(T val, std::string* out) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  out->append(reinterpret_cast<const char*>(&val), sizeof(T));
+}
+
+template <typename T>
+bool ReadPOD(std::string_view* in, T* val) {
+  static_assert(std::is_trivially_copyable_v<T>);
+  if (in->size() < sizeof(T)) {
+    return false;
+  }
+  std::memcpy(val, in->data(), sizeof(T));
+  in->remove_prefix(sizeof(T));
+  return true;
+}
+
+inline void AppendFloats(const float* data, size_t n, std::string* out) {
+  out->append(reinterpret_cast<const char*>(data), n * sizeof(float));
+}
+
+inline bool ReadFloats(std::string_view* in, float* out, size_t n) {
+  if (in->size() < n * sizeof(float)) {
+    return false;
+  }
+  std::memcpy(out, in->data(), n * sizeof(float));
+  in->remove_prefix(n * sizeof(float));
+  return true;
+}
+
+}  // namespace ml
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
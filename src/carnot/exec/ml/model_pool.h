@@ -18,8 +18,8 @@
 
 #pragma once
 
-#include <absl/base/internal/spinlock.h>
-#include <chrono>
+#include <absl/synchronization/mutex.h>
+#include <algorithm>
 #include <memory>
 #include <thread>
 #include <unordered_map>
@@ -33,43 +33,94 @@ namespace carnot {
 namespace exec {
 namespace ml {
 
+/**
+ * ModelPool holds the model executors shared by the queries of a Carnot instance.
+ *
+ * Executors of each model type are created lazily, up to max_executors_per_model, as concurrent
+ * callers need them. Each executor (and so each interpreter) is only ever used by one caller at a
+ * time. Once the limit is reached, callers block until an executor is returned to the pool.
+ */
 class ModelPool {
  public:
   using PoolType = BorrowPool<ModelExecutor>;
   using PtrType = PoolType::BorrowedPtrType;
 
-  static std::unique_ptr<ModelPool> Create() { return std::make_unique<ModelPool>(); }
+  // Models are large, so by default only a few executors are created per model, even on
+  // machines with many cores.
+  static constexpr size_t kMaxDefaultExecutorsPerModel = 4;
 
-  template <typename TExecutor, typename... Args>
-  void CreatePool(Args... args) {
-    // TODO(james, PP-2594): currently if you ask for the same type of model with different args the
-    // pool will return the first args asked for.
-    auto pool = std::make_unique<PoolType>();
-    pool->Add(std::make_unique<TExecutor>(args...));
-    pool_map_[TExecutor::Type()] = std::move(pool);
+  static size_t DefaultExecutorsPerModel() {
+    return std::clamp<size_t>(std::thread::hardware_concurrency(), 1, kMaxDefaultExecutorsPerModel);
   }
 
+  static std::unique_ptr<ModelPool> Create() {
+    return std::make_unique<ModelPool>(DefaultExecutorsPerModel());
+  }
+  static std::unique_ptr<ModelPool> Create(size_t max_executors_per_model) {
+    return std::make_unique<ModelPool>(max_executors_per_model);
+  }
+
+  explicit ModelPool(size_t max_executors_per_model)
+      : max_executors_per_model_(std::max<size_t>(max_executors_per_model, 1)) {}
+
   template <typename TExecutor>
   struct DerivedDeleter {
     void operator()(TExecutor* ptr) { deleter_(ptr); }
     PoolType::ReclaimDeleter deleter_;
   };
 
+  template <typename TExecutor>
+  using ExecutorPtr = std::unique_ptr<TExecutor, DerivedDeleter<TExecutor>>;
+
   template <typename TExecutor, typename... Args>
-  std::unique_ptr<TExecutor, DerivedDeleter<TExecutor>> GetModelExecutor(Args... args) {
-    if (pool_map_.find(TExecutor::Type()) == pool_map_.end()) {
-      CreatePool<TExecutor>(args...);
+  ExecutorPtr<TExecutor> GetModelExecutor(Args... args) {
+    // TODO(james, PP-2594): currently if you ask for the same type of model with different args the
+    // pool will return the first args asked for.
+    PoolType* pool;
+    bool create_executor = false;
+    {
+      absl::MutexLock l(&lock_);
+      ModelEntry& entry = pool_map_[TExecutor::Type()];
+      if (entry.pool == nullptr) {
+        entry.pool = std::make_unique<PoolType>();
+      }
+      pool = entry.pool.get();
+      auto ptr = pool->Borrow();
+      if (ptr != nullptr) {
+        return ToDerived<TExecutor>(std::move(ptr));
+      }
+      if (entry.num_executors < max_executors_per_model_) {
+        ++entry.num_executors;
+        create_executor = true;
+      }
     }
-    auto ptr = pool_map_[TExecutor::Type()]->Borrow();
-    while (ptr == nullptr) {
-      ptr = pool_map_[TExecutor::Type()]->Borrow();
-      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    if (create_executor) {
+      // Loading a model is slow, so it is done outside of the lock. If another caller borrows the
+      // new executor first, this one waits for the next executor to be returned.
+      pool->Add(std::make_unique<TExecutor>(args...));
     }
-    return std::unique_ptr<TExecutor, DerivedDeleter<TExecutor>>(
-        static_cast<TExecutor*>(ptr.release()), DerivedDeleter<TExecutor>{ptr.get_deleter()});
+    return ToDerived<TExecutor>(pool->BorrowOrWait());
+  }
+
+  size_t max_executors_per_model() const { return max_executors_per_model_; }
+
+ private:
+  struct ModelEntry {
+    std::unique_ptr<PoolType> pool;
+    // The number of executors created for the model, borrowed or not.
+    size_t num_executors = 0;
+  };
+
+  template <typename TExecutor>
+  static ExecutorPtr<TExecutor> ToDerived(PtrType ptr) {
+    auto deleter = ptr.get_deleter();
+    return ExecutorPtr<TExecutor>(static_cast<TExecutor*>(ptr.release()),
+                                  DerivedDeleter<TExecutor>{deleter});
   }
 
-  std::unordered_map<ModelType, std::unique_ptr<PoolType>> pool_map_;
+  const size_t max_executors_per_model_;
+  absl::Mutex lock_;
+  std::unordered_map<ModelType, ModelEntry> pool_map_ ABSL_GUARDED_BY(lock_);
 };
 
 }  // namespace ml
@@ -19,6 +19,8 @@
 #include "src/carnot/exec/ml/model_pool.h"
 #include <gflags/gflags.h>
 #include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
 #include "src/carnot/exec/ml/transformer_executor.h"
 
 DEFINE_string(embedding_dir, "", "Path to embedding.proto");
@@ -34,6 +36,39 @@ TEST(ModelPool, basic) {
   EXPECT_EQ(kTransformer, executor->Type());
 }
 
+class FakeExecutor : public ModelExecutor {
+ public:
+  FakeExecutor() { ++num_created; }
+  static constexpr ModelType Type() { return kTransformer; }
+  static inline std::atomic<int> num_created = 0;
+};
+
+TEST(ModelPool, creates_executors_up_to_max) {
+  auto p = ModelPool::Create(/*max_executors_per_model*/ 2);
+  FakeExecutor::num_created = 0;
+  {
+    auto executor1 = p->GetModelExecutor<FakeExecutor>();
+    auto executor2 = p->GetModelExecutor<FakeExecutor>();
+    EXPECT_NE(executor1.get(), executor2.get());
+    EXPECT_EQ(2, FakeExecutor::num_created);
+
+    // The third caller waits for an executor to be returned.
+    std::atomic<bool> borrowed = false;
+    std::thread waiter([&] {
+      auto executor3 = p->GetModelExecutor<FakeExecutor>();
+      borrowed = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(borrowed);
+    executor1.reset();
+    waiter.join();
+    EXPECT_TRUE(borrowed);
+  }
+  // Executors are reused once returned.
+  auto executor = p->GetModelExecutor<FakeExecutor>();
+  EXPECT_EQ(2, FakeExecutor::num_created);
+}
+
 }  // namespace ml
 }  // namespace exec
 }  // namespace carnot
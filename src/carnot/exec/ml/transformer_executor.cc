@@ -18,14 +18,19 @@
 
 #include "src/carnot/exec/ml/transformer_executor.h"
 
+#include <algorithm>
+#include <cstring>
+
+#include "src/carnot/exec/ml/float_vector.h"
+
 namespace px {
 namespace carnot {
 namespace exec {
 namespace ml {
 
-static int load_ints_from_json(std::string in, int32_t* arr, int max_num) {
+static int load_ints_from_json(std::string_view in, int32_t* arr, int max_num) {
   rapidjson::Document d;
-  rapidjson::ParseResult ok = d.Parse(in.data());
+  rapidjson::ParseResult ok = d.Parse(in.data(), in.size());
   // TODO(zasgar/michellenguyen, PP-419): Replace with null when available.
   if (ok == nullptr) {
     return 0;
@@ -50,56 +55,91 @@ static int load_ints_from_json(std::string in, int32_t* arr, int max_num) {
 }
 
 void TransformerExecutor::Execute(std::string doc, std::string* out) {
-  // LOG(INFO) << "inputs: " << tf_interpreter_->inputs().size() << "\n";
-  // LOG(INFO) << "input(0) name: " << tf_interpreter_->GetInputName(0) << "\n";
+  std::string_view doc_view = doc;
+  ExecuteBatch(absl::MakeConstSpan(&doc_view, 1), absl::MakeSpan(out, 1));
+}
 
-  // int t_size = tf_interpreter_->tensors_size();
-  // for (int i = 0; i < t_size; i++) {
-  //   if (tf_interpreter_->tensor(i)->name) {
-  //     LOG(INFO) << i << ": " << tf_interpreter_->tensor(i)->name << ", "
-  //               << tf_interpreter_->tensor(i)->bytes << ", "
-  //               << tf_interpreter_->tensor(i)->type;
-  //   }
-  // }
-  auto input = tf_interpreter_->typed_input_tensor<int32_t>(0);
-  if (input == nullptr) {
-    LOG(INFO) << "Error getting typed input tensor, most likely using wrong type for this model";
-    *out = "";
-    return;
+void TransformerExecutor::ExecuteBatch(absl::Span<const std::string_view> docs,
+                                       absl::Span<std::string> out) {
+  DCHECK_EQ(docs.size(), out.size());
+  for (size_t start = 0; start < docs.size(); start += max_batch_size_) {
+    size_t n = std::min(docs.size() - start, static_cast<size_t>(max_batch_size_));
+    ExecuteChunk(docs.subspan(start, n), out.subspan(start, n));
   }
+}
 
-  auto count = load_ints_from_json(doc, input, max_length_);
-  if (count == 0) {
-    // Either input array was empty or there was an error parsing the json, either way don't
-    // continue.
-    *out = "";
-    return;
+bool TransformerExecutor::ResizeBatch(int batch_size) {
+  if (batch_size == batch_size_) {
+    return true;
   }
-
-  // Add 1 to each token to account for pad token.
-  for (int i = 0; i < count; i++) {
-    input[i] = input[i] + 1;
+  tf_interpreter_->ResizeInputTensor(tf_interpreter_->inputs()[0], {batch_size, max_length_});
+  if (tf_interpreter_->AllocateTensors() != kTfLiteOk) {
+    LOG(ERROR) << "Failed to allocate tensors for a batch of " << batch_size;
+    // Force a reallocation on the next call.
+    batch_size_ = 0;
+    return false;
   }
+  batch_size_ = batch_size;
+  return true;
+}
 
-  for (int i = count; i < max_length_; i++) {
-    input[i] = 0;
+void TransformerExecutor::ExecuteChunk(absl::Span<const std::string_view> docs,
+                                       absl::Span<std::string> out) {
+  // Parse the documents into consecutive rows of token ids. Documents that fail to parse (or are
+  // empty) get an empty output, and don't take a row in the batch.
+  std::vector<size_t> rows;
+  rows.reserve(docs.size());
+  tokens_.resize(docs.size() * max_length_);
+  for (size_t i = 0; i < docs.size(); ++i) {
+    int32_t* row_tokens = tokens_.data() + rows.size() * max_length_;
+    auto count = load_ints_from_json(docs[i], row_tokens, max_length_);
+    if (count == 0) {
+      out[i] = "";
+      continue;
+    }
+    // Add 1 to each token to account for pad token.
+    for (int j = 0; j < count; j++) {
+      row_tokens[j] = row_tokens[j] + 1;
+    }
+    std::fill(row_tokens + count, row_tokens + max_length_, 0);
+    rows.push_back(i);
+  }
+  if (rows.empty()) {
+    return;
   }
 
-  const int embedding_size = 256;
+  const int batch_size = rows.size();
+  int32_t* input = nullptr;
+  if (ResizeBatch(batch_size)) {
+    input = tf_interpreter_->typed_input_tensor<int32_t>(0);
+    LOG_IF(INFO, input == nullptr)
+        << "Error getting typed input tensor, most likely using wrong type for this model";
+  }
+  if (input == nullptr) {
+    for (size_t row : rows) {
+      out[row] = "";
+    }
+    return;
+  }
+  std::memcpy(input, tokens_.data(), batch_size * max_length_ * sizeof(int32_t));
 
   tf_interpreter_->Invoke();
 
-  auto output = tf_interpreter_->typed_output_tensor<float>(0);
+  const TfLiteTensor* output_tensor = tf_interpreter_->tensor(tf_interpreter_->outputs()[0]);
+  if (batch_size > 1 &&
+      (output_tensor->dims->size == 0 || output_tensor->dims->data[0] != batch_size)) {
+    LOG(WARNING) << "Transformer model doesn't support batching, running one document at a time";
+    max_batch_size_ = 1;
+    for (size_t i = 0; i < docs.size(); ++i) {
+      ExecuteChunk(docs.subspan(i, 1), out.subspan(i, 1));
+    }
+    return;
+  }
 
-  // Copy output to json array.
-  rapidjson::StringBuffer sb;
-  rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
-  writer.StartArray();
-  for (int i = 0; i < embedding_size; i++) {
-    writer.Double(output[i]);
+  auto output = tf_interpreter_->typed_output_tensor<float>(0);
+  for (int j = 0; j < batch_size; ++j) {
+    out[rows[j]] = EncodeFloatVector(output + j * kEmbeddingSize, kEmbeddingSize);
   }
-  writer.EndArray();
-  *out = sb.GetString();
 }
 
 }  // namespace ml
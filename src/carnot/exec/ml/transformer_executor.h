@@ -24,8 +24,11 @@
 #include <tensorflow/lite/interpreter.h>
 #include <tensorflow/lite/kernels/register.h>
 #include <tensorflow/lite/model.h>
+#include <absl/types/span.h>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
 #include "src/carnot/exec/ml/model_executor.h"
 #include "src/common/base/utils.h"
 
@@ -55,10 +58,30 @@ class TransformerExecutor : public ModelExecutor {
 
   void Execute(std::string doc, std::string* out);
 
+  /**
+   * Computes the embeddings of a batch of documents (JSON arrays of token ids). The documents are
+   * run through the interpreter together, up to kMaxBatchSize at a time, with an input tensor of
+   * shape {N, max_length_}. Documents that can't be parsed get an empty output.
+   */
+  void ExecuteBatch(absl::Span<const std::string_view> docs, absl::Span<std::string> out);
+
+  // Bounds the size of the input and intermediate tensors.
+  static constexpr int kMaxBatchSize = 64;
+  static constexpr int kEmbeddingSize = 256;
+
  private:
+  void ExecuteChunk(absl::Span<const std::string_view> docs, absl::Span<std::string> out);
+  bool ResizeBatch(int batch_size);
+
   std::unique_ptr<tflite::Interpreter> tf_interpreter_;
   std::unique_ptr<tflite::FlatBufferModel> model_;
   int max_length_ = 64;
+  // The batch size the tensors are currently allocated for.
+  int batch_size_ = 1;
+  // Lowered to 1 if the model turns out not to support a batch dimension.
+  int max_batch_size_ = kMaxBatchSize;
+  // The token ids of the current chunk, one row of max_length_ per parsed document.
+  std::vector<int32_t> tokens_;
 };
 
 }  // namespace ml
@@ -0,0 +1,90 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/query_memory_pool.h"
+
+DEFINE_int64(carnot_query_memory_limit_bytes,
+             gflags::Int64FromEnv("PL_CARNOT_QUERY_MEMORY_LIMIT_BYTES", 0),
+             "The most memory a single query may use in Carnot. Queries that need more fail. "
+             "0 means no limit.");
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+thread_local QueryMemoryPool::BackgroundScope* QueryMemoryPool::BackgroundScope::current_ = nullptr;
+
+arrow::Status QueryMemoryPool::Allocate(int64_t size, uint8_t** out) {
+  if (WouldExceedLimit(size)) {
+    return arrow::Status::OutOfMemory("Query memory limit of ", limit_bytes_,
+                                      " bytes exceeded, while allocating ", size, " bytes");
+  }
+  ARROW_RETURN_NOT_OK(parent_->Allocate(size, out));
+  ++refs_;
+  bytes_allocated_ += size;
+  CountAllocation(size);
+  Update(size);
+  return arrow::Status::OK();
+}
+
+arrow::Status QueryMemoryPool::Reallocate(int64_t old_size, int64_t new_size, uint8_t** ptr) {
+  if (WouldExceedLimit(new_size - old_size)) {
+    return arrow::Status::OutOfMemory("Query memory limit of ", limit_bytes_,
+                                      " bytes exceeded, while allocating ", new_size - old_size,
+                                      " bytes");
+  }
+  ARROW_RETURN_NOT_OK(parent_->Reallocate(old_size, new_size, ptr));
+  bytes_allocated_ += new_size - old_size;
+  CountAllocation(new_size - old_size);
+  Update(new_size - old_size);
+  return arrow::Status::OK();
+}
+
+void QueryMemoryPool::Free(uint8_t* buffer, int64_t size) {
+  parent_->Free(buffer, size);
+  bytes_allocated_ -= size;
+  Update(-size);
+  Unref();
+}
+
+void QueryMemoryPool::Update(int64_t bytes) {
+  if (BackgroundScope* scope = background_scope()) {
+    scope->bytes_ += bytes;
+  } else {
+    foreground_bytes_used_ += bytes;
+  }
+  int64_t used = bytes_used_ += bytes;
+  int64_t peak = peak_bytes_;
+  while (used > peak && !peak_bytes_.compare_exchange_weak(peak, used)) {
+  }
+}
+
+Status QueryMemoryPool::CheckLimit() const {
+  int64_t used = bytes_used_;
+  if (limit_bytes_ > 0 && used > limit_bytes_) {
+    return error::ResourceUnavailable(
+        "Query uses $0 bytes of memory, over its limit of $1 bytes. The limit is set by "
+        "PL_CARNOT_QUERY_MEMORY_LIMIT_BYTES.",
+        used, limit_bytes_);
+  }
+  return Status::OK();
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
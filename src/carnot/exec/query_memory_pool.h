@@ -0,0 +1,190 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <arrow/memory_pool.h>
+#include <arrow/status.h>
+
+#include <atomic>
+#include <string>
+
+#include "src/common/base/base.h"
+
+DECLARE_int64(carnot_query_memory_limit_bytes);
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+/**
+ * QueryMemoryPool is the memory pool of a single query. It allocates the query's arrow buffers
+ * from a parent pool, and accounts for them along with the memory the query reserves elsewhere
+ * (eg. its arena), to report the query's peak memory and enforce its memory limit.
+ *
+ * Arrow buffers keep a raw pointer to their pool, and a query's buffers can outlive the query (eg.
+ * in the table of a memory sink). So the pool isn't deleted with the query: the query calls
+ * Detach(), and the pool deletes itself once all its buffers are freed.
+ */
+class QueryMemoryPool : public arrow::MemoryPool {
+ public:
+  /**
+   * Creates a pool, which is owned by the caller until it calls Detach().
+   * @param limit_bytes the most memory the query may use. 0 means no limit.
+   */
+  static QueryMemoryPool* Create(int64_t limit_bytes,
+                                 arrow::MemoryPool* parent = arrow::default_memory_pool()) {
+    return new QueryMemoryPool(limit_bytes, parent);
+  }
+
+  arrow::Status Allocate(int64_t size, uint8_t** out) override;
+  arrow::Status Reallocate(int64_t old_size, int64_t new_size, uint8_t** ptr) override;
+  void Free(uint8_t* buffer, int64_t size) override;
+
+  // The bytes held by arrow buffers.
+  int64_t bytes_allocated() const override { return bytes_allocated_; }
+  // The peak of bytes_used().
+  int64_t max_memory() const override { return peak_bytes_; }
+  std::string backend_name() const override { return parent_->backend_name(); }
+
+  /**
+   * While a BackgroundScope is alive, the allocations its thread makes from the pool are made in
+   * the background, eg. by the GRPC router threads that decode a query's input. They count toward
+   * the query's memory and limit as usual, but not toward the foreground counters below, which the
+   * exec nodes diff while they run (see ExecNodeStats) and which would charge them to whichever
+   * node happens to be running. The scope counts them instead, so that the caller can charge them
+   * to the node they were made for.
+   */
+  class BackgroundScope {
+   public:
+    // A null pool makes the scope a no-op, for nodes that run without a query pool.
+    explicit BackgroundScope(QueryMemoryPool* pool) : pool_(pool), prev_(current_) {
+      current_ = this;
+    }
+    ~BackgroundScope() { current_ = prev_; }
+
+    int64_t num_allocations() const { return num_allocations_; }
+    int64_t total_bytes_allocated() const { return total_bytes_allocated_; }
+    // The bytes allocated in the scope, net of what it freed.
+    int64_t bytes() const { return bytes_; }
+
+   private:
+    friend class QueryMemoryPool;
+
+    static thread_local BackgroundScope* current_;
+
+    QueryMemoryPool* pool_;
+    BackgroundScope* prev_;
+    int64_t num_allocations_ = 0;
+    int64_t total_bytes_allocated_ = 0;
+    int64_t bytes_ = 0;
+  };
+
+  /**
+   * Accounts for memory of the query that isn't allocated from this pool. Reservations are not
+   * refused; going over the limit is reported by CheckLimit() instead. Negative bytes release.
+   */
+  void Reserve(int64_t bytes) {
+    CountAllocation(bytes);
+    Update(bytes);
+  }
+
+  /**
+   * Like Reserve(), for memory that backs buffers which may outlive the query, the same as the
+   * pool's own buffers do. The pool stays alive until every positive reservation is released.
+   */
+  void ReserveBuffer(int64_t bytes) {
+    if (bytes > 0) {
+      ++refs_;
+    }
+    Reserve(bytes);
+    if (bytes < 0) {
+      Unref();
+    }
+  }
+
+  // The bytes the query holds: arrow buffers and reservations.
+  int64_t bytes_used() const { return bytes_used_; }
+  int64_t limit_bytes() const { return limit_bytes_; }
+
+  // The part of bytes_used() that was allocated and freed outside of a BackgroundScope.
+  int64_t foreground_bytes_used() const { return foreground_bytes_used_; }
+  // The number of allocations, growing reallocations and reservations made so far, outside of a
+  // BackgroundScope.
+  int64_t num_allocations() const { return num_allocations_; }
+  // The bytes of those allocations, not counting anything freed since.
+  int64_t total_bytes_allocated() const { return total_bytes_allocated_; }
+
+  /**
+   * Returns an error if the query uses more memory than its limit.
+   */
+  Status CheckLimit() const;
+
+  /**
+   * Gives up the caller's ownership. The pool deletes itself once its buffers are all freed,
+   * which may be right away. The pool can't be used by the caller afterwards.
+   */
+  void Detach() { Unref(); }
+
+ private:
+  QueryMemoryPool(int64_t limit_bytes, arrow::MemoryPool* parent)
+      : limit_bytes_(limit_bytes), parent_(parent) {}
+
+  bool WouldExceedLimit(int64_t bytes) const {
+    return limit_bytes_ > 0 && bytes > 0 && bytes_used_ + bytes > limit_bytes_;
+  }
+  // The current thread's BackgroundScope for this pool, if it has one.
+  BackgroundScope* background_scope() const {
+    BackgroundScope* scope = BackgroundScope::current_;
+    return scope != nullptr && scope->pool_ == this ? scope : nullptr;
+  }
+  void CountAllocation(int64_t bytes) {
+    if (bytes <= 0) {
+      return;
+    }
+    if (BackgroundScope* scope = background_scope()) {
+      ++scope->num_allocations_;
+      scope->total_bytes_allocated_ += bytes;
+      return;
+    }
+    ++num_allocations_;
+    total_bytes_allocated_ += bytes;
+  }
+  void Update(int64_t bytes);
+  void Unref() {
+    if (--refs_ == 0) {
+      delete this;
+    }
+  }
+
+  const int64_t limit_bytes_;
+  arrow::MemoryPool* parent_;
+
+  std::atomic<int64_t> bytes_allocated_ = 0;
+  std::atomic<int64_t> bytes_used_ = 0;
+  std::atomic<int64_t> peak_bytes_ = 0;
+  std::atomic<int64_t> foreground_bytes_used_ = 0;
+  std::atomic<int64_t> num_allocations_ = 0;
+  std::atomic<int64_t> total_bytes_allocated_ = 0;
+  // One reference per live buffer, plus one for the owner until it detaches.
+  std::atomic<int64_t> refs_ = 1;
+};
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
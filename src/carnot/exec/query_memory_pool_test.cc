@@ -0,0 +1,146 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/query_memory_pool.h"
+
+#include <arrow/array.h>
+#include <arrow/builder.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "src/common/testing/testing.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+TEST(QueryMemoryPoolTest, tracks_usage_and_peak) {
+  auto* pool = QueryMemoryPool::Create(/*limit_bytes*/ 0);
+  uint8_t* buf1;
+  uint8_t* buf2;
+  ASSERT_TRUE(pool->Allocate(100, &buf1).ok());
+  ASSERT_TRUE(pool->Allocate(200, &buf2).ok());
+  pool->Reserve(50);
+  EXPECT_EQ(300, pool->bytes_allocated());
+  EXPECT_EQ(350, pool->bytes_used());
+
+  ASSERT_TRUE(pool->Reallocate(200, 400, &buf2).ok());
+  pool->Free(buf1, 100);
+  pool->Reserve(-50);
+  EXPECT_EQ(400, pool->bytes_used());
+  EXPECT_EQ(550, pool->max_memory());
+
+  pool->Free(buf2, 400);
+  EXPECT_EQ(0, pool->bytes_used());
+  pool->Detach();
+}
+
+TEST(QueryMemoryPoolTest, counts_allocations) {
+  auto* pool = QueryMemoryPool::Create(/*limit_bytes*/ 0);
+  uint8_t* buf;
+  ASSERT_TRUE(pool->Allocate(100, &buf).ok());
+  pool->Reserve(50);
+  ASSERT_TRUE(pool->Reallocate(100, 300, &buf).ok());
+  EXPECT_EQ(3, pool->num_allocations());
+  EXPECT_EQ(350, pool->total_bytes_allocated());
+
+  // Shrinking and freeing don't count.
+  ASSERT_TRUE(pool->Reallocate(300, 200, &buf).ok());
+  pool->Reserve(-50);
+  pool->Free(buf, 200);
+  EXPECT_EQ(3, pool->num_allocations());
+  EXPECT_EQ(350, pool->total_bytes_allocated());
+  pool->Detach();
+}
+
+TEST(QueryMemoryPoolTest, enforces_limit) {
+  auto* pool = QueryMemoryPool::Create(/*limit_bytes*/ 1000);
+  uint8_t* buf;
+  ASSERT_TRUE(pool->Allocate(800, &buf).ok());
+  uint8_t* too_large;
+  EXPECT_TRUE(pool->Allocate(300, &too_large).IsOutOfMemory());
+  EXPECT_TRUE(pool->Reallocate(800, 1100, &buf).IsOutOfMemory());
+  EXPECT_OK(pool->CheckLimit());
+
+  // Reservations aren't refused, but are reported.
+  pool->Reserve(500);
+  EXPECT_NOT_OK(pool->CheckLimit());
+  pool->Reserve(-500);
+  EXPECT_OK(pool->CheckLimit());
+
+  pool->Free(buf, 800);
+  pool->Detach();
+}
+
+TEST(QueryMemoryPoolTest, background_scope) {
+  auto* pool = QueryMemoryPool::Create(/*limit_bytes*/ 0);
+  uint8_t* fg_buf;
+  ASSERT_TRUE(pool->Allocate(100, &fg_buf).ok());
+  uint8_t* bg_buf;
+  {
+    QueryMemoryPool::BackgroundScope scope(pool);
+    ASSERT_TRUE(pool->Allocate(200, &bg_buf).ok());
+    pool->Reserve(50);
+    EXPECT_EQ(2, scope.num_allocations());
+    EXPECT_EQ(250, scope.total_bytes_allocated());
+    EXPECT_EQ(250, scope.bytes());
+  }
+  // Background allocations count toward the query's memory, but not the foreground counters.
+  EXPECT_EQ(350, pool->bytes_used());
+  EXPECT_EQ(100, pool->foreground_bytes_used());
+  EXPECT_EQ(1, pool->num_allocations());
+  EXPECT_EQ(100, pool->total_bytes_allocated());
+
+  // Freeing in the foreground credits the foreground.
+  pool->Free(bg_buf, 200);
+  pool->Reserve(-50);
+  EXPECT_EQ(100, pool->bytes_used());
+  EXPECT_EQ(-150, pool->foreground_bytes_used());
+
+  pool->Free(fg_buf, 100);
+  pool->Detach();
+}
+
+TEST(QueryMemoryPoolTest, reserved_buffers_outlive_detach) {
+  auto* pool = QueryMemoryPool::Create(/*limit_bytes*/ 0);
+  pool->ReserveBuffer(100);
+  pool->Detach();
+  // The pool stays alive until the reservation is released.
+  EXPECT_EQ(100, pool->bytes_used());
+  pool->ReserveBuffer(-100);
+}
+
+TEST(QueryMemoryPoolTest, buffers_outlive_detach) {
+  auto* pool = QueryMemoryPool::Create(/*limit_bytes*/ 0);
+  std::shared_ptr<arrow::Array> arr;
+  {
+    arrow::Int64Builder builder(pool);
+    ASSERT_TRUE(builder.Append(1).ok());
+    ASSERT_TRUE(builder.Finish(&arr).ok());
+  }
+  EXPECT_GT(pool->bytes_allocated(), 0);
+  // The pool stays alive until the array's buffers are freed.
+  pool->Detach();
+  EXPECT_EQ(1, std::static_pointer_cast<arrow::Int64Array>(arr)->Value(0));
+  arr.reset();
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -345,6 +345,15 @@ class ExecNodeTester {
    */
   TExecNode* node() { return exec_node_.get(); }
 
+  /**
+   * Makes the execution node collect its stats, as it does when the query runs with analyze.
+   * @return the ExecNodeTester, to allow for chaining.
+   */
+  ExecNodeTester& CollectExecStats() {
+    exec_node_->stats()->collect_exec_stats = true;
+    return *this;
+  }
+
   /**
    * Calls Close on the execution node.
    * @return the ExecNodeTester, to allow for chaining.
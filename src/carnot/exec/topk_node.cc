@@ -0,0 +1,271 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/topk_node.h"
+
+#include <arrow/array.h>
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <absl/strings/substitute.h>
+
+#include "src/carnot/planpb/plan.pb.h"
+#include "src/common/base/base.h"
+#include "src/shared/types/arrow_adapter.h"
+#include "src/shared/types/type_utils.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using table_store::schema::RowBatch;
+
+namespace {
+
+// The buffered rows are compacted once the batches they reference hold this many times the rows
+// that are kept.
+constexpr size_t kCompactionFactor = 4;
+
+template <types::DataType DT>
+int CompareValues(const arrow::Array* a, int64_t i, const arrow::Array* b, int64_t j) {
+  if constexpr (DT == types::DataType::STRING) {
+    // Compare the string data in place, to avoid copying the values out of the arrays.
+    int32_t len_a = 0;
+    int32_t len_b = 0;
+    const uint8_t* val_a = static_cast<const arrow::StringArray*>(a)->GetValue(i, &len_a);
+    const uint8_t* val_b = static_cast<const arrow::StringArray*>(b)->GetValue(j, &len_b);
+    int cmp = std::memcmp(val_a, val_b, std::min(len_a, len_b));
+    if (cmp != 0) {
+      return cmp;
+    }
+    return (len_a > len_b) - (len_a < len_b);
+  } else {
+    auto val_a = types::GetValueFromArrowArray<DT>(a, i);
+    auto val_b = types::GetValueFromArrowArray<DT>(b, j);
+    return (val_b < val_a) - (val_a < val_b);
+  }
+}
+
+}  // namespace
+
+std::string TopKNode::DebugStringImpl() {
+  return absl::Substitute("Exec::TopKNode<$0>", plan_node_->DebugString());
+}
+
+Status TopKNode::InitImpl(const plan::Operator& plan_node) {
+  CHECK(plan_node.op_type() == planpb::OperatorType::TOPK_OPERATOR);
+  const auto* topk_plan_node = static_cast<const plan::TopKOperator*>(&plan_node);
+  // copy the plan node to local object;
+  plan_node_ = std::make_unique<plan::TopKOperator>(*topk_plan_node);
+  limit_ = plan_node_->record_limit();
+
+  DCHECK_EQ(input_descriptors_.size(), 1U);
+  const auto& input_descriptor = input_descriptors_[0];
+  for (size_t i = 0; i < plan_node_->sort_cols().size(); ++i) {
+    SortKey key;
+    key.col_idx = plan_node_->sort_cols()[i];
+    key.descending = plan_node_->sort_descending()[i];
+#define TYPE_CASE(_dt_) key.compare = &CompareValues<_dt_>;
+    PL_SWITCH_FOREACH_DATATYPE(input_descriptor.type(key.col_idx), TYPE_CASE);
+#undef TYPE_CASE
+    sort_keys_.push_back(key);
+  }
+  return Status::OK();
+}
+
+Status TopKNode::PrepareImpl(ExecState* /*exec_state*/) { return Status::OK(); }
+
+Status TopKNode::OpenImpl(ExecState* /*exec_state*/) { return Status::OK(); }
+
+Status TopKNode::CloseImpl(ExecState* /*exec_state*/) {
+  batches_.clear();
+  batch_sort_cols_.clear();
+  rows_.clear();
+  return Status::OK();
+}
+
+bool TopKNode::RowBefore(const RowRef& a, const RowRef& b) const {
+  const auto& sort_cols_a = batch_sort_cols_[a.batch];
+  const auto& sort_cols_b = batch_sort_cols_[b.batch];
+  for (size_t i = 0; i < sort_keys_.size(); ++i) {
+    const auto& key = sort_keys_[i];
+    int cmp = key.compare(sort_cols_a[i], a.row, sort_cols_b[i], b.row);
+    if (cmp != 0) {
+      return key.descending ? cmp > 0 : cmp < 0;
+    }
+  }
+  // Batches are kept in arrival order, so this keeps the sort stable.
+  if (a.batch != b.batch) {
+    return a.batch < b.batch;
+  }
+  return a.row < b.row;
+}
+
+void TopKNode::AddBatch(const RowBatch& rb) {
+  std::vector<const arrow::Array*> sort_cols;
+  sort_cols.reserve(sort_keys_.size());
+  for (const auto& key : sort_keys_) {
+    sort_cols.push_back(rb.ColumnAt(key.col_idx).get());
+  }
+  batches_.push_back(rb);
+  batch_sort_cols_.push_back(std::move(sort_cols));
+  buffered_rows_ += rb.num_rows();
+}
+
+void TopKNode::DropLastBatch() {
+  buffered_rows_ -= batches_.back().num_rows();
+  batches_.pop_back();
+  batch_sort_cols_.pop_back();
+}
+
+bool TopKNode::ConsumeRowsBounded(size_t batch) {
+  auto worse = [this](const RowRef& a, const RowRef& b) { return RowBefore(a, b); };
+  bool kept = false;
+  for (int64_t row = 0; row < batches_[batch].num_rows(); ++row) {
+    RowRef ref{batch, row};
+    if (rows_.size() < limit_) {
+      rows_.push_back(ref);
+      std::push_heap(rows_.begin(), rows_.end(), worse);
+    } else if (RowBefore(ref, rows_.front())) {
+      std::pop_heap(rows_.begin(), rows_.end(), worse);
+      rows_.back() = ref;
+      std::push_heap(rows_.begin(), rows_.end(), worse);
+    } else {
+      continue;
+    }
+    kept = true;
+  }
+  return kept;
+}
+
+template <types::DataType DT>
+Status TopKNode::AppendRows(arrow::ArrayBuilder* builder, int64_t col_idx,
+                            const std::vector<RowRef>& rows, size_t start, size_t end) {
+  std::vector<const arrow::Array*> cols;
+  cols.reserve(batches_.size());
+  for (const auto& rb : batches_) {
+    cols.push_back(rb.ColumnAt(col_idx).get());
+  }
+  for (size_t i = start; i < end; ++i) {
+    const auto& ref = rows[i];
+    PL_RETURN_IF_ERROR(table_store::schema::CopyValue<DT>(
+        builder, types::GetValueFromArrowArray<DT>(cols[ref.batch], ref.row)));
+  }
+  return Status::OK();
+}
+
+StatusOr<std::vector<RowBatch>> TopKNode::CopyRows(ExecState* exec_state,
+                                                   const table_store::schema::RowDescriptor& desc,
+                                                   const std::vector<int64_t>& cols,
+                                                   const std::vector<RowRef>& rows,
+                                                   size_t max_rows) {
+  DCHECK_GT(max_rows, 0U);
+  DCHECK_EQ(desc.size(), cols.size());
+  std::vector<RowBatch> output;
+  // Always output at least one batch, even if it has no rows.
+  for (size_t start = 0; start < rows.size() || output.empty(); start += max_rows) {
+    size_t end = std::min(rows.size(), start + max_rows);
+    RowBatch rb(desc, end - start);
+    for (size_t i = 0; i < desc.size(); ++i) {
+      auto builder = MakeArrowBuilder(desc.type(i), exec_state->exec_mem_pool());
+      PL_RETURN_IF_ERROR(builder->Reserve(end - start));
+#define TYPE_CASE(_dt_) \
+  PL_RETURN_IF_ERROR(AppendRows<_dt_>(builder.get(), cols[i], rows, start, end));
+      PL_SWITCH_FOREACH_DATATYPE(desc.type(i), TYPE_CASE);
+#undef TYPE_CASE
+      std::shared_ptr<arrow::Array> col;
+      PL_RETURN_IF_ERROR(builder->Finish(&col));
+      PL_RETURN_IF_ERROR(rb.AddColumn(col));
+    }
+    output.push_back(std::move(rb));
+  }
+  return output;
+}
+
+Status TopKNode::Compact(ExecState* exec_state) {
+  auto worse = [this](const RowRef& a, const RowRef& b) { return RowBefore(a, b); };
+  // Copy the rows in order, so that ties keep their order in the compacted batch. The compacted
+  // batch keeps all the input columns, since the sort keys and the selected columns are indices
+  // into them.
+  std::sort(rows_.begin(), rows_.end(), worse);
+  const auto& input_descriptor = input_descriptors_[0];
+  std::vector<int64_t> input_cols(input_descriptor.size());
+  std::iota(input_cols.begin(), input_cols.end(), 0);
+  PL_ASSIGN_OR_RETURN(auto compacted, CopyRows(exec_state, input_descriptor, input_cols, rows_,
+                                               std::max<size_t>(limit_, 1)));
+  DCHECK_EQ(compacted.size(), 1U);
+
+  batches_.clear();
+  batch_sort_cols_.clear();
+  buffered_rows_ = 0;
+  AddBatch(compacted[0]);
+  for (size_t i = 0; i < rows_.size(); ++i) {
+    rows_[i] = RowRef{0, static_cast<int64_t>(i)};
+  }
+  std::make_heap(rows_.begin(), rows_.end(), worse);
+  return Status::OK();
+}
+
+Status TopKNode::EmitRows(ExecState* exec_state) {
+  std::sort(rows_.begin(), rows_.end(),
+            [this](const RowRef& a, const RowRef& b) { return RowBefore(a, b); });
+  PL_ASSIGN_OR_RETURN(auto output, CopyRows(exec_state, *output_descriptor_,
+                                            plan_node_->selected_cols(), rows_,
+                                            kDefaultTopKRowBatchSize));
+  batches_.clear();
+  batch_sort_cols_.clear();
+  buffered_rows_ = 0;
+  rows_.clear();
+
+  output.back().set_eow(true);
+  output.back().set_eos(true);
+  for (const auto& rb : output) {
+    PL_RETURN_IF_ERROR(SendRowBatchToChildren(exec_state, rb));
+  }
+  return Status::OK();
+}
+
+Status TopKNode::ConsumeNextImpl(ExecState* exec_state, const RowBatch& rb, size_t) {
+  if (rb.num_rows() > 0) {
+    AddBatch(rb);
+    size_t batch = batches_.size() - 1;
+    if (limit_ == 0) {
+      for (int64_t row = 0; row < rb.num_rows(); ++row) {
+        rows_.push_back(RowRef{batch, row});
+      }
+    } else if (!ConsumeRowsBounded(batch)) {
+      // None of the rows made it into the heap, so the batch isn't needed anymore.
+      DropLastBatch();
+    } else if (buffered_rows_ >= kCompactionFactor * std::max(limit_, kDefaultTopKRowBatchSize)) {
+      PL_RETURN_IF_ERROR(Compact(exec_state));
+    }
+  }
+
+  if (rb.eos()) {
+    return EmitRows(exec_state);
+  }
+  return Status::OK();
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,115 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <arrow/array.h>
+#include <stddef.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/carnot/exec/exec_node.h"
+#include "src/carnot/exec/exec_state.h"
+#include "src/carnot/plan/operators.h"
+#include "src/common/base/base.h"
+#include "src/common/base/status.h"
+#include "src/shared/types/types.h"
+#include "src/table_store/table_store.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+constexpr size_t kDefaultTopKRowBatchSize = 1024;
+
+/**
+ * TopKNode sorts its input and outputs the first record_limit rows once the input is complete.
+ *
+ * With a limit, only the best rows seen so far are kept, in a bounded heap that references rows
+ * of the input batches. Input batches that contribute no row to the heap are dropped right away,
+ * and the kept rows are compacted into a batch of their own when the referenced batches grow too
+ * large, so the memory used is proportional to the limit rather than to the input. Without a
+ * limit, all the rows are kept and sorted at the end.
+ */
+class TopKNode : public ProcessingNode {
+ public:
+  TopKNode() = default;
+  virtual ~TopKNode() = default;
+
+ protected:
+  std::string DebugStringImpl() override;
+  Status InitImpl(const plan::Operator& plan_node) override;
+  Status PrepareImpl(ExecState* exec_state) override;
+  Status OpenImpl(ExecState* exec_state) override;
+  Status CloseImpl(ExecState* exec_state) override;
+  Status ConsumeNextImpl(ExecState* exec_state, const table_store::schema::RowBatch& rb,
+                         size_t parent_index) override;
+
+ private:
+  // Compares the values at a row of two arrays, returning <0, 0 or >0.
+  using CompareFn = int (*)(const arrow::Array*, int64_t, const arrow::Array*, int64_t);
+
+  struct SortKey {
+    int64_t col_idx;
+    bool descending;
+    CompareFn compare;
+  };
+
+  // A row of one of the buffered batches.
+  struct RowRef {
+    size_t batch;
+    int64_t row;
+  };
+
+  // Whether row a goes before row b in the output. Ties go to the earliest row.
+  bool RowBefore(const RowRef& a, const RowRef& b) const;
+  void AddBatch(const table_store::schema::RowBatch& rb);
+  void DropLastBatch();
+  // Pushes the rows of a batch that are among the best limit_ rows into the heap. Returns whether
+  // any row was kept.
+  bool ConsumeRowsBounded(size_t batch);
+  template <types::DataType DT>
+  Status AppendRows(arrow::ArrayBuilder* builder, int64_t col_idx, const std::vector<RowRef>& rows,
+                    size_t start, size_t end);
+  // Copies the given columns of the kept rows, in order, into batches of at most max_rows rows
+  // described by desc.
+  StatusOr<std::vector<table_store::schema::RowBatch>> CopyRows(
+      ExecState* exec_state, const table_store::schema::RowDescriptor& desc,
+      const std::vector<int64_t>& cols, const std::vector<RowRef>& rows, size_t max_rows);
+  // Replaces the buffered batches with a single batch of the rows in the heap.
+  Status Compact(ExecState* exec_state);
+  Status EmitRows(ExecState* exec_state);
+
+  std::unique_ptr<plan::TopKOperator> plan_node_;
+  std::vector<SortKey> sort_keys_;
+  size_t limit_ = 0;
+
+  // The input batches that have rows in rows_, in arrival order, and their sort columns.
+  std::vector<table_store::schema::RowBatch> batches_;
+  std::vector<std::vector<const arrow::Array*>> batch_sort_cols_;
+  size_t buffered_rows_ = 0;
+
+  // With a limit, a heap of the best rows so far, with the worst one on top. Otherwise, all the
+  // rows.
+  std::vector<RowRef> rows_;
+};
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,182 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/exec/topk_node.h"
+
+#include <memory>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <sole.hpp>
+
+#include "src/carnot/exec/test_utils.h"
+#include "src/carnot/planpb/test_proto.h"
+#include "src/carnot/udf/registry.h"
+#include "src/common/base/base.h"
+#include "src/shared/types/types.h"
+
+namespace px {
+namespace carnot {
+namespace exec {
+
+using table_store::schema::RowBatch;
+using table_store::schema::RowDescriptor;
+using types::Int64Value;
+
+class TopKNodeTest : public ::testing::Test {
+ public:
+  TopKNodeTest() {
+    func_registry_ = std::make_unique<udf::Registry>("test_registry");
+    auto table_store = std::make_shared<table_store::TableStore>();
+    exec_state_ = std::make_unique<ExecState>(func_registry_.get(), table_store,
+                                              MockResultSinkStubGenerator, sole::uuid4(), nullptr);
+  }
+
+ protected:
+  // The test operator sorts by column 1 descending, then by column 0.
+  void CreatePlanNode(int64_t limit) {
+    auto op_proto = planpb::testutils::CreateTestTopK1PB();
+    op_proto.mutable_topk_op()->set_limit(limit);
+    plan_node_ = plan::TopKOperator::FromProto(op_proto, 1);
+  }
+
+  std::unique_ptr<plan::Operator> plan_node_;
+  std::unique_ptr<ExecState> exec_state_;
+  std::unique_ptr<udf::Registry> func_registry_;
+};
+
+TEST_F(TopKNodeTest, limit_across_batches) {
+  CreatePlanNode(3);
+  RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64});
+  RowDescriptor output_rd({types::DataType::INT64, types::DataType::INT64});
+
+  auto tester = exec::ExecNodeTester<TopKNode, plan::TopKOperator>(*plan_node_, output_rd,
+                                                                   {input_rd}, exec_state_.get());
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd, 4, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::Int64Value>({1, 2, 3, 4})
+                       .AddColumn<types::Int64Value>({10, 30, 20, 30})
+                       .get(),
+                   0, 0)
+      .ConsumeNext(RowBatchBuilder(input_rd, 3, /*eow*/ true, /*eos*/ true)
+                       .AddColumn<types::Int64Value>({5, 6, 7})
+                       .AddColumn<types::Int64Value>({5, 40, 20})
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 3, true, true)
+                          .AddColumn<types::Int64Value>({6, 2, 4})
+                          .AddColumn<types::Int64Value>({40, 30, 30})
+                          .get())
+      .Close();
+}
+
+TEST_F(TopKNodeTest, full_sort) {
+  CreatePlanNode(0);
+  RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64});
+  RowDescriptor output_rd({types::DataType::INT64, types::DataType::INT64});
+
+  auto tester = exec::ExecNodeTester<TopKNode, plan::TopKOperator>(*plan_node_, output_rd,
+                                                                   {input_rd}, exec_state_.get());
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd, 4, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::Int64Value>({1, 2, 3, 4})
+                       .AddColumn<types::Int64Value>({10, 30, 20, 30})
+                       .get(),
+                   0, 0)
+      .ConsumeNext(RowBatchBuilder(input_rd, 3, /*eow*/ true, /*eos*/ true)
+                       .AddColumn<types::Int64Value>({5, 6, 7})
+                       .AddColumn<types::Int64Value>({5, 40, 20})
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 7, true, true)
+                          .AddColumn<types::Int64Value>({6, 2, 4, 3, 7, 1, 5})
+                          .AddColumn<types::Int64Value>({40, 30, 30, 20, 20, 10, 5})
+                          .get())
+      .Close();
+}
+
+TEST_F(TopKNodeTest, single_empty_batch) {
+  CreatePlanNode(3);
+  RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64});
+  RowDescriptor output_rd({types::DataType::INT64, types::DataType::INT64});
+
+  auto tester = exec::ExecNodeTester<TopKNode, plan::TopKOperator>(*plan_node_, output_rd,
+                                                                   {input_rd}, exec_state_.get());
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd, 0, /*eow*/ true, /*eos*/ true)
+                       .AddColumn<types::Int64Value>({})
+                       .AddColumn<types::Int64Value>({})
+                       .get(),
+                   0)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 0, true, true)
+                          .AddColumn<types::Int64Value>({})
+                          .AddColumn<types::Int64Value>({})
+                          .get())
+      .Close();
+}
+
+// Enough rows are kept to compact the buffered batches, and the output drops a sort column, so the
+// compacted batch must keep the input columns for the sort to read.
+TEST_F(TopKNodeTest, compaction_with_selected_cols) {
+  CreatePlanNode(3);
+  auto topk_pb = planpb::testutils::CreateTestTopK1PB();
+  topk_pb.mutable_topk_op()->clear_columns();
+  for (int64_t col_idx : {2, 0}) {
+    auto col = topk_pb.mutable_topk_op()->add_columns();
+    col->set_node(1);
+    col->set_index(col_idx);
+  }
+  plan_node_ = plan::TopKOperator::FromProto(topk_pb, 1);
+
+  RowDescriptor input_rd({types::DataType::INT64, types::DataType::INT64, types::DataType::INT64});
+  RowDescriptor output_rd({types::DataType::INT64, types::DataType::INT64});
+  auto tester = exec::ExecNodeTester<TopKNode, plan::TopKOperator>(*plan_node_, output_rd,
+                                                                   {input_rd}, exec_state_.get());
+
+  // Each batch has one row that beats the rows kept so far, so the batches are all kept until
+  // they are compacted, after the fourth batch.
+  const int64_t batch_length = kDefaultTopKRowBatchSize;
+  for (int64_t batch = 0; batch < 5; ++batch) {
+    std::vector<Int64Value> ids(batch_length);
+    std::vector<Int64Value> keys(batch_length, 0);
+    std::vector<Int64Value> values(batch_length);
+    for (int64_t i = 0; i < batch_length; ++i) {
+      ids[i] = batch * batch_length + i;
+      values[i] = 10 * ids[i].val;
+    }
+    keys[0] = 1000 + batch;
+    bool eos = batch == 4;
+    tester.ConsumeNext(RowBatchBuilder(input_rd, batch_length, eos, eos)
+                           .AddColumn<Int64Value>(ids)
+                           .AddColumn<Int64Value>(keys)
+                           .AddColumn<Int64Value>(values)
+                           .get(),
+                       0, eos ? 1 : 0);
+  }
+  tester
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 3, true, true)
+                          .AddColumn<Int64Value>({40960, 30720, 20480})
+                          .AddColumn<Int64Value>({4096, 3072, 2048})
+                          .get())
+      .Close();
+}
+
+}  // namespace exec
+}  // namespace carnot
+}  // namespace px
@@ -18,6 +18,7 @@
 
 #include "src/carnot/exec/union_node.h"
 
+#include <arrow/array/concatenate.h>
 #include <arrow/memory_pool.h>
 #include <arrow/status.h>
 #include <algorithm>
@@ -56,15 +57,6 @@ Status UnionNode::InitImpl(const plan::Operator& plan_node) {
   return Status::OK();
 }
 
-Status UnionNode::InitializeColumnBuilders() {
-  for (size_t i = 0; i < output_descriptor_->size(); ++i) {
-    column_builders_[i] =
-        MakeArrowBuilder(output_descriptor_->type(i), arrow::default_memory_pool());
-    PL_RETURN_IF_ERROR(column_builders_[i]->Reserve(output_rows_per_batch_));
-  }
-  return Status::OK();
-}
-
 Status UnionNode::PrepareImpl(ExecState*) {
   size_t num_output_cols = output_descriptor_->size();
 
@@ -75,10 +67,11 @@ Status UnionNode::PrepareImpl(ExecState*) {
     parent_row_batches_.resize(num_parents_);
     row_cursors_.resize(num_parents_);
     time_columns_.resize(num_parents_);
-    data_columns_.resize(num_parents_, std::vector<arrow::Array*>(num_output_cols));
+    data_columns_.resize(num_parents_,
+                         std::vector<std::shared_ptr<arrow::Array>>(num_output_cols));
 
-    column_builders_.resize(num_output_cols);
-    PL_RETURN_IF_ERROR(InitializeColumnBuilders());
+    pending_columns_.resize(num_output_cols);
+    BuildMergeTree();
   }
 
   return Status::OK();
@@ -111,16 +104,103 @@ types::Time64NSValue UnionNode::GetTimeAtParentCursor(size_t parent_index) const
                                                         row_cursors_[parent_index]);
 }
 
-Status UnionNode::AppendRow(size_t parent) {
-  auto row = row_cursors_[parent];
+UnionNode::ParentState UnionNode::GetParentState(size_t parent) const {
+  if (flushed_parent_eoses_[parent]) {
+    return ParentState::kDone;
+  }
+  return parent_row_batches_[parent].empty() ? ParentState::kNeedsData : ParentState::kHasData;
+}
+
+bool UnionNode::ParentBefore(size_t parent_a, size_t parent_b) const {
+  auto state_a = GetParentState(parent_a);
+  auto state_b = GetParentState(parent_b);
+  if (state_a != state_b) {
+    return state_a < state_b;
+  }
+  if (state_a == ParentState::kHasData) {
+    auto time_a = GetTimeAtParentCursor(parent_a);
+    auto time_b = GetTimeAtParentCursor(parent_b);
+    if (time_a != time_b) {
+      return time_a < time_b;
+    }
+  }
+  // Ties go to the lower parent index, so rows are stable with respect to the parent index.
+  return parent_a < parent_b;
+}
+
+void UnionNode::BuildMergeTree() {
+  // Nodes are laid out as a binary heap, with the parents as the leaves at [num_parents_,
+  // 2 * num_parents_).
+  merge_tree_.assign(num_parents_, 0);
+  std::vector<size_t> winners(2 * num_parents_);
+  for (size_t parent = 0; parent < num_parents_; ++parent) {
+    winners[num_parents_ + parent] = parent;
+  }
+  for (size_t node = num_parents_ - 1; node > 0; --node) {
+    size_t left = winners[2 * node];
+    size_t right = winners[2 * node + 1];
+    bool left_wins = ParentBefore(left, right);
+    winners[node] = left_wins ? left : right;
+    merge_tree_[node] = left_wins ? right : left;
+  }
+  merge_tree_[0] = num_parents_ > 1 ? winners[1] : 0;
+}
+
+void UnionNode::UpdateMergeTree(size_t parent) {
+  size_t winner = parent;
+  for (size_t node = (num_parents_ + parent) / 2; node > 0; node /= 2) {
+    if (ParentBefore(merge_tree_[node], winner)) {
+      std::swap(merge_tree_[node], winner);
+    }
+  }
+  merge_tree_[0] = winner;
+}
+
+size_t UnionNode::MergeRunnerUp() const {
+  DCHECK_GT(num_parents_, 1U);
+  size_t winner = merge_tree_[0];
+  size_t node = (num_parents_ + winner) / 2;
+  size_t runner_up = merge_tree_[node];
+  for (node /= 2; node > 0; node /= 2) {
+    if (ParentBefore(merge_tree_[node], runner_up)) {
+      runner_up = merge_tree_[node];
+    }
+  }
+  return runner_up;
+}
+
+size_t UnionNode::MergeRunEnd(size_t parent, size_t next_parent) const {
+  const auto& rb = parent_row_batches_[parent][0];
+  size_t end = rb.num_rows();
+  if (GetParentState(next_parent) != ParentState::kHasData) {
+    return end;
+  }
+  // Rows of the parent go first while their time is before the next parent's, or equal to it
+  // when the parent has the lower index.
+  auto next_time = GetTimeAtParentCursor(next_parent).val;
+  bool include_ties = parent < next_parent;
+  auto* time_col = time_columns_[parent];
+  size_t lo = row_cursors_[parent];
+  size_t hi = end;
+  // Binary search for the first row that goes after the next parent's row.
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    auto time = types::GetValueFromArrowArray<types::TIME64NS>(time_col, mid);
+    bool goes_first = time < next_time || (include_ties && time == next_time);
+    if (goes_first) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+Status UnionNode::AppendRun(size_t parent, size_t start, size_t length) {
   for (size_t i = 0; i < output_descriptor_->size(); ++i) {
-    auto input_col = data_columns_[parent][i];
-#define TYPE_CASE(_dt_)                                    \
-  PL_RETURN_IF_ERROR(table_store::schema::CopyValue<_dt_>( \
-      column_builders_[i].get(), types::GetValueFromArrowArray<_dt_>(input_col, row)));
-    PL_SWITCH_FOREACH_DATATYPE(output_descriptor_->type(i), TYPE_CASE);
-#undef TYPE_CASE
+    pending_columns_[i].push_back(data_columns_[parent][i]->Slice(start, length));
   }
+  pending_rows_ += length;
   return Status::OK();
 }
 
@@ -139,8 +219,7 @@ Status UnionNode::OptionallyFlushRowBatchIfTimeout(ExecState* exec_state) {
     return Status::OK();
   }
 
-  DCHECK_GT(column_builders_.size(), 0);
-  if (column_builders_[0]->length()) {
+  if (pending_rows_ > 0) {
     return FlushBatch(exec_state);
   }
   return Status::OK();
@@ -149,9 +228,8 @@ Status UnionNode::OptionallyFlushRowBatchIfTimeout(ExecState* exec_state) {
 // Flush the row batch if we have reached a certain number of records.
 Status UnionNode::OptionallyFlushRowBatchIfMaxRowsOrEOS(ExecState* exec_state) {
   bool eos = InputsComplete();
-  int64_t output_rows = column_builders_[0]->length();
 
-  if (output_rows < static_cast<int64_t>(output_rows_per_batch_) && !eos) {
+  if (pending_rows_ < output_rows_per_batch_ && !eos) {
     return Status::OK();
   }
 
@@ -162,78 +240,74 @@ Status UnionNode::FlushBatch(ExecState* exec_state) {
   DCHECK(!sent_eos_);
 
   bool eos = InputsComplete();
-  PL_ASSIGN_OR_RETURN(auto rb, RowBatch::FromColumnBuilders(*output_descriptor_, /*eow*/ eos,
-                                                            /*eos*/ eos, &column_builders_));
-  PL_RETURN_IF_ERROR(InitializeColumnBuilders());
+  RowBatch rb(*output_descriptor_, pending_rows_);
+  for (size_t i = 0; i < output_descriptor_->size(); ++i) {
+    auto& slices = pending_columns_[i];
+    std::shared_ptr<arrow::Array> col;
+    if (slices.size() == 1) {
+      // A single run is passed on as is, without copying.
+      col = slices[0];
+    } else if (slices.empty()) {
+      auto builder = MakeArrowBuilder(output_descriptor_->type(i), exec_state->exec_mem_pool());
+      PL_RETURN_IF_ERROR(builder->Finish(&col));
+    } else {
+      PL_RETURN_IF_ERROR(arrow::Concatenate(slices, exec_state->exec_mem_pool(), &col));
+    }
+    PL_RETURN_IF_ERROR(rb.AddColumn(col));
+    slices.clear();
+  }
+  pending_rows_ = 0;
+  rb.set_eow(eos);
+  rb.set_eos(eos);
   last_data_flush_time_ = std::chrono::system_clock::now();
-  return SendRowBatchToChildren(exec_state, *rb);
+  return SendRowBatchToChildren(exec_state, rb);
 }
 
 Status UnionNode::MergeData(ExecState* exec_state) {
   while (!sent_eos_) {
-    // Get the smallest time out of all of the current streams.
-    std::vector<size_t> parent_streams;
-    parent_streams.reserve(row_cursors_.size());
-
-    for (size_t parent = 0; parent < row_cursors_.size(); ++parent) {
-      if (flushed_parent_eoses_[parent]) {
-        continue;
-      }
-      // If we lack necessary data, we can't merge anymore.
-      if (!parent_row_batches_[parent].size()) {
-        return Status::OK();
-      }
-      parent_streams.push_back(parent);
+    // The winner of the merge tree is the parent with the smallest time at its cursor, unless
+    // some parent lacks data, in which case it wins and we can't merge anymore.
+    size_t parent = merge_tree_[0];
+    auto state = GetParentState(parent);
+    if (state == ParentState::kNeedsData) {
+      return Status::OK();
     }
 
     // If we have reached end of stream for all of our inputs, flush the queue.
-    if (!parent_streams.size()) {
+    if (state == ParentState::kDone) {
       return OptionallyFlushRowBatchIfMaxRowsOrEOS(exec_state);
     }
 
-    std::sort(parent_streams.begin(), parent_streams.end(),
-              [this](size_t parent_a, size_t parent_b) {
-                auto time_a = GetTimeAtParentCursor(parent_a);
-                auto time_b = GetTimeAtParentCursor(parent_b);
-                return time_a < time_b || (time_a == time_b && parent_a < parent_b);
-              });
-
-    bool has_limit = parent_streams.size() > 1;
-    size_t parent = parent_streams[0];
-
-    while (parent_row_batches_[parent].size()) {
-      if (has_limit) {
-        size_t next_parent = parent_streams[1];
-        // If this time is greater than another parent stream's earliest time,
-        // or if they are the same but the first parent is at a smaller index, stop merging.
-        // This way rows are always stable with respect to input parent index.
-        if (GetTimeAtParentCursor(parent) > GetTimeAtParentCursor(next_parent) ||
-            (GetTimeAtParentCursor(parent) == GetTimeAtParentCursor(next_parent) &&
-             parent > next_parent)) {
-          break;
-        }
-      }
-
-      PL_RETURN_IF_ERROR(AppendRow(parent));
-
-      // Mark whether or not we hit the eos for this stream, and whether the row batch needs to be
-      // popped.
-      const auto& rb = parent_row_batches_[parent][0];
-      bool pop_row_batch = ++row_cursors_[parent] == static_cast<size_t>(rb.num_rows());
-      if (pop_row_batch && rb.eos()) {
-        flushed_parent_eoses_[parent] = true;
-      }
-
-      if (pop_row_batch) {
-        // Delete the top row batch from our buffer and update the cursor.
-        parent_row_batches_[parent].erase(parent_row_batches_[parent].begin());
-        row_cursors_[parent] = 0;
-        CacheNextRowBatch(parent);
-      }
-
-      // Flush the current RowBatch if necessary.
-      PL_RETURN_IF_ERROR(OptionallyFlushRowBatchIfMaxRowsOrEOS(exec_state));
+    // Append the run of rows of this parent that go before any row of the other parents. Rows are
+    // stable with respect to input parent index, see ParentBefore.
+    size_t start = row_cursors_[parent];
+    size_t end = parent_row_batches_[parent][0].num_rows();
+    if (num_parents_ > 1) {
+      end = MergeRunEnd(parent, MergeRunnerUp());
+    }
+    end = std::min(end, start + output_rows_per_batch_ - pending_rows_);
+    DCHECK_GT(end, start);
+    PL_RETURN_IF_ERROR(AppendRun(parent, start, end - start));
+    row_cursors_[parent] = end;
+
+    // Mark whether or not we hit the eos for this stream, and whether the row batch needs to be
+    // popped.
+    const auto& rb = parent_row_batches_[parent][0];
+    bool pop_row_batch = end == static_cast<size_t>(rb.num_rows());
+    if (pop_row_batch && rb.eos()) {
+      flushed_parent_eoses_[parent] = true;
     }
+
+    if (pop_row_batch) {
+      // Delete the top row batch from our buffer and update the cursor.
+      parent_row_batches_[parent].erase(parent_row_batches_[parent].begin());
+      row_cursors_[parent] = 0;
+      CacheNextRowBatch(parent);
+    }
+    UpdateMergeTree(parent);
+
+    // Flush the current RowBatch if necessary.
+    PL_RETURN_IF_ERROR(OptionallyFlushRowBatchIfMaxRowsOrEOS(exec_state));
   }
   return Status::OK();
 }
@@ -253,14 +327,23 @@ void UnionNode::CacheNextRowBatch(size_t parent) {
   time_columns_[parent] = next_rb.ColumnAt(plan_node_->time_column_index(parent)).get();
 
   for (size_t i = 0; i < output_descriptor_->size(); ++i) {
-    data_columns_[parent][i] = GetInputColumn(next_rb, parent, i).get();
+    data_columns_[parent][i] = GetInputColumn(next_rb, parent, i);
   }
 }
 
 Status UnionNode::ConsumeNextOrdered(ExecState* exec_state, const RowBatch& rb,
                                      size_t parent_index) {
+  auto state_before = GetParentState(parent_index);
   parent_row_batches_[parent_index].push_back(rb);
   CacheNextRowBatch(parent_index);
+  // Replaying the comparisons on a parent's path is only valid for the winner, whose comparisons
+  // are all on that path. Any other parent whose state changed may now win against parents that
+  // aren't on its path, so the tree is rebuilt.
+  if (parent_index == merge_tree_[0]) {
+    UpdateMergeTree(parent_index);
+  } else if (GetParentState(parent_index) != state_before) {
+    BuildMergeTree();
+  }
   PL_RETURN_IF_ERROR(MergeData(exec_state));
   return OptionallyFlushRowBatchIfTimeout(exec_state);
 }
@@ -88,10 +88,31 @@ class UnionNode : public ProcessingNode {
 
   // The items below are all for the time-ordered case.
 
+  // The merge state of a parent stream. Parents are ordered by state, then by the time at their
+  // cursor, then by index.
+  enum class ParentState {
+    // The parent has no data buffered, so nothing can be merged until it does.
+    kNeedsData = 0,
+    kHasData = 1,
+    // The parent has been fully merged.
+    kDone = 2,
+  };
+
   void CacheNextRowBatch(size_t parent);
-  Status InitializeColumnBuilders();
   types::Time64NSValue GetTimeAtParentCursor(size_t parent_index) const;
-  Status AppendRow(size_t parent);
+  ParentState GetParentState(size_t parent) const;
+  // Whether the next row of parent_a goes before the next row of parent_b.
+  bool ParentBefore(size_t parent_a, size_t parent_b) const;
+  // The merge tree is a loser tree over the parents: each internal node holds the parent that
+  // lost the comparison there, and the root (index 0) the overall winner.
+  void BuildMergeTree();
+  // Replays the comparisons on the path of the winner, after its state or cursor changed.
+  void UpdateMergeTree(size_t parent);
+  // The parent that goes next after the winner, which is one of the parents it beat.
+  size_t MergeRunnerUp() const;
+  // The end of the run of rows of the parent that go before all the rows of next_parent.
+  size_t MergeRunEnd(size_t parent, size_t next_parent) const;
+  Status AppendRun(size_t parent, size_t start, size_t length);
   Status OptionallyFlushRowBatchIfMaxRowsOrEOS(ExecState* exec_state);
   Status OptionallyFlushRowBatchIfTimeout(ExecState* exec_state);
   Status FlushBatch(ExecState* exec_state);
@@ -101,8 +122,12 @@ class UnionNode : public ProcessingNode {
   // we just maintain the original row count to avoid copying the data.
   size_t output_rows_per_batch_;
 
-  // Column builders will flush a batch once they hit output_rows_per_batch_ rows.
-  std::vector<std::unique_ptr<arrow::ArrayBuilder>> column_builders_;
+  // The slices of the input columns that make up the next output batch, by output column. They
+  // are concatenated when the batch is flushed, once it has output_rows_per_batch_ rows.
+  std::vector<std::vector<std::shared_ptr<arrow::Array>>> pending_columns_;
+  size_t pending_rows_ = 0;
+
+  std::vector<size_t> merge_tree_;
 
   // Hold onto the input row batches for every parent until we copy all of their data.
   std::vector<std::vector<table_store::schema::RowBatch>> parent_row_batches_;
@@ -111,7 +136,7 @@ class UnionNode : public ProcessingNode {
   std::vector<size_t> row_cursors_;
   // Cache current working time and data columns for performance reasons.
   std::vector<arrow::Array*> time_columns_;
-  std::vector<std::vector<arrow::Array*>> data_columns_;
+  std::vector<std::vector<std::shared_ptr<arrow::Array>>> data_columns_;
 
   bool enable_data_flush_timeout_ = true;
   // When enable_data_flush_timeout_ is set to true, use this time to decide if we should
@@ -275,6 +275,46 @@ TEST_F(UnionNodeTest, ordered_full_overlap) {
       .Close();
 }
 
+// Runs of rows from the same parent that span parents' row batches and output batches.
+TEST_F(UnionNodeTest, ordered_interleaved_runs) {
+  auto op_proto = planpb::testutils::CreateTestUnionOrderedPB();
+  plan_node_ = plan::UnionOperator::FromProto(op_proto, /*id*/ 1);
+
+  RowDescriptor input_rd_0({types::DataType::STRING, types::DataType::TIME64NS});
+  RowDescriptor input_rd_1({types::DataType::TIME64NS, types::DataType::STRING});
+
+  RowDescriptor output_rd({types::DataType::STRING, types::DataType::TIME64NS});
+
+  auto tester = exec::ExecNodeTester<UnionNode, plan::UnionOperator>(
+      *plan_node_, output_rd, {input_rd_0, input_rd_1}, exec_state_.get());
+  tester.node()->disable_data_flush_timeout();
+
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd_0, 5, /*eow*/ true, /*eos*/ true)
+                       .AddColumn<types::StringValue>({"A", "B", "C", "D", "E"})
+                       .AddColumn<types::Time64NSValue>({0, 1, 2, 6, 7})
+                       .get(),
+                   0, 0)
+      .ConsumeNext(RowBatchBuilder(input_rd_1, 6, true, true)
+                       .AddColumn<types::Time64NSValue>({3, 4, 5, 7, 8, 9})
+                       .AddColumn<types::StringValue>({"a", "b", "c", "d", "e", "f"})
+                       .get(),
+                   1, 3)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 5, false, false)
+                          .AddColumn<types::StringValue>({"A", "B", "C", "a", "b"})
+                          .AddColumn<types::Time64NSValue>({0, 1, 2, 3, 4})
+                          .get())
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 5, false, false)
+                          .AddColumn<types::StringValue>({"c", "D", "E", "d", "e"})
+                          .AddColumn<types::Time64NSValue>({5, 6, 7, 7, 8})
+                          .get())
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 1, true, true)
+                          .AddColumn<types::StringValue>({"f"})
+                          .AddColumn<types::Time64NSValue>({9})
+                          .get())
+      .Close();
+}
+
 TEST_F(UnionNodeTest, no_rows_parent) {
   auto op_proto = planpb::testutils::CreateTestUnionOrderedPB();
   plan_node_ = plan::UnionOperator::FromProto(op_proto, /*id*/ 1);
@@ -623,6 +663,103 @@ TEST_F(UnionNodeTest, ordered_timeout_hit) {
       .Close();
 }
 
+// The second parent delivers data before the first.
+TEST_F(UnionNodeTest, ordered_second_parent_first) {
+  auto op_proto = planpb::testutils::CreateTestUnionOrderedPB();
+  plan_node_ = plan::UnionOperator::FromProto(op_proto, /*id*/ 1);
+
+  RowDescriptor input_rd_0({types::DataType::STRING, types::DataType::TIME64NS});
+  RowDescriptor input_rd_1({types::DataType::TIME64NS, types::DataType::STRING});
+
+  RowDescriptor output_rd({types::DataType::STRING, types::DataType::TIME64NS});
+
+  auto tester = exec::ExecNodeTester<UnionNode, plan::UnionOperator>(
+      *plan_node_, output_rd, {input_rd_0, input_rd_1}, exec_state_.get());
+  tester.node()->disable_data_flush_timeout();
+
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd_1, 2, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::Time64NSValue>({1, 3})
+                       .AddColumn<types::StringValue>({"b1", "b3"})
+                       .get(),
+                   1, 0)
+      .ConsumeNext(RowBatchBuilder(input_rd_0, 3, false, false)
+                       .AddColumn<types::StringValue>({"a0", "a2", "a4"})
+                       .AddColumn<types::Time64NSValue>({0, 2, 4})
+                       .get(),
+                   0, 0)
+      .ConsumeNext(RowBatchBuilder(input_rd_1, 2, true, true)
+                       .AddColumn<types::Time64NSValue>({5, 6})
+                       .AddColumn<types::StringValue>({"b5", "b6"})
+                       .get(),
+                   1, 1)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 5, false, false)
+                          .AddColumn<types::StringValue>({"a0", "b1", "a2", "b3", "a4"})
+                          .AddColumn<types::Time64NSValue>({0, 1, 2, 3, 4})
+                          .get())
+      .ConsumeNext(RowBatchBuilder(input_rd_0, 1, true, true)
+                       .AddColumn<types::StringValue>({"a7"})
+                       .AddColumn<types::Time64NSValue>({7})
+                       .get(),
+                   0, 1)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 3, true, true)
+                          .AddColumn<types::StringValue>({"b5", "b6", "a7"})
+                          .AddColumn<types::Time64NSValue>({5, 6, 7})
+                          .get())
+      .Close();
+}
+
+// Three parents, which deliver data in the reverse order of their index.
+TEST_F(UnionNodeTest, ordered_three_parents) {
+  auto op_proto = planpb::testutils::CreateTestUnionOrdered3ParentsPB();
+  plan_node_ = plan::UnionOperator::FromProto(op_proto, /*id*/ 1);
+
+  RowDescriptor input_rd_0({types::DataType::STRING, types::DataType::TIME64NS});
+  RowDescriptor input_rd_1({types::DataType::TIME64NS, types::DataType::STRING});
+
+  RowDescriptor output_rd({types::DataType::STRING, types::DataType::TIME64NS});
+
+  auto tester = exec::ExecNodeTester<UnionNode, plan::UnionOperator>(
+      *plan_node_, output_rd, {input_rd_0, input_rd_1, input_rd_0}, exec_state_.get());
+  tester.node()->disable_data_flush_timeout();
+
+  tester
+      .ConsumeNext(RowBatchBuilder(input_rd_0, 2, /*eow*/ false, /*eos*/ false)
+                       .AddColumn<types::StringValue>({"c2", "c5"})
+                       .AddColumn<types::Time64NSValue>({2, 5})
+                       .get(),
+                   2, 0)
+      .ConsumeNext(RowBatchBuilder(input_rd_1, 2, false, false)
+                       .AddColumn<types::Time64NSValue>({1, 4})
+                       .AddColumn<types::StringValue>({"b1", "b4"})
+                       .get(),
+                   1, 0)
+      .ConsumeNext(RowBatchBuilder(input_rd_0, 3, true, true)
+                       .AddColumn<types::StringValue>({"a0", "a3", "a6"})
+                       .AddColumn<types::Time64NSValue>({0, 3, 6})
+                       .get(),
+                   0, 1)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 5, false, false)
+                          .AddColumn<types::StringValue>({"a0", "b1", "c2", "a3", "b4"})
+                          .AddColumn<types::Time64NSValue>({0, 1, 2, 3, 4})
+                          .get())
+      .ConsumeNext(RowBatchBuilder(input_rd_1, 1, true, true)
+                       .AddColumn<types::Time64NSValue>({7})
+                       .AddColumn<types::StringValue>({"b7"})
+                       .get(),
+                   1, 0)
+      .ConsumeNext(RowBatchBuilder(input_rd_0, 1, true, true)
+                       .AddColumn<types::StringValue>({"c8"})
+                       .AddColumn<types::Time64NSValue>({8})
+                       .get(),
+                   2, 1)
+      .ExpectRowBatch(RowBatchBuilder(output_rd, 4, true, true)
+                          .AddColumn<types::StringValue>({"c5", "a6", "b7", "c8"})
+                          .AddColumn<types::Time64NSValue>({5, 6, 7, 8})
+                          .get())
+      .Close();
+}
+
 }  // namespace exec
 }  // namespace carnot
 }  // namespace px
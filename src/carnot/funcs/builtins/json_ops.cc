@@ -18,6 +18,10 @@
 
 #include "src/carnot/funcs/builtins/json_ops.h"
 
+#include <limits>
+
+#include <rapidjson/memorystream.h>
+
 #include "src/carnot/udf/registry.h"
 
 namespace px {
@@ -26,6 +30,157 @@ namespace builtins {
 
 using types::StringValue;
 
+namespace internal {
+
+bool JSONValueFinder::Find(std::string_view json) {
+  rapidjson::MemoryStream stream(json.data(), json.size());
+  rapidjson::Reader reader;
+  // The handler stops the parse once the value is read, which shows up as a parse error.
+  reader.Parse(stream, *this);
+  return done_;
+}
+
+template <typename TWriteFn>
+bool JSONValueFinder::Scalar(ValueType type, TWriteFn write_fn) {
+  if (depth_ == 0) {
+    // The root is neither an object nor an array.
+    return false;
+  }
+  if (capturing_) {
+    return write_fn();
+  }
+  if (root_is_array_ && depth_ == 1) {
+    capture_next_ = element_++ == index_;
+  }
+  if (!capture_next_) {
+    return true;
+  }
+  type_ = type;
+  write_fn();
+  done_ = true;
+  return false;
+}
+
+bool JSONValueFinder::Null() {
+  return Scalar(ValueType::kNull, [this] { return writer_.Null(); });
+}
+
+bool JSONValueFinder::Bool(bool b) {
+  return Scalar(ValueType::kBool, [this, b] { return writer_.Bool(b); });
+}
+
+bool JSONValueFinder::Int(int i) {
+  return Scalar(ValueType::kInt64, [this, i] {
+    int64_value_ = i;
+    return writer_.Int(i);
+  });
+}
+
+bool JSONValueFinder::Uint(unsigned i) {
+  return Scalar(ValueType::kInt64, [this, i] {
+    int64_value_ = i;
+    return writer_.Uint(i);
+  });
+}
+
+bool JSONValueFinder::Int64(int64_t i) {
+  return Scalar(ValueType::kInt64, [this, i] {
+    int64_value_ = i;
+    return writer_.Int64(i);
+  });
+}
+
+bool JSONValueFinder::Uint64(uint64_t i) {
+  // Values past the int64 range can only be read as doubles.
+  ValueType type = i > static_cast<uint64_t>(std::numeric_limits<int64_t>::max())
+                       ? ValueType::kDouble
+                       : ValueType::kInt64;
+  return Scalar(type, [this, i] {
+    int64_value_ = static_cast<int64_t>(i);
+    double_value_ = static_cast<double>(i);
+    return writer_.Uint64(i);
+  });
+}
+
+bool JSONValueFinder::Double(double d) {
+  return Scalar(ValueType::kDouble, [this, d] {
+    double_value_ = d;
+    return writer_.Double(d);
+  });
+}
+
+bool JSONValueFinder::String(const char* str, rapidjson::SizeType len, bool copy) {
+  return Scalar(ValueType::kString, [this, str, len, copy] {
+    if (!capturing_) {
+      string_value_.assign(str, len);
+      return true;
+    }
+    return writer_.String(str, len, copy);
+  });
+}
+
+bool JSONValueFinder::StartComposite(bool is_array) {
+  if (depth_ == 0) {
+    ++depth_;
+    return is_array == root_is_array_;
+  }
+  if (!capturing_) {
+    if (root_is_array_ && depth_ == 1) {
+      capture_next_ = element_++ == index_;
+    }
+    if (capture_next_) {
+      capturing_ = true;
+      capture_depth_ = depth_;
+      type_ = ValueType::kComposite;
+    }
+  }
+  ++depth_;
+  if (!capturing_) {
+    return true;
+  }
+  return is_array ? writer_.StartArray() : writer_.StartObject();
+}
+
+bool JSONValueFinder::EndComposite() {
+  --depth_;
+  if (!capturing_ || depth_ > capture_depth_) {
+    return true;
+  }
+  // Back at the depth the value started at, so the value is complete.
+  done_ = true;
+  return false;
+}
+
+bool JSONValueFinder::StartObject() { return StartComposite(/*is_array*/ false); }
+
+bool JSONValueFinder::Key(const char* str, rapidjson::SizeType len, bool copy) {
+  if (capturing_) {
+    return writer_.Key(str, len, copy);
+  }
+  if (!root_is_array_ && depth_ == 1) {
+    capture_next_ = std::string_view(str, len) == key_;
+  }
+  return true;
+}
+
+bool JSONValueFinder::EndObject(rapidjson::SizeType member_count) {
+  if (capturing_ && !writer_.EndObject(member_count)) {
+    return false;
+  }
+  return EndComposite();
+}
+
+bool JSONValueFinder::StartArray() { return StartComposite(/*is_array*/ true); }
+
+bool JSONValueFinder::EndArray(rapidjson::SizeType element_count) {
+  if (capturing_ && !writer_.EndArray(element_count)) {
+    return false;
+  }
+  return EndComposite();
+}
+
+}  // namespace internal
+
 void RegisterJSONOpsOrDie(udf::Registry* registry) {
   registry->RegisterOrDie<PluckUDF>("pluck");
   registry->RegisterOrDie<PluckAsInt64UDF>("pluck_int64");
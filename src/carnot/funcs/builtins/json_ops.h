@@ -18,11 +18,14 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 #include <rapidjson/document.h>
+#include <rapidjson/reader.h>
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 
@@ -33,36 +36,106 @@ namespace px {
 namespace carnot {
 namespace builtins {
 
+namespace internal {
+
+/**
+ * SAX handler that finds a single value in serialized JSON: either the value of a top-level key
+ * of an object, or the element at an index of an array.
+ *
+ * Unlike parsing into a rapidjson::Document, it doesn't build a DOM of the whole input and stops
+ * parsing as soon as the value has been read, so the rest of the input is never scanned.
+ * Composite values are re-serialized while they are parsed.
+ */
+class JSONValueFinder : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, JSONValueFinder> {
+ public:
+  enum class ValueType { kNull, kBool, kInt64, kDouble, kString, kComposite };
+
+  explicit JSONValueFinder(std::string_view key) : key_(key), root_is_array_(false) {}
+  explicit JSONValueFinder(int64_t index) : index_(index), root_is_array_(true) {}
+
+  /**
+   * Parses the JSON until the value is found. Returns false if the input is not an object (or
+   * array), doesn't contain the key (or index), or is malformed before the end of the value.
+   */
+  bool Find(std::string_view json);
+
+  ValueType type() const { return type_; }
+  int64_t int64_value() const { return int64_value_; }
+  double double_value() const { return double_value_; }
+  const std::string& string_value() const { return string_value_; }
+  // The value serialized as JSON. Set for all types but kString.
+  std::string_view serialized() const { return {buffer_.GetString(), buffer_.GetSize()}; }
+
+  // SAX events, called by rapidjson::Reader.
+  bool Null();
+  bool Bool(bool b);
+  bool Int(int i);
+  bool Uint(unsigned i);
+  bool Int64(int64_t i);
+  bool Uint64(uint64_t i);
+  bool Double(double d);
+  bool String(const char* str, rapidjson::SizeType len, bool copy);
+  bool StartObject();
+  bool Key(const char* str, rapidjson::SizeType len, bool copy);
+  bool EndObject(rapidjson::SizeType member_count);
+  bool StartArray();
+  bool EndArray(rapidjson::SizeType element_count);
+
+ private:
+  template <typename TWriteFn>
+  bool Scalar(ValueType type, TWriteFn write_fn);
+  bool StartComposite(bool is_array);
+  bool EndComposite();
+
+  std::string_view key_;
+  int64_t index_ = -1;
+  const bool root_is_array_;
+
+  // The nesting depth of the parser, 1 inside the root object or array.
+  int depth_ = 0;
+  int64_t element_ = 0;
+  // Set when the next value is the one looked for.
+  bool capture_next_ = false;
+  bool capturing_ = false;
+  int capture_depth_ = 0;
+  bool done_ = false;
+
+  ValueType type_ = ValueType::kNull;
+  int64_t int64_value_ = 0;
+  double double_value_ = 0;
+  std::string string_value_;
+  rapidjson::StringBuffer buffer_;
+  rapidjson::Writer<rapidjson::StringBuffer> writer_{buffer_};
+};
+
+/**
+ * Returns a plucked value as a string: strings as is, null as empty, and anything else
+ * (including nested JSON) serialized.
+ */
+inline std::string PluckedString(const JSONValueFinder& finder) {
+  switch (finder.type()) {
+    case JSONValueFinder::ValueType::kNull:
+      return "";
+    case JSONValueFinder::ValueType::kString:
+      return finder.string_value();
+    default:
+      return std::string(finder.serialized());
+  }
+}
+
+}  // namespace internal
+
 // TODO(zasgar): PL-419 To have proper support for JSON we need structs and nullable types.
 // Revisit when we have them.
 class PluckUDF : public udf::ScalarUDF {
  public:
   StringValue Exec(FunctionContext*, StringValue in, StringValue key) {
-    rapidjson::Document d;
-    rapidjson::ParseResult ok = d.Parse(in.data());
+    internal::JSONValueFinder finder{std::string_view(key)};
     // TODO(zasgar/michellenguyen, PP-419): Replace with null when available.
-    if (ok == nullptr) {
-      return "";
-    }
-    if (!d.IsObject()) {
+    if (!finder.Find(in)) {
       return "";
     }
-    if (!d.HasMember(key.data())) {
-      return "";
-    }
-    const auto& plucked_value = d[key.data()];
-    if (plucked_value.IsNull()) {
-      return "";
-    }
-    if (plucked_value.IsString()) {
-      return plucked_value.GetString();
-    }
-
-    // This is robust to nested JSON.
-    rapidjson::StringBuffer sb;
-    rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
-    plucked_value.Accept(writer);
-    return sb.GetString();
+    return internal::PluckedString(finder);
   }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder(
@@ -87,17 +160,12 @@ class PluckUDF : public udf::ScalarUDF {
 class PluckAsInt64UDF : public udf::ScalarUDF {
  public:
   Int64Value Exec(FunctionContext*, StringValue in, StringValue key) {
-    rapidjson::Document d;
-    rapidjson::ParseResult ok = d.Parse(in.data());
+    internal::JSONValueFinder finder{std::string_view(key)};
     // TODO(zasgar/michellenguyen, PP-419): Replace with null when available.
-    if (ok == nullptr) {
+    if (!finder.Find(in) || finder.type() != internal::JSONValueFinder::ValueType::kInt64) {
       return 0;
     }
-    if (!d.IsObject()) {
-      return 0;
-    }
-    const auto& plucked_value = d[key.data()];
-    return plucked_value.GetInt64();
+    return finder.int64_value();
   }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder(
@@ -122,17 +190,19 @@ class PluckAsInt64UDF : public udf::ScalarUDF {
 class PluckAsFloat64UDF : public udf::ScalarUDF {
  public:
   Float64Value Exec(FunctionContext*, StringValue in, StringValue key) {
-    rapidjson::Document d;
-    rapidjson::ParseResult ok = d.Parse(in.data());
+    internal::JSONValueFinder finder{std::string_view(key)};
     // TODO(zasgar/michellenguyen, PP-419): Replace with null when available.
-    if (ok == nullptr) {
+    if (!finder.Find(in)) {
       return 0.0;
     }
-    if (!d.IsObject()) {
-      return 0.0;
+    switch (finder.type()) {
+      case internal::JSONValueFinder::ValueType::kInt64:
+        return static_cast<double>(finder.int64_value());
+      case internal::JSONValueFinder::ValueType::kDouble:
+        return finder.double_value();
+      default:
+        return 0.0;
     }
-    const auto& plucked_value = d[key.data()];
-    return plucked_value.GetDouble();
   }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder(
@@ -160,33 +230,15 @@ class PluckAsFloat64UDF : public udf::ScalarUDF {
 class PluckArrayUDF : public udf::ScalarUDF {
  public:
   StringValue Exec(FunctionContext*, StringValue in, Int64Value index) {
-    rapidjson::Document d;
-    rapidjson::ParseResult ok = d.Parse(in.data());
     // TODO(zasgar/michellenguyen, PP-419): Replace with null when available.
-    if (ok == nullptr) {
-      return "";
-    }
-    if (!d.IsArray()) {
-      return "";
-    }
-    const auto& plucked_array = d.GetArray();
-    if (index < 0 || index >= plucked_array.Size()) {
+    if (index < 0) {
       return "";
     }
-
-    const auto& plucked_value = plucked_array[index.val];
-    if (plucked_value.IsNull()) {
+    internal::JSONValueFinder finder{index.val};
+    if (!finder.Find(in)) {
       return "";
     }
-    if (plucked_value.IsString()) {
-      return plucked_value.GetString();
-    }
-
-    // This is robust to nested JSON.
-    rapidjson::StringBuffer sb;
-    rapidjson::Writer<rapidjson::StringBuffer> writer(sb);
-    plucked_value.Accept(writer);
-    return sb.GetString();
+    return internal::PluckedString(finder);
   }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder(
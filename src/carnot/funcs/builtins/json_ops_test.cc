@@ -107,6 +107,43 @@ TEST(JSONOps, PluckArrayUDF_index_out_of_bound) {
   udf_tester.ForInput(kTestJSONArray, 3).Expect("");
 }
 
+TEST(JSONOps, PluckUDF_only_top_level_keys) {
+  auto udf_tester = udf::UDFTester<PluckUDF>();
+  udf_tester.ForInput(R"({"a": {"key": 1}, "key": [1, {"key": null}]})", "key")
+      .Expect(R"([1,{"key":null}])");
+  udf_tester.ForInput(R"({"a": {"key": 1}})", "key").Expect("");
+  udf_tester.ForInput(R"({"key": null})", "key").Expect("");
+  udf_tester.ForInput(R"({"key": true})", "key").Expect("true");
+}
+
+TEST(JSONOps, PluckUDF_stops_after_value) {
+  // The input after the plucked value is not parsed.
+  auto udf_tester = udf::UDFTester<PluckUDF>();
+  udf_tester.ForInput(R"({"key": {"a": "b"}, "other": )", "key").Expect(R"({"a":"b"})");
+  udf_tester.ForInput(R"({"key": {"a": "b")", "key").Expect("");
+}
+
+TEST(JSONOps, PluckAsFloat64UDF_int_value) {
+  auto udf_tester = udf::UDFTester<PluckAsFloat64UDF>();
+  udf_tester.ForInput(kTestJSONStr, "int64_key").Expect(34243242341.0);
+  udf_tester.ForInput(kTestJSONStr, "str_plain").Expect(0.0);
+}
+
+TEST(JSONOps, PluckAsInt64UDF_non_int_value) {
+  auto udf_tester = udf::UDFTester<PluckAsInt64UDF>();
+  udf_tester.ForInput(kTestJSONStr, "float64_key").Expect(0);
+  udf_tester.ForInput(kTestJSONStr, "blah").Expect(0);
+}
+
+TEST(JSONOps, PluckArrayUDF_nested_elements) {
+  auto udf_tester = udf::UDFTester<PluckArrayUDF>();
+  constexpr char kNestedArray[] = R"([[1, [2]], "foo", [3]])";
+  udf_tester.ForInput(kNestedArray, 0).Expect("[1,[2]]");
+  udf_tester.ForInput(kNestedArray, 1).Expect("foo");
+  udf_tester.ForInput(kNestedArray, 2).Expect("[3]");
+  udf_tester.ForInput(kNestedArray, -1).Expect("");
+}
+
 TEST(JSONOps, ScriptReferenceUDF_no_args) {
   auto udf_tester = udf::UDFTester<ScriptReferenceUDF<>>();
   auto res = udf_tester.ForInput("text", "px/script").Result();
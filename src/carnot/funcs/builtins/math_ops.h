@@ -34,6 +34,12 @@ template <typename TReturn, typename TArg1, typename TArg2>
 class AddUDF : public udf::ScalarUDF {
  public:
   TReturn Exec(FunctionContext*, TArg1 b1, TArg2 b2) { return b1.val + b2.val; }
+  void ExecBatch(FunctionContext*, udf::BatchArg<TArg1> b1, udf::BatchArg<TArg2> b2,
+                 udf::BatchOut<TReturn> out) {
+    for (size_t i = 0; i < out.size(); ++i) {
+      out[i] = b1[i] + b2[i];
+    }
+  }
   static udf::InfRuleVec SemanticInferenceRules() {
     return {
         udf::InheritTypeFromArgs<AddUDF>::Create({types::ST_BYTES, types::ST_THROUGHPUT_PER_NS,
@@ -59,6 +65,12 @@ template <typename TReturn, typename TArg1, typename TArg2>
 class SubtractUDF : public udf::ScalarUDF {
  public:
   TReturn Exec(FunctionContext*, TArg1 b1, TArg2 b2) { return b1.val - b2.val; }
+  void ExecBatch(FunctionContext*, udf::BatchArg<TArg1> b1, udf::BatchArg<TArg2> b2,
+                 udf::BatchOut<TReturn> out) {
+    for (size_t i = 0; i < out.size(); ++i) {
+      out[i] = b1[i] - b2[i];
+    }
+  }
   static udf::InfRuleVec SemanticInferenceRules() {
     return {
         udf::InheritTypeFromArgs<SubtractUDF>::Create({types::ST_BYTES, types::ST_THROUGHPUT_PER_NS,
@@ -89,6 +101,12 @@ class DivideUDF : public udf::ScalarUDF {
   TReturn Exec(FunctionContext*, TArg1 b1, TArg2 b2) {
     return ReturnValueType(b1.val) / ReturnValueType(b2.val);
   }
+  void ExecBatch(FunctionContext*, udf::BatchArg<TArg1> b1, udf::BatchArg<TArg2> b2,
+                 udf::BatchOut<TReturn> out) {
+    for (size_t i = 0; i < out.size(); ++i) {
+      out[i] = ReturnValueType(b1[i]) / ReturnValueType(b2[i]);
+    }
+  }
 
   static udf::InfRuleVec SemanticInferenceRules() {
     return {udf::ExplicitRule::Create<DivideUDF>(types::ST_THROUGHPUT_PER_NS,
@@ -114,6 +132,12 @@ template <typename TReturn, typename TArg1, typename TArg2>
 class MultiplyUDF : public udf::ScalarUDF {
  public:
   TReturn Exec(FunctionContext*, TArg1 b1, TArg2 b2) { return b1.val * b2.val; }
+  void ExecBatch(FunctionContext*, udf::BatchArg<TArg1> b1, udf::BatchArg<TArg2> b2,
+                 udf::BatchOut<TReturn> out) {
+    for (size_t i = 0; i < out.size(); ++i) {
+      out[i] = b1[i] * b2[i];
+    }
+  }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Multiplies the arguments.")
         .Details("Multiplies the two values together. Accessible using the `*` operator syntax.")
@@ -369,6 +393,12 @@ template <typename TArg1, typename TArg2>
 class EqualUDF : public udf::ScalarUDF {
  public:
   BoolValue Exec(FunctionContext*, TArg1 b1, TArg2 b2) { return b1 == b2; }
+  void ExecBatch(FunctionContext*, udf::BatchArg<TArg1> b1, udf::BatchArg<TArg2> b2,
+                 udf::BatchOut<BoolValue> out) {
+    for (size_t i = 0; i < out.size(); ++i) {
+      out[i] = b1[i] == b2[i];
+    }
+  }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Returns whether the values are equal.")
         .Details(
@@ -389,6 +419,12 @@ template <typename TArg1, typename TArg2>
 class NotEqualUDF : public udf::ScalarUDF {
  public:
   BoolValue Exec(FunctionContext*, TArg1 b1, TArg2 b2) { return b1 != b2; }
+  void ExecBatch(FunctionContext*, udf::BatchArg<TArg1> b1, udf::BatchArg<TArg2> b2,
+                 udf::BatchOut<BoolValue> out) {
+    for (size_t i = 0; i < out.size(); ++i) {
+      out[i] = b1[i] != b2[i];
+    }
+  }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Returns whether the values are not equal.")
         .Details(
@@ -436,6 +472,12 @@ template <typename TArg1, typename TArg2>
 class GreaterThanUDF : public udf::ScalarUDF {
  public:
   BoolValue Exec(FunctionContext*, TArg1 b1, TArg2 b2) { return b1 > b2; }
+  void ExecBatch(FunctionContext*, udf::BatchArg<TArg1> b1, udf::BatchArg<TArg2> b2,
+                 udf::BatchOut<BoolValue> out) {
+    for (size_t i = 0; i < out.size(); ++i) {
+      out[i] = b1[i] > b2[i];
+    }
+  }
 
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder(
@@ -455,6 +497,12 @@ template <typename TArg1, typename TArg2>
 class GreaterThanEqualUDF : public udf::ScalarUDF {
  public:
   BoolValue Exec(FunctionContext*, TArg1 b1, TArg2 b2) { return b1 >= b2; }
+  void ExecBatch(FunctionContext*, udf::BatchArg<TArg1> b1, udf::BatchArg<TArg2> b2,
+                 udf::BatchOut<BoolValue> out) {
+    for (size_t i = 0; i < out.size(); ++i) {
+      out[i] = b1[i] >= b2[i];
+    }
+  }
 
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder(
@@ -475,6 +523,12 @@ template <typename TArg1, typename TArg2>
 class LessThanUDF : public udf::ScalarUDF {
  public:
   BoolValue Exec(FunctionContext*, TArg1 b1, TArg2 b2) { return b1 < b2; }
+  void ExecBatch(FunctionContext*, udf::BatchArg<TArg1> b1, udf::BatchArg<TArg2> b2,
+                 udf::BatchOut<BoolValue> out) {
+    for (size_t i = 0; i < out.size(); ++i) {
+      out[i] = b1[i] < b2[i];
+    }
+  }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Returns which value is less than the other.")
         .Example(R"doc(# Implict call.
@@ -491,6 +545,12 @@ template <typename TArg1, typename TArg2>
 class LessThanEqualUDF : public udf::ScalarUDF {
  public:
   BoolValue Exec(FunctionContext*, TArg1 b1, TArg2 b2) { return b1 <= b2; }
+  void ExecBatch(FunctionContext*, udf::BatchArg<TArg1> b1, udf::BatchArg<TArg2> b2,
+                 udf::BatchOut<BoolValue> out) {
+    for (size_t i = 0; i < out.size(); ++i) {
+      out[i] = b1[i] <= b2[i];
+    }
+  }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Returns which value is less than or equal to the the other.")
         .Example(R"doc(
@@ -553,6 +613,15 @@ class MeanUDA : public udf::UDA {
     info_.size++;
     info_.count += arg.val;
   }
+  void UpdateBatch(FunctionContext*, udf::BatchArg<TArg> args) {
+    // Accumulate in the same order as Update so that floating point results match.
+    double count = info_.count;
+    for (auto arg : args) {
+      count += arg;
+    }
+    info_.size += args.size();
+    info_.count = count;
+  }
   void Merge(FunctionContext*, const MeanUDA& other) {
     info_.size += other.info_.size;
     info_.count += other.info_.count;
@@ -596,6 +665,13 @@ template <typename TArg, typename TAggType = TArg>
 class SumUDA : public udf::UDA {
  public:
   void Update(FunctionContext*, TArg arg) { sum_ = sum_.val + arg.val; }
+  void UpdateBatch(FunctionContext*, udf::BatchArg<TArg> args) {
+    auto sum = sum_.val;
+    for (auto arg : args) {
+      sum = sum + arg;
+    }
+    sum_ = sum;
+  }
   void Merge(FunctionContext*, const SumUDA& other) { sum_ = sum_.val + other.sum_.val; }
   TAggType Finalize(FunctionContext*) { return sum_; }
   static udf::InfRuleVec SemanticInferenceRules() {
@@ -631,6 +707,13 @@ class MaxUDA : public udf::UDA {
       max_ = arg;
     }
   }
+  void UpdateBatch(FunctionContext*, udf::BatchArg<TArg> args) {
+    auto max = max_.val;
+    for (auto arg : args) {
+      max = max < arg ? arg : max;
+    }
+    max_ = max;
+  }
   void Merge(FunctionContext*, const MaxUDA& other) {
     if (other.max_.val > max_.val) {
       max_ = other.max_;
@@ -673,6 +756,13 @@ class MinUDA : public udf::UDA {
       min_ = arg;
     }
   }
+  void UpdateBatch(FunctionContext*, udf::BatchArg<TArg> args) {
+    auto min = min_.val;
+    for (auto arg : args) {
+      min = min > arg ? arg : min;
+    }
+    min_ = min;
+  }
   void Merge(FunctionContext*, const MinUDA& other) {
     if (other.min_.val < min_.val) {
       min_ = other.min_;
@@ -710,6 +800,7 @@ template <typename TArg>
 class CountUDA : public udf::UDA {
  public:
   void Update(FunctionContext*, TArg) { count_++; }
+  void UpdateBatch(FunctionContext*, udf::BatchArg<TArg> args) { count_ += args.size(); }
   void Merge(FunctionContext*, const CountUDA& other) { count_ += other.count_; }
   Int64Value Finalize(FunctionContext*) { return count_; }
 
@@ -18,13 +18,156 @@
 
 #include "src/carnot/funcs/builtins/math_sketches.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
 namespace px {
 namespace carnot {
 namespace builtins {
 
+namespace internal {
+namespace {
+
+// Sketch layout:
+//   uint8 version | varint num_centroids | varint total_weight |
+//   num_centroids * (double mean | varint weight)
+// The centroids are sorted by mean. Weights are counts, so they are stored as integers.
+constexpr uint8_t kSketchVersion = 1;
+
+void AppendVarint(uint64_t val, std::string* out) {
+  while (val >= 0x80) {
+    out->push_back(static_cast<char>((val & 0x7f) | 0x80));
+    val >>= 7;
+  }
+  out->push_back(static_cast<char>(val));
+}
+
+bool ReadVarint(std::string_view* data, uint64_t* val) {
+  *val = 0;
+  for (int shift = 0; shift < 64 && !data->empty(); shift += 7) {
+    uint8_t byte = data->front();
+    data->remove_prefix(1);
+    *val |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ReadDouble(std::string_view* data, double* val) {
+  if (data->size() < sizeof(double)) {
+    return false;
+  }
+  std::memcpy(val, data->data(), sizeof(double));
+  data->remove_prefix(sizeof(double));
+  return true;
+}
+
+// Reads the header of a sketch, and leaves data at the first centroid.
+Status ReadSketchHeader(std::string_view* data, uint64_t* num_centroids, uint64_t* total_weight) {
+  if (data->empty() || static_cast<uint8_t>(data->front()) != kSketchVersion) {
+    return error::InvalidArgument("Unknown quantile sketch version");
+  }
+  data->remove_prefix(1);
+  if (!ReadVarint(data, num_centroids) || !ReadVarint(data, total_weight)) {
+    return error::InvalidArgument("Malformed quantile sketch header");
+  }
+  return Status::OK();
+}
+
+Status ReadCentroid(std::string_view* data, double* mean, uint64_t* weight) {
+  if (!ReadDouble(data, mean) || !ReadVarint(data, weight)) {
+    return error::InvalidArgument("Malformed quantile sketch centroid");
+  }
+  return Status::OK();
+}
+
+}  // namespace
+
+std::string SerializeTDigest(tdigest::TDigest* digest) {
+  // Merges the pending values, so that all the centroids are sorted in processed().
+  digest->compress();
+  const auto& centroids = digest->processed();
+
+  uint64_t total_weight = 0;
+  for (const auto& c : centroids) {
+    total_weight += std::llround(c.weight());
+  }
+
+  std::string sketch;
+  sketch.reserve(1 + 2 * 10 + centroids.size() * (sizeof(double) + 4));
+  sketch.push_back(static_cast<char>(kSketchVersion));
+  AppendVarint(centroids.size(), &sketch);
+  AppendVarint(total_weight, &sketch);
+  for (const auto& c : centroids) {
+    double mean = c.mean();
+    sketch.append(reinterpret_cast<const char*>(&mean), sizeof(mean));
+    AppendVarint(std::llround(c.weight()), &sketch);
+  }
+  return sketch;
+}
+
+Status DeserializeTDigest(std::string_view sketch, tdigest::TDigest* digest) {
+  uint64_t num_centroids;
+  uint64_t total_weight;
+  PL_RETURN_IF_ERROR(ReadSketchHeader(&sketch, &num_centroids, &total_weight));
+  for (uint64_t i = 0; i < num_centroids; ++i) {
+    double mean;
+    uint64_t weight;
+    PL_RETURN_IF_ERROR(ReadCentroid(&sketch, &mean, &weight));
+    digest->add(mean, weight);
+  }
+  return Status::OK();
+}
+
+StatusOr<double> SketchQuantile(std::string_view sketch, double q) {
+  uint64_t num_centroids;
+  uint64_t total_weight;
+  PL_RETURN_IF_ERROR(ReadSketchHeader(&sketch, &num_centroids, &total_weight));
+  if (q < 0 || q > 1 || num_centroids == 0) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+
+  // The position of q in the cumulative weight. Each centroid sits at the middle of its weight,
+  // and the quantile is interpolated between the two centroids around the position. Before the
+  // first and after the last centroid, the extreme centroids are used as is; in a digest they
+  // have a weight of 1, so their mean is the min or max of the data.
+  const double index = q * total_weight;
+  double prev_mean = 0;
+  double prev_mid = 0;
+  double cumulative = 0;
+  for (uint64_t i = 0; i < num_centroids; ++i) {
+    double mean;
+    uint64_t weight;
+    PL_RETURN_IF_ERROR(ReadCentroid(&sketch, &mean, &weight));
+    double mid = cumulative + weight / 2.0;
+    if (index <= mid) {
+      if (i == 0) {
+        return mean;
+      }
+      double z1 = index - prev_mid;
+      double z2 = mid - index;
+      double val = (prev_mean * z2 + mean * z1) / (z1 + z2);
+      return std::clamp(val, prev_mean, mean);
+    }
+    prev_mean = mean;
+    prev_mid = mid;
+    cumulative += weight;
+  }
+  return prev_mean;
+}
+
+}  // namespace internal
+
 void RegisterMathSketchesOrDie(udf::Registry* registry) {
   registry->RegisterOrDie<QuantilesUDA<types::Int64Value>>("quantiles");
   registry->RegisterOrDie<QuantilesUDA<types::Float64Value>>("quantiles");
+
+  registry->RegisterOrDie<QuantileSketchUDA<types::Int64Value>>("quantile_sketch");
+  registry->RegisterOrDie<QuantileSketchUDA<types::Float64Value>>("quantile_sketch");
+  registry->RegisterOrDie<SketchQuantileUDF>("sketch_quantile");
 }
 
 }  // namespace builtins
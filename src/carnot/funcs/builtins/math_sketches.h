@@ -21,6 +21,10 @@
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 
+#include <limits>
+#include <string>
+#include <string_view>
+
 #include "src/carnot/udf/registry.h"
 #include "src/shared/types/types.h"
 #include "tdigest/tdigest.h"
@@ -29,6 +33,27 @@ namespace px {
 namespace carnot {
 namespace builtins {
 
+namespace internal {
+
+/**
+ * Encodes the centroids of the digest into a compact binary quantile sketch.
+ * Pending values are merged into the digest first.
+ */
+std::string SerializeTDigest(tdigest::TDigest* digest);
+
+/**
+ * Adds the centroids of a sketch produced by SerializeTDigest to the digest.
+ */
+Status DeserializeTDigest(std::string_view sketch, tdigest::TDigest* digest);
+
+/**
+ * Estimates the quantile q of a sketch produced by SerializeTDigest, in a single pass over the
+ * encoded centroids. Interpolates between centroids the same way tdigest does.
+ */
+StatusOr<double> SketchQuantile(std::string_view sketch, double q);
+
+}  // namespace internal
+
 // TODO(zasgar): PL-419 Replace this when we add support for structs.
 template <typename TArg>
 class QuantilesUDA : public udf::UDA {
@@ -37,6 +62,12 @@ class QuantilesUDA : public udf::UDA {
   void Update(FunctionContext*, TArg val) { digest_.add(val.val); }
   void Merge(FunctionContext*, const QuantilesUDA& other) { digest_.merge(&other.digest_); }
 
+  StringValue Serialize(FunctionContext*) { return internal::SerializeTDigest(&digest_); }
+
+  Status Deserialize(FunctionContext*, const StringValue& data) {
+    return internal::DeserializeTDigest(data, &digest_);
+  }
+
   StringValue Finalize(FunctionContext*) {
     rapidjson::Document d;
     d.SetObject();
@@ -81,6 +112,65 @@ class QuantilesUDA : public udf::UDA {
   tdigest::TDigest digest_;
 };
 
+// The compression of the digests behind quantile sketches. It bounds the number of centroids,
+// and so the size of a sketch, to a few hundred.
+constexpr double kQuantileSketchCompression = 100;
+
+template <typename TArg>
+class QuantileSketchUDA : public udf::UDA {
+ public:
+  QuantileSketchUDA() : digest_(kQuantileSketchCompression) {}
+  void Update(FunctionContext*, TArg val) { digest_.add(val.val); }
+  void Merge(FunctionContext*, const QuantileSketchUDA& other) { digest_.merge(&other.digest_); }
+  StringValue Finalize(FunctionContext*) { return internal::SerializeTDigest(&digest_); }
+
+  StringValue Serialize(FunctionContext*) { return internal::SerializeTDigest(&digest_); }
+
+  Status Deserialize(FunctionContext*, const StringValue& data) {
+    return internal::DeserializeTDigest(data, &digest_);
+  }
+
+  static udf::UDADocBuilder Doc() {
+    return udf::UDADocBuilder("Builds a quantile sketch of the aggregated data.")
+        .Details(
+            "Summarizes the distribution of the aggregated data in a compact binary "
+            "[tdigest](https://github.com/tdunning/t-digest) sketch. Any quantile can then be "
+            "read from the sketch with `px.sketch_quantile`, without going through JSON as with "
+            "`px.quantiles`.")
+        .Example(R"doc(
+        | # Build the sketch.
+        | df = df.agg(latency_sketch=('latency_ms', px.quantile_sketch))
+        | # Read the p99 from the sketch.
+        | df.p99 = px.sketch_quantile(df.latency_sketch, 0.99)
+        )doc")
+        .Arg("val", "The data to summarize.")
+        .Returns("The quantile sketch of the data.");
+  }
+
+ protected:
+  tdigest::TDigest digest_;
+};
+
+class SketchQuantileUDF : public udf::ScalarUDF {
+ public:
+  Float64Value Exec(FunctionContext*, StringValue sketch, Float64Value q) {
+    PL_ASSIGN_OR(double val, internal::SketchQuantile(sketch, q.val),
+                 return std::numeric_limits<double>::quiet_NaN());
+    return val;
+  }
+
+  static udf::ScalarUDFDocBuilder Doc() {
+    return udf::ScalarUDFDocBuilder("Reads a quantile from a quantile sketch.")
+        .Details(
+            "Estimates the given quantile of the data summarized by a sketch from "
+            "`px.quantile_sketch`. Returns NaN if the sketch is empty or malformed.")
+        .Example("df.p99 = px.sketch_quantile(df.latency_sketch, 0.99)")
+        .Arg("sketch", "The sketch from `px.quantile_sketch`.")
+        .Arg("q", "The quantile to read, between 0 and 1.")
+        .Returns("The estimated value at the quantile.");
+  }
+};
+
 void RegisterMathSketchesOrDie(udf::Registry* registry);
 
 }  // namespace builtins
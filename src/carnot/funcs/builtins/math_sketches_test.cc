@@ -19,9 +19,12 @@
 #include <gtest/gtest.h>
 #include <rapidjson/document.h>
 
+#include <cmath>
+
 #include "src/carnot/funcs/builtins/math_sketches.h"
 #include "src/carnot/udf/test_utils.h"
 #include "src/common/base/base.h"
+#include "src/common/testing/testing.h"
 
 namespace px {
 namespace carnot {
@@ -69,6 +72,66 @@ TEST(MathSketches, quantiles_int64) {
   EXPECT_DOUBLE_EQ(d["p99"].GetDouble(), 6);
 }
 
+TEST(MathSketches, quantiles_serialize_round_trip) {
+  auto uda_tester = udf::UDATester<QuantilesUDA<types::Float64Value>>();
+  for (int i = 1; i <= 5; ++i) {
+    uda_tester.ForInput(i);
+  }
+  // The deserialized digest is merged into an empty one.
+  auto other_tester = udf::UDATester<QuantilesUDA<types::Float64Value>>();
+  ASSERT_OK(other_tester.Deserialize(uda_tester.Serialize()));
+
+  rapidjson::Document d;
+  auto res = other_tester.Result();
+  d.Parse(res.data());
+  EXPECT_DOUBLE_EQ(d["p01"].GetDouble(), 1);
+  EXPECT_DOUBLE_EQ(d["p50"].GetDouble(), 3);
+  EXPECT_DOUBLE_EQ(d["p99"].GetDouble(), 5);
+}
+
+TEST(MathSketches, quantile_sketch) {
+  auto uda_tester = udf::UDATester<QuantileSketchUDA<types::Int64Value>>();
+  for (int i = 1; i <= 1000; ++i) {
+    uda_tester.ForInput(i);
+  }
+  types::StringValue sketch = uda_tester.Result();
+
+  auto udf_tester = udf::UDFTester<SketchQuantileUDF>();
+  EXPECT_DOUBLE_EQ(udf_tester.ForInput(sketch, 0.0).Result().val, 1);
+  EXPECT_DOUBLE_EQ(udf_tester.ForInput(sketch, 1.0).Result().val, 1000);
+  EXPECT_NEAR(udf_tester.ForInput(sketch, 0.5).Result().val, 500, 5);
+  EXPECT_NEAR(udf_tester.ForInput(sketch, 0.99).Result().val, 990, 2);
+}
+
+TEST(MathSketches, quantile_sketch_merge) {
+  auto uda_tester = udf::UDATester<QuantileSketchUDA<types::Float64Value>>();
+  auto other_tester = udf::UDATester<QuantileSketchUDA<types::Float64Value>>();
+  for (int i = 1; i <= 100; ++i) {
+    uda_tester.ForInput(i);
+    other_tester.ForInput(100 + i);
+  }
+  ASSERT_OK(uda_tester.Deserialize(other_tester.Serialize()));
+
+  auto udf_tester = udf::UDFTester<SketchQuantileUDF>();
+  types::StringValue sketch = uda_tester.Result();
+  EXPECT_DOUBLE_EQ(udf_tester.ForInput(sketch, 0.0).Result().val, 1);
+  EXPECT_DOUBLE_EQ(udf_tester.ForInput(sketch, 1.0).Result().val, 200);
+  EXPECT_NEAR(udf_tester.ForInput(sketch, 0.5).Result().val, 100, 2);
+}
+
+TEST(MathSketches, sketch_quantile_invalid) {
+  auto udf_tester = udf::UDFTester<SketchQuantileUDF>();
+  EXPECT_TRUE(std::isnan(udf_tester.ForInput("not a sketch", 0.5).Result().val));
+  EXPECT_TRUE(std::isnan(udf_tester.ForInput("", 0.5).Result().val));
+
+  auto uda_tester = udf::UDATester<QuantileSketchUDA<types::Int64Value>>();
+  types::StringValue sketch = uda_tester.ForInput(1).Result();
+  EXPECT_TRUE(std::isnan(udf_tester.ForInput(sketch, 1.5).Result().val));
+  // A truncated sketch is rejected.
+  sketch.pop_back();
+  EXPECT_TRUE(std::isnan(udf_tester.ForInput(sketch, 0.5).Result().val));
+}
+
 }  // namespace builtins
 }  // namespace carnot
 }  // namespace px
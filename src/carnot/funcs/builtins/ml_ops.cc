@@ -65,6 +65,13 @@ int load_floats_from_json(std::string in, Eigen::VectorXf* out, int max_num) {
   return count;
 }
 
+int load_floats(std::string_view in, Eigen::VectorXf* out, int max_num) {
+  if (exec::ml::IsFloatVector(in)) {
+    return exec::ml::DecodeFloatVector(in, out->data(), max_num);
+  }
+  return load_floats_from_json(std::string(in), out, max_num);
+}
+
 std::string write_ints_to_json(int* arr, int num) {
   // Copy output to json array.
   rapidjson::StringBuffer sb;
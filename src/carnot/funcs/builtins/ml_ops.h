@@ -26,9 +26,13 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include <absl/strings/escaping.h>
+
 #include "src/carnot/exec/ml/coreset.h"
+#include "src/carnot/exec/ml/float_vector.h"
 #include "src/carnot/exec/ml/kmeans.h"
 #include "src/carnot/exec/ml/model_executor.h"
 #include "src/carnot/exec/ml/sampling.h"
@@ -47,8 +51,17 @@ using exec::ml::KMeans;
 using exec::ml::KMeansCoreset;
 
 int load_floats_from_json(std::string in, Eigen::VectorXf* out, int max_num);
+/**
+ * Loads an embedding, either encoded with exec::ml::EncodeFloatVector or as a JSON array.
+ * Returns the number of values loaded.
+ */
+int load_floats(std::string_view in, Eigen::VectorXf* out, int max_num);
 std::string write_ints_to_json(int* arr, int num);
 
+/**
+ * Computes the embedding of a document, as a float vector encoded with
+ * exec::ml::EncodeFloatVector.
+ */
 class TransformerUDF : public udf::ScalarUDF {
  public:
   TransformerUDF() : TransformerUDF("/embedding.proto") {}
@@ -61,6 +74,14 @@ class TransformerUDF : public udf::ScalarUDF {
     return output;
   }
 
+  // Borrows the executor once for the whole batch, and runs batched inference.
+  void ExecBatch(FunctionContext* ctx, udf::BatchArg<StringValue> docs,
+                 udf::BatchOut<StringValue> out) {
+    auto executor =
+        ctx->model_pool()->GetModelExecutor<exec::ml::TransformerExecutor>(model_proto_path_);
+    executor->ExecuteBatch(docs, out);
+  }
+
  private:
   std::string model_proto_path_;
 };
@@ -89,15 +110,14 @@ class KMeansUDA : public udf::UDA {
  public:
   KMeansUDA() : KMeansUDA(64) {}
   explicit KMeansUDA(int d)
-      : d_(d), coreset_(/*base_bucket_size*/ 64, d, /*r*/ 4, /*coreset_size*/ 64) {}
+      : d_(d), coreset_(/*base_bucket_size*/ 64, d, /*r*/ 4, /*coreset_size*/ 64), point_(d) {}
   void Update(FunctionContext*, StringValue in, Int64Value k) {
     if (k_ == -1) {
       k_ = k.val;
     }
-    Eigen::VectorXf point(d_);
-    int d = load_floats_from_json(in, &point, d_);
+    int d = load_floats(in, &point_, d_);
     DCHECK_EQ(d_, d);
-    coreset_.Update(point);
+    coreset_.Update(point_);
   }
   void Merge(FunctionContext*, const KMeansUDA& other) { coreset_.Merge(other.coreset_); }
   StringValue Finalize(FunctionContext*) {
@@ -107,38 +127,49 @@ class KMeansUDA : public udf::UDA {
     return kmeans.ToJSON();
   }
 
-  StringValue Serialize(FunctionContext*) { return coreset_.ToJSON(); }
+  // The binary coreset is base64 encoded, since the partial results are sent in string columns.
+  StringValue Serialize(FunctionContext*) { return absl::Base64Escape(coreset_.Serialize()); }
 
   Status Deserialize(FunctionContext*, const StringValue& data) {
-    coreset_.FromJSON(data);
-    return Status::OK();
+    if (!data.empty() && data[0] == '{') {
+      // Partial results from agents that still serialize coresets to JSON.
+      coreset_.FromJSON(data);
+      return Status::OK();
+    }
+    std::string serialized;
+    if (!absl::Base64Unescape(data, &serialized)) {
+      return error::InvalidArgument("Malformed serialized coreset");
+    }
+    return coreset_.Deserialize(serialized);
   }
 
  protected:
   int d_;
   int k_ = -1;
   CoresetDriver<CoresetTree<KMeansCoreset>> coreset_;
+  // Reused across calls to Update, to avoid an allocation per row.
+  Eigen::VectorXf point_;
 };
 
 class KMeansUDF : public udf::ScalarUDF {
  public:
   KMeansUDF() : KMeansUDF(64) {}
-  explicit KMeansUDF(int d) : d_(d) {}
+  explicit KMeansUDF(int d) : d_(d), point_(d) {}
 
   Int64Value Exec(FunctionContext*, StringValue embedding, StringValue kmeans_json) {
     if (kmeans_ == nullptr) {
       kmeans_ = std::make_unique<KMeans>(0);
       kmeans_->FromJSON(kmeans_json);
     }
-    Eigen::VectorXf point(d_);
-    int d = load_floats_from_json(embedding, &point, d_);
+    int d = load_floats(embedding, &point_, d_);
     DCHECK_EQ(d_, d);
-    return kmeans_->Transform(point);
+    return kmeans_->Transform(point_);
   }
 
  private:
   int d_;
   std::unique_ptr<KMeans> kmeans_;
+  Eigen::VectorXf point_;
 };
 
 template <typename TArg>
@@ -18,6 +18,7 @@
 
 #include <gflags/gflags.h>
 #include <gmock/gmock.h>
+#include <algorithm>
 #include <memory>
 #include <numeric>
 #include <string>
@@ -25,6 +26,9 @@
 #include <utility>
 #include <vector>
 
+#include <absl/strings/ascii.h>
+#include <absl/strings/str_cat.h>
+
 #include "src/carnot/funcs/builtins/ml_ops.h"
 #include "src/carnot/udf/test_utils.h"
 #include "src/common/base/base.h"
@@ -51,6 +55,29 @@ std::string write_vector_to_json(const Eigen::VectorXf& vector) {
   return sb.GetString();
 }
 
+bool IsPrintable(std::string_view str) {
+  return std::all_of(str.begin(), str.end(), [](char c) { return absl::ascii_isprint(c); });
+}
+
+TEST(FloatVector, encoding) {
+  std::vector<float> values = {1.5, -2.25, 0, 3e-20};
+  std::string encoded = exec::ml::EncodeFloatVector(values.data(), values.size());
+  ASSERT_TRUE(exec::ml::IsFloatVector(encoded));
+  // The encoding goes in string columns, so it must be text.
+  EXPECT_TRUE(IsPrintable(encoded));
+
+  Eigen::VectorXf decoded(values.size());
+  ASSERT_EQ(values.size(), load_floats(encoded, &decoded, values.size()));
+  EXPECT_THAT(std::vector<float>(decoded.data(), decoded.data() + decoded.size()),
+              ::testing::ElementsAreArray(values));
+  // Only max_num values are decoded.
+  EXPECT_EQ(2, load_floats(encoded, &decoded, 2));
+
+  // Malformed encodings decode no values.
+  EXPECT_EQ(0, load_floats(absl::StrCat(exec::ml::kFloatVectorPrefix, "!!!!"), &decoded, 4));
+  EXPECT_EQ(0, load_floats(absl::StrCat(exec::ml::kFloatVectorPrefix, "AAA="), &decoded, 4));
+}
+
 TEST(KMeans, basic) {
   int k = 3;
   int d = 2;
@@ -71,6 +98,42 @@ TEST(KMeans, basic) {
   EXPECT_THAT(kmeans.centroids(), UnorderedRowsAre(expected_centroids, 0.1));
 }
 
+TEST(KMeans, float_vector_input) {
+  int k = 3;
+  int d = 2;
+
+  auto kmeans_uda_tester = udf::UDATester<KMeansUDA>(d);
+
+  Eigen::MatrixXf expected_centroids = kmeans_expected_centroids();
+  Eigen::MatrixXf points = kmeans_test_data();
+
+  for (int i = 0; i < points.rows(); i++) {
+    Eigen::VectorXf point = points(i, Eigen::all).transpose();
+    kmeans_uda_tester.ForInput(exec::ml::EncodeFloatVector(point.data(), d), k);
+  }
+
+  auto res = kmeans_uda_tester.Result();
+  px::carnot::exec::ml::KMeans kmeans(k);
+  kmeans.FromJSON(res);
+  EXPECT_THAT(kmeans.centroids(), UnorderedRowsAre(expected_centroids, 0.1));
+
+  // The partial results are sent in string columns too.
+  auto serialized = kmeans_uda_tester.Serialize();
+  EXPECT_TRUE(IsPrintable(serialized));
+  auto merged_tester = udf::UDATester<KMeansUDA>(d);
+  ASSERT_OK(merged_tester.Deserialize(serialized));
+  EXPECT_NOT_OK(merged_tester.Deserialize("\x01not base64"));
+
+  auto kmeans_udf_tester = udf::UDFTester<KMeansUDF>(d);
+  for (int i = 0; i < expected_centroids.rows(); i++) {
+    Eigen::VectorXf centroid = expected_centroids(i, Eigen::all).transpose();
+    auto embedding = exec::ml::EncodeFloatVector(centroid.data(), d);
+    auto json = write_vector_to_json(centroid);
+    EXPECT_EQ(kmeans_udf_tester.ForInput(embedding, res).Result().val,
+              kmeans_udf_tester.ForInput(json, res).Result().val);
+  }
+}
+
 TEST(SentencePiece, basic) {
   auto udf_tester = udf::UDFTester<SentencePieceUDF>(FLAGS_sentencepiece_dir);
   udf_tester.ForInput("Test 123!");
@@ -83,10 +146,10 @@ TEST(Transformer, basic) {
   auto pool = exec::ml::ModelPool::Create();
   auto ctx = std::make_unique<FunctionContext>(nullptr, pool.get());
   auto udf_tester = udf::UDFTester<TransformerUDF>(std::move(ctx), FLAGS_embedding_dir);
-  udf_tester.ForInput("[4,197,803,195,16,5001]");
+  auto embedding = udf_tester.ForInput("[4,197,803,195,16,5001]").Result();
   // This test is just a sanity check to see that the transformer UDF runs.
   // If the model changes this test will fail.
-  udf_tester.Expect(
+  constexpr char kExpectedEmbedding[] =
       "[8.423064231872559,1.762765645980835,17.635025024414064,15.878694534301758,-1."
       "3718032836914063,8.416397094726563,3.800554037094116,14.292364120483399,8.203149795532227,"
       "15.849493026733399,13.610809326171875,1.56343674659729,-0.3372507393360138,3."
@@ -147,7 +210,15 @@ TEST(Transformer, basic) {
       "8550132513046265,0.5778014659881592,0.1923011839389801,0.11267414689064026,0."
       "05414436757564545,0.8641302585601807,0.8690036535263062,1.4261415004730225,0.58112633228302,"
       "1.9074645042419434,-0.12592265009880067,0.6470710635185242,0.5493981838226318,-0."
-      "15099024772644044,-0.10007300972938538,1.1897741556167603]");
+      "15099024772644044,-0.10007300972938538,1.1897741556167603]";
+  const int embedding_size = 256;
+  ASSERT_TRUE(exec::ml::IsFloatVector(embedding));
+  EXPECT_TRUE(IsPrintable(embedding));
+  Eigen::VectorXf actual(embedding_size);
+  Eigen::VectorXf expected(embedding_size);
+  ASSERT_EQ(embedding_size, load_floats(embedding, &actual, embedding_size));
+  ASSERT_EQ(embedding_size, load_floats(kExpectedEmbedding, &expected, embedding_size));
+  EXPECT_TRUE(actual.isApprox(expected));
 }
 
 }  // namespace builtins
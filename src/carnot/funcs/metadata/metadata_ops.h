@@ -109,6 +109,7 @@ class PodIDToPodNameUDF : public ScalarUDF {
 
     return "";
   }
+  static constexpr bool MemoizeExec() { return true; }
   static udf::InfRuleVec SemanticInferenceRules() {
     return {udf::ExplicitRule::Create<PodIDToPodNameUDF>(types::ST_POD_NAME, {types::ST_NONE})};
   }
@@ -128,6 +129,7 @@ class PodNameToPodIDUDF : public ScalarUDF {
     return GetPodID(md, pod_name);
   }
 
+  static constexpr bool MemoizeExec() { return true; }
   static StringValue GetPodID(const px::md::AgentMetadataState* md, StringValue pod_name) {
     // This UDF expects the pod name to be in the format of "<ns>/<pod-name>".
     PL_ASSIGN_OR(auto pod_name_view, internal::K8sName(pod_name), return "");
@@ -156,6 +158,7 @@ class PodNameToPodIPUDF : public ScalarUDF {
     return pod_info->pod_ip();
   }
 
+  static constexpr bool MemoizeExec() { return true; }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Get the IP address of a pod from its name.")
         .Details("Gets the IP address for the pod from its name.")
@@ -177,6 +180,7 @@ class PodIDToNamespaceUDF : public ScalarUDF {
 
     return "";
   }
+  static constexpr bool MemoizeExec() { return true; }
   static udf::InfRuleVec SemanticInferenceRules() {
     return {
         udf::ExplicitRule::Create<PodIDToNamespaceUDF>(types::ST_NAMESPACE_NAME, {types::ST_NONE})};
@@ -225,6 +229,7 @@ class UPIDToContainerIDUDF : public ScalarUDF {
     return pid->cid();
   }
 
+  static constexpr bool MemoizeExec() { return true; }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Get the Kubernetes container ID from a UPID.")
         .Details(
@@ -263,6 +268,7 @@ class UPIDToContainerNameUDF : public ScalarUDF {
     return std::string(container_info->name());
   }
 
+  static constexpr bool MemoizeExec() { return true; }
   static udf::InfRuleVec SemanticInferenceRules() {
     return {udf::ExplicitRule::Create<UPIDToContainerNameUDF>(types::ST_CONTAINER_NAME,
                                                               {types::ST_NONE})};
@@ -328,6 +334,7 @@ class UPIDToNamespaceUDF : public ScalarUDF {
     return pod_info->ns();
   }
 
+  static constexpr bool MemoizeExec() { return true; }
   static udf::InfRuleVec SemanticInferenceRules() {
     return {
         udf::ExplicitRule::Create<UPIDToNamespaceUDF>(types::ST_NAMESPACE_NAME, {types::ST_NONE})};
@@ -360,6 +367,7 @@ class UPIDToPodIDUDF : public ScalarUDF {
     return std::string(container_info->pod_id());
   }
 
+  static constexpr bool MemoizeExec() { return true; }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Get the Kubernetes Pod ID from a UPID.")
         .Details(
@@ -387,6 +395,7 @@ class UPIDToPodNameUDF : public ScalarUDF {
     return absl::Substitute("$0/$1", pod_info->ns(), pod_info->name());
   }
 
+  static constexpr bool MemoizeExec() { return true; }
   static udf::InfRuleVec SemanticInferenceRules() {
     return {udf::ExplicitRule::Create<UPIDToPodNameUDF>(types::ST_POD_NAME, {types::ST_NONE})};
   }
@@ -419,6 +428,7 @@ class ServiceIDToServiceNameUDF : public ScalarUDF {
 
     return "";
   }
+  static constexpr bool MemoizeExec() { return true; }
   static udf::InfRuleVec SemanticInferenceRules() {
     return {udf::ExplicitRule::Create<ServiceIDToServiceNameUDF>(types::ST_SERVICE_NAME,
                                                                  {types::ST_NONE})};
@@ -445,6 +455,7 @@ class ServiceIDToClusterIPUDF : public ScalarUDF {
     }
     return "";
   }
+  static constexpr bool MemoizeExec() { return true; }
   static udf::InfRuleVec SemanticInferenceRules() {
     return {
         udf::ExplicitRule::Create<ServiceIDToClusterIPUDF>(types::ST_IP_ADDRESS, {types::ST_NONE})};
@@ -470,6 +481,7 @@ class ServiceIDToExternalIPsUDF : public ScalarUDF {
     }
     return "";
   }
+  static constexpr bool MemoizeExec() { return true; }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder(
                "Convert the Kubernetes service ID to its external IP addresses.")
@@ -492,6 +504,7 @@ class ServiceNameToServiceIDUDF : public ScalarUDF {
     auto service_id = md->k8s_metadata_state().ServiceIDByName(service_name_view);
     return service_id;
   }
+  static constexpr bool MemoizeExec() { return true; }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Convert the service name to the service ID.")
         .Details(
@@ -557,6 +570,7 @@ class UPIDToServiceIDUDF : public ScalarUDF {
     return StringifyVector(running_service_ids);
   }
 
+  static constexpr bool MemoizeExec() { return true; }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Get the Service ID from a UPID.")
         .Details(
@@ -598,6 +612,7 @@ class UPIDToServiceNameUDF : public ScalarUDF {
     }
     return StringifyVector(running_service_names);
   }
+  static constexpr bool MemoizeExec() { return true; }
   static udf::InfRuleVec SemanticInferenceRules() {
     return {
         udf::ExplicitRule::Create<UPIDToServiceNameUDF>(types::ST_SERVICE_NAME, {types::ST_NONE})};
@@ -634,6 +649,7 @@ class UPIDToNodeNameUDF : public ScalarUDF {
     std::string foo = std::string(pod_info->node_name());
     return foo;
   }
+  static constexpr bool MemoizeExec() { return true; }
   static udf::InfRuleVec SemanticInferenceRules() {
     return {udf::ExplicitRule::Create<UPIDToNodeNameUDF>(types::ST_NODE_NAME, {types::ST_NONE})};
   }
@@ -665,6 +681,7 @@ class UPIDToHostnameUDF : public ScalarUDF {
     }
     return pod_info->hostname();
   }
+  static constexpr bool MemoizeExec() { return true; }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Get the Hostname from a UPID.")
         .Details(
@@ -706,6 +723,7 @@ class PodIDToServiceNameUDF : public ScalarUDF {
     }
     return StringifyVector(running_service_names);
   }
+  static constexpr bool MemoizeExec() { return true; }
   static udf::InfRuleVec SemanticInferenceRules() {
     return {
         udf::ExplicitRule::Create<PodIDToServiceNameUDF>(types::ST_SERVICE_NAME, {types::ST_NONE})};
@@ -747,6 +765,7 @@ class PodIDToServiceIDUDF : public ScalarUDF {
     }
     return StringifyVector(running_service_ids);
   }
+  static constexpr bool MemoizeExec() { return true; }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Get the service ID for a given pod ID.")
         .Details(
@@ -773,6 +792,7 @@ class PodIDToNodeNameUDF : public ScalarUDF {
     std::string foo = std::string(pod_info->node_name());
     return foo;
   }
+  static constexpr bool MemoizeExec() { return true; }
   static udf::InfRuleVec SemanticInferenceRules() {
     return {udf::ExplicitRule::Create<PodIDToNodeNameUDF>(types::ST_NODE_NAME, {types::ST_NONE})};
   }
@@ -817,6 +837,7 @@ class PodNameToServiceNameUDF : public ScalarUDF {
     }
     return StringifyVector(running_service_names);
   }
+  static constexpr bool MemoizeExec() { return true; }
   static udf::InfRuleVec SemanticInferenceRules() {
     return {udf::ExplicitRule::Create<PodNameToServiceNameUDF>(types::ST_SERVICE_NAME,
                                                                {types::ST_POD_NAME})};
@@ -862,6 +883,7 @@ class PodNameToServiceIDUDF : public ScalarUDF {
     }
     return StringifyVector(running_service_ids);
   }
+  static constexpr bool MemoizeExec() { return true; }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Get the service ID for a given pod name.")
         .Details(
@@ -925,6 +947,7 @@ class PodIDToPodStartTimeUDF : public ScalarUDF {
     }
     return pod_info->start_time_ns();
   }
+  static constexpr bool MemoizeExec() { return true; }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Get the start time of a pod from its ID.")
         .Details("Gets the start time (in nanosecond unix time format) of a pod from its pod ID.")
@@ -944,6 +967,7 @@ class PodIDToPodStopTimeUDF : public ScalarUDF {
     }
     return pod_info->stop_time_ns();
   }
+  static constexpr bool MemoizeExec() { return true; }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Get the stop time of a pod from its ID.")
         .Details("Gets the stop time (in nanosecond unix time format) of a pod from its pod ID.")
@@ -964,6 +988,7 @@ class PodNameToPodStartTimeUDF : public ScalarUDF {
     }
     return pod_info->start_time_ns();
   }
+  static constexpr bool MemoizeExec() { return true; }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Get the start time of a pod from its name.")
         .Details("Gets the start time (in nanosecond unix time format) of a pod from its name.")
@@ -984,6 +1009,7 @@ class PodNameToPodStopTimeUDF : public ScalarUDF {
     }
     return pod_info->stop_time_ns();
   }
+  static constexpr bool MemoizeExec() { return true; }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Get the stop time of a pod from its name.")
         .Details("Gets the stop time (in nanosecond unix time format) of a pod from its name.")
@@ -1000,6 +1026,7 @@ class ContainerNameToContainerIDUDF : public ScalarUDF {
     return md->k8s_metadata_state().ContainerIDByName(container_name);
   }
 
+  static constexpr bool MemoizeExec() { return true; }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Get the id of a container from its name.")
         .Details("Gets the kubernetes ID for the container from its name.")
@@ -1020,6 +1047,7 @@ class ContainerIDToContainerStartTimeUDF : public ScalarUDF {
     }
     return container_info->start_time_ns();
   }
+  static constexpr bool MemoizeExec() { return true; }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Get the start time of a container from its ID.")
         .Details(
@@ -1042,6 +1070,7 @@ class ContainerIDToContainerStopTimeUDF : public ScalarUDF {
     }
     return container_info->stop_time_ns();
   }
+  static constexpr bool MemoizeExec() { return true; }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Get the stop time of a container from its ID.")
         .Details(
@@ -1065,6 +1094,7 @@ class ContainerNameToContainerStartTimeUDF : public ScalarUDF {
     }
     return container_info->start_time_ns();
   }
+  static constexpr bool MemoizeExec() { return true; }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Get the start time of a container from its name.")
         .Details(
@@ -1087,6 +1117,7 @@ class ContainerNameToContainerStopTimeUDF : public ScalarUDF {
     }
     return container_info->stop_time_ns();
   }
+  static constexpr bool MemoizeExec() { return true; }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Get the stop time of a container from its name.")
         .Details(
@@ -1158,6 +1189,7 @@ class PodNameToPodStatusUDF : public ScalarUDF {
     return PodInfoToPodStatus(pod_info);
   }
 
+  static constexpr bool MemoizeExec() { return true; }
   static udf::InfRuleVec SemanticInferenceRules() {
     return {
         udf::ExplicitRule::Create<PodNameToPodStatusUDF>(types::ST_POD_STATUS, {types::ST_NONE})};
@@ -1195,6 +1227,7 @@ class PodNameToPodReadyUDF : public ScalarUDF {
     return ready_status->second == md::PodConditionStatus::kTrue;
   }
 
+  static constexpr bool MemoizeExec() { return true; }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Get readiness information about the given pod.")
         .Details(
@@ -1229,6 +1262,8 @@ class PodNameToPodStatusMessageUDF : public ScalarUDF {
     }
     return pod_info->phase_message();
   }
+
+  static constexpr bool MemoizeExec() { return true; }
 };
 
 class PodNameToPodStatusReasonUDF : public ScalarUDF {
@@ -1249,6 +1284,8 @@ class PodNameToPodStatusReasonUDF : public ScalarUDF {
     }
     return pod_info->phase_reason();
   }
+
+  static constexpr bool MemoizeExec() { return true; }
 };
 
 inline std::string ContainerStateToString(const px::md::ContainerState& container_state) {
@@ -1297,6 +1334,7 @@ class ContainerIDToContainerStatusUDF : public ScalarUDF {
     return sb.GetString();
   }
 
+  static constexpr bool MemoizeExec() { return true; }
   static udf::InfRuleVec SemanticInferenceRules() {
     return {udf::ExplicitRule::Create<ContainerIDToContainerStatusUDF>(types::ST_CONTAINER_STATUS,
                                                                        {types::ST_NONE})};
@@ -1329,6 +1367,7 @@ class UPIDToPodStatusUDF : public ScalarUDF {
     return PodInfoToPodStatus(UPIDtoPod(md, upid_value));
   }
 
+  static constexpr bool MemoizeExec() { return true; }
   static udf::InfRuleVec SemanticInferenceRules() {
     return {udf::ExplicitRule::Create<UPIDToPodStatusUDF>(types::ST_POD_STATUS, {types::ST_NONE})};
   }
@@ -1374,6 +1413,7 @@ class UPIDToCmdLineUDF : public ScalarUDF {
     return pid_info->cmdline();
   }
 
+  static constexpr bool MemoizeExec() { return true; }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Get the command line arguments used to start a UPID.")
         .Details(
@@ -1408,6 +1448,7 @@ class UPIDToPodQoSUDF : public ScalarUDF {
     auto md = GetMetadataState(ctx);
     return PodInfoToPodQoS(UPIDtoPod(md, upid_value));
   }
+  static constexpr bool MemoizeExec() { return true; }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Get the Kubernetes QOS class for the UPID.")
         .Details(
@@ -1471,6 +1512,7 @@ class IPToPodIDUDF : public ScalarUDF {
     auto md = GetMetadataState(ctx);
     return md->k8s_metadata_state().PodIDByIP(pod_ip);
   }
+  static constexpr bool MemoizeExec() { return true; }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder(
                "Convert IP address to the kubernetes pod ID that runs the backing service.")
@@ -1513,6 +1555,7 @@ class IPToServiceIDUDF : public ScalarUDF {
     return udf.Exec(ctx, pod_id);
   }
 
+  static constexpr bool MemoizeExec() { return true; }
   static udf::ScalarUDFDocBuilder Doc() {
     return udf::ScalarUDFDocBuilder("Get the service ID for a given IP.")
         .Details(
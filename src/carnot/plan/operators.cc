@@ -74,6 +74,8 @@ std::unique_ptr<Operator> Operator::FromProto(const planpb::Operator& pb, int64_
       return CreateOperator<FilterOperator>(id, pb.filter_op());
     case planpb::LIMIT_OPERATOR:
       return CreateOperator<LimitOperator>(id, pb.limit_op());
+    case planpb::TOPK_OPERATOR:
+      return CreateOperator<TopKOperator>(id, pb.topk_op());
     case planpb::UNION_OPERATOR:
       return CreateOperator<UnionOperator>(id, pb.union_op());
     case planpb::JOIN_OPERATOR:
@@ -212,6 +214,20 @@ Status AggregateOperator::Init(const planpb::AggregateOperator& pb) {
   for (int idx = 0; idx < pb_.groups_size(); ++idx) {
     groups_.emplace_back(GroupInfo{pb_.group_names(idx), pb_.groups(idx).index()});
   }
+  if (rolling()) {
+    if (rolling_window_size() <= 0 || rolling_slide() <= 0) {
+      return error::InvalidArgument("Rolling window size and slide must be positive, got $0 and $1",
+                                    rolling_window_size(), rolling_slide());
+    }
+    if (rolling_window_size() % rolling_slide() != 0) {
+      return error::InvalidArgument("Rolling window size $0 is not a multiple of the slide $1",
+                                    rolling_window_size(), rolling_slide());
+    }
+    if (pb_.windowed() || pb_.partial_agg() != pb_.finalize_results()) {
+      return error::InvalidArgument(
+          "Rolling aggregates can't be windowed or split into partial aggregates");
+    }
+  }
 
   is_initialized_ = true;
   return Status::OK();
@@ -232,6 +248,24 @@ StatusOr<table_store::schema::Relation> AggregateOperator::OutputRelation(
   PL_ASSIGN_OR_RETURN(const auto& input_relation, schema.GetRelation(input_ids[0]));
   table_store::schema::Relation output_relation;
 
+  if (rolling()) {
+    const auto& time_col = pb_.rolling_window().time_col();
+    if (time_col.node() != input_ids[0]) {
+      return error::InvalidArgument("Column $0 does not belong to the correct input node $1",
+                                    time_col.index(), time_col.node());
+    }
+    if (time_col.index() >= static_cast<int64_t>(input_relation.NumColumns())) {
+      return error::InvalidArgument("Column index $0 is out of bounds for node $1",
+                                    time_col.index(), time_col.node());
+    }
+    auto time_type = input_relation.GetColumnType(time_col.index());
+    if (time_type != types::TIME64NS && time_type != types::INT64) {
+      return error::InvalidArgument("Rolling window column must be a time, got $0",
+                                    magic_enum::enum_name(time_type));
+    }
+    output_relation.AddColumn(time_type, input_relation.GetColumnName(time_col.index()));
+  }
+
   for (int idx = 0; idx < pb_.groups_size(); ++idx) {
     int64_t node_id = pb_.groups(idx).node();
     int64_t col_idx = pb_.groups(idx).index();
@@ -448,6 +482,81 @@ StatusOr<table_store::schema::Relation> LimitOperator::OutputRelation(
   return output_relation;
 }
 
+/**
+ * TopK Operator Implementation.
+ */
+std::string TopKOperator::DebugString() const {
+  std::vector<std::string> sort_cols;
+  for (size_t i = 0; i < sort_cols_.size(); ++i) {
+    sort_cols.push_back(absl::Substitute("$0 $1", sort_cols_[i],
+                                         sort_descending_[i] ? "desc" : "asc"));
+  }
+  std::string debug_string =
+      absl::Substitute("(sort: [$0], limit: $1, cols: [$2])", absl::StrJoin(sort_cols, ","),
+                       pb_.limit(), absl::StrJoin(selected_cols_, ","));
+  return "Op:TopK" + debug_string;
+}
+
+Status TopKOperator::Init(const planpb::TopKOperator& pb) {
+  pb_ = pb;
+  if (pb_.sort_columns_size() == 0) {
+    return error::InvalidArgument("TopK operator must sort by at least one column");
+  }
+  if (pb_.limit() < 0) {
+    return error::InvalidArgument("TopK operator limit must be non-negative, got $0", pb_.limit());
+  }
+
+  sort_cols_.reserve(pb_.sort_columns_size());
+  sort_descending_.reserve(pb_.sort_columns_size());
+  for (const auto& sort_col : pb_.sort_columns()) {
+    sort_cols_.push_back(sort_col.column().index());
+    sort_descending_.push_back(sort_col.descending());
+  }
+
+  selected_cols_.reserve(pb_.columns_size());
+  for (auto i = 0; i < pb_.columns_size(); ++i) {
+    selected_cols_.push_back(pb_.columns(i).index());
+  }
+
+  is_initialized_ = true;
+  return Status::OK();
+}
+
+StatusOr<table_store::schema::Relation> TopKOperator::OutputRelation(
+    const table_store::schema::Schema& schema, const PlanState& /*state*/,
+    const std::vector<int64_t>& input_ids) const {
+  DCHECK(is_initialized_) << "Not initialized";
+
+  if (input_ids.size() != 1) {
+    return error::InvalidArgument("TopK operator must have exactly one input");
+  }
+  if (!schema.HasRelation(input_ids[0])) {
+    return error::NotFound("Missing relation ($0) for input of TopKOperator", input_ids[0]);
+  }
+
+  PL_ASSIGN_OR_RETURN(const table_store::schema::Relation& input_relation,
+                      schema.GetRelation(input_ids[0]));
+  for (auto sort_col_idx : sort_cols_) {
+    if (sort_col_idx < 0 || sort_col_idx >= static_cast<int64_t>(input_relation.NumColumns())) {
+      return error::InvalidArgument(
+          "Sort column index $0 is out of bounds, number of columns is $1", sort_col_idx,
+          input_relation.NumColumns());
+    }
+  }
+
+  table_store::schema::Relation output_relation;
+  for (auto selected_col_idx : selected_cols_) {
+    CHECK_LT(selected_col_idx, static_cast<int64_t>(input_relation.NumColumns()))
+        << absl::Substitute("Column index $0 is out of bounds, number of columns is $1",
+                            selected_col_idx, input_relation.NumColumns());
+
+    output_relation.AddColumn(input_relation.GetColumnType(selected_col_idx),
+                              input_relation.GetColumnName(selected_col_idx),
+                              input_relation.GetColumnDesc(selected_col_idx));
+  }
+  return output_relation;
+}
+
 /**
  * Zip Operator Implementation.
  */
@@ -96,6 +96,10 @@ class MemorySourceOperator : public Operator {
   std::vector<int64_t> Columns() const { return column_idxs_; }
   const types::TabletID& Tablet() const { return pb_.tablet(); }
   bool infinite_stream() const { return pb_.streaming(); }
+  bool HasPartitionFilter() const { return pb_.has_partition_filter(); }
+  const planpb::MemorySourceOperator::PartitionFilter& partition_filter() const {
+    return pb_.partition_filter();
+  }
 
  private:
   planpb::MemorySourceOperator pb_;
@@ -143,6 +147,14 @@ class AggregateOperator : public Operator {
   const std::vector<GroupInfo>& groups() const { return groups_; }
   const std::vector<std::shared_ptr<AggregateExpression>>& values() const { return values_; }
   bool windowed() const { return pb_.windowed(); }
+  bool rolling() const { return pb_.has_rolling_window(); }
+  // The index of the input column that rolling windows slide along.
+  int64_t rolling_time_col_idx() const { return pb_.rolling_window().time_col().index(); }
+  int64_t rolling_window_size() const { return pb_.rolling_window().window_size(); }
+  int64_t rolling_slide() const {
+    return pb_.rolling_window().slide() > 0 ? pb_.rolling_window().slide()
+                                             : pb_.rolling_window().window_size();
+  }
 
  private:
   std::vector<std::shared_ptr<AggregateExpression>> values_;
@@ -261,6 +273,31 @@ class LimitOperator : public Operator {
   planpb::LimitOperator pb_;
 };
 
+class TopKOperator : public Operator {
+ public:
+  explicit TopKOperator(int64_t id) : Operator(id, planpb::TOPK_OPERATOR) {}
+  ~TopKOperator() override = default;
+
+  StatusOr<table_store::schema::Relation> OutputRelation(
+      const table_store::schema::Schema& schema, const PlanState& state,
+      const std::vector<int64_t>& input_ids) const override;
+  Status Init(const planpb::TopKOperator& pb);
+  std::string DebugString() const override;
+  std::vector<int64_t> selected_cols() { return selected_cols_; }
+
+  // The input columns to sort by, in order of precedence, and whether each is descending.
+  const std::vector<int64_t>& sort_cols() const { return sort_cols_; }
+  const std::vector<bool>& sort_descending() const { return sort_descending_; }
+  // The number of rows to keep, or 0 to keep them all.
+  int64_t record_limit() const { return pb_.limit(); }
+
+ private:
+  std::vector<int64_t> sort_cols_;
+  std::vector<bool> sort_descending_;
+  std::vector<int64_t> selected_cols_;
+  planpb::TopKOperator pb_;
+};
+
 class UnionOperator : public Operator {
  public:
   explicit UnionOperator(int64_t id) : Operator(id, planpb::UNION_OPERATOR) {}
@@ -239,6 +239,36 @@ TEST_F(OperatorTest, from_proto_drop_limit) {
   auto limit_typed_op = static_cast<LimitOperator*>(limit_op.get());
   EXPECT_THAT(limit_typed_op->selected_cols(), ElementsAre(0, 2));
 }
+
+TEST_F(OperatorTest, from_proto_topk) {
+  auto topk_pb = planpb::testutils::CreateTestTopK1PB();
+  auto topk_op = Operator::FromProto(topk_pb, 1);
+  EXPECT_EQ(1, topk_op->id());
+  EXPECT_TRUE(topk_op->is_initialized());
+  EXPECT_EQ(planpb::OperatorType::TOPK_OPERATOR, topk_op->op_type());
+  auto topk_typed_op = static_cast<TopKOperator*>(topk_op.get());
+  EXPECT_THAT(topk_typed_op->sort_cols(), ElementsAre(1, 0));
+  EXPECT_THAT(topk_typed_op->sort_descending(), ElementsAre(true, false));
+  EXPECT_EQ(3, topk_typed_op->record_limit());
+  EXPECT_THAT(topk_typed_op->selected_cols(), ElementsAre(0, 1));
+}
+
+TEST_F(OperatorTest, from_proto_topk_errors) {
+  auto topk_pb = planpb::testutils::CreateTestTopK1PB();
+  topk_pb.mutable_topk_op()->set_limit(-1);
+  auto topk_op = std::make_unique<TopKOperator>(1);
+  auto s = topk_op->Init(topk_pb.topk_op());
+  EXPECT_NOT_OK(s);
+  EXPECT_EQ(s.msg(), "TopK operator limit must be non-negative, got -1");
+
+  topk_pb = planpb::testutils::CreateTestTopK1PB();
+  topk_pb.mutable_topk_op()->clear_sort_columns();
+  topk_op = std::make_unique<TopKOperator>(1);
+  s = topk_op->Init(topk_pb.topk_op());
+  EXPECT_NOT_OK(s);
+  EXPECT_EQ(s.msg(), "TopK operator must sort by at least one column");
+}
+
 TEST_F(OperatorTest, from_proto_join_with_time) {
   auto join_pb = planpb::testutils::CreateTestJoinWithTimePB();
   auto join_op = std::make_unique<JoinOperator>(1);
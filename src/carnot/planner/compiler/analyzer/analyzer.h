@@ -29,6 +29,7 @@
 #include "src/carnot/planner/compiler/analyzer/convert_string_times_rule.h"
 #include "src/carnot/planner/compiler/analyzer/drop_to_map_rule.h"
 #include "src/carnot/planner/compiler/analyzer/merge_group_by_into_group_acceptor_rule.h"
+#include "src/carnot/planner/compiler/analyzer/merge_rolling_into_agg_rule.h"
 #include "src/carnot/planner/compiler/analyzer/nested_blocking_agg_fn_check_rule.h"
 #include "src/carnot/planner/compiler/analyzer/propagate_expression_annotations_rule.h"
 #include "src/carnot/planner/compiler/analyzer/remove_group_by_rule.h"
@@ -36,6 +37,7 @@
 #include "src/carnot/planner/compiler/analyzer/resolve_stream_rule.h"
 #include "src/carnot/planner/compiler/analyzer/resolve_types_rule.h"
 #include "src/carnot/planner/compiler/analyzer/restrict_columns_rule.h"
+#include "src/carnot/planner/compiler/analyzer/rollup_rewrite_rule.h"
 #include "src/carnot/planner/compiler/analyzer/set_memory_source_times_rule.h"
 #include "src/carnot/planner/compiler/analyzer/setup_join_type_rule.h"
 #include "src/carnot/planner/compiler/analyzer/unique_sink_names_rule.h"
@@ -93,12 +95,26 @@ class Analyzer : public RuleExecutor<IR> {
     intermediate_resolution_batch->AddRule<SetMemorySourceTimesRule>();
   }
 
+  void CreateMergeRollingIntoAggBatch() {
+    // Runs once the rolling window sizes are constants.
+    RuleBatch* merge_rolling = CreateRuleBatch<FailOnMax>("MergeRollingIntoAgg", 2);
+    merge_rolling->AddRule<MergeRollingIntoAggRule>();
+  }
+
   // TODO(philkuz) need to add a new optimization that combines maps.
   void CreateCombineConsecutiveMapsRule() {
     RuleBatch* consecutive_maps = CreateRuleBatch<FailOnMax>("CombineConsecutiveMapsRule", 2);
     consecutive_maps->AddRule<CombineConsecutiveMapsRule>();
   }
 
+  void CreateRollupRewriteBatch() {
+    // Runs once the maps are combined, and before the types of the rewritten operators are
+    // resolved.
+    RuleBatch* rollup_rewrite = CreateRuleBatch<FailOnMax>("RollupRewrite", 2);
+    rollup_rewrite->AddRule<RollupRewriteRule>(compiler_state_,
+                                               table_store::schema::DefaultRollupSpecs());
+  }
+
   void CreateDataTypeResolutionBatch() {
     RuleBatch* intermediate_resolution_batch =
         CreateRuleBatch<FailOnMax>("DataTypeResolution", 100);
@@ -133,7 +149,9 @@ class Analyzer : public RuleExecutor<IR> {
     CreateUniqueSinkNamesBatch();
     CreateAddLimitToBatchResultSinkBatch();
     CreateOperatorCompileTimeExpressionRuleBatch();
+    CreateMergeRollingIntoAggBatch();
     CreateCombineConsecutiveMapsRule();
+    CreateRollupRewriteBatch();
     CreateDataTypeResolutionBatch();
     CreateManageColumnAccessBatch();
     CreateMetadataConversionBatch();
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <vector>
+
+#include "src/carnot/planner/compiler/analyzer/merge_rolling_into_agg_rule.h"
+#include "src/carnot/planner/ir/int_ir.h"
+#include "src/carnot/planner/ir/metadata_ir.h"
+#include "src/carnot/planner/ir/time_ir.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace compiler {
+
+StatusOr<bool> MergeRollingIntoAggRule::Apply(IRNode* ir_node) {
+  if (Match(ir_node, Rolling())) {
+    return MergeRollingIntoAggs(static_cast<RollingIR*>(ir_node));
+  }
+  return false;
+}
+
+StatusOr<bool> MergeRollingIntoAggRule::MergeRollingIntoAggs(RollingIR* rolling) {
+  int64_t window_size;
+  ExpressionIR* window_size_expr = rolling->window_size();
+  if (Match(window_size_expr, Int())) {
+    window_size = static_cast<IntIR*>(window_size_expr)->val();
+  } else if (window_size_expr->type() == IRNodeType::kTime) {
+    window_size = static_cast<TimeIR*>(window_size_expr)->val();
+  } else {
+    return window_size_expr->CreateIRNodeError(
+        "'rolling()' window must be a constant duration, received a $0",
+        window_size_expr->type_string());
+  }
+  if (window_size <= 0) {
+    return window_size_expr->CreateIRNodeError("'rolling()' window must be positive, received $0",
+                                               window_size);
+  }
+
+  std::vector<OperatorIR*> children = rolling->Children();
+  for (OperatorIR* child : children) {
+    if (!Match(child, BlockingAgg())) {
+      return rolling->CreateIRNodeError("'rolling()' should be followed by an 'agg()' not a $0",
+                                        child->type_string());
+    }
+  }
+
+  DCHECK_EQ(rolling->parents().size(), 1UL);
+  OperatorIR* rolling_parent = rolling->parents()[0];
+  for (OperatorIR* child : children) {
+    auto agg = static_cast<BlockingAggIR*>(child);
+    std::vector<ColumnIR*> new_groups;
+    for (ColumnIR* g : rolling->groups()) {
+      PL_ASSIGN_OR_RETURN(ColumnIR * col, CopyColumn(g));
+      new_groups.push_back(col);
+    }
+    new_groups.insert(new_groups.end(), agg->groups().begin(), agg->groups().end());
+    PL_RETURN_IF_ERROR(agg->SetGroups(new_groups));
+    PL_ASSIGN_OR_RETURN(ColumnIR * window_col, CopyColumn(rolling->window_col()));
+    PL_RETURN_IF_ERROR(agg->SetRollingWindow(window_col, window_size));
+    PL_RETURN_IF_ERROR(agg->ReplaceParent(rolling, rolling_parent));
+  }
+
+  IR* graph = rolling->graph();
+  auto rolling_id = rolling->id();
+  auto rolling_children = graph->dag().DependenciesOf(rolling_id);
+  PL_RETURN_IF_ERROR(graph->DeleteNode(rolling_id));
+  for (const auto& child_id : rolling_children) {
+    PL_RETURN_IF_ERROR(graph->DeleteOrphansInSubtree(child_id));
+  }
+  return true;
+}
+
+StatusOr<ColumnIR*> MergeRollingIntoAggRule::CopyColumn(ColumnIR* col) {
+  if (Match(col, Metadata())) {
+    return col->graph()->CreateNode<MetadataIR>(col->ast(), col->col_name(),
+                                                col->container_op_parent_idx());
+  }
+  return col->graph()->CreateNode<ColumnIR>(col->ast(), col->col_name(),
+                                            col->container_op_parent_idx());
+}
+
+}  // namespace compiler
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
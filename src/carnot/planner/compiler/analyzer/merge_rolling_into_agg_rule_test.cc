@@ -0,0 +1,94 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "src/carnot/planner/compiler/analyzer/merge_rolling_into_agg_rule.h"
+#include "src/carnot/planner/compiler/test_utils.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace compiler {
+
+using ::testing::ElementsAre;
+
+TEST_F(RulesTest, MergeRollingIntoAggRule) {
+  MemorySourceIR* mem_source = MakeMemSource();
+  RollingIR* rolling = MakeRolling(mem_source, MakeColumn("time_", 0), MakeInt(3000));
+  ASSERT_OK(rolling->SetGroups({MakeColumn("col1", 0)}));
+  BlockingAggIR* agg1 = MakeBlockingAgg(rolling, {MakeColumn("col2", 0)},
+                                        {{"outcount", MakeMeanFunc(MakeColumn("count", 0))}});
+  MakeMemSink(agg1, "");
+  BlockingAggIR* agg2 =
+      MakeBlockingAgg(rolling, {}, {{"latency_mean", MakeMeanFunc(MakeColumn("latency", 0))}});
+  MakeMemSink(agg2, "");
+  int64_t rolling_id = rolling->id();
+
+  MergeRollingIntoAggRule rule;
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_TRUE(result.ConsumeValueOrDie());
+
+  EXPECT_FALSE(graph->HasNode(rolling_id));
+  for (BlockingAggIR* agg : {agg1, agg2}) {
+    EXPECT_THAT(agg->parents(), ElementsAre(mem_source));
+    ASSERT_TRUE(agg->rolling());
+    EXPECT_EQ("time_", agg->rolling_window_col()->col_name());
+    EXPECT_EQ(3000, agg->rolling_window_size());
+  }
+
+  std::vector<std::string> group_names;
+  for (ColumnIR* g : agg1->groups()) {
+    group_names.push_back(g->col_name());
+  }
+  EXPECT_THAT(group_names, ElementsAre("col1", "col2"));
+  ASSERT_EQ(1, agg2->groups().size());
+  EXPECT_EQ("col1", agg2->groups()[0]->col_name());
+}
+
+TEST_F(RulesTest, MergeRollingIntoAggRule_FailOnNonAggChild) {
+  MemorySourceIR* mem_source = MakeMemSource();
+  RollingIR* rolling = MakeRolling(mem_source, MakeColumn("time_", 0), MakeInt(3000));
+  MakeMemSink(rolling, "");
+
+  MergeRollingIntoAggRule rule;
+  auto result = rule.Execute(graph.get());
+  ASSERT_NOT_OK(result);
+  EXPECT_THAT(result.status(), HasCompilerError("'rolling.*' should be followed by an 'agg.*'"));
+}
+
+TEST_F(RulesTest, MergeRollingIntoAggRule_FailOnNonPositiveWindow) {
+  MemorySourceIR* mem_source = MakeMemSource();
+  RollingIR* rolling = MakeRolling(mem_source, MakeColumn("time_", 0), MakeInt(0));
+  MakeMemSink(MakeBlockingAgg(rolling, {}, {{"outcount", MakeMeanFunc(MakeColumn("count", 0))}}),
+              "");
+
+  MergeRollingIntoAggRule rule;
+  auto result = rule.Execute(graph.get());
+  ASSERT_NOT_OK(result);
+  EXPECT_THAT(result.status(), HasCompilerError("'rolling.*' window must be positive"));
+}
+
+}  // namespace compiler
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,309 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/planner/compiler/analyzer/rollup_rewrite_rule.h"
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <absl/container/flat_hash_set.h>
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace compiler {
+
+using table_store::schema::RollupAggregate;
+using table_store::schema::RollupSpec;
+
+namespace {
+
+constexpr char kTimeColumn[] = "time_";
+constexpr char kUPIDColumn[] = "upid";
+
+std::optional<RollupAggregate::Kind> AggregateKind(const std::string& func_name) {
+  for (auto kind : {RollupAggregate::Kind::kCount, RollupAggregate::Kind::kSum,
+                    RollupAggregate::Kind::kMin, RollupAggregate::Kind::kMax}) {
+    if (table_store::schema::RollupAggregateFuncName(kind) == func_name) {
+      return kind;
+    }
+  }
+  return std::nullopt;
+}
+
+// The value of an int or time literal, if the expression is one.
+std::optional<int64_t> IntValue(ExpressionIR* expr) {
+  if (Match(expr, Int())) {
+    return static_cast<IntIR*>(expr)->val();
+  }
+  if (expr->type() == IRNodeType::kTime) {
+    return static_cast<TimeIR*>(expr)->val();
+  }
+  return std::nullopt;
+}
+
+// The start of the bucket that holds time_ns.
+int64_t FloorToBucket(int64_t time_ns, const RollupSpec& rollup) {
+  return time_ns - ((time_ns % rollup.bucket_ns) + rollup.bucket_ns) % rollup.bucket_ns;
+}
+
+// Aggregates the partial aggregates of func, held by col_name, again. Counts are summed.
+StatusOr<FuncIR*> Reaggregate(IR* graph, FuncIR* func, RollupAggregate::Kind kind,
+                              const std::string& col_name) {
+  std::string func_name = kind == RollupAggregate::Kind::kCount ? "sum" : func->func_name();
+  auto arg = static_cast<ColumnIR*>(func->all_args()[0]);
+  PL_ASSIGN_OR_RETURN(ColumnIR * col, graph->CreateNode<ColumnIR>(arg->ast(), col_name,
+                                                                  arg->container_op_parent_idx()));
+  return graph->CreateNode<FuncIR>(func->ast(), FuncIR::Op{FuncIR::Opcode::non_op, "", func_name},
+                                   std::vector<ExpressionIR*>{col});
+}
+
+}  // namespace
+
+bool RollupRewriteRule::IsRollupExpression(const RollupSpec& rollup, ExpressionIR* expr) const {
+  if (Match(expr, Metadata())) {
+    // Metadata is converted from the upid later on.
+    return std::find(rollup.group_by.begin(), rollup.group_by.end(), kUPIDColumn) !=
+           rollup.group_by.end();
+  }
+  if (Match(expr, ColumnNode())) {
+    const std::string& col_name = static_cast<ColumnIR*>(expr)->col_name();
+    return std::find(rollup.group_by.begin(), rollup.group_by.end(), col_name) !=
+           rollup.group_by.end();
+  }
+  if (Match(expr, Func())) {
+    auto func = static_cast<FuncIR*>(expr);
+    const auto& args = func->all_args();
+    // The time_ of the rollup is the start of its bucket, which falls in the same bins as the
+    // times of the bucket when the bins are made of whole buckets.
+    if (func->func_name() == "bin" && args.size() == 2 && Match(args[0], ColumnNode(kTimeColumn))) {
+      std::optional<int64_t> bin_size = IntValue(args[1]);
+      return bin_size.has_value() && bin_size.value() > 0 &&
+             bin_size.value() % rollup.bucket_ns == 0;
+    }
+    for (ExpressionIR* arg : args) {
+      if (!IsRollupExpression(rollup, arg)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  return Match(expr, DataNode());
+}
+
+bool RollupRewriteRule::CanAnswer(const RollupSpec& rollup, MapIR* map,
+                                  BlockingAggIR* agg) const {
+  absl::flat_hash_set<std::string> rollup_columns;
+  for (const auto& rollup_agg : rollup.aggregates) {
+    rollup_columns.insert(rollup_agg.output_column);
+  }
+  absl::flat_hash_set<std::string> map_columns;
+  if (map != nullptr) {
+    for (const auto& expr : map->col_exprs()) {
+      // The map keeps its input columns, which must not be shadowed by the map.
+      if (rollup_columns.contains(expr.name) || !IsRollupExpression(rollup, expr.node)) {
+        return false;
+      }
+      map_columns.insert(expr.name);
+    }
+  }
+
+  for (ColumnIR* group : agg->groups()) {
+    if (!map_columns.contains(group->col_name()) && !IsRollupExpression(rollup, group)) {
+      return false;
+    }
+  }
+  for (const auto& expr : agg->aggregate_expressions()) {
+    if (!Match(expr.node, Func())) {
+      return false;
+    }
+    auto func = static_cast<FuncIR*>(expr.node);
+    std::optional<RollupAggregate::Kind> kind = AggregateKind(func->func_name());
+    if (!kind.has_value() || func->all_args().size() != 1) {
+      return false;
+    }
+    ExpressionIR* arg = func->all_args()[0];
+    if (!Match(arg, ColumnNode()) || Match(arg, Metadata())) {
+      return false;
+    }
+    const std::string& col_name = static_cast<ColumnIR*>(arg)->col_name();
+    if (map_columns.contains(col_name) || rollup.FindAggregate(kind.value(), col_name) == nullptr) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::optional<RollupRewriteRule::BucketRange> RollupRewriteRule::RollupBuckets(
+    const RollupSpec& rollup, MemorySourceIR* src) const {
+  int64_t start_ns = src->IsTimeSet() ? src->time_start_ns() : 0;
+  int64_t stop_ns =
+      src->IsTimeSet() ? src->time_stop_ns() : std::numeric_limits<int64_t>::max();
+  // The agents may not have written the latest buckets to the rollup yet. Rounding the time to
+  // buckets means the plan can't simply be shifted to a later time.
+  int64_t flushed_end_ns = FloorToBucket(
+      compiler_state_->unshiftable_time_now().val - table_store::schema::kRollupMaxFlushDelayNs,
+      rollup);
+  BucketRange buckets;
+  // The time range is inclusive of its stop.
+  buckets.start_ns = FloorToBucket(start_ns + rollup.bucket_ns - 1, rollup);
+  buckets.end_ns = FloorToBucket(std::min(stop_ns, flushed_end_ns - 1) + 1, rollup);
+  if (buckets.end_ns <= buckets.start_ns) {
+    return std::nullopt;
+  }
+  return buckets;
+}
+
+StatusOr<BlockingAggIR*> RollupRewriteRule::AggregateSourceTable(MemorySourceIR* src, MapIR* map,
+                                                                 BlockingAggIR* agg,
+                                                                 int64_t start_ns,
+                                                                 int64_t stop_ns) {
+  IR* graph = agg->graph();
+  PL_ASSIGN_OR_RETURN(MemorySourceIR * part_src, graph->CopyNode(src));
+  part_src->SetTimeValuesNS(start_ns, stop_ns);
+  OperatorIR* parent = part_src;
+  if (map != nullptr) {
+    PL_ASSIGN_OR_RETURN(MapIR * part_map, graph->CopyNode(map));
+    PL_RETURN_IF_ERROR(part_map->AddParent(part_src));
+    parent = part_map;
+  }
+  PL_ASSIGN_OR_RETURN(BlockingAggIR * part_agg, graph->CopyNode(agg));
+  PL_RETURN_IF_ERROR(part_agg->AddParent(parent));
+  source_table_aggs_.insert(part_agg->id());
+  return part_agg;
+}
+
+Status RollupRewriteRule::Rewrite(const RollupSpec& rollup, const BucketRange& buckets,
+                                  MemorySourceIR* src, MapIR* map, BlockingAggIR* agg) {
+  IR* graph = agg->graph();
+  // The parts of the time range outside of the buckets are aggregated from the source table.
+  std::vector<OperatorIR*> parts;
+  if (src->IsTimeSet() && src->time_start_ns() < buckets.start_ns) {
+    PL_ASSIGN_OR_RETURN(BlockingAggIR * head, AggregateSourceTable(src, map, agg,
+                                                                   src->time_start_ns(),
+                                                                   buckets.start_ns - 1));
+    parts.push_back(head);
+  }
+  if (!src->IsTimeSet() || src->time_stop_ns() >= buckets.end_ns) {
+    int64_t stop_ns =
+        src->IsTimeSet() ? src->time_stop_ns() : std::numeric_limits<int64_t>::max();
+    PL_ASSIGN_OR_RETURN(BlockingAggIR * tail,
+                        AggregateSourceTable(src, map, agg, buckets.end_ns, stop_ns));
+    parts.push_back(tail);
+  }
+
+  src->SetTableName(rollup.name);
+  // The rollup is small, and the columns it has are all the ones that the query can use.
+  src->SetColumnNames({});
+  // The rows of the rollup are at the start of their bucket.
+  src->SetTimeValuesNS(buckets.start_ns, buckets.end_ns - 1);
+
+  // The rollup holds partial aggregates, so the counts are summed and the other aggregates are
+  // aggregated the same way again.
+  ColExpressionVector rollup_exprs;
+  for (const auto& expr : agg->aggregate_expressions()) {
+    auto func = static_cast<FuncIR*>(expr.node);
+    auto col = static_cast<ColumnIR*>(func->all_args()[0]);
+    RollupAggregate::Kind kind = AggregateKind(func->func_name()).value();
+    const RollupAggregate* rollup_agg = rollup.FindAggregate(kind, col->col_name());
+    PL_ASSIGN_OR_RETURN(FuncIR * rollup_func,
+                        Reaggregate(graph, func, kind, rollup_agg->output_column));
+    rollup_exprs.emplace_back(expr.name, rollup_func);
+  }
+  if (parts.empty()) {
+    return agg->SetAggExprs(rollup_exprs);
+  }
+
+  // Otherwise the rollup is aggregated on its own, like the parts of the source table, and the agg
+  // aggregates their partial aggregates again.
+  OperatorIR* parent = agg->parents()[0];
+  std::vector<ColumnIR*> groups;
+  for (ColumnIR* group : agg->groups()) {
+    PL_ASSIGN_OR_RETURN(ColumnIR * group_copy, graph->CopyNode(group));
+    groups.push_back(group_copy);
+  }
+  PL_ASSIGN_OR_RETURN(BlockingAggIR * rollup_agg,
+                      graph->CreateNode<BlockingAggIR>(agg->ast(), parent, groups, rollup_exprs));
+  parts.insert(parts.begin(), rollup_agg);
+  PL_ASSIGN_OR_RETURN(UnionIR * union_op, graph->CreateNode<UnionIR>(agg->ast(), parts));
+
+  ColExpressionVector combine_exprs;
+  for (const auto& expr : agg->aggregate_expressions()) {
+    auto func = static_cast<FuncIR*>(expr.node);
+    RollupAggregate::Kind kind = AggregateKind(func->func_name()).value();
+    PL_ASSIGN_OR_RETURN(FuncIR * combine_func, Reaggregate(graph, func, kind, expr.name));
+    combine_exprs.emplace_back(expr.name, combine_func);
+  }
+  PL_RETURN_IF_ERROR(agg->RemoveParent(parent));
+  PL_RETURN_IF_ERROR(agg->AddParent(union_op));
+  return agg->SetAggExprs(combine_exprs);
+}
+
+StatusOr<bool> RollupRewriteRule::Apply(IRNode* ir_node) {
+  if (!Match(ir_node, BlockingAgg()) || source_table_aggs_.contains(ir_node->id())) {
+    return false;
+  }
+  auto agg = static_cast<BlockingAggIR*>(ir_node);
+  if (agg->rolling()) {
+    return false;
+  }
+  DCHECK_EQ(1, agg->parents().size());
+  OperatorIR* parent = agg->parents()[0];
+
+  MapIR* map = nullptr;
+  if (Match(parent, Map())) {
+    map = static_cast<MapIR*>(parent);
+    if (!map->keep_input_columns() || map->Children().size() > 1) {
+      return false;
+    }
+    parent = map->parents()[0];
+  }
+  // Other children of the source need its raw rows.
+  if (!Match(parent, MemorySource()) || parent->Children().size() > 1) {
+    return false;
+  }
+  auto src = static_cast<MemorySourceIR*>(parent);
+  if (src->streaming()) {
+    return false;
+  }
+
+  for (const auto& rollup : rollups_) {
+    if (rollup.source_table != src->table_name() ||
+        compiler_state_->relation_map()->find(rollup.name) ==
+            compiler_state_->relation_map()->end()) {
+      continue;
+    }
+    if (!CanAnswer(rollup, map, agg)) {
+      continue;
+    }
+    std::optional<BucketRange> buckets = RollupBuckets(rollup, src);
+    if (buckets.has_value()) {
+      PL_RETURN_IF_ERROR(Rewrite(rollup, buckets.value(), src, map, agg));
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace compiler
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
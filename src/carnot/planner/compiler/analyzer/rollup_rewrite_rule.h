@@ -0,0 +1,90 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <absl/container/flat_hash_set.h>
+
+#include "src/carnot/planner/rules/rules.h"
+#include "src/table_store/schema/rollup_spec.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace compiler {
+
+/**
+ * @brief This rule answers aggregates of a table from one of its rollups, which are much smaller
+ * and hold a longer history.
+ *
+ * It rewrites MemorySource -> [Map] -> BlockingAgg when:
+ *  - the rollup table is available,
+ *  - the time range holds at least one whole bucket that the agents have written to the rollup,
+ *  - the map and the groups only use the group columns of the rollup, and time_ through bins that
+ *    are multiples of the rollup buckets,
+ *  - every aggregate is a count, sum, min or max that the rollup keeps.
+ * The MemorySource then reads those buckets from the rollup table, and the aggregates aggregate
+ * the rollup columns again (counts are summed). The rest of the time range, a partial first bucket
+ * and the buckets that may not be in the rollup yet, is aggregated from the source table. The
+ * partial aggregates of each part are then unioned and aggregated again.
+ *
+ * Runs before the types are resolved, as the rewritten operators read other columns.
+ */
+class RollupRewriteRule : public Rule {
+ public:
+  RollupRewriteRule(CompilerState* compiler_state,
+                    std::vector<table_store::schema::RollupSpec> rollups)
+      : Rule(compiler_state, /*use_topo*/ false, /*reverse_topological_execution*/ false),
+        rollups_(std::move(rollups)) {}
+
+ protected:
+  StatusOr<bool> Apply(IRNode* ir_node) override;
+
+ private:
+  // The buckets [start_ns, end_ns) that are read from a rollup.
+  struct BucketRange {
+    int64_t start_ns;
+    int64_t end_ns;
+  };
+
+  bool CanAnswer(const table_store::schema::RollupSpec& rollup, MapIR* map,
+                 BlockingAggIR* agg) const;
+  bool IsRollupExpression(const table_store::schema::RollupSpec& rollup,
+                          ExpressionIR* expr) const;
+  std::optional<BucketRange> RollupBuckets(const table_store::schema::RollupSpec& rollup,
+                                           MemorySourceIR* src) const;
+  Status Rewrite(const table_store::schema::RollupSpec& rollup, const BucketRange& buckets,
+                 MemorySourceIR* src, MapIR* map, BlockingAggIR* agg);
+  StatusOr<BlockingAggIR*> AggregateSourceTable(MemorySourceIR* src, MapIR* map,
+                                                BlockingAggIR* agg, int64_t start_ns,
+                                                int64_t stop_ns);
+
+  const std::vector<table_store::schema::RollupSpec> rollups_;
+  // The aggregates of the source table that the rule added, which it must not rewrite again.
+  absl::flat_hash_set<int64_t> source_table_aggs_;
+};
+
+}  // namespace compiler
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
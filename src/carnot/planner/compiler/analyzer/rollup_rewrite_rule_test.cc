@@ -0,0 +1,240 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include "src/carnot/planner/compiler/analyzer/rollup_rewrite_rule.h"
+#include "src/carnot/planner/compiler/test_utils.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace compiler {
+
+using table_store::schema::RollupAggregate;
+using table_store::schema::RollupSpec;
+
+class RollupRewriteRuleTest : public RulesTest {
+ protected:
+  void SetUpImpl() override {
+    RulesTest::SetUpImpl();
+    Relation source({types::TIME64NS, types::UINT128, types::INT64, types::INT64, types::STRING},
+                    {"time_", "upid", "resp_status", "latency", "req_path"});
+    ASSERT_OK_AND_ASSIGN(Relation rollup_relation, rollup_.RollupRelation(source));
+    compiler_state_->relation_map()->emplace("http_events", source);
+    compiler_state_->relation_map()->emplace("http_events_rollup", rollup_relation);
+  }
+
+  StatusOr<bool> RunRule() {
+    RollupRewriteRule rule(compiler_state_.get(), {rollup_});
+    return rule.Execute(graph.get());
+  }
+
+  FuncIR* AggFunc(BlockingAggIR* agg, int64_t i) {
+    return static_cast<FuncIR*>(agg->aggregate_expressions()[i].node);
+  }
+  std::string AggColumn(BlockingAggIR* agg, int64_t i) {
+    return static_cast<ColumnIR*>(AggFunc(agg, i)->all_args()[0])->col_name();
+  }
+
+  // The end of the buckets that the agents have written to the rollup.
+  int64_t FlushedEnd() const {
+    int64_t flushed = time_now - table_store::schema::kRollupMaxFlushDelayNs;
+    return flushed - flushed % kBucketNS;
+  }
+
+  static constexpr int64_t kBucketNS = 10 * 1000 * 1000 * 1000LL;
+  RollupSpec rollup_{"http_events_rollup",
+                     "http_events",
+                     {"upid", "resp_status"},
+                     kBucketNS,
+                     {{RollupAggregate::Kind::kCount, "latency", "count"},
+                      {RollupAggregate::Kind::kMax, "latency", "latency_max"}},
+                     1024};
+};
+
+TEST_F(RollupRewriteRuleTest, flushed_buckets) {
+  MemorySourceIR* src = MakeMemSource("http_events");
+  src->SetTimeValuesNS(100 * kBucketNS, 200 * kBucketNS - 1);
+  auto bin = MakeFunc("bin", {MakeColumn("time_", 0), MakeTime(6 * kBucketNS)});
+  MapIR* map = MakeMap(src, {{"timestamp", bin}, {"pod", MakeMetadataIR("pod", 0)}}, true);
+  BlockingAggIR* agg =
+      MakeBlockingAgg(map, {MakeColumn("timestamp", 0), MakeColumn("pod", 0)},
+                      {{"count", MakeFunc("count", {MakeColumn("latency", 0)})},
+                       {"max_latency", MakeFunc("max", {MakeColumn("latency", 0)})}});
+  MakeMemSink(agg, "out");
+
+  auto result = RunRule();
+  ASSERT_OK(result);
+  EXPECT_TRUE(result.ValueOrDie());
+  EXPECT_EQ("http_events_rollup", src->table_name());
+  EXPECT_EQ(map, agg->parents()[0]);
+  // The counts of the rollup are summed.
+  EXPECT_EQ("sum", AggFunc(agg, 0)->func_name());
+  EXPECT_EQ("count", AggColumn(agg, 0));
+  EXPECT_EQ("max", AggFunc(agg, 1)->func_name());
+  EXPECT_EQ("latency_max", AggColumn(agg, 1));
+
+  // The source now reads the rollup, which has no rollup.
+  result = RunRule();
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ValueOrDie());
+}
+
+TEST_F(RollupRewriteRuleTest, recent_buckets_from_source_table) {
+  MemorySourceIR* src = MakeMemSource("http_events");
+  src->SetTimeValuesNS(100 * kBucketNS, time_now);
+  auto bin = MakeFunc("bin", {MakeColumn("time_", 0), MakeTime(6 * kBucketNS)});
+  MapIR* map = MakeMap(src, {{"timestamp", bin}}, true);
+  BlockingAggIR* agg =
+      MakeBlockingAgg(map, {MakeColumn("timestamp", 0)},
+                      {{"count", MakeFunc("count", {MakeColumn("latency", 0)})},
+                       {"max_latency", MakeFunc("max", {MakeColumn("latency", 0)})}});
+  MakeMemSink(agg, "out");
+
+  auto result = RunRule();
+  ASSERT_OK(result);
+  EXPECT_TRUE(result.ValueOrDie());
+
+  // The rollup answers the buckets that the agents have written, up to the flush delay.
+  EXPECT_EQ("http_events_rollup", src->table_name());
+  EXPECT_EQ(100 * kBucketNS, src->time_start_ns());
+  EXPECT_EQ(FlushedEnd() - 1, src->time_stop_ns());
+
+  // The partial aggregates of the rollup and the source table are aggregated again.
+  ASSERT_TRUE(Match(agg->parents()[0], Union()));
+  auto union_op = static_cast<UnionIR*>(agg->parents()[0]);
+  ASSERT_EQ(2, union_op->parents().size());
+  EXPECT_EQ("sum", AggFunc(agg, 0)->func_name());
+  EXPECT_EQ("count", AggColumn(agg, 0));
+  EXPECT_EQ("max", AggFunc(agg, 1)->func_name());
+  EXPECT_EQ("max_latency", AggColumn(agg, 1));
+
+  auto rollup_agg = static_cast<BlockingAggIR*>(union_op->parents()[0]);
+  EXPECT_EQ(map, rollup_agg->parents()[0]);
+  EXPECT_EQ("sum", AggFunc(rollup_agg, 0)->func_name());
+  EXPECT_EQ("count", AggColumn(rollup_agg, 0));
+  EXPECT_EQ("latency_max", AggColumn(rollup_agg, 1));
+
+  // The rest is read from the source table.
+  auto tail_agg = static_cast<BlockingAggIR*>(union_op->parents()[1]);
+  EXPECT_EQ("count", AggFunc(tail_agg, 0)->func_name());
+  EXPECT_EQ("latency", AggColumn(tail_agg, 0));
+  ASSERT_TRUE(Match(tail_agg->parents()[0], Map()));
+  auto tail_src = static_cast<MemorySourceIR*>(tail_agg->parents()[0]->parents()[0]);
+  EXPECT_EQ("http_events", tail_src->table_name());
+  EXPECT_EQ(FlushedEnd(), tail_src->time_start_ns());
+  EXPECT_EQ(time_now, tail_src->time_stop_ns());
+
+  // Neither part is rewritten again.
+  result = RunRule();
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ValueOrDie());
+}
+
+TEST_F(RollupRewriteRuleTest, ungrouped_columns) {
+  MemorySourceIR* src = MakeMemSource("http_events");
+  BlockingAggIR* agg = MakeBlockingAgg(src, {MakeColumn("req_path", 0)},
+                                       {{"count", MakeFunc("count", {MakeColumn("latency", 0)})}});
+  MakeMemSink(agg, "out");
+
+  auto result = RunRule();
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ValueOrDie());
+  EXPECT_EQ("http_events", src->table_name());
+}
+
+TEST_F(RollupRewriteRuleTest, missing_aggregate) {
+  MemorySourceIR* src = MakeMemSource("http_events");
+  BlockingAggIR* agg = MakeBlockingAgg(src, {MakeColumn("upid", 0)},
+                                       {{"min", MakeFunc("min", {MakeColumn("latency", 0)})}});
+  MakeMemSink(agg, "out");
+
+  auto result = RunRule();
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ValueOrDie());
+}
+
+TEST_F(RollupRewriteRuleTest, partial_first_bucket) {
+  MemorySourceIR* src = MakeMemSource("http_events");
+  src->SetTimeValuesNS(100 * kBucketNS + 1, 200 * kBucketNS - 1);
+  BlockingAggIR* agg = MakeBlockingAgg(src, {MakeColumn("upid", 0)},
+                                       {{"count", MakeFunc("count", {MakeColumn("latency", 0)})}});
+  MakeMemSink(agg, "out");
+
+  auto result = RunRule();
+  ASSERT_OK(result);
+  EXPECT_TRUE(result.ValueOrDie());
+  EXPECT_EQ(101 * kBucketNS, src->time_start_ns());
+
+  // The rollup can't tell the rows of the first bucket apart, so they are read from the source
+  // table.
+  ASSERT_TRUE(Match(agg->parents()[0], Union()));
+  auto union_op = static_cast<UnionIR*>(agg->parents()[0]);
+  ASSERT_EQ(2, union_op->parents().size());
+  auto head_src = static_cast<MemorySourceIR*>(union_op->parents()[1]->parents()[0]);
+  EXPECT_EQ("http_events", head_src->table_name());
+  EXPECT_EQ(100 * kBucketNS + 1, head_src->time_start_ns());
+  EXPECT_EQ(101 * kBucketNS - 1, head_src->time_stop_ns());
+}
+
+TEST_F(RollupRewriteRuleTest, bins_within_buckets) {
+  MemorySourceIR* src = MakeMemSource("http_events");
+  src->SetTimeValuesNS(100 * kBucketNS, 200 * kBucketNS - 1);
+  // The rollup can't tell the rows within a bucket apart.
+  auto bin = MakeFunc("bin", {MakeColumn("time_", 0), MakeTime(kBucketNS / 2)});
+  MapIR* map = MakeMap(src, {{"timestamp", bin}}, true);
+  BlockingAggIR* agg = MakeBlockingAgg(map, {MakeColumn("timestamp", 0)},
+                                       {{"count", MakeFunc("count", {MakeColumn("latency", 0)})}});
+  MakeMemSink(agg, "out");
+
+  auto result = RunRule();
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ValueOrDie());
+}
+
+TEST_F(RollupRewriteRuleTest, no_flushed_buckets) {
+  MemorySourceIR* src = MakeMemSource("http_events");
+  // The agents may not have written any of these buckets to the rollup yet.
+  src->SetTimeValuesNS(time_now - table_store::schema::kRollupMaxFlushDelayNs / 2, time_now);
+  BlockingAggIR* agg = MakeBlockingAgg(src, {MakeColumn("upid", 0)},
+                                       {{"count", MakeFunc("count", {MakeColumn("latency", 0)})}});
+  MakeMemSink(agg, "out");
+
+  auto result = RunRule();
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ValueOrDie());
+  EXPECT_EQ("http_events", src->table_name());
+}
+
+TEST_F(RollupRewriteRuleTest, rollup_not_available) {
+  compiler_state_->relation_map()->erase("http_events_rollup");
+  MemorySourceIR* src = MakeMemSource("http_events");
+  BlockingAggIR* agg = MakeBlockingAgg(src, {MakeColumn("upid", 0)},
+                                       {{"count", MakeFunc("count", {MakeColumn("latency", 0)})}});
+  MakeMemSink(agg, "out");
+
+  auto result = RunRule();
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ValueOrDie());
+}
+
+}  // namespace compiler
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
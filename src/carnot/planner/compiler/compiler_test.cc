@@ -2649,75 +2649,72 @@ TEST_F(CompilerTest, TestUnaryOperators) {
   ASSERT_OK(plan_status);
 }
 
-// ENABLE and modify these tests once we know where rolling is getting merged into
 constexpr char kRollingTimeStringQuery[] = R"pxl(
 import px
-t1 = px.DataFrame(table='http_events', select=['time_', 'remote_port'])
-t1 = t1.rolling('3s')
+t1 = px.DataFrame(table='http_events', select=['time_', 'remote_port', 'resp_latency_ns'])
+t1 = t1.rolling('3s').groupby('remote_port').agg(latency=('resp_latency_ns', px.mean))
 px.display(t1)
 )pxl";
-TEST_F(CompilerTest, DISABLED_RollingTimeStringQuery) {
+TEST_F(CompilerTest, RollingTimeStringQuery) {
   auto graph_or_s = compiler_.CompileToIR(kRollingTimeStringQuery, compiler_state_.get());
   ASSERT_OK(graph_or_s);
   auto graph = graph_or_s.ConsumeValueOrDie();
 
-  std::vector<IRNode*> rolling_nodes = graph->FindNodesOfType(IRNodeType::kRolling);
-  ASSERT_EQ(rolling_nodes.size(), 1);
-  auto rolling = static_cast<RollingIR*>(rolling_nodes[0]);
-
-  ASSERT_EQ(rolling->window_col()->col_name(), "time_");
-  ASSERT_MATCH(rolling->window_size(), Int());
-  IntIR* window_size_int = static_cast<IntIR*>(rolling->window_size());
-  ASSERT_EQ(window_size_int->val(),
+  EXPECT_THAT(graph->FindNodesOfType(IRNodeType::kRolling), ::testing::IsEmpty());
+  std::vector<IRNode*> agg_nodes = graph->FindNodesOfType(IRNodeType::kBlockingAgg);
+  ASSERT_EQ(agg_nodes.size(), 1);
+  auto agg = static_cast<BlockingAggIR*>(agg_nodes[0]);
+  ASSERT_TRUE(agg->rolling());
+  EXPECT_EQ(agg->rolling_window_col()->col_name(), "time_");
+  EXPECT_EQ(agg->rolling_window_size(),
             std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::seconds(3)).count());
-  Relation rolling_relation({types::TIME64NS, types::INT64}, {"time_", "remote_port"});
-  EXPECT_THAT(*rolling->resolved_table_type(), IsTableType(rolling_relation));
+  EXPECT_THAT(agg->resolved_table_type()->ColumnNames(),
+              ElementsAre("time_", "remote_port", "latency"));
+
+  planpb::Operator op;
+  ASSERT_OK(agg->ToProto(&op));
+  ASSERT_TRUE(op.agg_op().has_rolling_window());
+  EXPECT_EQ(0, op.agg_op().rolling_window().time_col().index());
+  EXPECT_EQ(3000000000, op.agg_op().rolling_window().window_size());
+  ASSERT_EQ(1, op.agg_op().groups_size());
+  EXPECT_EQ(1, op.agg_op().groups(0).index());
 }
 
 constexpr char kRollingIntQuery[] = R"pxl(
 import px
-t1 = px.DataFrame(table='http_events', select=['time_', 'remote_port'])
-t1 = t1.rolling(3000)
+t1 = px.DataFrame(table='http_events', select=['time_', 'remote_port', 'resp_latency_ns'])
+t1 = t1.groupby('remote_port').rolling(3000).agg(count=('resp_latency_ns', px.count))
 px.display(t1)
 )pxl";
-TEST_F(CompilerTest, DISABLED_RollingIntQuery) {
-  auto graph_or_s = compiler_.CompileToIR(kRollingIntQuery, compiler_state_.get());
-  ASSERT_OK(graph_or_s);
-  auto graph = graph_or_s.ConsumeValueOrDie();
-
-  std::vector<IRNode*> rolling_nodes = graph->FindNodesOfType(IRNodeType::kRolling);
-  ASSERT_EQ(rolling_nodes.size(), 1);
-  auto rolling = static_cast<RollingIR*>(rolling_nodes[0]);
+TEST_F(CompilerTest, RollingIntQuery) {
+  auto plan_or_s = compiler_.Compile(kRollingIntQuery, compiler_state_.get());
+  ASSERT_OK(plan_or_s);
+  auto plan = plan_or_s.ConsumeValueOrDie();
 
-  ASSERT_EQ(rolling->window_col()->col_name(), "time_");
-  ASSERT_MATCH(rolling->window_size(), Int());
-  IntIR* window_size_int = static_cast<IntIR*>(rolling->window_size());
-  ASSERT_EQ(window_size_int->val(), 3000);
-  Relation rolling_relation({types::TIME64NS, types::INT64}, {"time_", "remote_port"});
-  EXPECT_THAT(*rolling->resolved_table_type(), IsTableType(rolling_relation));
+  std::vector<planpb::AggregateOperator> aggs;
+  for (const auto& node : plan.nodes(0).nodes()) {
+    if (node.op().op_type() == planpb::AGGREGATE_OPERATOR) {
+      aggs.push_back(node.op().agg_op());
+    }
+  }
+  ASSERT_EQ(aggs.size(), 1);
+  ASSERT_TRUE(aggs[0].has_rolling_window());
+  EXPECT_EQ(0, aggs[0].rolling_window().time_col().index());
+  EXPECT_EQ(3000, aggs[0].rolling_window().window_size());
+  EXPECT_THAT(aggs[0].group_names(), ElementsAre("remote_port"));
 }
 
-constexpr char kRollingCompileTimeExprEvalQuery[] = R"pxl(
+constexpr char kRollingWithoutAggQuery[] = R"pxl(
 import px
 t1 = px.DataFrame(table='http_events', select=['time_', 'remote_port'])
-t1 = t1.rolling(1 + px.now())
+t1 = t1.rolling('3s')
 px.display(t1)
 )pxl";
-TEST_F(CompilerTest, DISABLED_RollingCompileTimeExprEvalQuery) {
-  auto graph_or_s = compiler_.CompileToIR(kRollingCompileTimeExprEvalQuery, compiler_state_.get());
-  ASSERT_OK(graph_or_s);
-  auto graph = graph_or_s.ConsumeValueOrDie();
-
-  std::vector<IRNode*> rolling_nodes = graph->FindNodesOfType(IRNodeType::kRolling);
-  ASSERT_EQ(rolling_nodes.size(), 1);
-  auto rolling = static_cast<RollingIR*>(rolling_nodes[0]);
-
-  ASSERT_EQ(rolling->window_col()->col_name(), "time_");
-  ASSERT_MATCH(rolling->window_size(), Int());
-  IntIR* window_size_int = static_cast<IntIR*>(rolling->window_size());
-  ASSERT_EQ(window_size_int->val(), compiler_state_->time_now().val + 1);
-  Relation rolling_relation({types::TIME64NS, types::INT64}, {"time_", "remote_port"});
-  EXPECT_THAT(*rolling->resolved_table_type(), IsTableType(rolling_relation));
+TEST_F(CompilerTest, RollingWithoutAgg) {
+  auto graph_or_s = compiler_.CompileToIR(kRollingWithoutAggQuery, compiler_state_.get());
+  ASSERT_NOT_OK(graph_or_s);
+  EXPECT_THAT(graph_or_s.status(),
+              HasCompilerError("'rolling.*' should be followed by an 'agg.*'"));
 }
 
 constexpr char kRollingNonTimeColumn[] = R"pxl(
@@ -3229,6 +3226,76 @@ TEST_F(CompilerTest, syntax_error_in_func_params) {
   EXPECT_THAT(plan_or_s.status(), HasCompilerError("SyntaxError"));
 }
 
+constexpr char kSortValuesQuery[] = R"pxl(
+import px
+df = px.DataFrame(table='http_events', select=['time_', 'remote_port', 'resp_latency_ns'])
+df = df.sort_values(['resp_latency_ns', 'remote_port'], ascending=[False, True])
+px.display(df)
+)pxl";
+TEST_F(CompilerTest, SortValuesQuery) {
+  auto plan_or_s = compiler_.Compile(kSortValuesQuery, compiler_state_.get());
+  ASSERT_OK(plan_or_s);
+  auto plan = plan_or_s.ConsumeValueOrDie();
+
+  std::vector<planpb::TopKOperator> topks;
+  for (const auto& node : plan.nodes(0).nodes()) {
+    if (node.op().op_type() == planpb::TOPK_OPERATOR) {
+      topks.push_back(node.op().topk_op());
+    }
+  }
+  ASSERT_EQ(topks.size(), 1);
+  // Without a head(), all of the rows are sorted.
+  EXPECT_EQ(0, topks[0].limit());
+  ASSERT_EQ(2, topks[0].sort_columns_size());
+  EXPECT_EQ(2, topks[0].sort_columns(0).column().index());
+  EXPECT_TRUE(topks[0].sort_columns(0).descending());
+  EXPECT_EQ(1, topks[0].sort_columns(1).column().index());
+  EXPECT_FALSE(topks[0].sort_columns(1).descending());
+  EXPECT_EQ(3, topks[0].columns_size());
+}
+
+constexpr char kSortValuesMissingColumnQuery[] = R"pxl(
+import px
+df = px.DataFrame(table='http_events', select=['time_', 'remote_port'])
+df = df.sort_values('resp_latency_ns')
+px.display(df)
+)pxl";
+TEST_F(CompilerTest, SortValuesMissingColumn) {
+  auto graph_or_s = compiler_.CompileToIR(kSortValuesMissingColumnQuery, compiler_state_.get());
+  ASSERT_NOT_OK(graph_or_s);
+  EXPECT_THAT(graph_or_s.status(),
+              HasCompilerError("Column 'resp_latency_ns' not found in parent dataframe"));
+}
+
+constexpr char kSortValuesAscendingMismatchQuery[] = R"pxl(
+import px
+df = px.DataFrame(table='http_events', select=['time_', 'remote_port', 'resp_latency_ns'])
+df = df.sort_values(['resp_latency_ns', 'remote_port'], ascending=[False])
+px.display(df)
+)pxl";
+TEST_F(CompilerTest, SortValuesAscendingMismatch) {
+  auto graph_or_s =
+      compiler_.CompileToIR(kSortValuesAscendingMismatchQuery, compiler_state_.get());
+  ASSERT_NOT_OK(graph_or_s);
+  EXPECT_THAT(graph_or_s.status(),
+              HasCompilerError("'ascending' must be a bool or a list with one bool per 'by' "
+                               "column. Received 1 values for 2 columns"));
+}
+
+constexpr char kSortValuesStreamQuery[] = R"pxl(
+import px
+df = px.DataFrame(table='http_events', select=['time_', 'remote_port', 'resp_latency_ns'])
+df = df.sort_values('resp_latency_ns').head(10)
+px.display(df.stream())
+)pxl";
+TEST_F(CompilerTest, SortValuesStreamUnsupported) {
+  // The TopK only outputs rows once its input ends, which never happens when streaming.
+  auto graph_or_s = compiler_.CompileToIR(kSortValuesStreamQuery, compiler_state_.get());
+  ASSERT_NOT_OK(graph_or_s);
+  EXPECT_THAT(graph_or_s.status().msg(),
+              ContainsRegex("df.stream\\(\\) not yet supported with blocking operator"));
+}
+
 }  // namespace compiler
 }  // namespace planner
 }  // namespace carnot
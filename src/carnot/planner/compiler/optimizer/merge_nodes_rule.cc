@@ -174,6 +174,14 @@ bool MergeNodesRule::CanMerge(OperatorIR* a, OperatorIR* b) {
     if (!CompareColumns(agg_a->groups(), agg_b->groups())) {
       return false;
     }
+    if (agg_a->rolling() != agg_b->rolling()) {
+      return false;
+    }
+    if (agg_a->rolling() &&
+        (agg_a->rolling_window_size() != agg_b->rolling_window_size() ||
+         !CompareColumns({agg_a->rolling_window_col()}, {agg_b->rolling_window_col()}))) {
+      return false;
+    }
     return CompareExpressionLists(agg_a->aggregate_expressions(), agg_b->aggregate_expressions());
   } else if (Match(a, Join())) {
     auto join_a = static_cast<JoinIR*>(a);
@@ -380,9 +388,14 @@ StatusOr<OperatorIR*> MergeNodesRule::MergeOps(IR* graph,
       PL_RETURN_IF_ERROR(MergeExprs(&expr_list, &exprs, other_agg->aggregate_expressions()));
     }
 
-    PL_ASSIGN_OR_RETURN(merged_op,
+    PL_ASSIGN_OR_RETURN(BlockingAggIR * merged_agg,
                         graph->CreateNode<BlockingAggIR>(base_agg->ast(), base_agg->parents()[0],
                                                          base_agg->groups(), expr_list));
+    if (base_agg->rolling()) {
+      PL_RETURN_IF_ERROR(merged_agg->SetRollingWindow(base_agg->rolling_window_col(),
+                                                      base_agg->rolling_window_size()));
+    }
+    merged_op = merged_agg;
 
   } else if (Match(base_op, Join())) {
     auto join = static_cast<JoinIR*>(base_op);
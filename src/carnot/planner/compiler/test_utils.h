@@ -557,6 +557,13 @@ class OperatorTests : public ::testing::Test {
     return limit;
   }
 
+  TopKIR* MakeTopK(OperatorIR* parent, const std::vector<std::string>& sort_cols,
+                   const std::vector<bool>& descending) {
+    TopKIR* topk =
+        graph->CreateNode<TopKIR>(ast, parent, sort_cols, descending).ConsumeValueOrDie();
+    return topk;
+  }
+
   BlockingAggIR* MakeBlockingAgg(OperatorIR* parent, const std::vector<ColumnIR*>& columns,
                                  const ColExpressionVector& col_agg) {
     BlockingAggIR* agg =
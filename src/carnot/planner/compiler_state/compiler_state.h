@@ -125,7 +125,21 @@ class CompilerState : public NotCopyable {
     return &table_names_to_sensitive_columns_;
   }
   RegistryInfo* registry_info() const { return registry_info_; }
-  types::Time64NSValue time_now() const { return time_now_; }
+  // The time of compilation. It may only end up in the plan plus a constant (eg. as the start of a
+  // relative time range), so that the plan can be reused later by shifting those values.
+  types::Time64NSValue time_now() const {
+    time_now_used_ = true;
+    return time_now_;
+  }
+  // The time of compilation, for uses that don't shift along with it, eg. rounding it.
+  types::Time64NSValue unshiftable_time_now() const {
+    time_now_shiftable_ = false;
+    return time_now();
+  }
+  // Whether the compiled plan depends on time_now, and so can't be reused later as is.
+  bool time_now_used() const { return time_now_used_; }
+  // Whether the plan can be moved to a later time by shifting the values that hold time_now.
+  bool time_now_shiftable() const { return time_now_shiftable_; }
   const std::string& result_address() const { return result_address_; }
   const std::string& result_ssl_targetname() const { return result_ssl_targetname_; }
 
@@ -163,6 +177,8 @@ class CompilerState : public NotCopyable {
   SensitiveColumnMap table_names_to_sensitive_columns_;
   RegistryInfo* registry_info_;
   types::Time64NSValue time_now_;
+  mutable bool time_now_used_ = false;
+  mutable bool time_now_shiftable_ = true;
   std::map<IDRegistryKey, int64_t> udf_to_id_map_;
   std::map<IDRegistryKey, int64_t> uda_to_id_map_;
 
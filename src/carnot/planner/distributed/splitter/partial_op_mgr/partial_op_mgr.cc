@@ -44,6 +44,36 @@ StatusOr<OperatorIR*> LimitOperatorMgr::CreateMergeOperator(IR* plan, OperatorIR
   return new_limit;
 }
 
+StatusOr<OperatorIR*> TopKOperatorMgr::CreatePrepareOperator(IR* plan, OperatorIR* op) const {
+  DCHECK(Matches(op));
+  TopKIR* topk = static_cast<TopKIR*>(op);
+  PL_ASSIGN_OR_RETURN(TopKIR * new_topk, plan->CopyNode(topk));
+  PL_RETURN_IF_ERROR(new_topk->CopyParentsFrom(topk));
+
+  // The Merge TopK sorts by the same columns, so they must be sent over even if the original
+  // TopK doesn't output them.
+  DCHECK_EQ(topk->parents().size(), 1UL);
+  auto parent_type = topk->parents()[0]->resolved_table_type();
+  auto new_type = std::static_pointer_cast<TableType>(topk->resolved_table_type()->Copy());
+  for (const auto& col_name : topk->sort_cols()) {
+    if (!new_type->HasColumn(col_name)) {
+      PL_ASSIGN_OR_RETURN(auto col_type, parent_type->GetColumnType(col_name));
+      new_type->AddColumn(col_name, col_type->Copy());
+    }
+  }
+  PL_RETURN_IF_ERROR(new_topk->SetResolvedType(new_type));
+  return new_topk;
+}
+
+StatusOr<OperatorIR*> TopKOperatorMgr::CreateMergeOperator(IR* plan, OperatorIR* new_parent,
+                                                           OperatorIR* op) const {
+  DCHECK(Matches(op));
+  TopKIR* topk = static_cast<TopKIR*>(op);
+  PL_ASSIGN_OR_RETURN(TopKIR * new_topk, plan->CopyNode(topk));
+  PL_RETURN_IF_ERROR(new_topk->AddParent(new_parent));
+  return new_topk;
+}
+
 StatusOr<OperatorIR*> AggOperatorMgr::CreatePrepareOperator(IR* plan, OperatorIR* op) const {
   DCHECK(Matches(op));
   BlockingAggIR* agg = static_cast<BlockingAggIR*>(op);
@@ -87,6 +87,24 @@ class LimitOperatorMgr : public PartialOperatorMgr {
                                             OperatorIR* op) const override;
 };
 
+/**
+ * @brief TopKOperatorMgr manages splitting TopKs that have a limit over the boundary. Each agent
+ * only sends its own top rows, which the Merge TopK sorts again to keep the overall top rows.
+ */
+class TopKOperatorMgr : public PartialOperatorMgr {
+ public:
+  bool Matches(OperatorIR* op) const override {
+    if (!Match(op, TopK())) {
+      return false;
+    }
+    auto topk = static_cast<TopKIR*>(op);
+    return topk->limit_value_set() && topk->limit_value() > 0;
+  }
+  StatusOr<OperatorIR*> CreatePrepareOperator(IR* plan, OperatorIR* op) const override;
+  StatusOr<OperatorIR*> CreateMergeOperator(IR* plan, OperatorIR* new_parent,
+                                            OperatorIR* op) const override;
+};
+
 /**
  * @brief AggOperatorMgr manages splitting aggregates into partial aggregate and the merging node
  * over a network boundary.
@@ -98,6 +116,10 @@ class AggOperatorMgr : public PartialOperatorMgr {
       return false;
     }
     BlockingAggIR* agg = static_cast<BlockingAggIR*>(op);
+    // The windows of a rolling aggregate need all of the rows in time order, so it isn't split.
+    if (agg->rolling()) {
+      return false;
+    }
     for (const auto& col_expr : agg->aggregate_expressions()) {
       if (!Match(col_expr.node, PartialUDA())) {
         return false;
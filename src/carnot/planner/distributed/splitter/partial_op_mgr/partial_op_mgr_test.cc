@@ -68,6 +68,51 @@ TEST_F(PartialOpMgrTest, limit_test) {
   EXPECT_NE(merge_limit, limit);
 }
 
+TEST_F(PartialOpMgrTest, topk_test) {
+  auto mem_src = MakeMemSource(MakeRelation());
+  auto topk = MakeTopK(mem_src, {"cpu0", "count"}, {true, false});
+  topk->SetLimitValue(10);
+  MakeMemSink(topk, "out");
+
+  ResolveTypesRule type_rule(compiler_state_.get());
+  ASSERT_OK(type_rule.Execute(graph.get()));
+  // Drop the sort column cpu0 from the output, the prepare TopK should still send it.
+  ASSERT_OK(topk->PruneOutputColumnsTo({"count", "cpu1"}));
+
+  TopKOperatorMgr mgr;
+  EXPECT_TRUE(mgr.Matches(topk));
+  auto prepare_topk_or_s = mgr.CreatePrepareOperator(graph.get(), topk);
+  ASSERT_OK(prepare_topk_or_s);
+  OperatorIR* prepare_topk_uncasted = prepare_topk_or_s.ConsumeValueOrDie();
+  ASSERT_MATCH(prepare_topk_uncasted, TopK());
+  TopKIR* prepare_topk = static_cast<TopKIR*>(prepare_topk_uncasted);
+  EXPECT_EQ(prepare_topk->limit_value(), 10);
+  EXPECT_THAT(prepare_topk->sort_cols(), ElementsAre("cpu0", "count"));
+  EXPECT_EQ(prepare_topk->parents(), topk->parents());
+  EXPECT_THAT(prepare_topk->resolved_table_type()->ColumnNames(),
+              ElementsAre("count", "cpu1", "cpu0"));
+
+  auto mem_src2 = MakeMemSource(MakeRelation());
+  auto merge_topk_or_s = mgr.CreateMergeOperator(graph.get(), mem_src2, topk);
+  ASSERT_OK(merge_topk_or_s);
+  OperatorIR* merge_topk_uncasted = merge_topk_or_s.ConsumeValueOrDie();
+  ASSERT_MATCH(merge_topk_uncasted, TopK());
+  TopKIR* merge_topk = static_cast<TopKIR*>(merge_topk_uncasted);
+  EXPECT_EQ(merge_topk->limit_value(), 10);
+  EXPECT_THAT(merge_topk->descending(), ElementsAre(true, false));
+  EXPECT_EQ(merge_topk->parents()[0], mem_src2);
+  EXPECT_THAT(merge_topk->resolved_table_type()->ColumnNames(), ElementsAre("count", "cpu1"));
+}
+
+TEST_F(PartialOpMgrTest, topk_without_limit_not_split) {
+  auto mem_src = MakeMemSource(MakeRelation());
+  auto topk = MakeTopK(mem_src, {"cpu0"}, {false});
+  MakeMemSink(topk, "out");
+
+  TopKOperatorMgr mgr;
+  EXPECT_FALSE(mgr.Matches(topk));
+}
+
 TEST_F(PartialOpMgrTest, agg_test) {
   auto relation = MakeRelation();
   relation.AddColumn(types::STRING, "service");
@@ -66,6 +66,11 @@ OperatorIR* FilterPushdownRule::HandleAggPushdown(BlockingAggIR* agg,
     reverse_column_name_mapping[cur_name] = old_name;
   }
 
+  // The window start time of a rolling aggregate isn't the time of the input rows.
+  if (agg->rolling() &&
+      reverse_column_name_mapping.contains(agg->rolling_window_col()->col_name())) {
+    return nullptr;
+  }
   for (const auto& agg_expr : agg->aggregate_expressions()) {
     // If any of the filter columns come from the output of an aggregate expression,
     // don't push the filter up any further. For certain aggregate functions like min or max,
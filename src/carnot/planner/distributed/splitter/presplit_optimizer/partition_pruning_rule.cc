@@ -0,0 +1,108 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/planner/distributed/splitter/presplit_optimizer/partition_pruning_rule.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace distributed {
+
+namespace {
+// The column that the tables are partitioned by, and the function that maps it to pods.
+constexpr char kUPIDColumn[] = "upid";
+constexpr char kUPIDToPodNameFunc[] = "upid_to_pod_name";
+}  // namespace
+
+bool PartitionPruningRule::CollectPartitionKeys(ExpressionIR* expr,
+                                                std::vector<absl::uint128>* upids,
+                                                std::vector<std::string>* pod_names) {
+  if (!Match(expr, Func())) {
+    return false;
+  }
+  auto func = static_cast<FuncIR*>(expr);
+  const auto& args = func->all_args();
+
+  if (Match(func, LogicalAnd())) {
+    // Rows must pass both sides, so the keys of either side are enough.
+    std::vector<absl::uint128> lhs_upids;
+    std::vector<std::string> lhs_pod_names;
+    if (CollectPartitionKeys(args[0], &lhs_upids, &lhs_pod_names)) {
+      upids->insert(upids->end(), lhs_upids.begin(), lhs_upids.end());
+      pod_names->insert(pod_names->end(), lhs_pod_names.begin(), lhs_pod_names.end());
+      return true;
+    }
+    return CollectPartitionKeys(args[1], upids, pod_names);
+  }
+
+  if (Match(func, LogicalOr(Value(), Value()))) {
+    // Rows may pass either side, so both sides must restrict the keys.
+    return CollectPartitionKeys(args[0], upids, pod_names) &&
+           CollectPartitionKeys(args[1], upids, pod_names);
+  }
+
+  if (Match(func, Equals(ColumnNode(kUPIDColumn), UInt128Value()))) {
+    auto value = Match(args[0], UInt128Value()) ? args[0] : args[1];
+    upids->push_back(static_cast<UInt128IR*>(value)->val());
+    return true;
+  }
+
+  if (Match(func, Equals(Func(), String()))) {
+    auto md_func = static_cast<FuncIR*>(Match(args[0], Func()) ? args[0] : args[1]);
+    auto value = static_cast<StringIR*>(Match(args[0], String()) ? args[0] : args[1]);
+    // Rows whose UPID has no pod get an empty pod name, and can be in any partition.
+    if (md_func->func_name() != kUPIDToPodNameFunc || md_func->all_args().size() != 1 ||
+        !Match(md_func->all_args()[0], ColumnNode(kUPIDColumn)) || value->str().empty()) {
+      return false;
+    }
+    pod_names->push_back(value->str());
+    return true;
+  }
+  return false;
+}
+
+StatusOr<bool> PartitionPruningRule::Apply(IRNode* ir_node) {
+  if (!Match(ir_node, Filter())) {
+    return false;
+  }
+  FilterIR* filter = static_cast<FilterIR*>(ir_node);
+  DCHECK_EQ(1, filter->parents().size());
+  OperatorIR* parent = filter->parents()[0];
+  // The partition filter drops rows for all the children of the MemorySource.
+  if (!Match(parent, MemorySource()) || parent->Children().size() > 1) {
+    return false;
+  }
+  MemorySourceIR* src = static_cast<MemorySourceIR*>(parent);
+
+  std::vector<absl::uint128> upids;
+  std::vector<std::string> pod_names;
+  if (!CollectPartitionKeys(filter->filter_expr(), &upids, &pod_names)) {
+    return false;
+  }
+  if (src->HasPartitionFilter() && src->partition_upids() == upids &&
+      src->partition_pod_names() == pod_names) {
+    return false;
+  }
+  src->SetPartitionFilter(upids, pod_names);
+  return true;
+}
+
+}  // namespace distributed
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
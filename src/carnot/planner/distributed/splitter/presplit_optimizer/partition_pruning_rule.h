@@ -0,0 +1,60 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "src/carnot/planner/rules/rules.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace distributed {
+
+/**
+ * @brief This rule finds filters right after a MemorySource that only keep the rows of some
+ * UPIDs or pods, and sets them as the partition filter of the MemorySource. Tables that are
+ * partitioned by upid then only read the partitions that can hold those rows. The filters are
+ * kept, as the partitions also hold rows of other UPIDs.
+ *
+ * Supported filters are equalities of the upid column to a UPID, and of upid_to_pod_name(upid)
+ * (eg. df.ctx['pod']) to a pod name, as well as ands and ors of those.
+ */
+class PartitionPruningRule : public Rule {
+ public:
+  explicit PartitionPruningRule(CompilerState* compiler_state)
+      : Rule(compiler_state, /*use_topo*/ false, /*reverse_topological_execution*/ false) {}
+
+ protected:
+  StatusOr<bool> Apply(IRNode* ir_node) override;
+
+ private:
+  /**
+   * Collects the UPIDs and pods that the rows passing the expression must belong to. Returns
+   * false if the expression can pass rows of any UPID.
+   */
+  static bool CollectPartitionKeys(ExpressionIR* expr, std::vector<absl::uint128>* upids,
+                                   std::vector<std::string>* pod_names);
+};
+
+}  // namespace distributed
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
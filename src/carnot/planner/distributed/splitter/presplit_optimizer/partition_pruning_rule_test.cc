@@ -0,0 +1,129 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include "src/carnot/planner/compiler/test_utils.h"
+#include "src/carnot/planner/distributed/splitter/presplit_optimizer/partition_pruning_rule.h"
+#include "src/carnot/planner/test_utils.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace distributed {
+
+class PartitionPruningRuleTest : public testutils::DistributedRulesTest {
+ protected:
+  MemorySourceIR* MakeSource() {
+    Relation relation({types::DataType::UINT128, types::DataType::INT64}, {"upid", "abc"});
+    return MakeMemSource("source", relation);
+  }
+  FuncIR* MakeUPIDEquals(const std::string& upid) {
+    return MakeEqualsFunc(MakeColumn("upid", 0), MakeUInt128(upid));
+  }
+  FuncIR* MakePodEquals(const std::string& pod_name) {
+    return MakeEqualsFunc(MakeFunc("upid_to_pod_name", {MakeColumn("upid", 0)}),
+                          MakeString(pod_name));
+  }
+  StatusOr<bool> RunRule() {
+    PartitionPruningRule rule(compiler_state_.get());
+    return rule.Execute(graph.get());
+  }
+
+  static constexpr char kUPID1[] = "11285cdd-1de9-4ab1-ae6a-0ba08c8c676c";
+  static constexpr char kUPID2[] = "39a0f8ca-36f2-4794-8609-35f98c7fc9fe";
+};
+
+TEST_F(PartitionPruningRuleTest, upid_equals) {
+  MemorySourceIR* src = MakeSource();
+  auto upid = MakeUInt128(kUPID1);
+  FilterIR* filter = MakeFilter(src, MakeEqualsFunc(upid, MakeColumn("upid", 0)));
+  MakeMemSink(filter, "foo", {});
+
+  auto result = RunRule();
+  ASSERT_OK(result);
+  EXPECT_TRUE(result.ValueOrDie());
+  ASSERT_TRUE(src->HasPartitionFilter());
+  EXPECT_THAT(src->partition_upids(), ::testing::ElementsAre(upid->val()));
+  EXPECT_TRUE(src->partition_pod_names().empty());
+
+  // Running again doesn't change anything.
+  result = RunRule();
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ValueOrDie());
+}
+
+TEST_F(PartitionPruningRuleTest, pods_and_upids) {
+  MemorySourceIR* src = MakeSource();
+  auto keys = MakeOrFunc(MakePodEquals("pl/pod1"), MakeUPIDEquals(kUPID2));
+  auto expr = MakeAndFunc(MakeEqualsFunc(MakeColumn("abc", 0), MakeInt(10)), keys);
+  FilterIR* filter = MakeFilter(src, expr);
+  MakeMemSink(filter, "foo", {});
+
+  auto result = RunRule();
+  ASSERT_OK(result);
+  EXPECT_TRUE(result.ValueOrDie());
+  ASSERT_TRUE(src->HasPartitionFilter());
+  EXPECT_EQ(1, src->partition_upids().size());
+  EXPECT_THAT(src->partition_pod_names(), ::testing::ElementsAre("pl/pod1"));
+  // The filter is kept.
+  EXPECT_THAT(src->Children(), ::testing::ElementsAre(filter));
+}
+
+TEST_F(PartitionPruningRuleTest, or_with_other_column) {
+  MemorySourceIR* src = MakeSource();
+  auto expr =
+      MakeOrFunc(MakeUPIDEquals(kUPID1), MakeEqualsFunc(MakeColumn("abc", 0), MakeInt(10)));
+  FilterIR* filter = MakeFilter(src, expr);
+  MakeMemSink(filter, "foo", {});
+
+  auto result = RunRule();
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ValueOrDie());
+  EXPECT_FALSE(src->HasPartitionFilter());
+}
+
+TEST_F(PartitionPruningRuleTest, other_function_of_upid) {
+  MemorySourceIR* src = MakeSource();
+  auto expr = MakeEqualsFunc(MakeFunc("upid_to_service_name", {MakeColumn("upid", 0)}),
+                             MakeString("pl/svc"));
+  FilterIR* filter = MakeFilter(src, expr);
+  MakeMemSink(filter, "foo", {});
+
+  auto result = RunRule();
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ValueOrDie());
+  EXPECT_FALSE(src->HasPartitionFilter());
+}
+
+TEST_F(PartitionPruningRuleTest, source_with_other_children) {
+  MemorySourceIR* src = MakeSource();
+  FilterIR* filter = MakeFilter(src, MakeUPIDEquals(kUPID1));
+  MakeMemSink(filter, "foo", {});
+  MakeMemSink(src, "bar", {});
+
+  auto result = RunRule();
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ValueOrDie());
+  EXPECT_FALSE(src->HasPartitionFilter());
+}
+
+}  // namespace distributed
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
@@ -22,6 +22,8 @@
 #include "src/carnot/planner/compiler_state/compiler_state.h"
 #include "src/carnot/planner/distributed/splitter/presplit_optimizer/filter_push_down_rule.h"
 #include "src/carnot/planner/distributed/splitter/presplit_optimizer/limit_push_down_rule.h"
+#include "src/carnot/planner/distributed/splitter/presplit_optimizer/partition_pruning_rule.h"
+#include "src/carnot/planner/distributed/splitter/presplit_optimizer/topk_limit_fold_rule.h"
 #include "src/carnot/planner/rules/rule_executor.h"
 
 namespace px {
@@ -53,15 +55,29 @@ class PreSplitOptimizer : public RuleExecutor<IR> {
     limit_pushdown->AddRule<LimitPushdownRule>(compiler_state_);
   }
 
+  void CreateTopKLimitFoldBatch() {
+    // Runs after the limit pushdown, which can move a Limit right after a TopK.
+    RuleBatch* topk_limit_fold = CreateRuleBatch<FailOnMax>("TopKLimitFold", 2);
+    topk_limit_fold->AddRule<TopKLimitFoldRule>(compiler_state_);
+  }
+
   void CreateFilterPushdownBatch() {
     // Use TryUntilMax here to avoid swapping the positions of "equal" filters endlessly.
     RuleBatch* filter_pushdown = CreateRuleBatch<TryUntilMax>("FilterPushdown", 1);
     filter_pushdown->AddRule<FilterPushdownRule>(compiler_state_);
   }
 
+  void CreatePartitionPruningBatch() {
+    // Runs after the filter pushdown, which moves the filters right after the MemorySources.
+    RuleBatch* partition_pruning = CreateRuleBatch<FailOnMax>("PartitionPruning", 2);
+    partition_pruning->AddRule<PartitionPruningRule>(compiler_state_);
+  }
+
   Status Init() {
     CreateLimitPushdownBatch();
+    CreateTopKLimitFoldBatch();
     CreateFilterPushdownBatch();
+    CreatePartitionPruningBatch();
     return Status::OK();
   }
 
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/planner/distributed/splitter/presplit_optimizer/topk_limit_fold_rule.h"
+
+#include <algorithm>
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace distributed {
+
+StatusOr<bool> TopKLimitFoldRule::Apply(IRNode* ir_node) {
+  if (!Match(ir_node, Limit())) {
+    return false;
+  }
+  LimitIR* limit = static_cast<LimitIR*>(ir_node);
+  // A TopK limit of 0 means no limit, so there's nothing to fold for a Limit of 0.
+  if (limit->pem_only() || !limit->limit_value_set() || limit->limit_value() <= 0) {
+    return false;
+  }
+  DCHECK_EQ(1, limit->parents().size());
+  OperatorIR* parent = limit->parents()[0];
+  // The TopK can only keep fewer rows if nothing else reads all of its output.
+  if (!Match(parent, TopK()) || parent->Children().size() > 1) {
+    return false;
+  }
+
+  TopKIR* topk = static_cast<TopKIR*>(parent);
+  int64_t new_limit = limit->limit_value();
+  if (topk->limit_value_set() && topk->limit_value() > 0) {
+    new_limit = std::min(new_limit, topk->limit_value());
+  }
+  if (topk->limit_value_set() && topk->limit_value() == new_limit) {
+    return false;
+  }
+  // The Limit is left in place, it doesn't drop any rows of the TopK anymore.
+  topk->SetLimitValue(new_limit);
+  return true;
+}
+
+}  // namespace distributed
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,84 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include "src/carnot/planner/compiler/test_utils.h"
+#include "src/carnot/planner/distributed/splitter/presplit_optimizer/topk_limit_fold_rule.h"
+#include "src/carnot/planner/test_utils.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+namespace distributed {
+
+using TopKLimitFoldRuleTest = testutils::DistributedRulesTest;
+TEST_F(TopKLimitFoldRuleTest, simple) {
+  Relation relation({types::DataType::INT64, types::DataType::INT64}, {"abc", "xyz"});
+  MemorySourceIR* src = MakeMemSource(relation);
+  TopKIR* topk = MakeTopK(src, {"abc"}, {true});
+  LimitIR* limit = MakeLimit(topk, 10);
+  MakeMemSink(limit, "foo", {});
+
+  TopKLimitFoldRule rule(compiler_state_.get());
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_TRUE(result.ValueOrDie());
+  ASSERT_TRUE(topk->limit_value_set());
+  EXPECT_EQ(10, topk->limit_value());
+
+  // Folding again doesn't change anything.
+  result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ValueOrDie());
+}
+
+TEST_F(TopKLimitFoldRuleTest, keeps_smaller_limit) {
+  Relation relation({types::DataType::INT64, types::DataType::INT64}, {"abc", "xyz"});
+  MemorySourceIR* src = MakeMemSource(relation);
+  TopKIR* topk = MakeTopK(src, {"abc"}, {true});
+  topk->SetLimitValue(5);
+  LimitIR* limit = MakeLimit(topk, 10);
+  MakeMemSink(limit, "foo", {});
+
+  TopKLimitFoldRule rule(compiler_state_.get());
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ValueOrDie());
+  EXPECT_EQ(5, topk->limit_value());
+}
+
+TEST_F(TopKLimitFoldRuleTest, topk_with_other_children) {
+  Relation relation({types::DataType::INT64, types::DataType::INT64}, {"abc", "xyz"});
+  MemorySourceIR* src = MakeMemSource(relation);
+  TopKIR* topk = MakeTopK(src, {"abc"}, {true});
+  LimitIR* limit = MakeLimit(topk, 10);
+  MakeMemSink(limit, "foo", {});
+  MakeMemSink(topk, "bar", {});
+
+  TopKLimitFoldRule rule(compiler_state_.get());
+  auto result = rule.Execute(graph.get());
+  ASSERT_OK(result);
+  EXPECT_FALSE(result.ValueOrDie());
+  EXPECT_FALSE(topk->limit_value_set());
+}
+
+}  // namespace distributed
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
@@ -47,6 +47,7 @@
 #include "src/carnot/planner/ir/string_ir.h"
 #include "src/carnot/planner/ir/tablet_source_group_ir.h"
 #include "src/carnot/planner/ir/time_ir.h"
+#include "src/carnot/planner/ir/topk_ir.h"
 #include "src/carnot/planner/ir/udtf_source_ir.h"
 #include "src/carnot/planner/ir/uint128_ir.h"
 #include "src/carnot/planner/ir/union_ir.h"
@@ -51,9 +51,22 @@ Status BlockingAggIR::SetAggExprs(const ColExpressionVector& agg_exprs) {
   return Status::OK();
 }
 
+Status BlockingAggIR::SetRollingWindow(ColumnIR* window_col, int64_t window_size) {
+  if (rolling_window_col_ != nullptr) {
+    PL_RETURN_IF_ERROR(graph()->DeleteEdge(this, rolling_window_col_));
+    PL_RETURN_IF_ERROR(graph()->DeleteOrphansInSubtree(rolling_window_col_->id()));
+  }
+  PL_ASSIGN_OR_RETURN(rolling_window_col_, graph()->OptionallyCloneWithEdge(this, window_col));
+  rolling_window_size_ = window_size;
+  return Status::OK();
+}
+
 StatusOr<std::vector<absl::flat_hash_set<std::string>>> BlockingAggIR::RequiredInputColumns()
     const {
   absl::flat_hash_set<std::string> required;
+  if (rolling()) {
+    required.insert(rolling_window_col_->col_name());
+  }
   for (const auto& group : groups()) {
     required.insert(group->col_name());
   }
@@ -81,6 +94,9 @@ StatusOr<absl::flat_hash_set<std::string>> BlockingAggIR::PruneOutputColumnsToIm
   for (const ColumnIR* group : groups()) {
     kept_columns.insert(group->col_name());
   }
+  if (rolling()) {
+    kept_columns.insert(rolling_window_col_->col_name());
+  }
   return kept_columns;
 }
 
@@ -127,6 +143,11 @@ Status BlockingAggIR::ToProto(planpb::Operator* op) const {
   pb->set_windowed(false);
   pb->set_partial_agg(partial_agg_);
   pb->set_finalize_results(finalize_results_);
+  if (rolling()) {
+    auto rolling_window_pb = pb->mutable_rolling_window();
+    PL_RETURN_IF_ERROR(rolling_window_col_->ToProto(rolling_window_pb->mutable_time_col()));
+    rolling_window_pb->set_window_size(rolling_window_size_);
+  }
 
   op->set_op_type(planpb::AGGREGATE_OPERATOR);
   return Status::OK();
@@ -151,6 +172,11 @@ Status BlockingAggIR::CopyFromNodeImpl(
 
   PL_RETURN_IF_ERROR(SetAggExprs(new_agg_exprs));
   PL_RETURN_IF_ERROR(SetGroups(new_groups));
+  if (blocking_agg->rolling()) {
+    PL_ASSIGN_OR_RETURN(ColumnIR * new_window_col,
+                        graph()->CopyNode(blocking_agg->rolling_window_col_, copied_nodes_map));
+    PL_RETURN_IF_ERROR(SetRollingWindow(new_window_col, blocking_agg->rolling_window_size_));
+  }
 
   finalize_results_ = blocking_agg->finalize_results_;
   partial_agg_ = blocking_agg->partial_agg_;
@@ -162,6 +188,11 @@ Status BlockingAggIR::CopyFromNodeImpl(
 Status BlockingAggIR::ResolveType(CompilerState* compiler_state) {
   DCHECK_EQ(1, parent_types().size());
   auto new_table = TableType::Create();
+  if (rolling()) {
+    PL_RETURN_IF_ERROR(
+        ResolveExpressionType(rolling_window_col_, compiler_state, parent_types()));
+    new_table->AddColumn(rolling_window_col_->col_name(), rolling_window_col_->resolved_type());
+  }
   for (const auto& group_col : groups()) {
     PL_RETURN_IF_ERROR(ResolveExpressionType(group_col, compiler_state, parent_types()));
     new_table->AddColumn(group_col->col_name(), group_col->resolved_type());
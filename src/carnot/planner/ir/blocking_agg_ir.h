@@ -75,6 +75,16 @@ class BlockingAggIR : public GroupAcceptorIR {
     pre_split_proto_ = pre_split_proto;
   }
 
+  /**
+   * @brief Makes this aggregate over rolling windows of window_size along window_col, rather than
+   * over all of its input. The output then starts with window_col, holding the start time of each
+   * window.
+   */
+  Status SetRollingWindow(ColumnIR* window_col, int64_t window_size);
+  bool rolling() const { return rolling_window_col_ != nullptr; }
+  ColumnIR* rolling_window_col() const { return rolling_window_col_; }
+  int64_t rolling_window_size() const { return rolling_window_size_; }
+
  protected:
   StatusOr<absl::flat_hash_set<std::string>> PruneOutputColumnsToImpl(
       const absl::flat_hash_set<std::string>& output_colnames) override;
@@ -87,6 +97,9 @@ class BlockingAggIR : public GroupAcceptorIR {
   // Whether this finalizes the result of a partial aggregate.
   bool finalize_results_ = true;
   planpb::AggregateOperator pre_split_proto_;
+  // The time column that the rolling windows slide along, or nullptr if this isn't rolling.
+  ColumnIR* rolling_window_col_ = nullptr;
+  int64_t rolling_window_size_ = 0;
 };
 }  // namespace planner
 }  // namespace carnot
@@ -554,6 +554,90 @@ TEST_F(ToProtoTest, limit_ir) {
   EXPECT_THAT(pb, EqualsProto(kExpectedLimitPb));
 }
 
+constexpr char kExpectedTopKPb[] = R"(
+  op_type: TOPK_OPERATOR
+  topk_op {
+    sort_columns {
+      column {
+        node: 0
+        index: 1
+      }
+      descending: true
+    }
+    sort_columns {
+      column {
+        node: 0
+        index: 0
+      }
+      descending: false
+    }
+    limit: 5
+    columns {
+      node: 0
+      index: 0
+    }
+    columns {
+      node: 0
+      index: 1
+    }
+    columns {
+      node: 0
+      index: 2
+    }
+  }
+)";
+
+TEST_F(ToProtoTest, topk_ir) {
+  auto mem_src = graph
+                     ->CreateNode<MemorySourceIR>(
+                         ast, "source", std::vector<std::string>{"col1", "group1", "column"})
+                     .ValueOrDie();
+  table_store::schema::Relation src_rel({types::INT64, types::INT64, types::INT64},
+                                        {"col1", "group1", "column"});
+  compiler_state_->relation_map()->emplace("source", src_rel);
+
+  auto topk = graph
+                  ->CreateNode<TopKIR>(ast, mem_src, std::vector<std::string>{"group1", "col1"},
+                                       std::vector<bool>{true, false})
+                  .ValueOrDie();
+
+  ResolveTypesRule type_rule(compiler_state_.get());
+  ASSERT_OK(type_rule.Execute(graph.get()));
+
+  // Without a limit, all the rows are sorted.
+  planpb::Operator pb;
+  ASSERT_OK(topk->ToProto(&pb));
+  EXPECT_EQ(0, pb.topk_op().limit());
+
+  topk->SetLimitValue(5);
+  pb.Clear();
+  ASSERT_OK(topk->ToProto(&pb));
+  EXPECT_THAT(pb, EqualsProto(kExpectedTopKPb));
+
+  // A limit of 0 would be read as no limit.
+  topk->SetLimitValue(0);
+  EXPECT_THAT(topk->ToProto(&pb), HasCompilerError("TopK limit must be positive, received 0"));
+  topk->SetLimitValue(-1);
+  EXPECT_THAT(topk->ToProto(&pb), HasCompilerError("TopK limit must be positive, received -1"));
+}
+
+TEST_F(ToProtoTest, topk_ir_missing_column) {
+  auto mem_src = graph
+                     ->CreateNode<MemorySourceIR>(
+                         ast, "source", std::vector<std::string>{"col1", "group1", "column"})
+                     .ValueOrDie();
+  table_store::schema::Relation src_rel({types::INT64, types::INT64, types::INT64},
+                                        {"col1", "group1", "column"});
+  compiler_state_->relation_map()->emplace("source", src_rel);
+
+  ASSERT_OK(graph->CreateNode<TopKIR>(ast, mem_src, std::vector<std::string>{"bogus"},
+                                      std::vector<bool>{false}));
+
+  ResolveTypesRule type_rule(compiler_state_.get());
+  EXPECT_THAT(type_rule.Execute(graph.get()).status(),
+              HasCompilerError("Column 'bogus' not found in parent dataframe"));
+}
+
 constexpr char kInt64PbTxt[] = R"proto(
 constant {
   data_type: INT64
@@ -60,6 +60,18 @@ Status MemorySourceIR::ToProto(planpb::Operator* op) const {
     pb->set_tablet(tablet_value());
   }
 
+  if (HasPartitionFilter()) {
+    auto partition_filter = pb->mutable_partition_filter();
+    for (const auto& upid : partition_upids_) {
+      auto upid_pb = partition_filter->add_upids();
+      upid_pb->set_high(absl::Uint128High64(upid));
+      upid_pb->set_low(absl::Uint128Low64(upid));
+    }
+    for (const auto& pod_name : partition_pod_names_) {
+      partition_filter->add_pod_names(pod_name);
+    }
+  }
+
   pb->set_streaming(streaming());
   return Status::OK();
 }
@@ -135,6 +147,9 @@ Status MemorySourceIR::CopyFromNodeImpl(
   column_index_map_ = source_ir->column_index_map_;
   has_time_expressions_ = source_ir->has_time_expressions_;
   streaming_ = source_ir->streaming_;
+  partition_upids_ = source_ir->partition_upids_;
+  partition_pod_names_ = source_ir->partition_pod_names_;
+  has_partition_filter_ = source_ir->has_partition_filter_;
 
   if (has_time_expressions_) {
     PL_ASSIGN_OR_RETURN(ExpressionIR * new_start_expr,
@@ -55,6 +55,9 @@ class MemorySourceIR : public OperatorIR {
   Status Init(const std::string& table_name, const std::vector<std::string>& select_columns);
 
   std::string table_name() const { return table_name_; }
+  // Reads another table instead, such as a rollup of this one. Only valid before the types are
+  // resolved.
+  void SetTableName(const std::string& table_name) { table_name_ = table_name; }
 
   // Whether or not the MemorySource should be executed in persistent streaming mode,
   // where the MemorySource reads data indefinitely.
@@ -111,6 +114,20 @@ class MemorySourceIR : public OperatorIR {
     return tablet_value_;
   }
 
+  /**
+   * @brief Sets the UPIDs and pods whose rows can pass the filters of the query. Partitioned
+   * tables then only read the partitions that hold those rows.
+   */
+  void SetPartitionFilter(const std::vector<absl::uint128>& upids,
+                          const std::vector<std::string>& pod_names) {
+    partition_upids_ = upids;
+    partition_pod_names_ = pod_names;
+    has_partition_filter_ = true;
+  }
+  bool HasPartitionFilter() const { return has_partition_filter_; }
+  const std::vector<absl::uint128>& partition_upids() const { return partition_upids_; }
+  const std::vector<std::string>& partition_pod_names() const { return partition_pod_names_; }
+
   StatusOr<std::vector<absl::flat_hash_set<std::string>>> RequiredInputColumns() const override {
     return std::vector<absl::flat_hash_set<std::string>>{};
   }
@@ -146,6 +163,10 @@ class MemorySourceIR : public OperatorIR {
 
   types::TabletID tablet_value_;
   bool has_tablet_value_ = false;
+
+  std::vector<absl::uint128> partition_upids_;
+  std::vector<std::string> partition_pod_names_;
+  bool has_partition_filter_ = false;
 };
 
 }  // namespace planner
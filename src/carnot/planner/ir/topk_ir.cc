@@ -0,0 +1,99 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/planner/ir/topk_ir.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+
+Status TopKIR::Init(OperatorIR* parent, const std::vector<std::string>& sort_cols,
+                    const std::vector<bool>& descending) {
+  DCHECK_EQ(sort_cols.size(), descending.size());
+  PL_RETURN_IF_ERROR(AddParent(parent));
+  sort_cols_ = sort_cols;
+  descending_ = descending;
+  return Status::OK();
+}
+
+StatusOr<std::vector<absl::flat_hash_set<std::string>>> TopKIR::RequiredInputColumns() const {
+  DCHECK(is_type_resolved());
+  absl::flat_hash_set<std::string> required_cols(resolved_table_type()->ColumnNames().begin(),
+                                                 resolved_table_type()->ColumnNames().end());
+  required_cols.insert(sort_cols_.begin(), sort_cols_.end());
+  return std::vector<absl::flat_hash_set<std::string>>{required_cols};
+}
+
+Status TopKIR::ResolveType(CompilerState* /* compiler_state */) {
+  DCHECK_EQ(1, parent_types().size());
+  auto parent_table = std::static_pointer_cast<TableType>(parent_types()[0]);
+  for (const auto& col_name : sort_cols_) {
+    if (!parent_table->HasColumn(col_name)) {
+      return CreateIRNodeError("Column '$0' not found in parent dataframe", col_name);
+    }
+  }
+  return SetResolvedType(parent_table->Copy());
+}
+
+Status TopKIR::ToProto(planpb::Operator* op) const {
+  auto pb = op->mutable_topk_op();
+  op->set_op_type(planpb::TOPK_OPERATOR);
+  DCHECK_EQ(parents().size(), 1UL);
+
+  DCHECK(parents()[0]->is_type_resolved());
+  auto parent_table_type = parents()[0]->resolved_table_type();
+  auto parent_id = parents()[0]->id();
+
+  for (const auto& [i, col_name] : Enumerate(sort_cols_)) {
+    if (!parent_table_type->HasColumn(col_name)) {
+      return CreateIRNodeError("Sort column '$0' not found in parent", col_name);
+    }
+    auto sort_col_pb = pb->add_sort_columns();
+    sort_col_pb->mutable_column()->set_node(parent_id);
+    sort_col_pb->mutable_column()->set_index(parent_table_type->GetColumnIndex(col_name));
+    sort_col_pb->set_descending(descending_[i]);
+  }
+
+  DCHECK(is_type_resolved());
+  for (const std::string& col_name : resolved_table_type()->ColumnNames()) {
+    planpb::Column* col_pb = pb->add_columns();
+    col_pb->set_node(parent_id);
+    DCHECK(parent_table_type->HasColumn(col_name));
+    col_pb->set_index(parent_table_type->GetColumnIndex(col_name));
+  }
+
+  // A limit of 0 in the proto means no limit, so a set limit must keep at least one row.
+  if (limit_value_set_ && limit_value_ <= 0) {
+    return CreateIRNodeError("TopK limit must be positive, received $0", limit_value_);
+  }
+  pb->set_limit(limit_value_set_ ? limit_value_ : 0);
+  return Status::OK();
+}
+
+Status TopKIR::CopyFromNodeImpl(const IRNode* node, absl::flat_hash_map<const IRNode*, IRNode*>*) {
+  const TopKIR* topk = static_cast<const TopKIR*>(node);
+  sort_cols_ = topk->sort_cols_;
+  descending_ = topk->descending_;
+  limit_value_ = topk->limit_value_;
+  limit_value_set_ = topk->limit_value_set_;
+  return Status::OK();
+}
+
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
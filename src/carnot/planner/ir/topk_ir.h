@@ -0,0 +1,85 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/carnot/planner/compiler_state/compiler_state.h"
+#include "src/carnot/planner/ir/operator_ir.h"
+#include "src/carnot/planner/types/types.h"
+#include "src/common/base/base.h"
+#include "src/shared/types/types.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+
+/**
+ * @brief The TopKIR sorts its parent by a list of columns and keeps the first rows.
+ *
+ * Without a limit value it sorts all of the rows. A Limit that directly follows a TopK is folded
+ * into its limit value before splitting, so that the distributed plan can keep only the top rows
+ * on each agent.
+ */
+class TopKIR : public OperatorIR {
+ public:
+  TopKIR() = delete;
+  explicit TopKIR(int64_t id) : OperatorIR(id, IRNodeType::kTopK) {}
+
+  Status Init(OperatorIR* parent, const std::vector<std::string>& sort_cols,
+              const std::vector<bool>& descending);
+
+  Status ToProto(planpb::Operator*) const override;
+
+  const std::vector<std::string>& sort_cols() const { return sort_cols_; }
+  const std::vector<bool>& descending() const { return descending_; }
+
+  void SetLimitValue(int64_t value) {
+    limit_value_ = value;
+    limit_value_set_ = true;
+  }
+  bool limit_value_set() const { return limit_value_set_; }
+  int64_t limit_value() const { return limit_value_; }
+
+  Status CopyFromNodeImpl(const IRNode* node,
+                          absl::flat_hash_map<const IRNode*, IRNode*>* copied_nodes_map) override;
+  inline bool IsBlocking() const override { return true; }
+
+  StatusOr<std::vector<absl::flat_hash_set<std::string>>> RequiredInputColumns() const override;
+
+  Status ResolveType(CompilerState* compiler_state);
+
+ protected:
+  StatusOr<absl::flat_hash_set<std::string>> PruneOutputColumnsToImpl(
+      const absl::flat_hash_set<std::string>& output_cols) override {
+    return output_cols;
+  }
+
+ private:
+  std::vector<std::string> sort_cols_;
+  std::vector<bool> descending_;
+  int64_t limit_value_ = 0;
+  bool limit_value_set_ = false;
+};
+
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
@@ -18,10 +18,24 @@
 
 #include "src/carnot/planner/logical_planner.h"
 
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
 #include <utility>
 
+#include <absl/strings/str_cat.h>
+
 #include "src/shared/scriptspb/scripts.pb.h"
 
+DEFINE_int64(planner_plan_cache_size, gflags::Int64FromEnv("PL_PLANNER_PLAN_CACHE_SIZE", 128),
+             "The number of compiled queries (and of serialized plans) the planner keeps for "
+             "reuse by identical requests. 0 disables the cache.");
+DEFINE_int64(planner_plan_cache_max_staleness_ms,
+             gflags::Int64FromEnv("PL_PLANNER_PLAN_CACHE_MAX_STALENESS_MS", 0),
+             "How long a cached plan that depends on the compile time other than as an offset "
+             "(eg. rounded to rollup buckets) may be reused. Such a plan queries a time window "
+             "that lags by up to this duration. 0 never reuses them.");
+
 namespace px {
 namespace carnot {
 namespace planner {
@@ -60,7 +74,7 @@ static inline RedactionOptions RedactionOptionsFromPb(
 
 StatusOr<std::unique_ptr<CompilerState>> CreateCompilerState(
     const distributedpb::LogicalPlannerState& logical_state, RegistryInfo* registry_info,
-    int64_t max_output_rows_per_table) {
+    int64_t max_output_rows_per_table, int64_t time_now) {
   PL_ASSIGN_OR_RETURN(std::unique_ptr<RelationMap> rel_map,
                       MakeRelationMapFromDistributedState(logical_state.distributed_state()));
 
@@ -72,14 +86,59 @@ StatusOr<std::unique_ptr<CompilerState>> CreateCompilerState(
       {"nats_events.beta", {"body", "resp"}},
       {"pgsql_events", {"req", "resp"}},
       {"redis_events", {"req_args", "resp"}}};
-  // Create a CompilerState obj using the relation map and grabbing the current time.
+  // Create a CompilerState obj using the relation map and the time to compile at.
   return std::make_unique<planner::CompilerState>(
-      std::move(rel_map), sensitive_columns, registry_info, px::CurrentTimeNS(),
+      std::move(rel_map), sensitive_columns, registry_info, time_now,
       max_output_rows_per_table, logical_state.result_address(),
       logical_state.result_ssl_targetname(),
       RedactionOptionsFromPb(logical_state.redaction_options()));
 }
 
+namespace {
+
+// How much later than the compile time a time-dependent query is planned again, to find the
+// values of the plan that hold the time. It isn't a round duration, so that uses of the time
+// rounded to seconds or minutes don't shift by exactly as much.
+constexpr int64_t kTimeParamsProbeShiftNs = 3600LL * 1000 * 1000 * 1000 + 1;
+
+std::string SerializeDeterministic(const google::protobuf::Message& msg) {
+  std::string out;
+  {
+    google::protobuf::io::StringOutputStream string_stream(&out);
+    google::protobuf::io::CodedOutputStream coded_stream(&string_stream);
+    coded_stream.SetSerializationDeterministic(true);
+    msg.SerializeToCodedStream(&coded_stream);
+  }
+  return out;
+}
+
+std::string CacheKey(const google::protobuf::Message& state, const plannerpb::QueryRequest& query) {
+  std::string state_str = SerializeDeterministic(state);
+  // Prefix the state with its size, so that the two parts can't run into each other.
+  return absl::StrCat(state_str.size(), ":", state_str, SerializeDeterministic(query));
+}
+
+// The key of everything compilation depends on: the request, the options, and the schemas, but
+// not the agents.
+std::string CompileCacheKey(const distributedpb::LogicalPlannerState& logical_state,
+                            const plannerpb::QueryRequest& query) {
+  distributedpb::LogicalPlannerState compile_state = logical_state;
+  auto* distributed_state = compile_state.mutable_distributed_state();
+  distributed_state->clear_carnot_info();
+  for (auto& schema_info : *distributed_state->mutable_schema_info()) {
+    schema_info.clear_agent_list();
+  }
+  return CacheKey(compile_state, query);
+}
+
+}  // namespace
+
+LogicalPlanner::LogicalPlanner()
+    : compiled_query_cache_(FLAGS_planner_plan_cache_size,
+                            FLAGS_planner_plan_cache_max_staleness_ms * 1000 * 1000),
+      plan_cache_(FLAGS_planner_plan_cache_size,
+                  FLAGS_planner_plan_cache_max_staleness_ms * 1000 * 1000) {}
+
 StatusOr<std::unique_ptr<LogicalPlanner>> LogicalPlanner::Create(const udfspb::UDFInfo& udf_info) {
   auto planner = std::unique_ptr<LogicalPlanner>(new LogicalPlanner());
   PL_RETURN_IF_ERROR(planner->Init(udf_info));
@@ -98,20 +157,113 @@ Status LogicalPlanner::Init(const udfspb::UDFInfo& udf_info) {
 StatusOr<std::unique_ptr<distributed::DistributedPlan>> LogicalPlanner::Plan(
     const distributedpb::LogicalPlannerState& logical_state,
     const plannerpb::QueryRequest& query_request) {
+  PL_ASSIGN_OR_RETURN(std::shared_ptr<CompiledQuery> compiled,
+                      GetCompiledQuery(logical_state, query_request));
+  return PlanCompiledQuery(logical_state, compiled.get());
+}
+
+StatusOr<std::shared_ptr<LogicalPlanner::CompiledQuery>> LogicalPlanner::Compile(
+    const distributedpb::LogicalPlannerState& logical_state,
+    const plannerpb::QueryRequest& query_request, int64_t time_now) {
   // Compile into the IR.
   auto ms = logical_state.plan_options().max_output_rows_per_table();
   VLOG(1) << "Max output rows: " << ms;
-  PL_ASSIGN_OR_RETURN(std::unique_ptr<CompilerState> compiler_state,
-                      CreateCompilerState(logical_state, registry_info_.get(), ms));
+  auto compiled = std::make_shared<CompiledQuery>();
+  PL_ASSIGN_OR_RETURN(compiled->compiler_state,
+                      CreateCompilerState(logical_state, registry_info_.get(), ms, time_now));
 
   std::vector<plannerpb::FuncToExecute> exec_funcs(query_request.exec_funcs().begin(),
                                                    query_request.exec_funcs().end());
-  PL_ASSIGN_OR_RETURN(
-      std::shared_ptr<IR> single_node_plan,
-      compiler_.CompileToIR(query_request.query_str(), compiler_state.get(), exec_funcs));
+  PL_ASSIGN_OR_RETURN(compiled->ir, compiler_.CompileToIR(query_request.query_str(),
+                                                          compiled->compiler_state.get(),
+                                                          exec_funcs));
+  ++num_compiles_;
+  compiled->time_dependent = compiled->compiler_state->time_now_used();
+  compiled->time_shiftable = compiled->compiler_state->time_now_shiftable();
+  compiled->compiled_at_ns = time_now;
+  return compiled;
+}
+
+StatusOr<std::shared_ptr<LogicalPlanner::CompiledQuery>> LogicalPlanner::GetCompiledQuery(
+    const distributedpb::LogicalPlannerState& logical_state,
+    const plannerpb::QueryRequest& query_request) {
+  int64_t now = px::CurrentTimeNS();
+  std::string compile_key = CompileCacheKey(logical_state, query_request);
+  std::shared_ptr<CompiledQuery> compiled = compiled_query_cache_.Get(compile_key, now);
+  if (compiled != nullptr) {
+    return compiled;
+  }
+  PL_ASSIGN_OR_RETURN(compiled, Compile(logical_state, query_request, now));
+  // The IR can't be moved to a later time, so time dependent queries follow the staleness limit.
+  compiled_query_cache_.Put(std::move(compile_key), compiled, compiled->time_dependent,
+                            compiled->compiled_at_ns);
+  return compiled;
+}
+
+StatusOr<std::unique_ptr<distributed::DistributedPlan>> LogicalPlanner::PlanCompiledQuery(
+    const distributedpb::LogicalPlannerState& logical_state, CompiledQuery* compiled) {
   // Create the distributed plan.
-  return distributed_planner_->Plan(logical_state.distributed_state(), compiler_state.get(),
-                                    single_node_plan.get());
+  absl::MutexLock lock(&compiled->mu);
+  return distributed_planner_->Plan(logical_state.distributed_state(),
+                                    compiled->compiler_state.get(), compiled->ir.get());
+}
+
+StatusOr<distributedpb::DistributedPlan> LogicalPlanner::PlanCompiledQueryToProto(
+    const distributedpb::LogicalPlannerState& logical_state, CompiledQuery* compiled) {
+  PL_ASSIGN_OR_RETURN(std::unique_ptr<distributed::DistributedPlan> distributed_plan,
+                      PlanCompiledQuery(logical_state, compiled));
+  // In the future, if we actually have plan options that will actually determine how the plan is
+  // constructed, we may want to pass the planOptions to planner.Plan. However, this
+  // will need to go through many more layers (such as the coordinator), so this is fine for now.
+  distributed_plan->SetPlanOptions(logical_state.plan_options());
+  return distributed_plan->ToProto();
+}
+
+StatusOr<PlanTimeParams> LogicalPlanner::FindTimeParams(
+    const distributedpb::LogicalPlannerState& logical_state,
+    const plannerpb::QueryRequest& query_request, const distributedpb::DistributedPlan& plan,
+    int64_t compiled_at_ns) {
+  PL_ASSIGN_OR_RETURN(
+      std::shared_ptr<CompiledQuery> shifted,
+      Compile(logical_state, query_request, compiled_at_ns + kTimeParamsProbeShiftNs));
+  PL_ASSIGN_OR_RETURN(distributedpb::DistributedPlan shifted_plan,
+                      PlanCompiledQueryToProto(logical_state, shifted.get()));
+  return PlanTimeParams::Find(plan, shifted_plan, kTimeParamsProbeShiftNs);
+}
+
+StatusOr<distributedpb::DistributedPlan> LogicalPlanner::PlanToProto(
+    const distributedpb::LogicalPlannerState& logical_state,
+    const plannerpb::QueryRequest& query_request) {
+  int64_t now = px::CurrentTimeNS();
+  std::string plan_key = CacheKey(logical_state, query_request);
+  auto cached_plan = plan_cache_.Get(plan_key, now);
+  if (cached_plan != nullptr) {
+    // Move the plan to the current time, as if it was compiled now.
+    distributedpb::DistributedPlan plan_pb = cached_plan->plan;
+    cached_plan->time_params.Shift(now - cached_plan->compiled_at_ns, &plan_pb);
+    return plan_pb;
+  }
+
+  PL_ASSIGN_OR_RETURN(std::shared_ptr<CompiledQuery> compiled,
+                      GetCompiledQuery(logical_state, query_request));
+  auto new_plan = std::make_shared<CachedPlan>();
+  PL_ASSIGN_OR_RETURN(new_plan->plan, PlanCompiledQueryToProto(logical_state, compiled.get()));
+  new_plan->compiled_at_ns = compiled->compiled_at_ns;
+
+  bool time_dependent = compiled->time_dependent;
+  if (time_dependent && compiled->time_shiftable && FLAGS_planner_plan_cache_size > 0) {
+    // The plan can be reused at any time, if the compile time only ends up in it as an offset.
+    auto time_params_or_s =
+        FindTimeParams(logical_state, query_request, new_plan->plan, compiled->compiled_at_ns);
+    if (time_params_or_s.ok()) {
+      new_plan->time_params = time_params_or_s.ConsumeValueOrDie();
+      time_dependent = false;
+    } else {
+      VLOG(1) << "The plan can't be moved to a later time: " << time_params_or_s.msg();
+    }
+  }
+  plan_cache_.Put(std::move(plan_key), new_plan, time_dependent, new_plan->compiled_at_ns);
+  return new_plan->plan;
 }
 
 StatusOr<std::unique_ptr<compiler::MutationsIR>> LogicalPlanner::CompileTrace(
@@ -120,8 +272,9 @@ StatusOr<std::unique_ptr<compiler::MutationsIR>> LogicalPlanner::CompileTrace(
   // Compile into the IR.
   auto ms = logical_state.plan_options().max_output_rows_per_table();
   VLOG(1) << "Max output rows: " << ms;
-  PL_ASSIGN_OR_RETURN(std::unique_ptr<CompilerState> compiler_state,
-                      CreateCompilerState(logical_state, registry_info_.get(), ms));
+  PL_ASSIGN_OR_RETURN(
+      std::unique_ptr<CompilerState> compiler_state,
+      CreateCompilerState(logical_state, registry_info_.get(), ms, px::CurrentTimeNS()));
 
   std::vector<plannerpb::FuncToExecute> exec_funcs(mutations_req.exec_funcs().begin(),
                                                    mutations_req.exec_funcs().end());
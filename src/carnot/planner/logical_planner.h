@@ -17,6 +17,7 @@
  */
 
 #pragma once
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
@@ -25,6 +26,9 @@
 #include "src/carnot/planner/compiler_state/compiler_state.h"
 #include "src/carnot/planner/distributed/distributed_plan/distributed_plan.h"
 #include "src/carnot/planner/distributed/distributed_planner.h"
+#include "src/carnot/planner/distributedpb/distributed_plan.pb.h"
+#include "src/carnot/planner/plan_cache.h"
+#include "src/carnot/planner/plan_time_params.h"
 #include "src/carnot/planner/plannerpb/func_args.pb.h"
 #include "src/carnot/planner/probes/probes.h"
 #include "src/shared/scriptspb/scripts.pb.h"
@@ -58,6 +62,19 @@ class LogicalPlanner : public NotCopyable {
       const distributedpb::LogicalPlannerState& logical_state,
       const plannerpb::QueryRequest& query);
 
+  /**
+   * @brief Plans the query and serializes the distributed plan, with the plan options of the
+   * logical state set.
+   *
+   * Identical requests (same script, arguments, schemas, agents and options) reuse the
+   * serialized plan of an earlier request, with the values that hold the compile time (eg. the
+   * start of a relative time range) moved to the current time. When only the agents changed, the
+   * compiled query is reused, and only the distributed planning is redone.
+   */
+  StatusOr<distributedpb::DistributedPlan> PlanToProto(
+      const distributedpb::LogicalPlannerState& logical_state,
+      const plannerpb::QueryRequest& query);
+
   StatusOr<std::unique_ptr<compiler::MutationsIR>> CompileTrace(
       const distributedpb::LogicalPlannerState& logical_state,
       const plannerpb::CompileMutationsRequest& mutations_req);
@@ -65,13 +82,56 @@ class LogicalPlanner : public NotCopyable {
   Status Init(std::unique_ptr<planner::RegistryInfo> registry_info);
   Status Init(const udfspb::UDFInfo& udf_info);
 
+  // The number of queries compiled so far, cache hits excluded.
+  int64_t num_compiles() const { return num_compiles_; }
+
  protected:
-  LogicalPlanner() {}
+  LogicalPlanner();
 
  private:
+  // A query compiled to the IR, along with the state it was compiled with. The state keeps the
+  // ids of the functions in the IR, so it is reused (under the lock) when the IR is planned.
+  struct CompiledQuery {
+    std::unique_ptr<CompilerState> compiler_state;
+    std::shared_ptr<IR> ir;
+    bool time_dependent = false;
+    bool time_shiftable = true;
+    int64_t compiled_at_ns = 0;
+    absl::Mutex mu;
+  };
+
+  // A serialized plan, along with the values in it that hold the compile time.
+  struct CachedPlan {
+    distributedpb::DistributedPlan plan;
+    PlanTimeParams time_params;
+    int64_t compiled_at_ns = 0;
+  };
+
+  StatusOr<std::shared_ptr<CompiledQuery>> Compile(
+      const distributedpb::LogicalPlannerState& logical_state,
+      const plannerpb::QueryRequest& query, int64_t time_now);
+  // Returns the compiled query from the cache, or compiles it now.
+  StatusOr<std::shared_ptr<CompiledQuery>> GetCompiledQuery(
+      const distributedpb::LogicalPlannerState& logical_state,
+      const plannerpb::QueryRequest& query);
+  StatusOr<std::unique_ptr<distributed::DistributedPlan>> PlanCompiledQuery(
+      const distributedpb::LogicalPlannerState& logical_state, CompiledQuery* compiled);
+  StatusOr<distributedpb::DistributedPlan> PlanCompiledQueryToProto(
+      const distributedpb::LogicalPlannerState& logical_state, CompiledQuery* compiled);
+  // Finds the time params of the plan of the query, compiled at compiled_at_ns, by planning the
+  // query again at a later time.
+  StatusOr<PlanTimeParams> FindTimeParams(const distributedpb::LogicalPlannerState& logical_state,
+                                          const plannerpb::QueryRequest& query,
+                                          const distributedpb::DistributedPlan& plan,
+                                          int64_t compiled_at_ns);
+
   compiler::Compiler compiler_;
   std::unique_ptr<distributed::Planner> distributed_planner_;
   std::unique_ptr<planner::RegistryInfo> registry_info_;
+
+  PlanCache<CompiledQuery> compiled_query_cache_;
+  PlanCache<const CachedPlan> plan_cache_;
+  std::atomic<int64_t> num_compiles_ = 0;
 };
 
 }  // namespace planner
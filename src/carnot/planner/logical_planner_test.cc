@@ -20,6 +20,10 @@
 #include <google/protobuf/text_format.h>
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <map>
+#include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -614,6 +618,155 @@ TEST_F(LogicalPlannerTest, limit_pushdown_failing) {
   ASSERT_OK(proto_or_s.status());
 }
 
+constexpr char kNoTimeQuery[] = R"pxl(
+import px
+df = px.DataFrame(table='http_events')
+df = df.groupby('resp_status').agg(count=('resp_latency_ns', px.count))
+px.display(df, 'out')
+)pxl";
+
+TEST_F(LogicalPlannerTest, identical_request_reuses_plan) {
+  auto planner = LogicalPlanner::Create(info_).ConsumeValueOrDie();
+  auto state = testutils::CreateTwoPEMsOneKelvinPlannerState(testutils::kHttpEventsSchema);
+
+  auto plan1_or_s = planner->PlanToProto(state, MakeQueryRequest(kNoTimeQuery));
+  ASSERT_OK(plan1_or_s);
+  EXPECT_EQ(1, planner->num_compiles());
+  auto plan2_or_s = planner->PlanToProto(state, MakeQueryRequest(kNoTimeQuery));
+  ASSERT_OK(plan2_or_s);
+  EXPECT_EQ(1, planner->num_compiles());
+  EXPECT_THAT(plan2_or_s.ConsumeValueOrDie(), EqualsProto(plan1_or_s.ConsumeValueOrDie()));
+
+  // A different script is compiled.
+  ASSERT_OK(planner->PlanToProto(
+      state, MakeQueryRequest("import px\npx.display(px.DataFrame('http_events'), 'out')")));
+  EXPECT_EQ(2, planner->num_compiles());
+}
+
+TEST_F(LogicalPlannerTest, changed_agents_reuse_compiled_query) {
+  auto planner = LogicalPlanner::Create(info_).ConsumeValueOrDie();
+  auto state = testutils::CreateTwoPEMsOneKelvinPlannerState(testutils::kHttpEventsSchema);
+  ASSERT_OK(planner->PlanToProto(state, MakeQueryRequest(kNoTimeQuery)));
+
+  state.mutable_distributed_state()->mutable_carnot_info(0)->set_query_broker_address("moved");
+  ASSERT_OK(planner->PlanToProto(state, MakeQueryRequest(kNoTimeQuery)));
+  EXPECT_EQ(1, planner->num_compiles());
+}
+
+// The start times of the memory sources of the plan, by query broker address.
+std::map<std::string, std::vector<int64_t>> MemSourceStartTimes(
+    const distributedpb::DistributedPlan& plan) {
+  std::map<std::string, std::vector<int64_t>> start_times;
+  for (const auto& [qb_address, carnot_plan] : plan.qb_address_to_plan()) {
+    for (const auto& fragment : carnot_plan.nodes()) {
+      for (const auto& node : fragment.nodes()) {
+        if (node.op().op_type() == planpb::MEMORY_SOURCE_OPERATOR) {
+          start_times[qb_address].push_back(node.op().mem_source_op().start_time().value());
+        }
+      }
+    }
+  }
+  return start_times;
+}
+
+TEST_F(LogicalPlannerTest, time_dependent_query_reuses_shifted_plan) {
+  auto planner = LogicalPlanner::Create(info_).ConsumeValueOrDie();
+  auto state = testutils::CreateTwoPEMsOneKelvinPlannerState(testutils::kHttpEventsSchema);
+  // The relative start_time depends on the compile time, so the query is planned again at a later
+  // time, to find the values of the plan that hold the time.
+  ASSERT_OK_AND_ASSIGN(auto plan1,
+                       planner->PlanToProto(state, MakeQueryRequest(testutils::kHttpRequestStats)));
+  EXPECT_EQ(2, planner->num_compiles());
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  ASSERT_OK_AND_ASSIGN(auto plan2,
+                       planner->PlanToProto(state, MakeQueryRequest(testutils::kHttpRequestStats)));
+  EXPECT_EQ(2, planner->num_compiles());
+
+  // The reused plan starts as much later as it was requested later.
+  auto start_times1 = MemSourceStartTimes(plan1);
+  auto start_times2 = MemSourceStartTimes(plan2);
+  ASSERT_FALSE(start_times1.empty());
+  ASSERT_EQ(start_times1.size(), start_times2.size());
+  int64_t shift_ns = start_times2.begin()->second[0] - start_times1.begin()->second[0];
+  EXPECT_GE(shift_ns, 1000 * 1000);
+  for (const auto& [qb_address, times1] : start_times1) {
+    const auto& times2 = start_times2[qb_address];
+    ASSERT_EQ(times1.size(), times2.size());
+    for (size_t i = 0; i < times1.size(); ++i) {
+      EXPECT_EQ(shift_ns, times2[i] - times1[i]);
+    }
+  }
+}
+
+// The TopK operators of the plan, by query broker address.
+std::map<std::string, std::vector<planpb::TopKOperator>> TopKOps(
+    const distributedpb::DistributedPlan& plan) {
+  std::map<std::string, std::vector<planpb::TopKOperator>> topks;
+  for (const auto& [qb_address, carnot_plan] : plan.qb_address_to_plan()) {
+    for (const auto& fragment : carnot_plan.nodes()) {
+      for (const auto& node : fragment.nodes()) {
+        if (node.op().op_type() == planpb::TOPK_OPERATOR) {
+          topks[qb_address].push_back(node.op().topk_op());
+        }
+      }
+    }
+  }
+  return topks;
+}
+
+constexpr char kSortValuesHeadQuery[] = R"pxl(
+import px
+df = px.DataFrame(table='http_events', select=['time_', 'remote_port', 'resp_latency_ns'])
+df = df.sort_values(['resp_latency_ns', 'remote_port'], ascending=[False, True]).head(10)
+px.display(df)
+)pxl";
+
+TEST_F(LogicalPlannerTest, sort_values_head_keeps_top_rows_on_each_agent) {
+  auto planner = LogicalPlanner::Create(info_).ConsumeValueOrDie();
+  auto state = testutils::CreateTwoPEMsOneKelvinPlannerState(testutils::kHttpEventsSchema);
+  ASSERT_OK_AND_ASSIGN(auto plan,
+                       planner->PlanToProto(state, MakeQueryRequest(kSortValuesHeadQuery)));
+
+  // Each PEM keeps its top rows, and Kelvin merges them.
+  auto topks = TopKOps(plan);
+  EXPECT_EQ(3, topks.size());
+  for (const auto& [qb_address, agent_topks] : topks) {
+    SCOPED_TRACE(qb_address);
+    ASSERT_EQ(1, agent_topks.size());
+    const planpb::TopKOperator& topk = agent_topks[0];
+    EXPECT_EQ(10, topk.limit());
+    ASSERT_EQ(2, topk.sort_columns_size());
+    EXPECT_EQ(2, topk.sort_columns(0).column().index());
+    EXPECT_TRUE(topk.sort_columns(0).descending());
+    EXPECT_EQ(1, topk.sort_columns(1).column().index());
+    EXPECT_FALSE(topk.sort_columns(1).descending());
+  }
+}
+
+constexpr char kSortValuesHeadZeroQuery[] = R"pxl(
+import px
+df = px.DataFrame(table='http_events', select=['time_', 'remote_port', 'resp_latency_ns'])
+df = df.sort_values('resp_latency_ns').head(0)
+px.display(df)
+)pxl";
+
+TEST_F(LogicalPlannerTest, sort_values_head_zero_is_not_folded) {
+  auto planner = LogicalPlanner::Create(info_).ConsumeValueOrDie();
+  auto state = testutils::CreateTwoPEMsOneKelvinPlannerState(testutils::kHttpEventsSchema);
+  ASSERT_OK_AND_ASSIGN(auto plan,
+                       planner->PlanToProto(state, MakeQueryRequest(kSortValuesHeadZeroQuery)));
+
+  // A TopK limit of 0 means no limit, so the sort stays unlimited, on Kelvin only, and the Limit
+  // after it drops the rows.
+  auto topks = TopKOps(plan);
+  ASSERT_EQ(1, topks.size());
+  const auto& agent_topks = topks.begin()->second;
+  ASSERT_EQ(1, agent_topks.size());
+  EXPECT_EQ(0, agent_topks[0].limit());
+  EXPECT_FALSE(agent_topks[0].sort_columns(0).descending());
+}
+
 }  // namespace planner
 }  // namespace carnot
 }  // namespace px
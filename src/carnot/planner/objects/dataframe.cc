@@ -172,6 +172,22 @@ Status Dataframe::Init() {
   PL_RETURN_IF_ERROR(limitfn->SetDocString(kLimitOpDocstring));
   AddMethod(kLimitOpID, limitfn);
 
+  /**
+   * # Equivalent to the python method method syntax:
+   * def sort_values(self, by, ascending=True):
+   *     ...
+   */
+  PL_ASSIGN_OR_RETURN(
+      std::shared_ptr<FuncObject> sortfn,
+      FuncObject::Create(kSortOpID, {"by", "ascending"}, {{"ascending", "True"}},
+                         /* has_variable_len_args */ false,
+                         /* has_variable_len_kwargs */ false,
+                         std::bind(&SortHandler::Eval, graph(), op(), std::placeholders::_1,
+                                   std::placeholders::_2, std::placeholders::_3),
+                         ast_visitor()));
+  PL_RETURN_IF_ERROR(sortfn->SetDocString(kSortOpDocstring));
+  AddMethod(kSortOpID, sortfn);
+
   /**
    *
    * # Equivalent to the python method method syntax:
@@ -418,6 +434,36 @@ StatusOr<QLObjectPtr> LimitHandler::Eval(IR* graph, OperatorIR* op, const pypa::
   return Dataframe::Create(limit_op, visitor);
 }
 
+StatusOr<QLObjectPtr> SortHandler::Eval(IR* graph, OperatorIR* op, const pypa::AstPtr& ast,
+                                        const ParsedArgs& args, ASTVisitor* visitor) {
+  QLObjectPtr by_arg = args.GetArg("by");
+  QLObjectPtr ascending_arg = args.GetArg("ascending");
+  PL_ASSIGN_OR_RETURN(std::vector<std::string> sort_cols, ParseAsListOfStrings(by_arg, "by"));
+  if (sort_cols.empty()) {
+    return by_arg->CreateError("'by' must name at least one column to sort by");
+  }
+  PL_ASSIGN_OR_RETURN(std::vector<BoolIR*> ascending,
+                      ParseAsListOf<BoolIR>(ascending_arg, "ascending"));
+
+  std::vector<bool> descending;
+  if (!CollectionObject::IsCollection(ascending_arg)) {
+    DCHECK_EQ(ascending.size(), 1UL);
+    descending.assign(sort_cols.size(), !ascending[0]->val());
+  } else if (ascending.size() == sort_cols.size()) {
+    for (BoolIR* asc : ascending) {
+      descending.push_back(!asc->val());
+    }
+  } else {
+    return ascending_arg->CreateError(
+        "'ascending' must be a bool or a list with one bool per 'by' column. Received $0 values "
+        "for $1 columns",
+        ascending.size(), sort_cols.size());
+  }
+
+  PL_ASSIGN_OR_RETURN(TopKIR * topk_op, graph->CreateNode<TopKIR>(ast, op, sort_cols, descending));
+  return Dataframe::Create(topk_op, visitor);
+}
+
 StatusOr<QLObjectPtr> SubscriptHandler::Eval(IR* graph, OperatorIR* op, const pypa::AstPtr& ast,
                                              const ParsedArgs& args, ASTVisitor* visitor) {
   QLObjectPtr key = args.GetArg("key");
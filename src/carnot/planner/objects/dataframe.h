@@ -266,6 +266,39 @@ class Dataframe : public QLObject {
     px.DataFrame: DataFrame with the first n rows.
   )doc";
 
+  inline static constexpr char kSortOpID[] = "sort_values";
+  inline static constexpr char kSortOpDocstring[] = R"doc(
+  Sorts the rows by the values of columns.
+
+  Returns a DataFrame with the rows sorted by the passed in columns, in order of
+  precedence. Rows with equal values keep their relative order. Followed by `head(n)`,
+  only the top n rows are kept on each node before the results are merged, which is much
+  cheaper than sorting all of the data.
+  The sorted rows are only output once all of the input has been read, so sort_values
+  can't be used with `stream()`.
+
+  :topic: dataframe_ops
+  :opname: Sort
+
+  Examples:
+    df = px.DataFrame('http_events')
+    # Keep the 100 slowest http requests.
+    df = df.sort_values('resp_latency_ns', ascending=False).head(100)
+  Examples:
+    df = px.DataFrame('process_stats')
+    df = df.groupby('upid').agg(rss=('rss_bytes', px.mean))
+    # Sort by descending rss, then by upid.
+    df = df.sort_values(['rss', 'upid'], ascending=[False, True])
+
+  Args:
+    by (Union[str,List[str]]): The columns to sort by, either as a string or a list.
+    ascending (Union[bool,List[bool]], default True): Whether to sort in ascending order,
+      either for all the columns or as a list with one value per column.
+
+  Returns:
+    px.DataFrame: DataFrame with the rows sorted.
+  )doc";
+
   inline static constexpr char kMergeOpID[] = "merge";
   inline static constexpr char kMergeOpDocstring[] = R"doc(
   Merges the input DataFrame with this one using a database-style join.
@@ -508,6 +541,24 @@ class LimitHandler {
                                     const ParsedArgs& args, ASTVisitor* visitor);
 };
 
+/**
+ * @brief Implements the sort_values operator logic.
+ *
+ */
+class SortHandler {
+ public:
+  /**
+   * @brief Evaluates the sort_values method. Creates a TopK without a limit.
+   *
+   * @param df the dataframe that's a parent to the sort method.
+   * @param ast the ast node that signifies where the query was written
+   * @param args the arguments for sort_values()
+   * @return StatusOr<QLObjectPtr>
+   */
+  static StatusOr<QLObjectPtr> Eval(IR* graph, OperatorIR* op, const pypa::AstPtr& ast,
+                                    const ParsedArgs& args, ASTVisitor* visitor);
+};
+
 class SubscriptHandler {
  public:
   /**
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/synchronization/mutex.h>
+
+#include "src/common/base/base.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+
+/**
+ * PlanCache is a thread-safe LRU cache of compilation results, keyed by a serialization of
+ * everything the compilation depends on.
+ *
+ * Results that depend on the compile time (eg. through px.now() or relative start times) bake
+ * that time into the plan. Unless the caller moves them to the current time itself (see
+ * PlanTimeParams) and stores them as time independent, they are only returned while they are at
+ * most max_staleness_ns old, and never if max_staleness_ns is 0.
+ */
+template <typename TValue>
+class PlanCache : public NotCopyable {
+ public:
+  PlanCache(size_t capacity, int64_t max_staleness_ns)
+      : capacity_(capacity), max_staleness_ns_(max_staleness_ns) {}
+
+  /**
+   * Returns the cached value for the key, or nullptr if there is no valid entry.
+   */
+  std::shared_ptr<TValue> Get(std::string_view key, int64_t now_ns) {
+    absl::MutexLock lock(&mu_);
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+      return nullptr;
+    }
+    const Entry& entry = *it->second;
+    if (entry.time_dependent && now_ns - entry.compiled_at_ns > max_staleness_ns_) {
+      auto entry_it = it->second;
+      index_.erase(it);
+      entries_.erase(entry_it);
+      return nullptr;
+    }
+    // Move the entry to the front, as the most recently used.
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return entry.value;
+  }
+
+  /**
+   * Adds (or replaces) the value for the key, evicting the least recently used entry if the
+   * cache is full. Time dependent values are not stored if they could never be returned.
+   */
+  void Put(std::string key, std::shared_ptr<TValue> value, bool time_dependent,
+           int64_t compiled_at_ns) {
+    if (capacity_ == 0 || (time_dependent && max_staleness_ns_ <= 0)) {
+      return;
+    }
+    absl::MutexLock lock(&mu_);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      auto entry_it = it->second;
+      index_.erase(it);
+      entries_.erase(entry_it);
+    }
+    if (entries_.size() >= capacity_) {
+      index_.erase(entries_.back().key);
+      entries_.pop_back();
+    }
+    entries_.push_front(Entry{std::move(key), std::move(value), time_dependent, compiled_at_ns});
+    // The key is owned by the list node, which doesn't move, so the index can view it.
+    index_.emplace(entries_.front().key, entries_.begin());
+  }
+
+  size_t size() const {
+    absl::MutexLock lock(&mu_);
+    return entries_.size();
+  }
+
+ private:
+  struct Entry {
+    std::string key;
+    std::shared_ptr<TValue> value;
+    bool time_dependent;
+    int64_t compiled_at_ns;
+  };
+
+  const size_t capacity_;
+  const int64_t max_staleness_ns_;
+
+  mutable absl::Mutex mu_;
+  // Ordered from the most to the least recently used.
+  std::list<Entry> entries_ ABSL_GUARDED_BY(mu_);
+  absl::flat_hash_map<std::string_view, typename std::list<Entry>::iterator> index_
+      ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "src/carnot/planner/plan_cache.h"
+#include "src/common/testing/testing.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+
+TEST(PlanCacheTest, evicts_least_recently_used) {
+  PlanCache<int> cache(/*capacity*/ 2, /*max_staleness_ns*/ 0);
+  cache.Put("a", std::make_shared<int>(1), /*time_dependent*/ false, 0);
+  cache.Put("b", std::make_shared<int>(2), /*time_dependent*/ false, 0);
+  // Use "a", so that "b" is the least recently used.
+  ASSERT_NE(cache.Get("a", 0), nullptr);
+  cache.Put("c", std::make_shared<int>(3), /*time_dependent*/ false, 0);
+
+  EXPECT_EQ(2, cache.size());
+  EXPECT_EQ(nullptr, cache.Get("b", 0));
+  ASSERT_NE(cache.Get("a", 0), nullptr);
+  EXPECT_EQ(1, *cache.Get("a", 0));
+  ASSERT_NE(cache.Get("c", 0), nullptr);
+  EXPECT_EQ(3, *cache.Get("c", 0));
+}
+
+TEST(PlanCacheTest, replaces_value) {
+  PlanCache<int> cache(/*capacity*/ 2, /*max_staleness_ns*/ 0);
+  cache.Put("a", std::make_shared<int>(1), /*time_dependent*/ false, 0);
+  cache.Put("a", std::make_shared<int>(2), /*time_dependent*/ false, 0);
+  EXPECT_EQ(1, cache.size());
+  ASSERT_NE(cache.Get("a", 0), nullptr);
+  EXPECT_EQ(2, *cache.Get("a", 0));
+}
+
+TEST(PlanCacheTest, time_dependent_values_expire) {
+  PlanCache<int> cache(/*capacity*/ 2, /*max_staleness_ns*/ 100);
+  cache.Put("now", std::make_shared<int>(1), /*time_dependent*/ true, 1000);
+  cache.Put("fixed", std::make_shared<int>(2), /*time_dependent*/ false, 1000);
+
+  EXPECT_NE(nullptr, cache.Get("now", 1100));
+  EXPECT_EQ(nullptr, cache.Get("now", 1101));
+  EXPECT_EQ(1, cache.size());
+  EXPECT_NE(nullptr, cache.Get("fixed", 1000000));
+}
+
+TEST(PlanCacheTest, time_dependent_values_not_stored_without_staleness) {
+  PlanCache<int> cache(/*capacity*/ 2, /*max_staleness_ns*/ 0);
+  cache.Put("now", std::make_shared<int>(1), /*time_dependent*/ true, 1000);
+  EXPECT_EQ(0, cache.size());
+  EXPECT_EQ(nullptr, cache.Get("now", 1000));
+}
+
+TEST(PlanCacheTest, zero_capacity) {
+  PlanCache<int> cache(/*capacity*/ 0, /*max_staleness_ns*/ 0);
+  cache.Put("a", std::make_shared<int>(1), /*time_dependent*/ false, 0);
+  EXPECT_EQ(0, cache.size());
+  EXPECT_EQ(nullptr, cache.Get("a", 0));
+}
+
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
@@ -0,0 +1,130 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/carnot/planner/plan_time_params.h"
+
+#include <google/protobuf/util/message_differencer.h>
+
+#include <algorithm>
+
+namespace px {
+namespace carnot {
+namespace planner {
+
+using google::protobuf::FieldDescriptor;
+using google::protobuf::Message;
+using google::protobuf::Reflection;
+
+StatusOr<PlanTimeParams> PlanTimeParams::Find(const distributedpb::DistributedPlan& plan,
+                                              const distributedpb::DistributedPlan& shifted_plan,
+                                              int64_t shift_ns) {
+  PlanTimeParams params;
+  for (const auto& [qb_address, carnot_plan] : plan.qb_address_to_plan()) {
+    auto it = shifted_plan.qb_address_to_plan().find(qb_address);
+    if (it == shifted_plan.qb_address_to_plan().end()) {
+      return error::InvalidArgument("Only one of the plans has a plan for $0", qb_address);
+    }
+    FieldPath path;
+    params.FindShiftedValues(carnot_plan, it->second, shift_ns, qb_address, &path);
+  }
+
+  // Everything but the params must be the same in both plans.
+  distributedpb::DistributedPlan expected_plan = plan;
+  params.Shift(shift_ns, &expected_plan);
+  if (!google::protobuf::util::MessageDifferencer::Equals(expected_plan, shifted_plan)) {
+    return error::InvalidArgument("The plans differ by more than their time params");
+  }
+  return params;
+}
+
+void PlanTimeParams::FindShiftedValues(const Message& msg, const Message& shifted_msg,
+                                       int64_t shift_ns, const std::string& qb_address,
+                                       FieldPath* path) {
+  const Reflection* reflection = msg.GetReflection();
+  std::vector<const FieldDescriptor*> fields;
+  reflection->ListFields(msg, &fields);
+  for (const FieldDescriptor* field : fields) {
+    if (field->cpp_type() != FieldDescriptor::CPPTYPE_MESSAGE &&
+        field->cpp_type() != FieldDescriptor::CPPTYPE_INT64) {
+      continue;
+    }
+    if (!field->is_repeated()) {
+      FindShiftedValue(msg, shifted_msg, {field, -1}, shift_ns, qb_address, path);
+      continue;
+    }
+    // Differing sizes are caught when comparing the plans.
+    int size =
+        std::min(reflection->FieldSize(msg, field), reflection->FieldSize(shifted_msg, field));
+    for (int i = 0; i < size; ++i) {
+      FindShiftedValue(msg, shifted_msg, {field, i}, shift_ns, qb_address, path);
+    }
+  }
+}
+
+void PlanTimeParams::FindShiftedValue(const Message& msg, const Message& shifted_msg,
+                                      FieldIndex field_index, int64_t shift_ns,
+                                      const std::string& qb_address, FieldPath* path) {
+  const Reflection* reflection = msg.GetReflection();
+  const auto& [field, index] = field_index;
+  path->push_back(field_index);
+  if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+    if (index < 0) {
+      FindShiftedValues(reflection->GetMessage(msg, field),
+                        reflection->GetMessage(shifted_msg, field), shift_ns, qb_address, path);
+    } else {
+      FindShiftedValues(reflection->GetRepeatedMessage(msg, field, index),
+                        reflection->GetRepeatedMessage(shifted_msg, field, index), shift_ns,
+                        qb_address, path);
+    }
+  } else {
+    int64_t value = index < 0 ? reflection->GetInt64(msg, field)
+                              : reflection->GetRepeatedInt64(msg, field, index);
+    int64_t shifted_value = index < 0 ? reflection->GetInt64(shifted_msg, field)
+                                      : reflection->GetRepeatedInt64(shifted_msg, field, index);
+    // Unsigned, so that values close to the limits can't overflow.
+    if (static_cast<uint64_t>(shifted_value) - static_cast<uint64_t>(value) ==
+        static_cast<uint64_t>(shift_ns)) {
+      params_.push_back(Param{qb_address, *path});
+    }
+  }
+  path->pop_back();
+}
+
+void PlanTimeParams::Shift(int64_t shift_ns, distributedpb::DistributedPlan* plan) const {
+  for (const Param& param : params_) {
+    Message* msg = &plan->mutable_qb_address_to_plan()->at(param.qb_address);
+    for (size_t i = 0; i + 1 < param.path.size(); ++i) {
+      const auto& [field, index] = param.path[i];
+      const Reflection* reflection = msg->GetReflection();
+      msg = index < 0 ? reflection->MutableMessage(msg, field)
+                      : reflection->MutableRepeatedMessage(msg, field, index);
+    }
+    const auto& [field, index] = param.path.back();
+    const Reflection* reflection = msg->GetReflection();
+    if (index < 0) {
+      reflection->SetInt64(msg, field, reflection->GetInt64(*msg, field) + shift_ns);
+    } else {
+      reflection->SetRepeatedInt64(msg, field, index,
+                                   reflection->GetRepeatedInt64(*msg, field, index) + shift_ns);
+    }
+  }
+}
+
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
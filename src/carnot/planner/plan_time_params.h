@@ -0,0 +1,85 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <google/protobuf/message.h>
+
+#include "src/carnot/planner/distributedpb/distributed_plan.pb.h"
+#include "src/common/base/base.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+
+/**
+ * PlanTimeParams are the values of a serialized distributed plan that hold the compile time plus
+ * a constant, eg. the start time of a memory source given a relative start_time. They make the
+ * compile time a parameter of the plan: shifting them by the same amount gives the plan that a
+ * later compilation would produce.
+ */
+class PlanTimeParams {
+ public:
+  /**
+   * Finds the time params of plan, given shifted_plan, which was planned from the same request
+   * with the compile time shift_ns later. The values that differ by shift_ns are the params.
+   * Returns an error if the plans differ in any other way, ie. when the compile time is used other
+   * than as an offset.
+   */
+  static StatusOr<PlanTimeParams> Find(const distributedpb::DistributedPlan& plan,
+                                       const distributedpb::DistributedPlan& shifted_plan,
+                                       int64_t shift_ns);
+
+  /**
+   * Adds shift_ns to the time params of plan, which must be the plan they were found in.
+   */
+  void Shift(int64_t shift_ns, distributedpb::DistributedPlan* plan) const;
+
+  size_t size() const { return params_.size(); }
+
+ private:
+  // A field of a message, with the index of the value if the field is repeated, or -1.
+  struct FieldIndex {
+    const google::protobuf::FieldDescriptor* field;
+    int index;
+  };
+  using FieldPath = std::vector<FieldIndex>;
+  // The path to an int64 value in the plan of a Carnot instance. The plans have no map fields, so
+  // the indexes of their repeated fields are the same in any copy of them.
+  struct Param {
+    std::string qb_address;
+    FieldPath path;
+  };
+
+  // Adds the int64 values under msg that are shift_ns more in shifted_msg as params.
+  void FindShiftedValues(const google::protobuf::Message& msg,
+                         const google::protobuf::Message& shifted_msg, int64_t shift_ns,
+                         const std::string& qb_address, FieldPath* path);
+  void FindShiftedValue(const google::protobuf::Message& msg,
+                        const google::protobuf::Message& shifted_msg, FieldIndex field_index,
+                        int64_t shift_ns, const std::string& qb_address, FieldPath* path);
+
+  std::vector<Param> params_;
+};
+
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
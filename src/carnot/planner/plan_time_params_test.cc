@@ -0,0 +1,130 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <google/protobuf/text_format.h>
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <absl/strings/substitute.h>
+
+#include "src/carnot/planner/plan_time_params.h"
+#include "src/common/testing/testing.h"
+
+namespace px {
+namespace carnot {
+namespace planner {
+
+using px::testing::proto::EqualsProto;
+
+// A plan reading from start_time until stop_time, and filtering on the time column against
+// filter_time.
+constexpr char kPlanTmpl[] = R"proto(
+qb_address_to_plan {
+  key: "agent"
+  value {
+    nodes {
+      id: 1
+      nodes {
+        id: 1
+        op {
+          op_type: MEMORY_SOURCE_OPERATOR
+          mem_source_op {
+            name: "http_events"
+            column_idxs: 0
+            start_time { value: $0 }
+            stop_time { value: $1 }
+          }
+        }
+      }
+      nodes {
+        id: 2
+        op {
+          op_type: FILTER_OPERATOR
+          filter_op {
+            expression {
+              func {
+                name: "greaterThanEqual"
+                args { column { node: 1 index: 0 } }
+                args { constant { data_type: TIME64NS time64_ns_value: $2 } }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+qb_address_to_dag_id {
+  key: "agent"
+  value: 0
+}
+)proto";
+
+distributedpb::DistributedPlan MakePlan(int64_t start_time, int64_t stop_time,
+                                        int64_t filter_time) {
+  distributedpb::DistributedPlan plan;
+  CHECK(google::protobuf::TextFormat::ParseFromString(
+      absl::Substitute(kPlanTmpl, start_time, stop_time, filter_time), &plan));
+  return plan;
+}
+
+TEST(PlanTimeParamsTest, shifts_time_params) {
+  // The start and filter times are relative to the compile time, the stop time isn't.
+  auto plan = MakePlan(1000, 5000, 1500);
+  auto shifted_plan = MakePlan(1100, 5000, 1600);
+  ASSERT_OK_AND_ASSIGN(PlanTimeParams params, PlanTimeParams::Find(plan, shifted_plan, 100));
+  EXPECT_EQ(2, params.size());
+
+  params.Shift(100, &plan);
+  EXPECT_THAT(plan, EqualsProto(shifted_plan.DebugString()));
+  params.Shift(1000, &plan);
+  EXPECT_THAT(plan, EqualsProto(MakePlan(2100, 5000, 2600).DebugString()));
+}
+
+TEST(PlanTimeParamsTest, identical_plans_have_no_params) {
+  auto plan = MakePlan(1000, 5000, 1500);
+  ASSERT_OK_AND_ASSIGN(PlanTimeParams params, PlanTimeParams::Find(plan, plan, 100));
+  EXPECT_EQ(0, params.size());
+}
+
+TEST(PlanTimeParamsTest, rejects_other_differences) {
+  auto plan = MakePlan(1000, 5000, 1500);
+  // The time isn't just an offset of the start time.
+  EXPECT_NOT_OK(PlanTimeParams::Find(plan, MakePlan(1200, 5000, 1600), 100));
+
+  auto other_table = MakePlan(1100, 5000, 1600);
+  other_table.mutable_qb_address_to_plan()
+      ->at("agent")
+      .mutable_nodes(0)
+      ->mutable_nodes(0)
+      ->mutable_op()
+      ->mutable_mem_source_op()
+      ->set_name("process_stats");
+  EXPECT_NOT_OK(PlanTimeParams::Find(plan, other_table, 100));
+
+  auto other_agent = MakePlan(1100, 5000, 1600);
+  auto agent_plan = other_agent.qb_address_to_plan().at("agent");
+  other_agent.mutable_qb_address_to_plan()->clear();
+  (*other_agent.mutable_qb_address_to_plan())["other_agent"] = agent_plan;
+  EXPECT_NOT_OK(PlanTimeParams::Find(plan, other_agent, 100));
+}
+
+}  // namespace planner
+}  // namespace carnot
+}  // namespace px
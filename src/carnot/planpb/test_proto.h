@@ -324,6 +324,31 @@ columns {
 }
 )";
 
+constexpr char kTopKOperator1[] = R"(
+sort_columns {
+  column {
+    node: 1
+    index: 1
+  }
+  descending: true
+}
+sort_columns {
+  column {
+    node: 1
+    index: 0
+  }
+}
+limit: 3
+columns {
+  node: 1
+  index: 0
+}
+columns {
+  node: 1
+  index: 1
+}
+)";
+
 constexpr char kLimitDropOperator1[] = R"(
 limit: 10
 columns {
@@ -352,6 +377,24 @@ constexpr char kUnionOperatorOrdered[] = R"(
   }
 )";
 
+constexpr char kUnionOperatorOrdered3Parents[] = R"(
+  rows_per_batch: 5
+  column_names: "abc"
+  column_names: "time_"
+  column_mappings {
+    column_indexes: 0
+    column_indexes: 1
+  }
+  column_mappings {
+    column_indexes: 1
+    column_indexes: 0
+  }
+  column_mappings {
+    column_indexes: 0
+    column_indexes: 1
+  }
+)";
+
 constexpr char kUnionOperatorUnordered[] = R"(
   column_names: "abc"
   column_names: "xyz"
@@ -1438,6 +1481,14 @@ planpb::Operator CreateTestUnionOrderedPB() {
   return op;
 }
 
+planpb::Operator CreateTestUnionOrdered3ParentsPB() {
+  planpb::Operator op;
+  auto op_proto = absl::Substitute(kOperatorProtoTmpl, "UNION_OPERATOR", "union_op",
+                                   kUnionOperatorOrdered3Parents);
+  CHECK(google::protobuf::TextFormat::MergeFromString(op_proto, &op)) << "Failed to parse proto";
+  return op;
+}
+
 planpb::Operator CreateTestUnionUnorderedPB() {
   planpb::Operator op;
   auto op_proto =
@@ -1470,6 +1521,13 @@ planpb::Operator CreateTestLimit1PB() {
   return op;
 }
 
+planpb::Operator CreateTestTopK1PB() {
+  planpb::Operator op;
+  auto op_proto = absl::Substitute(kOperatorProtoTmpl, "TOPK_OPERATOR", "topk_op", kTopKOperator1);
+  CHECK(google::protobuf::TextFormat::MergeFromString(op_proto, &op)) << "Failed to parse proto";
+  return op;
+}
+
 planpb::Operator CreateTestDropLimit1PB() {
   planpb::Operator op;
   auto op_proto =
@@ -17,6 +17,7 @@
  */
 
 #pragma once
+#include <absl/types/span.h>
 #include <arrow/builder.h>
 #include <arrow/type.h>
 
@@ -25,6 +26,7 @@
 #include <iostream>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -74,6 +76,18 @@ class AnyUDA : public BaseFunc {
  *      Status Init(FunctionContext *ctx, UDFValue... init_args) {}
  *  This function is called once during initialization of each instance (many instances
  *  may exists in a given query). The arguments are as provided by the query.
+ *
+ * A ScalarUDF with a single Exec argument whose result only depends on that argument can
+ * _optionally_ implement:
+ *      static constexpr bool MemoizeExec() { return true; }
+ *  Exec is then called once per distinct input value in a batch, and the result is reused
+ *  for the other rows with the same value.
+ *
+ * The ScalarUDF can _optionally_ implement a batch form of Exec over the native types:
+ *      void ExecBatch(FunctionContext *ctx, BatchArg<UDFValue>... in, BatchOut<UDFValue> out) {}
+ *  It is used instead of Exec when all the argument and return types are fixed size or strings
+ *  (see udf_wrapper.h). This lets simple loops over the spans be vectorized by the compiler, and
+ *  lets expensive UDFs (eg. model inference) process the whole batch at once.
  */
 class ScalarUDF : public AnyUDF {
  public:
@@ -94,6 +108,9 @@ class ScalarUDF : public AnyUDF {
  *
  * It may optionally implement:
  *     Status Init(FunctionContext *ctx, InitArgs...) {}
+ *     void UpdateBatch(FunctionContext *ctx, BatchArg<UDFValue>... args) {}
+ * UpdateBatch must be equivalent to calling Update on each row, and is used instead of it when
+ * all the argument types are fixed size.
  *
  * To support partial aggregation to UDAs must also implement:
  *     StringValue Serialize(FunctionContext*) {}
@@ -176,6 +193,14 @@ struct check_executor_fn<T, typename std::enable_if_t<has_udf_executor_fn<T>::va
                 "must have a valid Executor fn, in form: UDFSourceExecutor Executor()");
 };
 
+// SFINAE test for the Exec memoization opt-in.
+template <typename T, typename = void>
+struct has_udf_memoize_exec : std::false_type {};
+
+template <typename T>
+struct has_udf_memoize_exec<T, std::void_t<decltype(T::MemoizeExec())>>
+    : std::bool_constant<T::MemoizeExec()> {};
+
 template <typename ReturnType, typename TUDF, typename... Types>
 static constexpr std::array<types::DataType, sizeof...(Types)> GetArgumentTypesHelper(
     ReturnType (TUDF::*)(FunctionContext*, Types...)) {
@@ -188,6 +213,58 @@ static constexpr types::DataType ReturnTypeHelper(ReturnType (TUDF::*)(Types...)
   return types::ValueTypeTraits<ReturnType>::data_type;
 }
 
+// The element type of the argument spans. Strings are passed as views, so that they can point
+// straight into the input columns.
+template <typename TValue>
+struct BatchArgElement {
+  using type = typename types::ValueTypeTraits<TValue>::native_type;
+};
+template <>
+struct BatchArgElement<types::StringValue> {
+  using type = std::string_view;
+};
+
+// The argument and output span types of ExecBatch and UpdateBatch, for a UDF value type.
+template <typename TValue>
+using BatchArg = absl::Span<const typename BatchArgElement<TValue>::type>;
+template <typename TValue>
+using BatchOut = absl::Span<typename types::ValueTypeTraits<TValue>::native_type>;
+
+// The form ExecBatch must have for a given Exec: the same arguments as spans of native values,
+// followed by the output span.
+template <typename ReturnType, typename TUDF, typename... Types>
+auto ExecBatchFnTypeHelper(ReturnType (TUDF::*)(FunctionContext*, Types...))
+    -> void (TUDF::*)(FunctionContext*, BatchArg<Types>..., BatchOut<ReturnType>);
+
+// The form UpdateBatch must have for a given Update.
+template <typename TUDA, typename... Types>
+auto UpdateBatchFnTypeHelper(void (TUDA::*)(FunctionContext*, Types...))
+    -> void (TUDA::*)(FunctionContext*, BatchArg<Types>...);
+
+// SFINAE test for ExecBatch fn.
+template <typename T, typename = void>
+struct has_udf_exec_batch_fn : std::false_type {};
+
+template <typename T>
+struct has_udf_exec_batch_fn<T, std::void_t<decltype(&T::ExecBatch)>> : std::true_type {
+  static_assert(std::is_same_v<decltype(&T::ExecBatch), decltype(ExecBatchFnTypeHelper(&T::Exec))>,
+                "If an ExecBatch function exists, it must have the form: void "
+                "ExecBatch(FunctionContext*, BatchArg<TArg>..., BatchOut<TReturn>), matching the "
+                "types of Exec");
+};
+
+// SFINAE test for UpdateBatch fn.
+template <typename T, typename = void>
+struct has_uda_update_batch_fn : std::false_type {};
+
+template <typename T>
+struct has_uda_update_batch_fn<T, std::void_t<decltype(&T::UpdateBatch)>> : std::true_type {
+  static_assert(
+      std::is_same_v<decltype(&T::UpdateBatch), decltype(UpdateBatchFnTypeHelper(&T::Update))>,
+      "If an UpdateBatch function exists, it must have the form: void "
+      "UpdateBatch(FunctionContext*, BatchArg<TArg>...), matching the types of Update");
+};
+
 template <typename T, typename = void>
 struct check_init_fn {};
 
@@ -228,6 +305,18 @@ class ScalarUDFTraits {
    */
   static constexpr bool HasExecutor() { return has_udf_executor_fn<T>::value; }
 
+  /**
+   * Checks if Exec results should be memoized per distinct input within a batch.
+   * @return true if the UDF opted in to memoization.
+   */
+  static constexpr bool MemoizeExec() { return has_udf_memoize_exec<T>::value; }
+
+  /**
+   * Checks if the UDF has an ExecBatch function.
+   * @return true if it has an ExecBatch function.
+   */
+  static constexpr bool HasExecBatch() { return has_udf_exec_batch_fn<T>::value; }
+
   template <typename Q = T, std::enable_if_t<ScalarUDFTraits<Q>::HasInit(), void>* = nullptr>
   static constexpr auto InitArguments() {
     return GetArgumentTypesHelper(&Q::Init);
@@ -359,6 +448,12 @@ class UDATraits {
    */
   static constexpr bool HasInit() { return has_udf_init_fn<T>::value; }
 
+  /**
+   * Checks if the UDA has an UpdateBatch function.
+   * @return true if it has an UpdateBatch function.
+   */
+  static constexpr bool HasUpdateBatch() { return has_uda_update_batch_fn<T>::value; }
+
   /**
    * @brief Whether this UDA supports a partial aggregate representation
    * @return true
@@ -67,6 +67,50 @@ class InitArgUDF : public ScalarUDF {
   int64_t i_;
 };
 
+// Tags each result with the number of prior invocations, so reused results are visible.
+class MemoizedUDF : public ScalarUDF {
+ public:
+  types::StringValue Exec(FunctionContext*, types::StringValue str) {
+    return absl::StrCat(str, invoke_count_++);
+  }
+  static constexpr bool MemoizeExec() { return true; }
+
+ private:
+  int invoke_count_ = 0;
+};
+
+// The batch form offsets its results, so tests can tell which form was used.
+class BatchAddUDF : public ScalarUDF {
+ public:
+  types::Int64Value Exec(FunctionContext*, types::Int64Value v1, types::Int64Value v2) {
+    return v1.val + v2.val;
+  }
+  void ExecBatch(FunctionContext*, BatchArg<types::Int64Value> v1,
+                 BatchArg<types::Int64Value> v2, BatchOut<types::Int64Value> out) {
+    for (size_t i = 0; i < out.size(); ++i) {
+      out[i] = v1[i] + v2[i] + 100;
+    }
+  }
+};
+
+// Counts the calls to ExecBatch, so tests can tell that the batch form was used.
+class BatchConcatUDF : public ScalarUDF {
+ public:
+  types::StringValue Exec(FunctionContext*, types::StringValue str, types::Int64Value i) {
+    return absl::StrCat(str, i.val);
+  }
+  void ExecBatch(FunctionContext*, BatchArg<types::StringValue> str,
+                 BatchArg<types::Int64Value> i, BatchOut<types::StringValue> out) {
+    ++num_batches_;
+    for (size_t idx = 0; idx < out.size(); ++idx) {
+      out[idx] = absl::StrCat(str[idx], i[idx], "/", num_batches_);
+    }
+  }
+
+ private:
+  int num_batches_ = 0;
+};
+
 TEST(UDFDefinition, no_args) {
   auto ctx = FunctionContext(nullptr, nullptr);
   ScalarUDFDefinition def("noargudf");
@@ -161,6 +205,122 @@ TEST(UDFDefinition, init_args) {
   EXPECT_EQ("init_arg, 10, hello", out[2]);
 }
 
+TEST(UDFDefinition, memoized_exec) {
+  auto ctx = FunctionContext(nullptr, nullptr);
+  ScalarUDFDefinition def("memoized");
+  EXPECT_OK(def.Init<MemoizedUDF>());
+
+  types::StringValueColumnWrapper inputs({"a", "a", "b", "a", "c", "b"});
+
+  types::StringValueColumnWrapper out(inputs.Size());
+  auto u = def.Make();
+  EXPECT_OK(def.ExecBatch(u.get(), &ctx, {&inputs}, &out, inputs.Size()));
+
+  EXPECT_EQ("a0", out[0]);
+  EXPECT_EQ("a0", out[1]);
+  EXPECT_EQ("b1", out[2]);
+  EXPECT_EQ("a0", out[3]);
+  EXPECT_EQ("c2", out[4]);
+  EXPECT_EQ("b1", out[5]);
+}
+
+TEST(UDFDefinition, memoized_exec_arrow) {
+  auto ctx = FunctionContext(nullptr, nullptr);
+  std::vector<types::StringValue> inputs = {"a", "b", "a", "c", "b"};
+  auto inputs_arr = ToArrow(inputs, arrow::default_memory_pool());
+
+  auto output_builder = std::make_shared<arrow::StringBuilder>();
+  auto u = std::make_shared<MemoizedUDF>();
+  EXPECT_OK(ScalarUDFWrapper<MemoizedUDF>::ExecBatchArrow(u.get(), &ctx, {inputs_arr.get()},
+                                                          output_builder.get(), inputs.size()));
+
+  std::shared_ptr<arrow::Array> res;
+  EXPECT_TRUE(output_builder->Finish(&res).ok());
+  auto* res_arr = static_cast<arrow::StringArray*>(res.get());
+  ASSERT_EQ(5, res_arr->length());
+  EXPECT_EQ("a0", res_arr->GetString(0));
+  EXPECT_EQ("b1", res_arr->GetString(1));
+  EXPECT_EQ("a0", res_arr->GetString(2));
+  EXPECT_EQ("c2", res_arr->GetString(3));
+  EXPECT_EQ("b1", res_arr->GetString(4));
+}
+
+TEST(UDFDefinition, exec_batch) {
+  auto ctx = FunctionContext(nullptr, nullptr);
+  ScalarUDFDefinition def("batch_add");
+  EXPECT_OK(def.Init<BatchAddUDF>());
+
+  types::Int64ValueColumnWrapper v1({1, 2, 3});
+  types::Int64ValueColumnWrapper v2({3, 4, 5});
+
+  types::Int64ValueColumnWrapper out(v1.Size());
+  auto u = def.Make();
+  EXPECT_OK(def.ExecBatch(u.get(), &ctx, {&v1, &v2}, &out, v1.Size()));
+  EXPECT_EQ(104, out[0].val);
+  EXPECT_EQ(106, out[1].val);
+  EXPECT_EQ(108, out[2].val);
+}
+
+TEST(UDFDefinition, exec_batch_arrow) {
+  auto ctx = FunctionContext(nullptr, nullptr);
+  std::vector<types::Int64Value> v1 = {1, 2, 3};
+  std::vector<types::Int64Value> v2 = {3, 4, 5};
+
+  auto v1a = ToArrow(v1, arrow::default_memory_pool());
+  auto v2a = ToArrow(v2, arrow::default_memory_pool());
+
+  auto output_builder = std::make_shared<arrow::Int64Builder>();
+  auto u = std::make_shared<BatchAddUDF>();
+  EXPECT_OK(ScalarUDFWrapper<BatchAddUDF>::ExecBatchArrow(u.get(), &ctx, {v1a.get(), v2a.get()},
+                                                          output_builder.get(), 3));
+
+  std::shared_ptr<arrow::Array> res;
+  EXPECT_TRUE(output_builder->Finish(&res).ok());
+  auto* res_arr = static_cast<arrow::Int64Array*>(res.get());
+  ASSERT_EQ(3, res_arr->length());
+  EXPECT_EQ(104, res_arr->Value(0));
+  EXPECT_EQ(106, res_arr->Value(1));
+  EXPECT_EQ(108, res_arr->Value(2));
+}
+
+TEST(UDFDefinition, exec_batch_strings) {
+  auto ctx = FunctionContext(nullptr, nullptr);
+  ScalarUDFDefinition def("batch_concat");
+  EXPECT_OK(def.Init<BatchConcatUDF>());
+
+  types::StringValueColumnWrapper v1({"abc", "", "de"});
+  types::Int64ValueColumnWrapper v2({1, 2, 3});
+
+  types::StringValueColumnWrapper out(v1.Size());
+  auto u = def.Make();
+  EXPECT_OK(def.ExecBatch(u.get(), &ctx, {&v1, &v2}, &out, v1.Size()));
+  EXPECT_EQ("abc1/1", out[0]);
+  EXPECT_EQ("2/1", out[1]);
+  EXPECT_EQ("de3/1", out[2]);
+}
+
+TEST(UDFDefinition, exec_batch_strings_arrow) {
+  auto ctx = FunctionContext(nullptr, nullptr);
+  std::vector<types::StringValue> v1 = {"abc", "", "de"};
+  std::vector<types::Int64Value> v2 = {1, 2, 3};
+
+  auto v1a = ToArrow(v1, arrow::default_memory_pool());
+  auto v2a = ToArrow(v2, arrow::default_memory_pool());
+
+  auto output_builder = std::make_shared<arrow::StringBuilder>();
+  auto u = std::make_shared<BatchConcatUDF>();
+  EXPECT_OK(ScalarUDFWrapper<BatchConcatUDF>::ExecBatchArrow(
+      u.get(), &ctx, {v1a.get(), v2a.get()}, output_builder.get(), 3));
+
+  std::shared_ptr<arrow::Array> res;
+  EXPECT_TRUE(output_builder->Finish(&res).ok());
+  auto* res_arr = static_cast<arrow::StringArray*>(res.get());
+  ASSERT_EQ(3, res_arr->length());
+  EXPECT_EQ("abc1/1", res_arr->GetString(0));
+  EXPECT_EQ("2/1", res_arr->GetString(1));
+  EXPECT_EQ("de3/1", res_arr->GetString(2));
+}
+
 // Test UDA, takes the min of two arguments and then sums them.
 class MinSumUDA : public udf::UDA {
  public:
@@ -174,6 +334,31 @@ class MinSumUDA : public udf::UDA {
   types::Int64Value sum_ = 0;
 };
 
+// Same as MinSumUDA, with a batch form of Update that counts its calls.
+class BatchMinSumUDA : public udf::UDA {
+ public:
+  void Update(udf::FunctionContext*, types::Int64Value arg1, types::Int64Value arg2) {
+    sum_ = sum_.val + std::min(arg1.val, arg2.val);
+  }
+  void UpdateBatch(udf::FunctionContext*, BatchArg<types::Int64Value> arg1,
+                   BatchArg<types::Int64Value> arg2) {
+    for (size_t i = 0; i < arg1.size(); ++i) {
+      sum_ = sum_.val + std::min(arg1[i], arg2[i]);
+    }
+    ++batches_;
+  }
+  void Merge(udf::FunctionContext*, const BatchMinSumUDA& other) {
+    sum_ = sum_.val + other.sum_.val;
+  }
+  types::Int64Value Finalize(udf::FunctionContext*) { return sum_; }
+
+  int batches() const { return batches_; }
+
+ protected:
+  types::Int64Value sum_ = 0;
+  int batches_ = 0;
+};
+
 class InitArgUDA : public udf::UDA {
  public:
   Status Init(udf::FunctionContext*, types::Int64Value i, types::StringValue str,
@@ -253,6 +438,25 @@ TEST(UDADefinition, arrow_output) {
   EXPECT_EQ(5, casted->Value(0));
 }
 
+TEST(UDADefinition, update_batch) {
+  auto ctx = FunctionContext(nullptr, nullptr);
+  UDADefinition def("batch_minsum");
+  EXPECT_OK(def.Init<BatchMinSumUDA>());
+
+  types::Int64ValueColumnWrapper v1({1, 2, 3});
+  types::Int64ValueColumnWrapper v2({5, 1, 3});
+  auto v1a = v1.ConvertToArrow(arrow::default_memory_pool());
+  auto v2a = v2.ConvertToArrow(arrow::default_memory_pool());
+
+  types::Int64Value out;
+  auto u = def.Make();
+  EXPECT_OK(def.ExecBatchUpdate(u.get(), &ctx, {&v1, &v2}));
+  EXPECT_OK(def.ExecBatchUpdateArrow(u.get(), &ctx, {v1a.get(), v2a.get()}));
+  EXPECT_OK(def.FinalizeValue(u.get(), &ctx, &out));
+  EXPECT_EQ(10, out.val);
+  EXPECT_EQ(2, static_cast<BatchMinSumUDA*>(u.get())->batches());
+}
+
 TEST(UDADefinition, init_args) {
   auto ctx = FunctionContext(nullptr, nullptr);
   UDADefinition def("initarguda");
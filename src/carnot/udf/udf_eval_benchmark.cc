@@ -31,6 +31,8 @@
 #include "src/shared/types/types.h"
 
 using px::Status;
+using px::carnot::udf::BatchArg;
+using px::carnot::udf::BatchOut;
 using px::carnot::udf::FunctionContext;
 using px::carnot::udf::ScalarUDF;
 using px::carnot::udf::ScalarUDFDefinition;
@@ -57,12 +59,25 @@ class AddUDF : public ScalarUDF {
   Int64Value Exec(FunctionContext*, Int64Value v1, Int64Value v2) { return v1.val + v2.val; }
 };
 
+// Same as AddUDF, but uses the batch form of Exec.
+class AddBatchUDF : public ScalarUDF {
+ public:
+  Int64Value Exec(FunctionContext*, Int64Value v1, Int64Value v2) { return v1.val + v2.val; }
+  void ExecBatch(FunctionContext*, BatchArg<Int64Value> v1, BatchArg<Int64Value> v2,
+                 BatchOut<Int64Value> out) {
+    for (size_t i = 0; i < out.size(); ++i) {
+      out[i] = v1[i] + v2[i];
+    }
+  }
+};
+
 class SubStrUDF : public ScalarUDF {
  public:
   StringValue Exec(FunctionContext*, StringValue v1) { return v1.substr(1, 2); }
 };
 
 // This benchmark add two columns using Int64ValueVectors.
+template <typename TUDF>
 // NOLINTNEXTLINE : runtime/references.
 static void BM_AddInt64Values(benchmark::State& state) {
   auto vec1 = CreateLargeData<Int64Value>(state.range(0));
@@ -75,7 +90,7 @@ static void BM_AddInt64Values(benchmark::State& state) {
 
   // Create the UDF.
   ScalarUDFDefinition def("add");
-  CHECK(def.template Init<AddUDF>().ok());
+  CHECK(def.template Init<TUDF>().ok());
   auto u = def.Make();
 
   // Loop the test.
@@ -127,13 +142,14 @@ static void BM_SubStr(benchmark::State& state) {
 }
 
 // Benchmark adding two integers using arrow as the interface.
+template <typename TUDF>
 // NOLINTNEXTLINE : runtime/references.
 static void BM_AddTwoInt64sArrow(benchmark::State& state) {
   size_t size = state.range(0);
   auto arr1 = ToArrow(CreateLargeData<Int64Value>(size), arrow::default_memory_pool());
   auto arr2 = ToArrow(CreateLargeData<Int64Value>(size), arrow::default_memory_pool());
 
-  auto u = std::make_shared<AddUDF>();
+  auto u = std::make_shared<TUDF>();
   std::shared_ptr<arrow::Array> out;
   // NOLINTNEXTLINE : clang-analyzer-deadcode.DeadStores.
   for (auto _ : state) {
@@ -141,8 +157,8 @@ static void BM_AddTwoInt64sArrow(benchmark::State& state) {
       out.reset();
     }
     auto output_builder = std::make_shared<arrow::Int64Builder>();
-    auto res = ScalarUDFWrapper<AddUDF>::ExecBatchArrow(u.get(), nullptr, {arr1.get(), arr2.get()},
-                                                        output_builder.get(), size);
+    auto res = ScalarUDFWrapper<TUDF>::ExecBatchArrow(u.get(), nullptr, {arr1.get(), arr2.get()},
+                                                      output_builder.get(), size);
     CHECK(res.ok());
     CHECK(output_builder->Finish(&out).ok());
     benchmark::DoNotOptimize(out);
@@ -245,8 +261,10 @@ static void BM_SubStrArrow(benchmark::State& state) {
 }
 
 BENCHMARK(BM_AddInt64ValueToArrow)->RangeMultiplier(2)->Range(1, 1 << 16);
-BENCHMARK(BM_AddTwoInt64sArrow)->RangeMultiplier(2)->Range(1, 1 << 16);
-BENCHMARK(BM_AddInt64Values)->RangeMultiplier(2)->Range(1, 1 << 16);
+BENCHMARK_TEMPLATE(BM_AddTwoInt64sArrow, AddUDF)->RangeMultiplier(2)->Range(1, 1 << 16);
+BENCHMARK_TEMPLATE(BM_AddTwoInt64sArrow, AddBatchUDF)->RangeMultiplier(2)->Range(1, 1 << 16);
+BENCHMARK_TEMPLATE(BM_AddInt64Values, AddUDF)->RangeMultiplier(2)->Range(1, 1 << 16);
+BENCHMARK_TEMPLATE(BM_AddInt64Values, AddBatchUDF)->RangeMultiplier(2)->Range(1, 1 << 16);
 
 BENCHMARK(BM_ConvertToArrowString)->RangeMultiplier(2)->Range(1, 1 << 16);
 BENCHMARK(BM_ConvertToArrowInt64)->RangeMultiplier(2)->Range(1, 1 << 16);
@@ -18,10 +18,14 @@
 
 #pragma once
 
+#include <absl/container/flat_hash_map.h>
 #include <arrow/array.h>
 
 #include <memory>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 #include "src/carnot/udf/udf.h"
@@ -132,6 +136,270 @@ Status ExecWrapperArrow(TUDF* udf, FunctionContext* ctx, size_t count, TOutput*
   return Status::OK();
 }
 
+// Returns the hashable native value of a UDF value, used as the key to memoize Exec results.
+template <typename T>
+inline const auto& MemoKey(const T& v) {
+  return v.val;
+}
+
+inline const std::string& MemoKey(const types::StringValue& s) { return s; }
+
+/**
+ * Variant of ExecWrapper for UDFs that opted in to memoization (see ScalarUDF).
+ *
+ * Exec is called once per distinct input value, and every other row with that value copies
+ * the output of the first row that produced it.
+ */
+template <typename TUDF, typename TOutput>
+Status ExecWrapperMemoized(TUDF* udf, FunctionContext* ctx, size_t count, TOutput* out,
+                           const std::vector<const types::BaseValueType*>& args) {
+  constexpr auto exec_argument_types = ScalarUDFTraits<TUDF>::ExecArguments();
+  static_assert(exec_argument_types.size() == 1, "Only single argument UDFs can be memoized");
+  constexpr types::DataType arg_type = exec_argument_types[0];
+  using key_type = typename types::DataTypeTraits<arg_type>::native_type;
+
+  const auto* in = CastToUDFValueType<arg_type>(args[0]);
+  absl::flat_hash_map<key_type, size_t> first_row;
+  for (size_t idx = 0; idx < count; ++idx) {
+    const auto& key = MemoKey(in[idx]);
+    // Rows with the same input tend to be adjacent, so check the previous row before hashing.
+    if (idx > 0 && key == MemoKey(in[idx - 1])) {
+      out[idx] = out[idx - 1];
+      continue;
+    }
+    auto [it, inserted] = first_row.try_emplace(key, idx);
+    if (inserted) {
+      out[idx] = udf->Exec(ctx, in[idx]);
+    } else {
+      out[idx] = out[it->second];
+    }
+  }
+  return Status::OK();
+}
+
+/**
+ * Variant of ExecWrapperArrow for UDFs that opted in to memoization (see ScalarUDF).
+ *
+ * The distinct inputs are resolved first, and the results are then scattered to the output.
+ * Since the output size is known at that point, string data is reserved in one allocation.
+ */
+template <typename TUDF, typename TOutput>
+Status ExecWrapperArrowMemoized(TUDF* udf, FunctionContext* ctx, size_t count, TOutput* out,
+                                const std::vector<arrow::Array*>& args) {
+  constexpr auto exec_argument_types = ScalarUDFTraits<TUDF>::ExecArguments();
+  static_assert(exec_argument_types.size() == 1, "Only single argument UDFs can be memoized");
+  constexpr types::DataType arg_type = exec_argument_types[0];
+  using key_type = typename types::DataTypeTraits<arg_type>::native_type;
+  using result_type = decltype(UnWrap(udf->Exec(ctx, std::declval<key_type>())));
+
+  absl::flat_hash_map<key_type, size_t> slots;
+  std::vector<result_type> results;
+  std::vector<size_t> row_slots(count);
+  for (size_t idx = 0; idx < count; ++idx) {
+    auto [it, inserted] =
+        slots.try_emplace(types::GetValueFromArrowArray<arg_type>(args[0], idx), results.size());
+    if (inserted) {
+      results.push_back(UnWrap(udf->Exec(ctx, it->first)));
+    }
+    row_slots[idx] = it->second;
+  }
+
+  PL_RETURN_IF_ERROR(out->Reserve(count));
+  // PL_CARNOT_UPDATE_FOR_NEW_TYPES.
+  if constexpr (std::is_same_v<arrow::StringBuilder, TOutput>) {
+    size_t total_size = 0;
+    for (size_t slot : row_slots) {
+      total_size += results[slot].size();
+    }
+    PL_RETURN_IF_ERROR(out->ReserveData(total_size));
+  }
+  for (size_t slot : row_slots) {
+    out->UnsafeAppend(results[slot]);
+  }
+  return Status::OK();
+}
+
+// Whether column wrappers of this type store a contiguous array of the native type.
+// PL_CARNOT_UPDATE_FOR_NEW_TYPES.
+constexpr bool IsBatchNativeType(types::DataType type) {
+  return type == types::BOOLEAN || type == types::INT64 || type == types::FLOAT64 ||
+         type == types::TIME64NS;
+}
+
+// Whether arrow arrays of this type store a contiguous array of the native type.
+// Booleans are bit-packed in arrow, so they are excluded.
+// PL_CARNOT_UPDATE_FOR_NEW_TYPES.
+constexpr bool IsArrowBatchNativeType(types::DataType type) {
+  return type == types::INT64 || type == types::FLOAT64 || type == types::TIME64NS;
+}
+
+// Whether ExecBatch can take (or return) values of this type. Strings are passed as views.
+constexpr bool IsExecBatchType(types::DataType type) {
+  return IsBatchNativeType(type) || type == types::STRING;
+}
+
+constexpr bool IsArrowExecBatchType(types::DataType type) {
+  return IsArrowBatchNativeType(type) || type == types::STRING;
+}
+
+template <std::size_t SIZE>
+constexpr bool AllOf(const std::array<types::DataType, SIZE>& types,
+                     bool (*pred)(types::DataType)) {
+  for (const auto& type : types) {
+    if (!pred(type)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Whether ExecBatch should be used over Exec: the UDF must implement it, and every
+ * argument and the return type must be usable as spans.
+ */
+template <typename TUDF>
+constexpr bool UseExecBatch(bool arrow) {
+  if constexpr (!ScalarUDFTraits<TUDF>::HasExecBatch()) {
+    return false;
+  } else {
+    constexpr auto exec_argument_types = ScalarUDFTraits<TUDF>::ExecArguments();
+    auto* input_pred = arrow ? &IsArrowExecBatchType : &IsExecBatchType;
+    return AllOf(exec_argument_types, input_pred) &&
+           IsExecBatchType(ScalarUDFTraits<TUDF>::ReturnType());
+  }
+}
+
+/**
+ * Whether UpdateBatch should be used over Update.
+ */
+template <typename TUDA>
+constexpr bool UseUpdateBatch(bool arrow) {
+  if constexpr (!UDATraits<TUDA>::HasUpdateBatch()) {
+    return false;
+  } else {
+    constexpr auto update_argument_types = UDATraits<TUDA>::UpdateArgumentTypes();
+    return AllOf(update_argument_types, arrow ? &IsArrowBatchNativeType : &IsBatchNativeType);
+  }
+}
+
+template <types::DataType T>
+using NativeType = typename types::DataTypeTraits<T>::native_type;
+
+// Views a column of fixed size UDF values as a span of their native values. The value types
+// hold only their native value, so the arrays have the same layout.
+template <types::DataType T>
+inline absl::Span<const NativeType<T>> NativeSpan(const types::BaseValueType* arg, size_t count) {
+  using value_type = typename types::DataTypeTraits<T>::value_type;
+  static_assert(sizeof(value_type) == sizeof(NativeType<T>));
+  return {reinterpret_cast<const NativeType<T>*>(CastToUDFValueType<T>(arg)), count};
+}
+
+template <types::DataType T>
+inline absl::Span<const NativeType<T>> ArrowNativeSpan(const arrow::Array* arg, size_t count) {
+  using arrow_array_type = typename types::DataTypeTraits<T>::arrow_array_type;
+  return {static_cast<const arrow_array_type*>(arg)->raw_values(), count};
+}
+
+/**
+ * Holds the span passed to ExecBatch for an input column. Fixed size values are viewed in place.
+ */
+template <types::DataType T>
+class BatchArgHolder {
+ public:
+  BatchArgHolder(const types::BaseValueType* arg, size_t count)
+      : span_(NativeSpan<T>(arg, count)) {}
+  BatchArgHolder(const arrow::Array* arg, size_t count) : span_(ArrowNativeSpan<T>(arg, count)) {}
+
+  absl::Span<const NativeType<T>> span() const { return span_; }
+
+ private:
+  absl::Span<const NativeType<T>> span_;
+};
+
+/**
+ * Strings are not stored contiguously, so they are viewed through a vector of string_views.
+ */
+template <>
+class BatchArgHolder<types::STRING> {
+ public:
+  BatchArgHolder(const types::BaseValueType* arg, size_t count) : views_(count) {
+    const auto* values = CastToUDFValueType<types::STRING>(arg);
+    for (size_t idx = 0; idx < count; ++idx) {
+      views_[idx] = values[idx];
+    }
+  }
+  BatchArgHolder(const arrow::Array* arg, size_t count) : views_(count) {
+    const auto* arr = static_cast<const arrow::StringArray*>(arg);
+    for (size_t idx = 0; idx < count; ++idx) {
+      int32_t length;
+      const uint8_t* data = arr->GetValue(idx, &length);
+      views_[idx] = std::string_view(reinterpret_cast<const char*>(data), length);
+    }
+  }
+
+  absl::Span<const std::string_view> span() const { return views_; }
+
+ private:
+  std::vector<std::string_view> views_;
+};
+
+/**
+ * Calls ExecBatch directly on the input and output columns. String results are computed into a
+ * temporary vector, and then moved into the output column.
+ */
+template <typename TUDF, typename TOutput, std::size_t... I>
+Status ExecBatchWrapper(TUDF* udf, FunctionContext* ctx, size_t count, TOutput* out,
+                        const std::vector<const types::BaseValueType*>& args,
+                        std::index_sequence<I...>) {
+  [[maybe_unused]] constexpr auto exec_argument_types = ScalarUDFTraits<TUDF>::ExecArguments();
+  constexpr types::DataType return_type = ScalarUDFTraits<TUDF>::ReturnType();
+  std::tuple<BatchArgHolder<exec_argument_types[I]>...> holders(
+      BatchArgHolder<exec_argument_types[I]>(args[I], count)...);
+  if constexpr (return_type == types::STRING) {
+    std::vector<std::string> results(count);
+    udf->ExecBatch(ctx, std::get<I>(holders).span()..., absl::MakeSpan(results));
+    for (size_t idx = 0; idx < count; ++idx) {
+      out[idx] = std::move(results[idx]);
+    }
+  } else {
+    static_assert(sizeof(TOutput) == sizeof(NativeType<return_type>));
+    udf->ExecBatch(ctx, std::get<I>(holders).span()...,
+                   absl::Span<NativeType<return_type>>(
+                       reinterpret_cast<NativeType<return_type>*>(out), count));
+  }
+  return Status::OK();
+}
+
+/**
+ * Calls ExecBatch on the arrow input values. Arrow builders cannot be written to as a span,
+ * so the output goes through a temporary buffer.
+ */
+template <typename TUDF, typename TOutput, std::size_t... I>
+Status ExecBatchWrapperArrow(TUDF* udf, FunctionContext* ctx, size_t count, TOutput* out,
+                             const std::vector<arrow::Array*>& args, std::index_sequence<I...>) {
+  [[maybe_unused]] static constexpr auto exec_argument_types =
+      ScalarUDFTraits<TUDF>::ExecArguments();
+  constexpr types::DataType return_type = ScalarUDFTraits<TUDF>::ReturnType();
+  std::tuple<BatchArgHolder<exec_argument_types[I]>...> holders(
+      BatchArgHolder<exec_argument_types[I]>(args[I], count)...);
+  auto results = std::make_unique<NativeType<return_type>[]>(count);
+  udf->ExecBatch(ctx, std::get<I>(holders).span()...,
+                 absl::Span<NativeType<return_type>>(results.get(), count));
+
+  PL_RETURN_IF_ERROR(out->Reserve(count));
+  if constexpr (return_type == types::STRING) {
+    size_t total_size = 0;
+    for (size_t idx = 0; idx < count; ++idx) {
+      total_size += results[idx].size();
+    }
+    PL_RETURN_IF_ERROR(out->ReserveData(total_size));
+  }
+  for (size_t idx = 0; idx < count; ++idx) {
+    out->UnsafeAppend(results[idx]);
+  }
+  return Status::OK();
+}
+
 /**
  * Checks types between column wrapper and array of types::UDFDataTypes.
  * @return true if all types match.
@@ -197,13 +465,22 @@ struct ScalarUDFWrapper {
     // Check that the arity is correct.
     DCHECK(inputs.size() == ScalarUDFTraits<TUDF>::ExecArguments().size());
 
+    auto* casted_output =
+        static_cast<typename types::DataTypeTraits<return_type>::arrow_builder_type*>(output);
+    if constexpr (ScalarUDFTraits<TUDF>::MemoizeExec()) {
+      return ExecWrapperArrowMemoized<TUDF>(static_cast<TUDF*>(udf), ctx, count, casted_output,
+                                            inputs);
+    }
+    if constexpr (UseExecBatch<TUDF>(/* arrow */ true)) {
+      return ExecBatchWrapperArrow<TUDF>(static_cast<TUDF*>(udf), ctx, count, casted_output,
+                                         inputs,
+                                         std::make_index_sequence<exec_argument_types.size()>{});
+    }
     // The outer wrapper just casts the output type and UDF type. We then pass in
     // the inputs with a sequence based on the number of arguments to iterate through and
     // cast the inputs.
-    return ExecWrapperArrow<TUDF>(
-        static_cast<TUDF*>(udf), ctx, count,
-        static_cast<typename types::DataTypeTraits<return_type>::arrow_builder_type*>(output),
-        inputs, std::make_index_sequence<exec_argument_types.size()>{});
+    return ExecWrapperArrow<TUDF>(static_cast<TUDF*>(udf), ctx, count, casted_output, inputs,
+                                  std::make_index_sequence<exec_argument_types.size()>{});
   }
 
   /**
@@ -238,6 +515,15 @@ struct ScalarUDFWrapper {
 
     using output_type = typename types::DataTypeTraits<return_type>::value_type;
     auto* casted_output = static_cast<output_type*>(output->UnsafeRawData());
+    if constexpr (ScalarUDFTraits<TUDF>::MemoizeExec()) {
+      return ExecWrapperMemoized<TUDF>(static_cast<TUDF*>(udf), ctx, count, casted_output,
+                                       input_as_base_value);
+    }
+    if constexpr (UseExecBatch<TUDF>(/* arrow */ false)) {
+      return ExecBatchWrapper<TUDF>(static_cast<TUDF*>(udf), ctx, count, casted_output,
+                                    input_as_base_value,
+                                    std::make_index_sequence<exec_argument_types.size()>{});
+    }
     // The outer wrapper just casts the output type and UDF type. We then pass in
     // the inputs with a sequence based on the number of arguments to iterate through and
     // cast the inputs.
@@ -289,6 +575,10 @@ Status UpdateWrapper(TUDA* uda, FunctionContext* ctx, size_t count,
                      const std::vector<const types::BaseValueType*>& args,
                      std::index_sequence<I...>) {
   constexpr auto update_argument_types = UDATraits<TUDA>::UpdateArgumentTypes();
+  if constexpr (UseUpdateBatch<TUDA>(/* arrow */ false)) {
+    uda->UpdateBatch(ctx, NativeSpan<update_argument_types[I]>(args[I], count)...);
+    return Status::OK();
+  }
   for (size_t idx = 0; idx < count; ++idx) {
     uda->Update(ctx, CastToUDFValueType<update_argument_types[I]>(args[I])[idx]...);
   }
@@ -303,6 +593,10 @@ template <typename TUDA, std::size_t... I>
 Status UpdateWrapperArrow(TUDA* uda, FunctionContext* ctx, size_t count,
                           const std::vector<const arrow::Array*>& args, std::index_sequence<I...>) {
   constexpr auto update_argument_types = UDATraits<TUDA>::UpdateArgumentTypes();
+  if constexpr (UseUpdateBatch<TUDA>(/* arrow */ true)) {
+    uda->UpdateBatch(ctx, ArrowNativeSpan<update_argument_types[I]>(args[I], count)...);
+    return Status::OK();
+  }
   for (size_t idx = 0; idx < count; ++idx) {
     uda->Update(ctx, types::GetValueFromArrowArray<update_argument_types[I]>(args[I], idx)...);
   }
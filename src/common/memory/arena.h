@@ -0,0 +1,146 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "src/common/base/base.h"
+
+namespace px {
+
+/**
+ * Arena is a bump allocator for objects that all live until the arena is reset (or destroyed),
+ * such as the per-row state of a query. Allocating is a pointer bump, and everything is freed at
+ * once, with no per-object bookkeeping besides the destructors to run.
+ *
+ * Unlike ObjectPool, Arena is not thread-safe: it is meant to be used by a single thread at a
+ * time.
+ */
+class Arena : public NotCopyable {
+ public:
+  static constexpr size_t kDefaultBlockSize = 64 * 1024;
+
+  /**
+   * Called with the size of each block the arena reserves, and with the negated total when the
+   * arena releases its blocks. Used to account for the arena's memory.
+   */
+  using ReserveFn = std::function<void(int64_t bytes)>;
+
+  explicit Arena(size_t block_size = kDefaultBlockSize, ReserveFn reserve_fn = nullptr)
+      : block_size_(block_size), reserve_fn_(std::move(reserve_fn)) {}
+
+  ~Arena() { Reset(); }
+
+  /**
+   * Allocates uninitialized memory, which is valid until the arena is reset.
+   */
+  void* Allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+    uintptr_t pos = AlignUp(reinterpret_cast<uintptr_t>(pos_), alignment);
+    if (pos_ == nullptr || pos + bytes > reinterpret_cast<uintptr_t>(end_)) {
+      AddBlock(bytes + alignment);
+      pos = AlignUp(reinterpret_cast<uintptr_t>(pos_), alignment);
+    }
+    pos_ = reinterpret_cast<char*>(pos + bytes);
+    bytes_used_ += bytes;
+    return reinterpret_cast<void*>(pos);
+  }
+
+  /**
+   * Constructs an object in the arena. Its destructor is run when the arena is reset.
+   */
+  template <typename T, typename... Args>
+  T* New(Args&&... args) {
+    T* obj = new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      destructors_ = new (Allocate(sizeof(Destructor), alignof(Destructor)))
+          Destructor{obj, [](void* ptr) { static_cast<T*>(ptr)->~T(); }, destructors_};
+    }
+    return obj;
+  }
+
+  /**
+   * Destroys all the objects (latest first) and frees all the memory of the arena.
+   */
+  void Reset() {
+    for (Destructor* d = destructors_; d != nullptr; d = d->next) {
+      d->fn(d->obj);
+    }
+    destructors_ = nullptr;
+    blocks_.clear();
+    pos_ = nullptr;
+    end_ = nullptr;
+    bytes_used_ = 0;
+    if (reserve_fn_ && bytes_reserved_ > 0) {
+      reserve_fn_(-static_cast<int64_t>(bytes_reserved_));
+    }
+    bytes_reserved_ = 0;
+  }
+
+  // The bytes allocated from the arena.
+  size_t bytes_used() const { return bytes_used_; }
+  // The bytes of the blocks the arena holds.
+  size_t bytes_reserved() const { return bytes_reserved_; }
+
+ private:
+  struct Destructor {
+    void* obj;
+    void (*fn)(void*);
+    Destructor* next;
+  };
+
+  static uintptr_t AlignUp(uintptr_t pos, size_t alignment) {
+    return (pos + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+  }
+
+  void AddBlock(size_t min_size) {
+    // Large allocations get a block of their own size. The rest of the current block is wasted,
+    // which is bounded by the allocation size.
+    size_t size = std::max(block_size_, min_size);
+    blocks_.emplace_back(new char[size]);
+    pos_ = blocks_.back().get();
+    end_ = pos_ + size;
+    bytes_reserved_ += size;
+    if (reserve_fn_) {
+      reserve_fn_(size);
+    }
+  }
+
+  const size_t block_size_;
+  const ReserveFn reserve_fn_;
+
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  // The free part of the current block.
+  char* pos_ = nullptr;
+  char* end_ = nullptr;
+  // The destructors to run on reset, latest first.
+  Destructor* destructors_ = nullptr;
+
+  size_t bytes_used_ = 0;
+  size_t bytes_reserved_ = 0;
+};
+
+}  // namespace px
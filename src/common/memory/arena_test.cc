@@ -0,0 +1,84 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/common/memory/arena.h"
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace px {
+
+class CountedObject {
+ public:
+  CountedObject(int* destroy_count, std::string name)
+      : destroy_count_(destroy_count), name_(std::move(name)) {}
+  ~CountedObject() { (*destroy_count_)++; }
+  const std::string& name() const { return name_; }
+
+ private:
+  int* destroy_count_;
+  std::string name_;
+};
+
+TEST(arena_test, test_destroy) {
+  int count = 0;
+  {
+    Arena arena;
+    auto* obj = arena.New<CountedObject>(&count, "a");
+    arena.New<CountedObject>(&count, "b");
+    EXPECT_EQ("a", obj->name());
+    EXPECT_EQ(0, count);
+  }
+  EXPECT_EQ(2, count);
+}
+
+TEST(arena_test, test_reset) {
+  int count = 0;
+  Arena arena;
+  arena.New<CountedObject>(&count, "a");
+  arena.New<CountedObject>(&count, "b");
+  arena.Reset();
+  EXPECT_EQ(2, count);
+  EXPECT_EQ(0, arena.bytes_used());
+  EXPECT_EQ(0, arena.bytes_reserved());
+
+  // The arena can be used again after a reset.
+  arena.New<CountedObject>(&count, "c");
+  arena.Reset();
+  EXPECT_EQ(3, count);
+}
+
+TEST(arena_test, test_alignment_and_blocks) {
+  int64_t reserved = 0;
+  Arena arena(/*block_size*/ 128, [&](int64_t bytes) { reserved += bytes; });
+  for (int i = 0; i < 100; ++i) {
+    arena.Allocate(1, 1);
+    auto* val = static_cast<double*>(arena.Allocate(sizeof(double), alignof(double)));
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(val) % alignof(double));
+    *val = i;
+  }
+  // A large allocation gets its own block.
+  arena.Allocate(1024);
+  EXPECT_GT(arena.bytes_reserved(), 1024);
+  EXPECT_EQ(static_cast<int64_t>(arena.bytes_reserved()), reserved);
+
+  arena.Reset();
+  EXPECT_EQ(0, reserved);
+}
+
+}  // namespace px
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+#include <time.h>
+
+#include "src/common/base/base.h"
+
+namespace px {
+
+/**
+ * Timer of the CPU time used by the calling thread, from CLOCK_THREAD_CPUTIME_ID.
+ *
+ * Unlike ElapsedTimer, time the thread spends blocked or descheduled is not counted. The timer
+ * must be resumed and stopped on the same thread.
+ */
+class ThreadCPUTimer : public NotCopyable {
+ public:
+  /**
+   * Start the timer.
+   */
+  void Start() {
+    Reset();
+    Resume();
+  }
+
+  /**
+   * Stop the timer.
+   */
+  void Stop() {
+    DCHECK(timer_running_) << "Stop called when timer is not running";
+    timer_running_ = false;
+    elapsed_time_ns_ += Now() - start_time_ns_;
+  }
+
+  /**
+   * Resume the timer.
+   */
+  void Resume() {
+    DCHECK(!timer_running_) << "Timer already running";
+    timer_running_ = true;
+    start_time_ns_ = Now();
+  }
+
+  /**
+   * Reset the timer.
+   */
+  void Reset() {
+    timer_running_ = false;
+    elapsed_time_ns_ = 0;
+  }
+
+  /**
+   * @return the CPU time in ns.
+   */
+  uint64_t ElapsedTime_ns() const {
+    return elapsed_time_ns_ + (timer_running_ ? Now() - start_time_ns_ : 0);
+  }
+
+ private:
+  static uint64_t Now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000 * 1000 * 1000 + ts.tv_nsec;
+  }
+  bool timer_running_ = false;
+  uint64_t start_time_ns_ = 0;
+  uint64_t elapsed_time_ns_ = 0;
+};
+
+}  // namespace px
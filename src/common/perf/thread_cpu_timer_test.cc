@@ -0,0 +1,62 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+
+#include "src/common/perf/elapsed_timer.h"
+#include "src/common/perf/thread_cpu_timer.h"
+
+namespace px {
+
+TEST(thread_cpu_timer, excludes_sleep) {
+  ElapsedTimer wall_timer;
+  ThreadCPUTimer cpu_timer;
+  wall_timer.Start();
+  cpu_timer.Start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  cpu_timer.Stop();
+  wall_timer.Stop();
+
+  EXPECT_GE(wall_timer.ElapsedTime_us(), 50 * 1000);
+  EXPECT_LT(cpu_timer.ElapsedTime_ns(), 25 * 1000 * 1000);
+}
+
+TEST(thread_cpu_timer, counts_work_across_resumes) {
+  ThreadCPUTimer cpu_timer;
+  volatile uint64_t sum = 0;
+  for (int i = 0; i < 2; ++i) {
+    cpu_timer.Resume();
+    for (uint64_t j = 0; j < 10 * 1000 * 1000; ++j) {
+      sum = sum + j;
+    }
+    cpu_timer.Stop();
+  }
+  uint64_t elapsed_ns = cpu_timer.ElapsedTime_ns();
+  EXPECT_GT(elapsed_ns, 0);
+
+  // Stopped timers don't count the time until they resume.
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_EQ(elapsed_ns, cpu_timer.ElapsedTime_ns());
+
+  cpu_timer.Reset();
+  EXPECT_EQ(0, cpu_timer.ElapsedTime_ns());
+}
+
+}  // namespace px
@@ -38,8 +38,50 @@ namespace md {
 using K8sMetadataObjectUPtr = std::unique_ptr<K8sMetadataObject>;
 using ContainerInfoUPtr = std::unique_ptr<ContainerInfo>;
 using PIDInfoUPtr = std::unique_ptr<PIDInfo>;
+using K8sMetadataObjectSPtr = std::shared_ptr<K8sMetadataObject>;
+using ContainerInfoSPtr = std::shared_ptr<ContainerInfo>;
+using PIDInfoSPtr = std::shared_ptr<PIDInfo>;
 using AgentID = sole::uuid;
 
+/**
+ * CopyOnWrite holds a value that is shared between copies of the holder, until one of the copies
+ * asks for mutable access, at which point that copy gets a private copy of the value.
+ *
+ * This lets a metadata state be cloned in constant time, with each update then paying only for
+ * the containers it touches. Mutable access must only happen from the single thread that updates
+ * the state; readers of published states only ever see the const value.
+ */
+template <typename T>
+class CopyOnWrite {
+ public:
+  CopyOnWrite() : value_(std::make_shared<T>()) {}
+
+  const T& operator*() const { return *value_; }
+  const T* operator->() const { return value_.get(); }
+
+  T* mutable_value() {
+    if (value_.use_count() > 1) {
+      value_ = std::make_shared<T>(*value_);
+    }
+    return value_.get();
+  }
+
+ private:
+  std::shared_ptr<T> value_;
+};
+
+/**
+ * Returns a mutable pointer to the object held by the given map slot. The object is copied first
+ * if it is still shared with another (cloned) metadata state.
+ */
+template <typename T>
+T* MutableObject(std::shared_ptr<T>* obj) {
+  if (obj->use_count() > 1) {
+    *obj = (*obj)->Clone();
+  }
+  return obj->get();
+}
+
 /**
  * This class contains all kubernetes relate metadata.
  */
@@ -112,7 +154,7 @@ class K8sMetadataState : NotCopyable {
 
   const std::vector<CIDRBlock>& pod_cidrs() const { return pod_cidrs_; }
 
-  const PodsByNameMap& pods_by_name() const { return pods_by_name_; }
+  const PodsByNameMap& pods_by_name() const { return *pods_by_name_; }
 
   /**
    * PodInfoByID gets an unowned pointer to the Pod. This pointer will remain active
@@ -150,6 +192,14 @@ class K8sMetadataState : NotCopyable {
    */
   const ContainerInfo* ContainerInfoByID(CIDView id) const;
 
+  /**
+   * MutableContainerInfoByID returns the container info by ID, for modification.
+   * The container is copied if it is shared with another metadata state.
+   * @param id The ID of the container.
+   * @return ContainerInfo or nullptr if not found.
+   */
+  ContainerInfo* MutableContainerInfoByID(CIDView id);
+
   /**
    * ContainerIDByName returns the ContainerID for the container of the given name.
    * @param container_name the container name
@@ -196,7 +246,9 @@ class K8sMetadataState : NotCopyable {
 
   Status CleanupExpiredMetadata(int64_t retention_time_ns);
 
-  absl::flat_hash_map<CID, ContainerInfoUPtr>& containers_by_id() { return containers_by_id_; }
+  const absl::flat_hash_map<CID, ContainerInfoSPtr>& containers_by_id() const {
+    return *containers_by_id_;
+  }
   std::string DebugString(int indent_level = 0) const;
 
  private:
@@ -208,41 +260,43 @@ class K8sMetadataState : NotCopyable {
   // The CIDRs used for pods inside the cluster.
   std::vector<CIDRBlock> pod_cidrs_;
 
+  // All maps, and the objects within them, are shared with clones of this state until modified.
+
   // This stores K8s native objects (services, pods, etc).
-  absl::flat_hash_map<UID, K8sMetadataObjectUPtr> k8s_objects_by_id_;
+  CopyOnWrite<absl::flat_hash_map<UID, K8sMetadataObjectSPtr>> k8s_objects_by_id_;
 
   // This stores container objects, complementing k8s_objects_by_id_.
-  absl::flat_hash_map<CID, ContainerInfoUPtr> containers_by_id_;
+  CopyOnWrite<absl::flat_hash_map<CID, ContainerInfoSPtr>> containers_by_id_;
 
   /**
    * Mapping of pods by name.
    */
-  PodsByNameMap pods_by_name_;
+  CopyOnWrite<PodsByNameMap> pods_by_name_;
 
   /**
    * Mapping of services by name.
    */
-  ServicesByNameMap services_by_name_;
+  CopyOnWrite<ServicesByNameMap> services_by_name_;
 
   /**
    * Mapping of namespaces by name.
    */
-  NamespacesByNameMap namespaces_by_name_;
+  CopyOnWrite<NamespacesByNameMap> namespaces_by_name_;
 
   /**
    * Mapping of containers by name.
    */
-  ContainersByNameMap containers_by_name_;
+  CopyOnWrite<ContainersByNameMap> containers_by_name_;
 
   /**
    * Mapping of Pods by host ip.
    */
-  PodsByPodIpMap pods_by_ip_;
+  CopyOnWrite<PodsByPodIpMap> pods_by_ip_;
 
   /**
    * Mapping of Services by Cluster IP.
    */
-  ServicesByServiceIpMap services_by_cluster_ip_;
+  CopyOnWrite<ServicesByServiceIpMap> services_by_cluster_ip_;
 };
 
 class AgentMetadataState : NotCopyable {
@@ -277,9 +331,9 @@ class AgentMetadataState : NotCopyable {
 
   std::shared_ptr<AgentMetadataState> CloneToShared() const;
 
-  PIDInfo* GetPIDByUPID(UPID upid) const {
-    auto it = pids_by_upid_.find(upid);
-    if (it != pids_by_upid_.end()) {
+  const PIDInfo* GetPIDByUPID(UPID upid) const {
+    auto it = pids_by_upid_->find(upid);
+    if (it != pids_by_upid_->end()) {
       return it->second.get();
     }
     return nullptr;
@@ -289,23 +343,23 @@ class AgentMetadataState : NotCopyable {
     DCHECK(pid_info != nullptr);
     DCHECK_EQ(pid_info->stop_time_ns(), 0);
 
-    pids_by_upid_[upid] = std::move(pid_info);
-    upids_.insert(upid);
+    (*pids_by_upid_.mutable_value())[upid] = std::move(pid_info);
+    upids_.mutable_value()->insert(upid);
   }
 
   void MarkUPIDAsStopped(UPID upid, int64_t ts) {
-    auto* pid_info = GetPIDByUPID(upid);
-    if (pid_info != nullptr) {
-      pid_info->set_stop_time_ns(ts);
-      upids_.erase(upid);
-    } else {
-      DCHECK(!upids_.contains(upid));
+    if (!pids_by_upid_->contains(upid)) {
+      DCHECK(!upids_->contains(upid));
+      return;
     }
+    auto* pids_by_upid = pids_by_upid_.mutable_value();
+    MutableObject(&pids_by_upid->find(upid)->second)->set_stop_time_ns(ts);
+    upids_.mutable_value()->erase(upid);
   }
 
-  const absl::flat_hash_map<UPID, PIDInfoUPtr>& pids_by_upid() const { return pids_by_upid_; }
+  const absl::flat_hash_map<UPID, PIDInfoSPtr>& pids_by_upid() const { return *pids_by_upid_; }
 
-  const absl::flat_hash_set<md::UPID>& upids() const { return upids_; }
+  const absl::flat_hash_set<md::UPID>& upids() const { return *upids_; }
 
   std::string DebugString(int indent_level = 0) const;
 
@@ -333,14 +387,14 @@ class AgentMetadataState : NotCopyable {
   /**
    * Mapping of PIDs by UPID for active pods on the system.
    */
-  absl::flat_hash_map<UPID, PIDInfoUPtr> pids_by_upid_;
+  CopyOnWrite<absl::flat_hash_map<UPID, PIDInfoSPtr>> pids_by_upid_;
 
   /**
    * All active UPIDs. Unlike pids_by_upid_, this does not contain stopped pids.
    * While this set could be reconstructed from pids_by_upid_,
    * it is tracked separately as a performance optimization.
    */
-  absl::flat_hash_set<md::UPID> upids_;
+  CopyOnWrite<absl::flat_hash_set<md::UPID>> upids_;
 };
 
 }  // namespace md
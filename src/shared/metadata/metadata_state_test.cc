@@ -169,6 +169,37 @@ TEST(K8sMetadataStateTest, CloneCopiedCIDR) {
   EXPECT_EQ(service_cidr.prefix_length, state_copy->service_cidr()->prefix_length);
 }
 
+TEST(K8sMetadataStateTest, CloneSharesUnmodifiedObjects) {
+  K8sMetadataState state;
+
+  K8sMetadataState::ContainerUpdate container_update;
+  ASSERT_TRUE(TextFormat::MergeFromString(kContainer0UpdatePbTxt, &container_update));
+  K8sMetadataState::PodUpdate pod_update;
+  ASSERT_TRUE(TextFormat::MergeFromString(kPod0UpdatePbTxt, &pod_update));
+  ASSERT_OK(state.HandleContainerUpdate(container_update));
+  ASSERT_OK(state.HandlePodUpdate(pod_update));
+
+  auto state_copy = state.Clone();
+
+  // Until modified, the clone shares the objects of the original.
+  EXPECT_EQ(state.PodInfoByID("pod0_uid"), state_copy->PodInfoByID("pod0_uid"));
+  EXPECT_EQ(state.ContainerInfoByID("container0_uid"),
+            state_copy->ContainerInfoByID("container0_uid"));
+
+  // Modifying the clone copies only the modified object, and leaves the original untouched.
+  state_copy->MutableContainerInfoByID("container0_uid")->set_stop_time_ns(1000);
+  EXPECT_EQ(1000, state_copy->ContainerInfoByID("container0_uid")->stop_time_ns());
+  EXPECT_EQ(102, state.ContainerInfoByID("container0_uid")->stop_time_ns());
+  EXPECT_EQ(state.PodInfoByID("pod0_uid"), state_copy->PodInfoByID("pod0_uid"));
+
+  pod_update.set_pod_ip("1.2.3.9");
+  ASSERT_OK(state_copy->HandlePodUpdate(pod_update));
+  EXPECT_EQ("1.2.3.9", state_copy->PodInfoByID("pod0_uid")->pod_ip());
+  EXPECT_EQ("1.2.3.4", state.PodInfoByID("pod0_uid")->pod_ip());
+  EXPECT_EQ("pod0_uid", state_copy->PodIDByIP("1.2.3.9"));
+  EXPECT_EQ("", state.PodIDByIP("1.2.3.9"));
+}
+
 TEST(K8sMetadataStateTest, HandleContainerUpdate) {
   K8sMetadataState state;
 
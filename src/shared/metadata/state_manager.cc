@@ -16,6 +16,7 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -223,6 +224,18 @@ Status ProcessPIDUpdates(
     moodycamel::BlockingConcurrentQueue<std::unique_ptr<PIDStatusEvent>>* pid_updates) {
   const auto& k8s_md_state = md->k8s_metadata_state();
 
+  // The containers are only read in the loop, and modified after it: MutableContainerInfoByID
+  // copies the container map when it's shared with a previous metadata state, which would
+  // invalidate the iterator.
+  struct StoppedContainer {
+    CID cid;
+    int64_t stop_time_ns;
+    // Whether the container's processes are stopped too.
+    bool stop_upids;
+  };
+  std::vector<StoppedContainer> stopped_containers;
+  std::vector<std::pair<CID, absl::flat_hash_set<uint32_t>>> updated_containers;
+
   for (const auto& [cid, cinfo] : k8s_md_state->containers_by_id()) {
     if (cinfo->stop_time_ns() != 0) {
       // Ignore dead containers.
@@ -249,7 +262,7 @@ Status ProcessPIDUpdates(
     if (pod_info->stop_time_ns() != 0) {
       VLOG(1) << absl::Substitute("Found a running container in a deleted pod [cid=$0, pod_id=$1]",
                                   cid, pod_id);
-      cinfo->set_stop_time_ns(pod_info->stop_time_ns());
+      stopped_containers.push_back({cid, pod_info->stop_time_ns(), /*stop_upids*/ false});
       continue;
     }
 
@@ -267,16 +280,36 @@ Status ProcessPIDUpdates(
       // NOTE: Currently, MDS sends pods that do no belong to this Agent, so this is actually
       // required to avoid repeatedly printing out the warning message above.
       if (error::IsNotFound(s)) {
-        cinfo->set_stop_time_ns(ts);
-        for (const auto& upid : cinfo->active_upids()) {
-          md->MarkUPIDAsStopped(upid, ts);
-        }
-        cinfo->mutable_active_upids()->clear();
+        stopped_containers.push_back({cid, ts, /*stop_upids*/ true});
       }
       continue;
     }
 
-    ProcessContainerPIDUpdates(cid, ts, proc_parser, md, cinfo->mutable_active_upids(),
+    // Most containers' PIDs don't change between updates. Skip those, so that their
+    // ContainerInfo is not copied out of the previous metadata state.
+    const auto& active_upids = cinfo->active_upids();
+    if (active_upids.size() == cgroups_active_pids.size() &&
+        std::all_of(active_upids.begin(), active_upids.end(), [&](const UPID& upid) {
+          return cgroups_active_pids.contains(upid.pid());
+        })) {
+      continue;
+    }
+    updated_containers.emplace_back(cid, std::move(cgroups_active_pids));
+  }
+
+  for (const auto& [cid, stop_time_ns, stop_upids] : stopped_containers) {
+    ContainerInfo* mutable_cinfo = k8s_md_state->MutableContainerInfoByID(cid);
+    mutable_cinfo->set_stop_time_ns(stop_time_ns);
+    if (stop_upids) {
+      for (const auto& upid : mutable_cinfo->active_upids()) {
+        md->MarkUPIDAsStopped(upid, stop_time_ns);
+      }
+      mutable_cinfo->mutable_active_upids()->clear();
+    }
+  }
+  for (auto& [cid, cgroups_active_pids] : updated_containers) {
+    ProcessContainerPIDUpdates(cid, ts, proc_parser, md,
+                               k8s_md_state->MutableContainerInfoByID(cid)->mutable_active_upids(),
                                &cgroups_active_pids, pid_updates);
   }
 
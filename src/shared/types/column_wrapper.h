@@ -62,6 +62,7 @@ class ColumnWrapper {
   virtual int64_t Bytes() const = 0;
 
   virtual void Reserve(size_t size) = 0;
+  virtual void Resize(size_t size) = 0;
   virtual void Clear() = 0;
   virtual void ShrinkToFit() = 0;
   virtual std::shared_ptr<arrow::Array> ConvertToArrow(arrow::MemoryPool* mem_pool) = 0;
@@ -128,7 +129,7 @@ class ColumnWrapperTmpl : public ColumnWrapper {
 
   void ShrinkToFit() override { data_.shrink_to_fit(); }
 
-  void Resize(size_t size) { data_.resize(size); }
+  void Resize(size_t size) override { data_.resize(size); }
 
   void Clear() override { data_.clear(); }
 
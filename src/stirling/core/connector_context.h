@@ -57,7 +57,7 @@ class ConnectorContext {
   /**
    * Return detailed information on UPIDs.
    */
-  virtual const absl::flat_hash_map<md::UPID, md::PIDInfoUPtr>& GetPIDInfoMap() const = 0;
+  virtual const absl::flat_hash_map<md::UPID, md::PIDInfoSPtr>& GetPIDInfoMap() const = 0;
 
   /**
    * Return K8s information (Pod and container information)
@@ -95,7 +95,7 @@ class AgentContext : public ConnectorContext {
     return agent_metadata_state_->upids();
   }
 
-  const absl::flat_hash_map<md::UPID, md::PIDInfoUPtr>& GetPIDInfoMap() const override {
+  const absl::flat_hash_map<md::UPID, md::PIDInfoSPtr>& GetPIDInfoMap() const override {
     return agent_metadata_state_->pids_by_upid();
   }
 
@@ -129,8 +129,8 @@ class StandaloneContext : public ConnectorContext {
 
   const absl::flat_hash_set<md::UPID>& GetUPIDs() const override { return upids_; }
 
-  const absl::flat_hash_map<md::UPID, md::PIDInfoUPtr>& GetPIDInfoMap() const override {
-    static const absl::flat_hash_map<md::UPID, md::PIDInfoUPtr> kEmpty;
+  const absl::flat_hash_map<md::UPID, md::PIDInfoSPtr>& GetPIDInfoMap() const override {
+    static const absl::flat_hash_map<md::UPID, md::PIDInfoSPtr> kEmpty;
     return kEmpty;
   }
 
@@ -18,16 +18,27 @@
 
 #include "src/stirling/obj_tools/dwarf_reader.h"
 
+#include <unistd.h>
+
 #include <algorithm>
+#include <functional>
+#include <thread>
 
+#include <absl/strings/escaping.h>
+#include <absl/strings/strip.h>
 #include <llvm/DebugInfo/DIContext.h>
 #include <llvm/Object/ObjectFile.h>
 
 #include "src/shared/types/typespb/wrapper/types_pb_wrapper.h"
 #include "src/stirling/obj_tools/abi_model.h"
 #include "src/stirling/obj_tools/dwarf_utils.h"
+#include "src/stirling/obj_tools/elf_reader.h"
 #include "src/stirling/obj_tools/init.h"
 
+DEFINE_string(stirling_dwarf_index_cache_dir, "",
+              "If not empty, the directory in which DWARF indexes are cached across DwarfReaders "
+              "of the same binary, keyed by its build ID.");
+
 namespace px {
 namespace stirling {
 namespace obj_tools {
@@ -55,6 +66,44 @@ std::vector<DWARFDie> GetParamDIEs(const DWARFDie& function_die) {
 // https://superuser.com/questions/791506/how-to-determine-if-a-linux-binary-file-is-32-bit-or-64-bit
 uint8_t kAddressSize = sizeof(void*);
 
+namespace {
+
+// Returns the name of the file that caches the DWARF index of the binary. It is derived from the
+// GNU build-id, or else the Go build ID, which are read from the notes of the already parsed
+// object file instead of parsing the binary again. The ID is hex encoded, because Go build IDs
+// contain '/'. Returns an empty string if the binary has no build ID.
+std::string IndexCacheFileName(const llvm::object::ObjectFile& obj_file) {
+  std::string_view go_build_id;
+  for (const llvm::object::SectionRef& section : obj_file.sections()) {
+    llvm::Expected<llvm::StringRef> name = section.getName();
+    if (!name) {
+      llvm::consumeError(name.takeError());
+      continue;
+    }
+    if (*name != ".note.gnu.build-id" && *name != ".note.go.buildid") {
+      continue;
+    }
+    llvm::Expected<llvm::StringRef> contents = section.getContents();
+    if (!contents) {
+      llvm::consumeError(contents.takeError());
+      continue;
+    }
+    std::string_view desc = ElfNoteDesc(std::string_view(contents->data(), contents->size()));
+    if (*name == ".note.gnu.build-id" && !desc.empty()) {
+      return absl::StrCat(absl::BytesToHexString(desc), ".dwarf_index");
+    }
+    if (*name == ".note.go.buildid" && IsGoBuildIDValid(desc)) {
+      go_build_id = desc;
+    }
+  }
+  if (go_build_id.empty()) {
+    return "";
+  }
+  return absl::StrCat(absl::BytesToHexString(go_build_id), ".dwarf_index");
+}
+
+}  // namespace
+
 StatusOr<std::unique_ptr<DwarfReader>> DwarfReader::Create(
     const std::filesystem::path& obj_file_path, bool index) {
   using llvm::MemoryBuffer;
@@ -89,7 +138,24 @@ StatusOr<std::unique_ptr<DwarfReader>> DwarfReader::Create(
   PL_RETURN_IF_ERROR(dwarf_reader->DetectSourceLanguage());
 
   if (index) {
-    dwarf_reader->IndexDIEs();
+    std::filesystem::path index_path;
+    if (!FLAGS_stirling_dwarf_index_cache_dir.empty()) {
+      std::string file_name = IndexCacheFileName(*obj_file);
+      if (!file_name.empty()) {
+        index_path = std::filesystem::path(FLAGS_stirling_dwarf_index_cache_dir) / file_name;
+      }
+    }
+
+    if (index_path.empty() || !dwarf_reader->LoadIndex(index_path).ok()) {
+      dwarf_reader->IndexDIEs();
+      if (!index_path.empty()) {
+        Status s = dwarf_reader->SaveIndex(index_path);
+        if (!s.ok()) {
+          VLOG(1) << absl::Substitute("Failed to save DWARF index of $0, message: $1",
+                                      obj_filename, s.msg());
+        }
+      }
+    }
   }
 
   return dwarf_reader;
@@ -223,16 +289,94 @@ void DwarfReader::IndexDIEs() {
   auto& fn_dies = die_map_[llvm::dwarf::DW_TAG_subprogram];
 
   for (auto iter = fn_dies.begin(); iter != fn_dies.end(); ++iter) {
-    uint64_t offset = iter->second.getOffset();
+    uint64_t offset = iter->second;
     auto spec_iter = fn_spec_offsets.find(offset);
     if (spec_iter == fn_spec_offsets.end()) {
       continue;
     }
     // Replace the DIE with the DW_TAG_subprogram die that has DW_AT_specification attribute.
-    iter->second = spec_iter->second;
+    iter->second = spec_iter->second.getOffset();
   }
 }
 
+namespace {
+
+// The index file is the magic, followed by one record per indexed DIE:
+//   tag (4 bytes) | DIE offset (8 bytes) | name size (4 bytes) | name
+// All integers are little-endian.
+constexpr std::string_view kIndexFileMagic = "PXDWIDX1";
+constexpr size_t kIndexRecordHeaderSize = 16;
+
+template <typename TIntType>
+void AppendLEndianInt(TIntType val, std::string* out) {
+  char bytes[sizeof(TIntType)];
+  utils::IntToLEndianBytes(val, bytes);
+  out->append(bytes, sizeof(bytes));
+}
+
+}  // namespace
+
+Status DwarfReader::LoadIndex(const std::filesystem::path& index_path) {
+  PL_ASSIGN_OR_RETURN(std::string contents,
+                      ReadFileToString(index_path, std::ios_base::in | std::ios_base::binary));
+  std::string_view buf = contents;
+  if (!absl::ConsumePrefix(&buf, kIndexFileMagic)) {
+    return error::InvalidArgument("Invalid DWARF index file $0", index_path.string());
+  }
+
+  absl::flat_hash_map<llvm::dwarf::Tag, absl::flat_hash_map<std::string, uint64_t>> die_map;
+  while (!buf.empty()) {
+    if (buf.size() < kIndexRecordHeaderSize) {
+      return error::InvalidArgument("Truncated DWARF index file $0", index_path.string());
+    }
+    auto tag = static_cast<llvm::dwarf::Tag>(utils::LEndianBytesToInt<uint32_t>(buf.substr(0, 4)));
+    auto offset = utils::LEndianBytesToInt<uint64_t>(buf.substr(4, 8));
+    auto name_size = utils::LEndianBytesToInt<uint32_t>(buf.substr(12, 4));
+    buf.remove_prefix(kIndexRecordHeaderSize);
+    if (buf.size() < name_size) {
+      return error::InvalidArgument("Truncated DWARF index file $0", index_path.string());
+    }
+    die_map[tag][std::string(buf.substr(0, name_size))] = offset;
+    buf.remove_prefix(name_size);
+  }
+
+  die_map_ = std::move(die_map);
+  return Status::OK();
+}
+
+Status DwarfReader::SaveIndex(const std::filesystem::path& index_path) const {
+  std::string contents(kIndexFileMagic);
+  for (const auto& [tag, die_type_map] : die_map_) {
+    for (const auto& [name, offset] : die_type_map) {
+      AppendLEndianInt<uint32_t>(tag, &contents);
+      AppendLEndianInt<uint64_t>(offset, &contents);
+      AppendLEndianInt<uint32_t>(name.size(), &contents);
+      contents.append(name);
+    }
+  }
+
+  std::error_code ec;
+  std::filesystem::create_directories(index_path.parent_path(), ec);
+  if (ec) {
+    return error::Internal("Failed to create directory $0: $1", index_path.parent_path().string(),
+                           ec.message());
+  }
+
+  // Writes to a temporary file first, so concurrent readers of the same binary never observe a
+  // partially written index.
+  std::filesystem::path tmp_path =
+      absl::StrCat(index_path.string(), ".", getpid(), ".",
+                   std::hash<std::thread::id>{}(std::this_thread::get_id()), ".tmp");
+  PL_RETURN_IF_ERROR(WriteFileFromString(tmp_path, contents,
+                                         std::ios_base::out | std::ios_base::binary));
+  std::filesystem::rename(tmp_path, index_path, ec);
+  if (ec) {
+    std::filesystem::remove(tmp_path, ec);
+    return error::Internal("Failed to write $0", index_path.string());
+  }
+  return Status::OK();
+}
+
 StatusOr<std::vector<DWARFDie>> DwarfReader::GetMatchingDIEs(
     std::string_view name, std::optional<llvm::dwarf::Tag> type_opt) {
   DCHECK(dwarf_context_ != nullptr);
@@ -646,11 +790,11 @@ void DwarfReader::InsertToDIEMap(std::string name, llvm::dwarf::Tag tag, llvm::D
   if (die_type_map.find(name) != die_type_map.end()) {
     return;
   }
-  die_type_map[name] = die;
+  die_type_map[name] = die.getOffset();
 }
 
 std::optional<llvm::DWARFDie> DwarfReader::FindInDIEMap(const std::string& name,
-                                                        llvm::dwarf::Tag tag) const {
+                                                        llvm::dwarf::Tag tag) {
   auto iter = die_map_.find(tag);
   if (iter == die_map_.end()) {
     return std::nullopt;
@@ -660,7 +804,13 @@ std::optional<llvm::DWARFDie> DwarfReader::FindInDIEMap(const std::string& name,
   if (die_iter == die_type_map.end()) {
     return std::nullopt;
   }
-  return die_iter->second;
+  // Only the unit that contains the DIE is parsed here, if it has not been already.
+  DWARFDie die = dwarf_context_->getDIEForOffset(die_iter->second);
+  if (!die.isValid() || die.getTag() != tag) {
+    // Possible with a stale cached index.
+    return std::nullopt;
+  }
+  return die;
 }
 
 StatusOr<TypeInfo> DwarfReader::DereferencePointerType(std::string type_name) {
@@ -34,6 +34,8 @@
 #include "src/common/base/base.h"
 #include "src/stirling/obj_tools/abi_model.h"
 
+DECLARE_string(stirling_dwarf_index_cache_dir);
+
 namespace px {
 namespace stirling {
 namespace obj_tools {
@@ -150,6 +152,8 @@ class DwarfReader {
    * Creates a DwarfReader that provides access to DWARF Debugging information entries (DIEs).
    * @param obj_filename The object file from which to read DWARF information.
    * @param index If true, creates an index to speed up accesses when called more than once.
+   *              If --stirling_dwarf_index_cache_dir is set, the index is saved there, and later
+   *              DwarfReaders of a binary with the same build ID load it instead of re-indexing.
    * @return error if file does not exist or is not a valid object file. Otherwise returns
    * a unique pointer to a DwarfReader.
    */
@@ -300,6 +304,11 @@ class DwarfReader {
   // When making multiple DwarfReader calls, this speeds up the process at the cost of some memory.
   void IndexDIEs();
 
+  // Loads the index from, or saves it to, a file written by SaveIndex().
+  // The DIEs are only parsed when looked up, so loading the index does not touch the DWARF data.
+  Status LoadIndex(const std::filesystem::path& index_path);
+  Status SaveIndex(const std::filesystem::path& index_path) const;
+
   // Walks the struct_die for all members, recursively visiting any members which are also structs,
   // to capture information of all base type members of the struct in a flattened form.
   // See GetStructSpec() for the public interface, and the output format.
@@ -307,7 +316,7 @@ class DwarfReader {
                              const std::string& path_prefix, int offset);
 
   void InsertToDIEMap(std::string name, llvm::dwarf::Tag tag, llvm::DWARFDie die);
-  std::optional<llvm::DWARFDie> FindInDIEMap(const std::string& name, llvm::dwarf::Tag tag) const;
+  std::optional<llvm::DWARFDie> FindInDIEMap(const std::string& name, llvm::dwarf::Tag tag);
 
   // Records the source language of the DWARF information.
   llvm::dwarf::SourceLanguage source_language_;
@@ -316,8 +325,9 @@ class DwarfReader {
   std::unique_ptr<llvm::MemoryBuffer> memory_buffer_;
   std::unique_ptr<llvm::DWARFContext> dwarf_context_;
 
-  // Nested map: [tag][symbol_name] -> DWARFDie
-  absl::flat_hash_map<llvm::dwarf::Tag, absl::flat_hash_map<std::string, llvm::DWARFDie>> die_map_;
+  // Nested map: [tag][symbol_name] -> DIE offset in .debug_info.
+  // Offsets instead of DWARFDie objects, so a loaded index does not require parsing all units.
+  absl::flat_hash_map<llvm::dwarf::Tag, absl::flat_hash_map<std::string, uint64_t>> die_map_;
 };
 
 }  // namespace obj_tools
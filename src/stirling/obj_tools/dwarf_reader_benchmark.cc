@@ -19,6 +19,7 @@
 #include <benchmark/benchmark.h>
 
 #include "src/common/base/base.h"
+#include "src/common/testing/temp_dir.h"
 #include "src/common/testing/test_environment.h"
 #include "src/stirling/obj_tools/dwarf_reader.h"
 
@@ -104,5 +105,31 @@ static void BM_indexed(benchmark::State& state) {
   }
 }
 
+// Same as BM_indexed, but with the index loaded from the cache written by a previous DwarfReader.
+// NOLINTNEXTLINE : runtime/references.
+static void BM_indexed_cached(benchmark::State& state) {
+  size_t num_lookup_iterations = state.range(0);
+
+  px::testing::TempDir cache_dir;
+  FLAGS_stirling_dwarf_index_cache_dir = cache_dir.path().string();
+
+  // Populates the cache.
+  PL_CHECK_OK(DwarfReader::Create(kBinary));
+
+  for (auto _ : state) {
+    SymAddrs symaddrs;
+
+    PL_ASSIGN_OR_EXIT(std::unique_ptr<DwarfReader> dwarf_reader, DwarfReader::Create(kBinary));
+
+    for (size_t i = 0; i < num_lookup_iterations; ++i) {
+      GetSymAddrs(dwarf_reader.get(), &symaddrs);
+      benchmark::DoNotOptimize(symaddrs);
+    }
+  }
+
+  FLAGS_stirling_dwarf_index_cache_dir = "";
+}
+
 BENCHMARK(BM_noindex)->RangeMultiplier(2)->Range(1, 16);
 BENCHMARK(BM_indexed)->RangeMultiplier(2)->Range(1, 16);
+BENCHMARK(BM_indexed_cached)->RangeMultiplier(2)->Range(1, 16);
@@ -18,11 +18,15 @@
 
 #include "src/stirling/obj_tools/dwarf_reader.h"
 
+#include <absl/strings/escaping.h>
+
 #include "src/common/testing/test_environment.h"
 #include "src/common/testing/testing.h"
 
 constexpr std::string_view kTestGo1_16Binary =
     "src/stirling/obj_tools/testdata/go/test_go_1_16_binary";
+constexpr std::string_view kTestGo1_16BuildID =
+    "dFcePuw7dDYwj11OZzmq/UKfX80Tu_Wn5QhKg7-ml/yVQY8EJXhjK7ugZZAeyM/POf6a2Kz2v2rf5f7LoyR";
 constexpr std::string_view kTestGo1_17Binary =
     "src/stirling/obj_tools/testdata/go/test_go_1_17_binary";
 constexpr std::string_view kGoGRPCServer =
@@ -97,6 +101,30 @@ TEST_F(DwarfReaderTest, SourceLanguage) {
   }
 }
 
+// Tests that a DwarfReader loading the index saved by a previous DwarfReader of the same binary
+// finds the same DIEs.
+TEST_F(DwarfReaderTest, CachedIndex) {
+  px::testing::TempDir cache_dir;
+  FLAGS_stirling_dwarf_index_cache_dir = cache_dir.path().string();
+
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_OK_AND_ASSIGN(std::unique_ptr<DwarfReader> dwarf_reader,
+                         DwarfReader::Create(kGo1_16BinaryPath));
+    EXPECT_OK_AND_EQ(dwarf_reader->GetStructMemberOffset("main.Vertex", "Y"), 8);
+    EXPECT_OK_AND_EQ(dwarf_reader->GetStructByteSize("main.Vertex"), 16);
+    EXPECT_OK_AND_THAT(
+        dwarf_reader->GetMatchingDIEs("non-existent-name", llvm::dwarf::DW_TAG_structure_type),
+        IsEmpty());
+  }
+
+  // The index is keyed by the binary's Go build ID, since it has no GNU build-id.
+  EXPECT_TRUE(std::filesystem::exists(
+      cache_dir.path() /
+      absl::StrCat(absl::BytesToHexString(kTestGo1_16BuildID), ".dwarf_index")));
+
+  FLAGS_stirling_dwarf_index_cache_dir = "";
+}
+
 // Tests that GetMatchingDIEs() returns empty vector when nothing is found.
 TEST_P(DwarfReaderTest, GetMatchingDIEsReturnsEmptyVector) {
   DwarfReaderTestParam p = GetParam();
@@ -46,6 +46,33 @@ struct LowercaseHex {
 };
 }  // namespace
 
+std::string_view ElfNoteDesc(std::string_view note_section) {
+  // Structure of a note:
+  //    namesz :   32-bit, size of "name" field
+  //    descsz :   32-bit, size of "desc" field
+  //    type   :   32-bit, vendor specific "type"
+  //    name   :   "namesz" bytes, null-terminated string, padded to 4 bytes
+  //    desc   :   "descsz" bytes, binary data
+  constexpr size_t kHeaderSize = 3 * sizeof(uint32_t);
+  if (note_section.size() < kHeaderSize) {
+    return {};
+  }
+  // The sizes come from the binary, so they are read unsigned and checked in 64 bits, where they
+  // can't overflow.
+  uint64_t name_size = utils::LEndianBytesToInt<uint32_t>(note_section.substr(0, sizeof(uint32_t)));
+  uint64_t desc_size =
+      utils::LEndianBytesToInt<uint32_t>(note_section.substr(sizeof(uint32_t), sizeof(uint32_t)));
+  uint64_t desc_pos = kHeaderSize + ((name_size + 3) & ~uint64_t{3});
+  if (desc_pos + desc_size > note_section.size()) {
+    return {};
+  }
+  return note_section.substr(desc_pos, desc_size);
+}
+
+bool IsGoBuildIDValid(std::string_view go_build_id) {
+  return go_build_id.find('/') != std::string_view::npos;
+}
+
 Status ElfReader::LocateDebugSymbols(const std::filesystem::path& debug_file_dir) {
   std::string build_id;
   std::string debug_link;
@@ -66,24 +93,21 @@ Status ElfReader::LocateDebugSymbols(const std::filesystem::path& debug_file_dir
 
     // Method 1: build-id.
     if (psec->get_name() == ".note.gnu.build-id") {
-      // Structure of this section:
-      //    namesz :   32-bit, size of "name" field
-      //    descsz :   32-bit, size of "desc" field
-      //    type   :   32-bit, vendor specific "type"
-      //    name   :   "namesz" bytes, null-terminated string
-      //    desc   :   "descsz" bytes, binary data
-      int32_t name_size =
-          utils::LEndianBytesToInt<int32_t>(std::string_view(psec->get_data(), sizeof(int32_t)));
-      int32_t desc_size = utils::LEndianBytesToInt<int32_t>(
-          std::string_view(psec->get_data() + sizeof(int32_t), sizeof(int32_t)));
-
-      int32_t desc_pos = 3 * sizeof(int32_t) + name_size;
-      std::string_view desc = std::string_view(psec->get_data() + desc_pos, desc_size);
-
+      std::string_view desc = ElfNoteDesc(std::string_view(psec->get_data(), psec->get_size()));
       build_id = BytesToString<LowercaseHex>(desc);
       VLOG(1) << absl::Substitute("Found build-id: $0", build_id);
     }
 
+    // Go binaries usually have no GNU build-id, but the Go toolchain records its own build ID.
+    // It is only used to identify the binary, not to locate debug symbols.
+    if (psec->get_name() == ".note.go.buildid") {
+      std::string_view desc = ElfNoteDesc(std::string_view(psec->get_data(), psec->get_size()));
+      if (IsGoBuildIDValid(desc)) {
+        go_build_id_ = std::string(desc);
+        VLOG(1) << absl::Substitute("Found Go build ID: $0", go_build_id_);
+      }
+    }
+
     // Method 2: .gnu_debuglink.
     if (psec->get_name() == ".gnu_debuglink") {
       constexpr int kCRCBytes = 4;
@@ -103,6 +127,8 @@ Status ElfReader::LocateDebugSymbols(const std::filesystem::path& debug_file_dir
   //  (2) /usr/bin/.debug/ls.debug
   //  (2) /usr/lib/debug/usr/bin/ls.debug.
 
+  build_id_ = build_id;
+
   if (found_symtab) {
     debug_symbols_path_ = binary_path_;
     return Status::OK();
@@ -21,6 +21,7 @@
 #include <filesystem>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include <absl/container/btree_map.h>
@@ -48,6 +49,19 @@ enum class SymbolMatchType {
   kSubstr
 };
 
+/**
+ * Returns the descriptor of the first note in the contents of an ELF note section (e.g.
+ * .note.gnu.build-id), or an empty string_view if the note is malformed.
+ */
+std::string_view ElfNoteDesc(std::string_view note_section);
+
+/**
+ * Returns true if the Go build ID identifies the contents of the binary. The Go linker writes
+ * "<action ID>/<content ID>", but reproducible builds (e.g. Bazel's) may write a placeholder such
+ * as "redacted" instead.
+ */
+bool IsGoBuildIDValid(std::string_view go_build_id);
+
 class ElfReader {
  public:
   /**
@@ -63,6 +77,13 @@ class ElfReader {
 
   std::filesystem::path& debug_symbols_path() { return debug_symbols_path_; }
 
+  /**
+   * Returns an ID that identifies the contents of the binary: the GNU build-id if present,
+   * otherwise the Go build ID. Returns an empty string if the binary has neither, or if its Go
+   * build ID is a placeholder.
+   */
+  std::string_view build_id() const { return !build_id_.empty() ? build_id_ : go_build_id_; }
+
   struct SymbolInfo {
     std::string name;
     int type = -1;
@@ -187,6 +208,10 @@ class ElfReader {
 
   std::filesystem::path debug_symbols_path_;
 
+  // The GNU build-id as a hex string, and the raw Go build ID string, if present.
+  std::string build_id_;
+  std::string go_build_id_;
+
   // Set up an elf reader, so we can extract debug symbols.
   ELFIO::elfio elf_reader_;
 };
@@ -193,6 +193,7 @@ TEST(ElfReaderTest, ExternalDebugSymbolsBuildID) {
 
   EXPECT_OK_AND_THAT(elf_reader->ListFuncSymbols("CanYouFindThis", SymbolMatchType::kExact),
                      ElementsAre(SymbolNameIs("CanYouFindThis")));
+  EXPECT_EQ(elf_reader->build_id(), "7deb0e3f89deba61");
 }
 
 TEST(ElfReaderTest, ExternalDebugSymbolsDebugLink) {
@@ -251,6 +252,28 @@ TEST(ElfReaderTest, GolangAppRuntimeBuildVersion) {
   EXPECT_EQ(symbol.type, ELFIO::STT_OBJECT);
 }
 
+TEST(ElfReaderTest, GoBuildID) {
+  // The precompiled Go binaries have no GNU build-id, so the Go build ID is used.
+  const std::string kPath =
+      px::testing::TestFilePath("src/stirling/obj_tools/testdata/go/test_go_1_16_binary");
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<ElfReader> elf_reader, ElfReader::Create(kPath));
+  EXPECT_EQ(elf_reader->build_id(),
+            "dFcePuw7dDYwj11OZzmq/UKfX80Tu_Wn5QhKg7-ml/yVQY8EJXhjK7ugZZAeyM/POf6a2Kz2v2rf5f7LoyR");
+}
+
+TEST(ElfReaderTest, ElfNoteDesc) {
+  // namesz=4, descsz=3, type=3, name="GNU\0", desc="abc" and padding.
+  const std::string kNote("\x04\0\0\0\x03\0\0\0\x03\0\0\0GNU\0abc\0", 20);
+  EXPECT_EQ(ElfNoteDesc(kNote), "abc");
+  // The name is padded to 4 bytes: namesz=2, name="Go\0\0".
+  EXPECT_EQ(ElfNoteDesc(std::string("\x02\0\0\0\x01\0\0\0\x04\0\0\0Go\0\0x", 17)), "x");
+
+  // Truncated header, or a desc that runs past the end of the section.
+  EXPECT_EQ(ElfNoteDesc(kNote.substr(0, 8)), "");
+  EXPECT_EQ(ElfNoteDesc(kNote.substr(0, 18)), "");
+  EXPECT_EQ(ElfNoteDesc(std::string("\xff\xff\xff\xff\x03\0\0\0\x03\0\0\0GNU\0abc", 19)), "");
+}
+
 // Tests that the versioned symbol names always include version strings.
 TEST(ElfReaderTest, VersionedSymbolsInDynamicLibrary) {
   const std::string kPath =
@@ -65,21 +65,23 @@ void JVMStatsConnector::FindJavaUPIDs(const ConnectorContext& ctx) {
   }
 }
 
-Status JVMStatsConnector::ExportStats(const md::UPID& upid,
-                                      const std::filesystem::path& hsperf_data_path,
+Status JVMStatsConnector::ExportStats(const md::UPID& upid, JavaProcInfo* java_proc,
                                       DataTable* data_table) const {
-  PL_ASSIGN_OR_RETURN(std::string hsperf_data_str, ReadFileToString(hsperf_data_path));
-
-  if (hsperf_data_str.empty()) {
-    // Assume this is a transient failure.
-    return Status::OK();
+  if (java_proc->hsperf_data_reader == nullptr) {
+    auto reader_or = java::HsperfdataReader::Create(java_proc->hsperf_data_path);
+    if (error::IsResourceUnavailable(reader_or.status())) {
+      // The file is empty, assume this is a transient failure.
+      return Status::OK();
+    }
+    PL_ASSIGN_OR_RETURN(java_proc->hsperf_data_reader, std::move(reader_or));
   }
 
-  java::Stats stats(std::move(hsperf_data_str));
-  if (!stats.Parse().ok()) {
+  auto stats_or = java_proc->hsperf_data_reader->ReadStats();
+  if (!stats_or.ok()) {
     // Assumes this is a transient failure.
     return Status::OK();
   }
+  const java::Stats& stats = stats_or.ValueOrDie();
 
   uint64_t time = CurrentTimeNS();
 
@@ -106,12 +108,18 @@ void JVMStatsConnector::TransferDataImpl(ConnectorContext* ctx,
 
   FindJavaUPIDs(*ctx);
 
+  // The hsperfdata file is deleted when the JVM exits, but its mapping stays readable. So the exit
+  // of the process has to be detected through the tracked UPIDs, instead of export failures.
+  for (const auto& upid : proc_tracker_.deleted_upids()) {
+    java_procs_.erase(upid);
+  }
+
   for (auto iter = java_procs_.begin(); iter != java_procs_.end();) {
     const md::UPID& upid = iter->first;
     JavaProcInfo& java_proc = iter->second;
 
     md::UPID upid_with_asid(ctx->GetASID(), upid.pid(), upid.start_ts());
-    auto status = ExportStats(upid_with_asid, java_proc.hsperf_data_path, data_table);
+    auto status = ExportStats(upid_with_asid, &java_proc, data_table);
     if (!status.ok()) {
       ++java_proc.export_failure_count;
     }
@@ -18,14 +18,21 @@
 
 #include "src/stirling/source_connectors/jvm_stats/utils/java.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <absl/strings/match.h>
 
+#include <cstring>
 #include <map>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "src/common/base/byte_utils.h"
+#include "src/common/base/defer.h"
 #include "src/common/base/statusor.h"
 #include "src/common/fs/fs_wrapper.h"
 #include "src/common/system/proc_parser.h"
@@ -58,34 +65,53 @@ Status Stats::Parse() {
   return Status::OK();
 }
 
-uint64_t Stats::YoungGCTimeNanos() const { return StatForSuffix("gc.collector.0.time"); }
+namespace {
+
+constexpr std::string_view kYoungGCTimeSuffix = "gc.collector.0.time";
+constexpr std::string_view kFullGCTimeSuffix = "gc.collector.1.time";
+constexpr std::string_view kUsedHeapSizeSuffixes[] = {
+    "gc.generation.0.space.0.used",
+    "gc.generation.0.space.1.used",
+    "gc.generation.0.space.2.used",
+    "gc.generation.1.space.0.used",
+};
+constexpr std::string_view kTotalHeapSizeSuffixes[] = {
+    "gc.generation.0.space.0.capacity",
+    "gc.generation.0.space.1.capacity",
+    "gc.generation.0.space.2.capacity",
+    "gc.generation.1.space.0.capacity",
+};
+constexpr std::string_view kMaxHeapSizeSuffixes[] = {
+    "gc.generation.0.maxCapacity",
+    "gc.generation.1.maxCapacity",
+};
+
+// Returns true if the stat is used to compute any of the values exported by Stats.
+bool IsWantedStat(std::string_view name) {
+  auto ends_with_any = [name](absl::Span<const std::string_view> suffixes) {
+    for (const auto& suffix : suffixes) {
+      if (absl::EndsWith(name, suffix)) {
+        return true;
+      }
+    }
+    return false;
+  };
+  return absl::EndsWith(name, kYoungGCTimeSuffix) || absl::EndsWith(name, kFullGCTimeSuffix) ||
+         ends_with_any(kUsedHeapSizeSuffixes) || ends_with_any(kTotalHeapSizeSuffixes) ||
+         ends_with_any(kMaxHeapSizeSuffixes);
+}
 
-uint64_t Stats::FullGCTimeNanos() const { return StatForSuffix("gc.collector.1.time"); }
+}  // namespace
 
-uint64_t Stats::UsedHeapSizeBytes() const {
-  return SumStatsForSuffixes({
-      "gc.generation.0.space.0.used",
-      "gc.generation.0.space.1.used",
-      "gc.generation.0.space.2.used",
-      "gc.generation.1.space.0.used",
-  });
-}
+uint64_t Stats::YoungGCTimeNanos() const { return StatForSuffix(kYoungGCTimeSuffix); }
 
-uint64_t Stats::TotalHeapSizeBytes() const {
-  return SumStatsForSuffixes({
-      "gc.generation.0.space.0.capacity",
-      "gc.generation.0.space.1.capacity",
-      "gc.generation.0.space.2.capacity",
-      "gc.generation.1.space.0.capacity",
-  });
-}
+uint64_t Stats::FullGCTimeNanos() const { return StatForSuffix(kFullGCTimeSuffix); }
 
-uint64_t Stats::MaxHeapSizeBytes() const {
-  return SumStatsForSuffixes({
-      "gc.generation.0.maxCapacity",
-      "gc.generation.1.maxCapacity",
-  });
-}
+uint64_t Stats::UsedHeapSizeBytes() const { return SumStatsForSuffixes(kUsedHeapSizeSuffixes); }
+
+uint64_t Stats::TotalHeapSizeBytes() const { return SumStatsForSuffixes(kTotalHeapSizeSuffixes); }
+
+uint64_t Stats::MaxHeapSizeBytes() const { return SumStatsForSuffixes(kMaxHeapSizeSuffixes); }
 
 uint64_t Stats::StatForSuffix(std::string_view suffix) const {
   for (const auto& stat : stats_) {
@@ -96,7 +122,7 @@ uint64_t Stats::StatForSuffix(std::string_view suffix) const {
   return 0;
 }
 
-uint64_t Stats::SumStatsForSuffixes(const std::vector<std::string_view>& suffixes) const {
+uint64_t Stats::SumStatsForSuffixes(absl::Span<const std::string_view> suffixes) const {
   uint64_t sum = 0;
   for (const auto& suffix : suffixes) {
     sum += StatForSuffix(suffix);
@@ -104,6 +130,75 @@ uint64_t Stats::SumStatsForSuffixes(const std::vector<std::string_view>& suffixe
   return sum;
 }
 
+StatusOr<std::unique_ptr<HsperfdataReader>> HsperfdataReader::Create(
+    const std::filesystem::path& path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return error::Internal("Failed to open $0, error: $1", path.string(), std::strerror(errno));
+  }
+  DEFER(close(fd));
+
+  struct stat st = {};
+  if (fstat(fd, &st) != 0) {
+    return error::Internal("Failed to stat $0, error: $1", path.string(), std::strerror(errno));
+  }
+  if (st.st_size == 0) {
+    return error::ResourceUnavailable("$0 is empty", path.string());
+  }
+
+  // The JVM keeps updating the counters through its own shared mapping of the same file, so a
+  // read-only shared mapping always observes the latest values.
+  void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, /*offset*/ 0);
+  if (addr == MAP_FAILED) {
+    return error::Internal("Failed to mmap $0, error: $1", path.string(), std::strerror(errno));
+  }
+  return std::unique_ptr<HsperfdataReader>(new HsperfdataReader(addr, st.st_size));
+}
+
+HsperfdataReader::HsperfdataReader(const void* addr, size_t size)
+    : buf_(static_cast<const char*>(addr), size) {}
+
+HsperfdataReader::~HsperfdataReader() {
+  munmap(const_cast<char*>(buf_.data()), buf_.size());
+}
+
+Status HsperfdataReader::ResolveCounters() {
+  hsperf::HsperfData hsperf_data = {};
+  PL_RETURN_IF_ERROR(ParseHsperfData(buf_, &hsperf_data));
+
+  counters_.clear();
+  for (const auto& entry : hsperf_data.data_entries) {
+    if (entry.header->data_type != static_cast<uint8_t>(hsperf::DataType::kLong)) {
+      continue;
+    }
+    if (entry.data.size() < sizeof(uint64_t) || !IsWantedStat(entry.name)) {
+      continue;
+    }
+    counters_.push_back({entry.name, static_cast<size_t>(entry.data.data() - buf_.data())});
+  }
+  num_entries_ = hsperf_data.prologue->num_entries;
+  return Status::OK();
+}
+
+StatusOr<Stats> HsperfdataReader::ReadStats() {
+  // New entries are only appended while the JVM starts up, so the counters rarely need to be
+  // resolved again.
+  const auto* prologue = reinterpret_cast<const hsperf::Prologue*>(buf_.data());
+  if (buf_.size() < sizeof(hsperf::Prologue) || counters_.empty() ||
+      prologue->num_entries != num_entries_) {
+    PL_RETURN_IF_ERROR(ResolveCounters());
+  }
+
+  std::vector<Stats::Stat> stats;
+  stats.reserve(counters_.size());
+  for (const auto& counter : counters_) {
+    auto value =
+        LEndianBytesToInt<uint64_t>(buf_.substr(counter.data_offset, sizeof(uint64_t)));
+    stats.push_back({counter.name, value});
+  }
+  return Stats(std::move(stats));
+}
+
 StatusOr<std::filesystem::path> HsperfdataPath(pid_t pid) {
   const system::Config& sysconfig = system::Config::GetInstance();
   const std::filesystem::path& host_path = sysconfig.host_path();
@@ -19,11 +19,15 @@
 #pragma once
 
 #include <filesystem>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <utility>
 #include <vector>
 
+#include <absl/types/span.h>
+
+#include "src/common/base/mixins.h"
 #include "src/common/base/statusor.h"
 
 namespace px {
@@ -58,12 +62,47 @@ class Stats {
 
  private:
   uint64_t StatForSuffix(std::string_view suffix) const;
-  uint64_t SumStatsForSuffixes(const std::vector<std::string_view>& suffixes) const;
+  uint64_t SumStatsForSuffixes(absl::Span<const std::string_view> suffixes) const;
 
   std::string hsperf_data_;
   std::vector<Stat> stats_;
 };
 
+/**
+ * Reads Stats from a memory-mapped hsperfdata file.
+ *
+ * The file is mapped once, and the offsets of the counters used by Stats are resolved on the first
+ * read. Later reads only load those counters from the mapping, so the cost of each read does not
+ * depend on the size of the file. The offsets are resolved again if the JVM adds new entries.
+ */
+class HsperfdataReader : public NotCopyable {
+ public:
+  static StatusOr<std::unique_ptr<HsperfdataReader>> Create(const std::filesystem::path& path);
+
+  ~HsperfdataReader();
+
+  /**
+   * Returns the current values of the counters in the file.
+   */
+  StatusOr<Stats> ReadStats();
+
+ private:
+  HsperfdataReader(const void* addr, size_t size);
+
+  // Scans all entries of the file, and records the name and data offset of the wanted counters.
+  Status ResolveCounters();
+
+  struct Counter {
+    std::string_view name;
+    size_t data_offset;
+  };
+
+  std::string_view buf_;
+  // The number of entries in the file when the counters were last resolved.
+  uint32_t num_entries_ = 0;
+  std::vector<Counter> counters_;
+};
+
 /**
  * Returns the path of the hsperfdata for a JVM process.
  */
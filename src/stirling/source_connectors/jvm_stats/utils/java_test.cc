@@ -22,6 +22,7 @@
 #include <gtest/gtest.h>
 
 #include <filesystem>
+#include <memory>
 #include <string>
 #include <string_view>
 
@@ -59,6 +60,28 @@ TEST(StatsTest, CommonValues) {
   EXPECT_EQ(2, stats.MaxHeapSizeBytes());
 }
 
+// Tests that the mmap-based reader produces the same values as parsing the whole file.
+TEST(HsperfdataReaderTest, MatchesParsedStats) {
+  const std::string hsperfdata_path =
+      testing::TestFilePath("src/stirling/source_connectors/jvm_stats/utils/test_hsperfdata");
+  ASSERT_OK_AND_ASSIGN(std::string hsperfdata, ReadFileToString(hsperfdata_path));
+  Stats parsed_stats(std::move(hsperfdata));
+  ASSERT_OK(parsed_stats.Parse());
+
+  ASSERT_OK_AND_ASSIGN(std::unique_ptr<HsperfdataReader> reader,
+                       HsperfdataReader::Create(hsperfdata_path));
+  // Reads twice, the second read reuses the resolved counter offsets.
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_OK_AND_ASSIGN(Stats stats, reader->ReadStats());
+    EXPECT_EQ(parsed_stats.YoungGCTimeNanos(), stats.YoungGCTimeNanos());
+    EXPECT_EQ(parsed_stats.FullGCTimeNanos(), stats.FullGCTimeNanos());
+    EXPECT_EQ(parsed_stats.UsedHeapSizeBytes(), stats.UsedHeapSizeBytes());
+    EXPECT_EQ(parsed_stats.TotalHeapSizeBytes(), stats.TotalHeapSizeBytes());
+    EXPECT_EQ(parsed_stats.MaxHeapSizeBytes(), stats.MaxHeapSizeBytes());
+  }
+  EXPECT_GT(parsed_stats.MaxHeapSizeBytes(), 0);
+}
+
 TEST(HsperfdataPathTest, ResultIsAsExpected) {
   const char kClassPath[] = "src/stirling/source_connectors/jvm_stats/testing/HelloWorld.jar";
   const std::string class_path = testing::TestFilePath(kClassPath);
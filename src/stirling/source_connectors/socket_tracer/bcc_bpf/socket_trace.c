@@ -105,6 +105,16 @@ BPF_HASH(active_sendfile_args_map, uint64_t, struct sendfile_args_t);
 BPF_PERCPU_ARRAY(socket_data_event_buffer_heap, struct socket_data_event_t, 1);
 BPF_PERCPU_ARRAY(conn_stats_event_buffer_heap, struct conn_stats_event_t, 1);
 
+#ifdef ENABLE_CONN_AGGREGATION
+// Per-process, per-protocol traffic stats aggregated in-kernel.
+// Entries are read and removed by user-space.
+BPF_HASH(conn_agg_stats_map, struct conn_agg_key_t, struct conn_agg_stats_t, 16384);
+
+// A zero-valued conn_agg_stats_t used to initialize new map entries; too large for the stack.
+// Never written to.
+BPF_PERCPU_ARRAY(conn_agg_stats_zero_heap, struct conn_agg_stats_t, 1);
+#endif
+
 // This array records singular values that are used by probes. We group them together to reduce the
 // number of arrays with only 1 element.
 BPF_PERCPU_ARRAY(control_values, int64_t, kNumControlValues);
@@ -675,6 +685,64 @@ static __inline void update_conn_stats(struct pt_regs* ctx, struct conn_info_t*
   }
 }
 
+#ifdef ENABLE_CONN_AGGREGATION
+static __inline void update_conn_agg_stats(struct conn_info_t* conn_info,
+                                           enum traffic_direction_t direction,
+                                           ssize_t bytes_count) {
+  // Without a protocol and role, traffic cannot be attributed, nor requests told from responses.
+  if (conn_info->protocol == kProtocolUnknown || conn_info->role == kRoleUnknown) {
+    return;
+  }
+
+  int kZero = 0;
+  struct conn_agg_stats_t* zero = conn_agg_stats_zero_heap.lookup(&kZero);
+  if (zero == NULL) {
+    return;
+  }
+
+  struct conn_agg_key_t key;
+  __builtin_memset(&key, 0, sizeof(key));
+  key.upid = conn_info->conn_id.upid;
+  key.protocol = conn_info->protocol;
+  key.role = conn_info->role;
+
+  struct conn_agg_stats_t* stats = conn_agg_stats_map.lookup_or_init(&key, zero);
+  if (stats == NULL) {
+    return;
+  }
+
+  if (direction == kEgress) {
+    __sync_fetch_and_add(&stats->bytes_sent, bytes_count);
+  } else {
+    __sync_fetch_and_add(&stats->bytes_recv, bytes_count);
+  }
+
+  // Servers receive requests; clients send them.
+  enum traffic_direction_t req_direction = (conn_info->role == kRoleServer) ? kIngress : kEgress;
+  if (direction == req_direction) {
+    if (conn_info->agg_req_start_ns == 0) {
+      conn_info->agg_req_start_ns = bpf_ktime_get_ns();
+    }
+    return;
+  }
+
+  if (conn_info->agg_req_start_ns == 0) {
+    // Response data without an observed request, or the rest of an already-counted response.
+    return;
+  }
+
+  uint64_t latency_ns = bpf_ktime_get_ns() - conn_info->agg_req_start_ns;
+  conn_info->agg_req_start_ns = 0;
+
+  __sync_fetch_and_add(&stats->num_requests, 1);
+  __sync_fetch_and_add(&stats->latency_sum_ns, latency_ns);
+  int bucket = latency_hist_bucket(latency_ns);
+  if (bucket >= 0 && bucket < LATENCY_HIST_NUM_BUCKETS) {
+    __sync_fetch_and_add(&stats->latency_hist[bucket], 1);
+  }
+}
+#endif
+
 static __inline void process_data(const bool vecs, struct pt_regs* ctx, uint64_t id,
                                   const enum traffic_direction_t direction,
                                   const struct data_args_t* args, ssize_t bytes_count, bool ssl) {
@@ -757,6 +825,9 @@ static __inline void process_data(const bool vecs, struct pt_regs* ctx, uint64_t
   //                     if (!ssl) { ... }
   if (conn_info->ssl == ssl) {
     update_conn_stats(ctx, conn_info, direction, bytes_count);
+#ifdef ENABLE_CONN_AGGREGATION
+    update_conn_agg_stats(conn_info, direction, bytes_count);
+#endif
   }
 
   return;
@@ -68,6 +68,10 @@ struct conn_info_t {
   // Used for determining when to send updated conn_stats values.
   int64_t last_reported_bytes;
 
+  // The timestamp of the first data of the outstanding request, or 0 if there is none.
+  // Only used when in-kernel aggregation is enabled (see conn_agg_stats_t).
+  uint64_t agg_req_start_ns;
+
   // The number of bytes written by application (for uprobe) on this connection.
   int64_t app_wr_bytes;
   // The number of bytes read by application (for uprobe) on this connection.
@@ -231,6 +235,91 @@ struct conn_stats_event_t {
   uint32_t conn_events;
 };
 
+// In-kernel aggregation of per-process, per-protocol traffic stats. Only populated when the BPF
+// program is compiled with ENABLE_CONN_AGGREGATION, in which case user-space periodically reads
+// conn_agg_stats_map instead of reconstructing the same metrics from individual events.
+//
+// Request latency is approximated from the direction of traffic: a request starts on the first
+// data in the request direction, and completes on the first data in the opposite direction.
+
+// Latencies are bucketed in microseconds. The first 4 buckets hold 0-3us; beyond that, each power
+// of 2 is split into 4 linear sub-buckets. 128 buckets cover latencies up to ~2.4 hours.
+#define LATENCY_HIST_NUM_BUCKETS 128
+
+struct conn_agg_key_t {
+  struct upid_t upid;
+  enum traffic_protocol_t protocol;
+  enum endpoint_role_t role;
+
+#ifdef __cplusplus
+  friend inline bool operator==(const conn_agg_key_t& lhs, const conn_agg_key_t& rhs) {
+    return lhs.upid == rhs.upid && lhs.protocol == rhs.protocol && lhs.role == rhs.role;
+  }
+
+  template <typename H>
+  friend H AbslHashValue(H h, const conn_agg_key_t& key) {
+    return H::combine(std::move(h), key.upid, key.protocol, key.role);
+  }
+#endif
+};
+
+struct conn_agg_stats_t {
+  uint64_t bytes_sent;
+  uint64_t bytes_recv;
+  uint64_t num_requests;
+  uint64_t latency_sum_ns;
+  uint64_t latency_hist[LATENCY_HIST_NUM_BUCKETS];
+};
+
+// Returns floor(log2(v)), or 0 if v is 0.
+// Written without loops or builtins, so it compiles to plain BPF instructions.
+static __inline int px_log2(uint64_t v) {
+  int r = 0;
+  if (v >> 32) {
+    v >>= 32;
+    r += 32;
+  }
+  if (v >> 16) {
+    v >>= 16;
+    r += 16;
+  }
+  if (v >> 8) {
+    v >>= 8;
+    r += 8;
+  }
+  if (v >> 4) {
+    v >>= 4;
+    r += 4;
+  }
+  if (v >> 2) {
+    v >>= 2;
+    r += 2;
+  }
+  if (v >> 1) {
+    r += 1;
+  }
+  return r;
+}
+
+static __inline int latency_hist_bucket(uint64_t latency_ns) {
+  uint64_t latency_us = latency_ns / 1000;
+  if (latency_us < 4) {
+    return latency_us;
+  }
+  int log2 = px_log2(latency_us);
+  int bucket = 4 * (log2 - 1) + ((latency_us >> (log2 - 2)) & 3);
+  return bucket < LATENCY_HIST_NUM_BUCKETS ? bucket : LATENCY_HIST_NUM_BUCKETS - 1;
+}
+
+// The smallest latency (in nanoseconds) that falls into the given bucket.
+static __inline uint64_t latency_hist_bucket_lower_bound_ns(int bucket) {
+  if (bucket < 4) {
+    return bucket * 1000ULL;
+  }
+  int log2 = bucket / 4 + 1;
+  return ((1ULL << log2) + (bucket % 4) * (1ULL << (log2 - 2))) * 1000ULL;
+}
+
 enum control_event_type_t {
   kConnOpen,
   kConnClose,
@@ -33,3 +33,21 @@ TEST(SocketDataEventTTest, VerifyAlignment) {
   EXPECT_EQ(0, offsetof(socket_data_event_t, attr));
   EXPECT_EQ(sizeof(event.attr), offsetof(socket_data_event_t, msg));
 }
+
+TEST(LatencyHistTest, BucketBoundaries) {
+  EXPECT_EQ(latency_hist_bucket(0), 0);
+  EXPECT_EQ(latency_hist_bucket(999), 0);
+  EXPECT_EQ(latency_hist_bucket(3'999), 3);
+  EXPECT_EQ(latency_hist_bucket(4'000), 4);
+  EXPECT_EQ(latency_hist_bucket(7'999), 7);
+  EXPECT_EQ(latency_hist_bucket(8'000), 8);
+  EXPECT_EQ(latency_hist_bucket(10'000), 9);
+  EXPECT_EQ(latency_hist_bucket(UINT64_MAX), LATENCY_HIST_NUM_BUCKETS - 1);
+
+  for (int i = 0; i < LATENCY_HIST_NUM_BUCKETS; ++i) {
+    EXPECT_EQ(latency_hist_bucket(latency_hist_bucket_lower_bound_ns(i)), i);
+    if (i > 0) {
+      EXPECT_EQ(latency_hist_bucket(latency_hist_bucket_lower_bound_ns(i) - 1), i - 1);
+    }
+  }
+}
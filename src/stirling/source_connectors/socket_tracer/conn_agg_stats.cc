@@ -0,0 +1,93 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/stirling/source_connectors/socket_tracer/conn_agg_stats.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace px {
+namespace stirling {
+
+std::vector<ConnAggStats::Record> ConnAggStats::Update(
+    const std::vector<std::pair<conn_agg_key_t, conn_agg_stats_t>>& snapshot) {
+  std::vector<Record> records;
+
+  for (const auto& [key, stats] : snapshot) {
+    conn_agg_stats_t& prev = prev_stats_[key];
+    if (stats.bytes_sent == prev.bytes_sent && stats.bytes_recv == prev.bytes_recv &&
+        stats.num_requests == prev.num_requests) {
+      continue;
+    }
+
+    // The BPF map is read without synchronization, so a bucket may momentarily lag behind
+    // num_requests; the deltas are clamped rather than trusted to be consistent.
+    uint64_t hist_delta[LATENCY_HIST_NUM_BUCKETS];
+    for (int i = 0; i < LATENCY_HIST_NUM_BUCKETS; ++i) {
+      hist_delta[i] = stats.latency_hist[i] - std::min(stats.latency_hist[i], prev.latency_hist[i]);
+    }
+
+    Record record;
+    record.key = key;
+    record.bytes_sent = stats.bytes_sent;
+    record.bytes_recv = stats.bytes_recv;
+    record.num_requests = stats.num_requests;
+    record.latency_p50_ns = LatencyQuantileNS(hist_delta, 0.5);
+    record.latency_p90_ns = LatencyQuantileNS(hist_delta, 0.9);
+    record.latency_p99_ns = LatencyQuantileNS(hist_delta, 0.99);
+    records.push_back(record);
+
+    prev = stats;
+  }
+
+  return records;
+}
+
+uint64_t ConnAggStats::LatencyQuantileNS(absl::Span<const uint64_t> hist, double q) {
+  uint64_t total = 0;
+  for (uint64_t count : hist) {
+    total += count;
+  }
+  if (total == 0) {
+    return 0;
+  }
+
+  // The 1-based rank of the requested sample.
+  const double rank = std::max(1.0, std::ceil(q * total));
+
+  uint64_t cumulative = 0;
+  for (size_t i = 0; i < hist.size(); ++i) {
+    if (hist[i] == 0 || cumulative + hist[i] < rank) {
+      cumulative += hist[i];
+      continue;
+    }
+    const uint64_t lower = latency_hist_bucket_lower_bound_ns(i);
+    if (i + 1 == hist.size()) {
+      // The last bucket is open-ended.
+      return lower;
+    }
+    const uint64_t upper = latency_hist_bucket_lower_bound_ns(i + 1);
+    const double fraction = (rank - cumulative) / hist[i];
+    return lower + static_cast<uint64_t>(fraction * (upper - lower));
+  }
+
+  return latency_hist_bucket_lower_bound_ns(hist.size() - 1);
+}
+
+}  // namespace stirling
+}  // namespace px
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/types/span.h>
+
+#include "src/stirling/source_connectors/socket_tracer/bcc_bpf_intf/socket_trace.hpp"
+
+namespace px {
+namespace stirling {
+
+/**
+ * Turns periodic snapshots of the in-kernel conn_agg_stats_map into per-interval records.
+ * Counters are passed through as-is; latency quantiles are computed over the histogram counts
+ * accumulated since the previous snapshot.
+ */
+class ConnAggStats {
+ public:
+  struct Record {
+    conn_agg_key_t key;
+    uint64_t bytes_sent = 0;
+    uint64_t bytes_recv = 0;
+    uint64_t num_requests = 0;
+    uint64_t latency_p50_ns = 0;
+    uint64_t latency_p90_ns = 0;
+    uint64_t latency_p99_ns = 0;
+  };
+
+  /**
+   * Consumes a snapshot of the BPF map, and returns records for the keys that saw traffic since
+   * the previous snapshot.
+   */
+  std::vector<Record> Update(
+      const std::vector<std::pair<conn_agg_key_t, conn_agg_stats_t>>& snapshot);
+
+  /**
+   * Drops the state of a key whose BPF map entry has been removed.
+   */
+  void Erase(const conn_agg_key_t& key) { prev_stats_.erase(key); }
+
+  /**
+   * Returns the q-th quantile (0 <= q <= 1) of a latency histogram, in nanoseconds,
+   * interpolating linearly within the bucket. Returns 0 for an empty histogram.
+   */
+  static uint64_t LatencyQuantileNS(absl::Span<const uint64_t> hist, double q);
+
+ private:
+  absl::flat_hash_map<conn_agg_key_t, conn_agg_stats_t> prev_stats_;
+};
+
+}  // namespace stirling
+}  // namespace px
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "src/stirling/core/types.h"
+#include "src/stirling/source_connectors/socket_tracer/canonical_types.h"
+
+namespace px {
+namespace stirling {
+
+// clang-format off
+constexpr DataElement kConnAggStatsElements[] = {
+        canonical_data_elements::kTime,
+        canonical_data_elements::kUPID,
+        canonical_data_elements::kTraceRole,
+        {"protocol", "The protocol of the traffic.",
+         types::DataType::INT64, types::SemanticType::ST_NONE, types::PatternType::GENERAL_ENUM,
+         &kTrafficProtocolDecoder},
+        {"bytes_sent", "The number of bytes sent since the beginning of tracing.",
+         types::DataType::INT64, types::SemanticType::ST_BYTES, types::PatternType::METRIC_COUNTER},
+        {"bytes_recv", "The number of bytes received since the beginning of tracing.",
+         types::DataType::INT64, types::SemanticType::ST_BYTES, types::PatternType::METRIC_COUNTER},
+        {"num_requests", "The number of requests completed since the beginning of tracing.",
+         types::DataType::INT64, types::SemanticType::ST_NONE, types::PatternType::METRIC_COUNTER},
+        {"latency_p50", "The median request latency since the previous record.",
+         types::DataType::INT64, types::SemanticType::ST_DURATION_NS,
+         types::PatternType::METRIC_GAUGE},
+        {"latency_p90", "The 90th percentile request latency since the previous record.",
+         types::DataType::INT64, types::SemanticType::ST_DURATION_NS,
+         types::PatternType::METRIC_GAUGE},
+        {"latency_p99", "The 99th percentile request latency since the previous record.",
+         types::DataType::INT64, types::SemanticType::ST_DURATION_NS,
+         types::PatternType::METRIC_GAUGE},
+};
+// clang-format on
+
+constexpr DataTableSchema kConnAggStatsTable(
+    "conn_agg_stats",
+    "Per-process, per-protocol traffic and request latency stats aggregated inside the kernel. "
+    "Only populated when --stirling_enable_conn_aggregation is set. Latencies are approximated "
+    "by the time from the first request data to the first response data.",
+    kConnAggStatsElements);
+DEFINE_PRINT_TABLE(ConnAggStats)
+
+namespace conn_agg_stats_idx {
+
+constexpr int kTime = kConnAggStatsTable.ColIndex("time_");
+constexpr int kUPID = kConnAggStatsTable.ColIndex("upid");
+constexpr int kRole = kConnAggStatsTable.ColIndex("trace_role");
+constexpr int kProtocol = kConnAggStatsTable.ColIndex("protocol");
+constexpr int kBytesSent = kConnAggStatsTable.ColIndex("bytes_sent");
+constexpr int kBytesRecv = kConnAggStatsTable.ColIndex("bytes_recv");
+constexpr int kNumRequests = kConnAggStatsTable.ColIndex("num_requests");
+constexpr int kLatencyP50 = kConnAggStatsTable.ColIndex("latency_p50");
+constexpr int kLatencyP90 = kConnAggStatsTable.ColIndex("latency_p90");
+constexpr int kLatencyP99 = kConnAggStatsTable.ColIndex("latency_p99");
+
+}  // namespace conn_agg_stats_idx
+
+}  // namespace stirling
+}  // namespace px
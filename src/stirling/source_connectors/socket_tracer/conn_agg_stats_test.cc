@@ -0,0 +1,81 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/stirling/source_connectors/socket_tracer/conn_agg_stats.h"
+
+#include <vector>
+
+#include "src/common/testing/testing.h"
+
+namespace px {
+namespace stirling {
+
+using ::testing::IsEmpty;
+using ::testing::SizeIs;
+
+TEST(ConnAggStatsTest, LatencyQuantile) {
+  std::vector<uint64_t> hist(LATENCY_HIST_NUM_BUCKETS, 0);
+  EXPECT_EQ(ConnAggStats::LatencyQuantileNS(hist, 0.5), 0);
+
+  // 90 samples in [0us, 1us), 10 samples in [8us, 10us).
+  hist[0] = 90;
+  hist[8] = 10;
+  EXPECT_LT(ConnAggStats::LatencyQuantileNS(hist, 0.5), 1'000);
+  EXPECT_LE(ConnAggStats::LatencyQuantileNS(hist, 0.9), 1'000);
+  EXPECT_GE(ConnAggStats::LatencyQuantileNS(hist, 0.99), 8'000);
+  EXPECT_LE(ConnAggStats::LatencyQuantileNS(hist, 0.99), 10'000);
+  EXPECT_EQ(ConnAggStats::LatencyQuantileNS(hist, 1.0), 10'000);
+}
+
+TEST(ConnAggStatsTest, ReportsIntervalQuantiles) {
+  conn_agg_key_t key = {};
+  key.upid.pid = 123;
+  key.upid.start_time_ticks = 456;
+  key.protocol = kProtocolHTTP;
+  key.role = kRoleServer;
+
+  conn_agg_stats_t stats = {};
+  stats.bytes_sent = 100;
+  stats.bytes_recv = 50;
+  stats.num_requests = 10;
+  stats.latency_hist[latency_hist_bucket(100'000)] = 10;
+
+  ConnAggStats agg_stats;
+
+  std::vector<ConnAggStats::Record> records = agg_stats.Update({{key, stats}});
+  ASSERT_THAT(records, SizeIs(1));
+  EXPECT_EQ(records[0].key, key);
+  EXPECT_EQ(records[0].num_requests, 10);
+  EXPECT_GE(records[0].latency_p50_ns, 96'000);
+  EXPECT_LE(records[0].latency_p50_ns, 112'000);
+
+  // No new traffic, no record.
+  EXPECT_THAT(agg_stats.Update({{key, stats}}), IsEmpty());
+
+  // Only the new, slower requests contribute to the quantiles.
+  stats.num_requests = 20;
+  stats.latency_hist[latency_hist_bucket(1'000'000)] = 10;
+  records = agg_stats.Update({{key, stats}});
+  ASSERT_THAT(records, SizeIs(1));
+  EXPECT_EQ(records[0].num_requests, 20);
+  EXPECT_GE(records[0].latency_p50_ns, 896'000);
+  EXPECT_LE(records[0].latency_p50_ns, 1'024'000);
+}
+
+}  // namespace stirling
+}  // namespace px
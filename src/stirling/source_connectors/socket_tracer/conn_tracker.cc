@@ -55,6 +55,11 @@ DEFINE_int64(
     stirling_check_proc_for_conn_close, true,
     "If enabled, Stirling will check Linux /proc on idle connections to see if they are closed.");
 
+DEFINE_uint32(stirling_conn_parse_budget_ms_per_sec, 0,
+              "If non-zero, a connection whose parsing and stitching takes more than this many "
+              "milliseconds of CPU time per second is disabled, so that only its connection stats "
+              "are traced. 0 means no limit.");
+
 DECLARE_int32(test_only_socket_trace_target_pid);
 
 namespace px {
@@ -352,11 +357,22 @@ std::vector<protocols::http2::Record>
 ConnTracker::ProcessToRecords<protocols::http2::ProtocolTraits>() {
   protocols::RecordsWithErrorCount<protocols::http2::Record> result;
 
+  auto stitch_start = std::chrono::steady_clock::now();
+
   protocols::http2::ProcessHTTP2Streams(&http2_client_streams_, IsZombie(), &result);
   protocols::http2::ProcessHTTP2Streams(&http2_server_streams_, IsZombie(), &result);
 
+  auto stitch_end = std::chrono::steady_clock::now();
+
   UpdateResultStats(result);
 
+  // Uprobe-based HTTP2 events arrive already framed, so all of the cost is in stitching.
+  ProcessingCost cost;
+  cost.stitch_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(stitch_end - stitch_start).count();
+  cost.records = result.records.size();
+  AddProcessingCost(cost);
+
   return std::move(result.records);
 }
 
@@ -699,15 +715,49 @@ void ConnTracker::UpdateDataStats(const SocketDataEvent& event) {
       stats_.Increment(StatKey::kDataEventSent, 1);
       stats_.Increment(StatKey::kBytesSent, event.attr.msg_size);
       stats_.Increment(StatKey::kBytesSentTransferred, event.attr.msg_buf_size);
+      processing_cost_.bytes += event.attr.msg_buf_size;
     } break;
     case traffic_direction_t::kIngress: {
       stats_.Increment(StatKey::kDataEventRecv, 1);
       stats_.Increment(StatKey::kBytesRecv, event.attr.msg_size);
       stats_.Increment(StatKey::kBytesRecvTransferred, event.attr.msg_buf_size);
+      processing_cost_.bytes += event.attr.msg_buf_size;
     } break;
   }
 }
 
+void ConnTracker::AddProcessingCost(const ProcessingCost& cost) {
+  processing_cost_ += cost;
+  budget_window_cost_ns_ += cost.parse_ns + cost.stitch_ns;
+}
+
+void ConnTracker::CheckProcessingBudget() {
+  // The cost is averaged over a window, so that a single burst of traffic, or a slow iteration,
+  // does not disable an otherwise well-behaved connection.
+  constexpr auto kBudgetWindow = std::chrono::seconds(10);
+
+  if (budget_window_start_.time_since_epoch().count() == 0) {
+    budget_window_start_ = current_time_;
+    return;
+  }
+
+  auto window = current_time_ - budget_window_start_;
+  if (window < kBudgetWindow) {
+    return;
+  }
+
+  const uint64_t window_ms = std::chrono::duration_cast<std::chrono::milliseconds>(window).count();
+  const uint64_t budget_ns = window_ms * FLAGS_stirling_conn_parse_budget_ms_per_sec * 1000;
+  if (budget_window_cost_ns_ > budget_ns) {
+    Disable(absl::Substitute("Processing cost of $0ms/s exceeded the budget of $1ms/s",
+                             budget_window_cost_ns_ / window_ms / 1000,
+                             FLAGS_stirling_conn_parse_budget_ms_per_sec));
+  }
+
+  budget_window_start_ = current_time_;
+  budget_window_cost_ns_ = 0;
+}
+
 void ConnTracker::IterationPreTick(
     const std::chrono::time_point<std::chrono::steady_clock>& iteration_time,
     const std::vector<CIDRBlock>& cluster_cidrs, system::ProcParser* proc_parser,
@@ -772,6 +822,10 @@ void ConnTracker::IterationPostTick() {
     Disable(absl::Substitute("Connection does not appear to produce valid records of protocol $0",
                              magic_enum::enum_name(protocol())));
   }
+
+  if (FLAGS_stirling_conn_parse_budget_ms_per_sec > 0) {
+    CheckProcessingBudget();
+  }
 }
 
 void ConnTracker::CheckProcForConnClose() {
@@ -48,6 +48,7 @@ DECLARE_int64(stirling_conn_trace_pid);
 DECLARE_int64(stirling_conn_trace_fd);
 DECLARE_bool(stirling_conn_disable_to_bpf);
 DECLARE_int64(stirling_check_proc_for_conn_close);
+DECLARE_uint32(stirling_conn_parse_budget_ms_per_sec);
 
 #define CONN_TRACE(level) LOG_IF(INFO, level <= debug_trace_level_) << ToString() << " "
 
@@ -103,6 +104,27 @@ class ConnTracker : NotCopyMoveable {
     kInvalidRecords,
   };
 
+  // The user-space cost of processing the traffic of a connection.
+  struct ProcessingCost {
+    // Time spent parsing raw data into frames, and stitching frames into records.
+    uint64_t parse_ns = 0;
+    uint64_t stitch_ns = 0;
+
+    // The number of bytes transferred from BPF, and the number of frames/records they yielded.
+    uint64_t bytes = 0;
+    uint64_t frames = 0;
+    uint64_t records = 0;
+
+    ProcessingCost& operator+=(const ProcessingCost& other) {
+      parse_ns += other.parse_ns;
+      stitch_ns += other.stitch_ns;
+      bytes += other.bytes;
+      frames += other.frames;
+      records += other.records;
+      return *this;
+    }
+  };
+
   // State values change monotonically from lower to higher values; and cannot change reversely.
   enum class State {
     // When collecting, the tracker collects data from BPF, but does not push them to table store.
@@ -251,8 +273,13 @@ class ConnTracker : NotCopyMoveable {
 
     InitProtocolState<TStateType>();
 
+    const int num_frames_before = NumParsedFrames();
+    auto parse_start = std::chrono::steady_clock::now();
+
     DataStreamsToFrames<TFrameType, TStateType>();
 
+    auto stitch_start = std::chrono::steady_clock::now();
+
     auto& req_frames = req_data()->Frames<TFrameType>();
     auto& resp_frames = resp_data()->Frames<TFrameType>();
     auto state_ptr = protocol_state<TStateType>();
@@ -264,10 +291,21 @@ class ConnTracker : NotCopyMoveable {
         protocols::StitchFrames<TRecordType, TFrameType, TStateType>(&req_frames, &resp_frames,
                                                                      state_ptr);
 
+    auto stitch_end = std::chrono::steady_clock::now();
+
     CONN_TRACE(1) << absl::Substitute("records=$0", result.records.size());
 
     UpdateResultStats(result);
 
+    ProcessingCost cost;
+    cost.parse_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(stitch_start - parse_start).count();
+    cost.stitch_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(stitch_end - stitch_start).count();
+    cost.frames = NumParsedFrames() - num_frames_before;
+    cost.records = result.records.size();
+    AddProcessingCost(cost);
+
     return result.records;
   }
 
@@ -478,6 +516,11 @@ class ConnTracker : NotCopyMoveable {
 
   int64_t GetStat(StatKey key) const { return stats_.Get(key); }
 
+  /**
+   * Returns the processing cost accumulated since the previous call, and resets it.
+   */
+  ProcessingCost ConsumeProcessingCost() { return std::exchange(processing_cost_, {}); }
+
   /**
    * Initializes protocol state for a protocol.
    */
@@ -613,6 +656,16 @@ class ConnTracker : NotCopyMoveable {
                                                                          state_ptr);
   }
 
+  int NumParsedFrames() const {
+    return send_data_.stat_valid_frames() + send_data_.stat_invalid_frames() +
+           recv_data_.stat_valid_frames() + recv_data_.stat_invalid_frames();
+  }
+
+  void AddProcessingCost(const ProcessingCost& cost);
+
+  // Disables the tracker if its processing cost exceeds --stirling_conn_parse_budget_ms_per_sec.
+  void CheckProcessingBudget();
+
   template <typename TRecordType>
   void UpdateResultStats(const protocols::RecordsWithErrorCount<TRecordType>& result) {
     stats_.Increment(StatKey::kInvalidRecords, result.error_count);
@@ -677,6 +730,14 @@ class ConnTracker : NotCopyMoveable {
 
   utils::StatCounter<StatKey> stats_;
 
+  // Processing cost since the last ConsumeProcessingCost().
+  ProcessingCost processing_cost_;
+
+  // Processing time spent within the current budget window, which started at
+  // budget_window_start_.
+  uint64_t budget_window_cost_ns_ = 0;
+  std::chrono::time_point<std::chrono::steady_clock> budget_window_start_;
+
   // Connection trackers need to keep a state because there can be information between
   // needed from previous requests/responses needed to parse or render current request.
   // E.g. MySQL keeps a map of previously occurred stmt prepare events as the state such
@@ -131,6 +131,34 @@ TEST_F(ConnTrackerTest, ReqRespMatchingSimple) {
   EXPECT_EQ(records[2].resp.body, "bar");
 }
 
+TEST_F(ConnTrackerTest, ProcessingCost) {
+  testing::EventGenerator event_gen(&real_clock_);
+  struct socket_control_event_t conn = event_gen.InitConn();
+  std::unique_ptr<SocketDataEvent> req0 = event_gen.InitSendEvent<kProtocolHTTP>(kHTTPReq0);
+  std::unique_ptr<SocketDataEvent> resp0 = event_gen.InitRecvEvent<kProtocolHTTP>(kHTTPResp0);
+
+  ConnTracker tracker;
+  tracker.AddControlEvent(conn);
+  tracker.AddDataEvent(std::move(req0));
+  tracker.AddDataEvent(std::move(resp0));
+
+  std::vector<http::Record> records = tracker.ProcessToRecords<http::ProtocolTraits>();
+  ASSERT_EQ(1, records.size());
+
+  ConnTracker::ProcessingCost cost = tracker.ConsumeProcessingCost();
+  EXPECT_EQ(cost.bytes, kHTTPReq0.size() + kHTTPResp0.size());
+  EXPECT_EQ(cost.frames, 2);
+  EXPECT_EQ(cost.records, 1);
+
+  // The cost is reset once consumed.
+  cost = tracker.ConsumeProcessingCost();
+  EXPECT_EQ(cost.bytes, 0);
+  EXPECT_EQ(cost.frames, 0);
+  EXPECT_EQ(cost.records, 0);
+  EXPECT_EQ(cost.parse_ns, 0);
+  EXPECT_EQ(cost.stitch_ns, 0);
+}
+
 TEST_F(ConnTrackerTest, DISABLED_ReqRespMatchingPipelined) {
   testing::EventGenerator event_gen(&real_clock_);
   struct socket_control_event_t conn = event_gen.InitConn();
@@ -747,9 +775,45 @@ struct UpdateStateParam {
 
 class ConnTrackerTestDouble : public ConnTracker {
  public:
+  using ConnTracker::AddProcessingCost;
   using ConnTracker::UpdateState;
 };
 
+// Tests that a tracker that exceeds its processing budget disables itself.
+TEST_F(ConnTrackerTest, DisabledDueToProcessingBudget) {
+  const uint32_t orig_budget = FLAGS_stirling_conn_parse_budget_ms_per_sec;
+  FLAGS_stirling_conn_parse_budget_ms_per_sec = 1;
+
+  ConnTrackerTestDouble tracker;
+  auto now = now_;
+  tracker.set_current_time(now);
+  // The first iteration starts the budget window.
+  tracker.IterationPostTick();
+
+  // 5ms over a 10s window is within the budget of 10ms.
+  tracker.AddProcessingCost({.parse_ns = 3'000'000, .stitch_ns = 2'000'000});
+  now += std::chrono::seconds(10);
+  tracker.set_current_time(now);
+  tracker.IterationPostTick();
+  EXPECT_EQ(tracker.state(), ConnTracker::State::kCollecting);
+
+  // The cost is only checked once the window ends, so a burst doesn't disable the tracker.
+  tracker.AddProcessingCost({.parse_ns = 30'000'000});
+  now += std::chrono::seconds(1);
+  tracker.set_current_time(now);
+  tracker.IterationPostTick();
+  EXPECT_EQ(tracker.state(), ConnTracker::State::kCollecting);
+
+  // 30ms over a 10s window is 3ms/s.
+  now += std::chrono::seconds(9);
+  tracker.set_current_time(now);
+  tracker.IterationPostTick();
+  EXPECT_EQ(tracker.state(), ConnTracker::State::kDisabled);
+  EXPECT_EQ(tracker.disable_reason(), "Processing cost of 3ms/s exceeded the budget of 1ms/s");
+
+  FLAGS_stirling_conn_parse_budget_ms_per_sec = orig_budget;
+}
+
 class ConnTrackerUpdateStateTest : public ::testing::TestWithParam<UpdateStateParam> {};
 
 // Tests that ConnTracker::UpdateState() changes the state correctly.
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "src/stirling/core/types.h"
+#include "src/stirling/source_connectors/socket_tracer/canonical_types.h"
+
+namespace px {
+namespace stirling {
+
+// clang-format off
+constexpr DataElement kProtocolParseStatsElements[] = {
+        canonical_data_elements::kTime,
+        canonical_data_elements::kUPID,
+        {"protocol", "The protocol being parsed.",
+         types::DataType::INT64, types::SemanticType::ST_NONE, types::PatternType::GENERAL_ENUM,
+         &kTrafficProtocolDecoder},
+        {"parse_time", "Time spent parsing raw data into frames since the previous record.",
+         types::DataType::INT64, types::SemanticType::ST_DURATION_NS,
+         types::PatternType::METRIC_GAUGE},
+        {"stitch_time", "Time spent stitching frames into records since the previous record.",
+         types::DataType::INT64, types::SemanticType::ST_DURATION_NS,
+         types::PatternType::METRIC_GAUGE},
+        {"bytes", "The number of bytes transferred from the kernel since the previous record.",
+         types::DataType::INT64, types::SemanticType::ST_BYTES, types::PatternType::METRIC_GAUGE},
+        {"frames", "The number of frames parsed since the previous record.",
+         types::DataType::INT64, types::SemanticType::ST_NONE, types::PatternType::METRIC_GAUGE},
+        {"records", "The number of records produced since the previous record.",
+         types::DataType::INT64, types::SemanticType::ST_NONE, types::PatternType::METRIC_GAUGE},
+        {"frames_per_sec", "The rate of parsed frames since the previous record.",
+         types::DataType::FLOAT64, types::SemanticType::ST_NONE, types::PatternType::METRIC_GAUGE},
+};
+// clang-format on
+
+constexpr DataTableSchema kProtocolParseStatsTable(
+    "protocol_parse_stats",
+    "The user-space cost of parsing and stitching the traced traffic, per process and protocol. "
+    "Use together with --stirling_conn_parse_budget_ms_per_sec to find and limit the "
+    "connections that are most expensive to trace.",
+    kProtocolParseStatsElements);
+DEFINE_PRINT_TABLE(ProtocolParseStats)
+
+namespace protocol_parse_stats_idx {
+
+constexpr int kTime = kProtocolParseStatsTable.ColIndex("time_");
+constexpr int kUPID = kProtocolParseStatsTable.ColIndex("upid");
+constexpr int kProtocol = kProtocolParseStatsTable.ColIndex("protocol");
+constexpr int kParseTime = kProtocolParseStatsTable.ColIndex("parse_time");
+constexpr int kStitchTime = kProtocolParseStatsTable.ColIndex("stitch_time");
+constexpr int kBytes = kProtocolParseStatsTable.ColIndex("bytes");
+constexpr int kFrames = kProtocolParseStatsTable.ColIndex("frames");
+constexpr int kRecords = kProtocolParseStatsTable.ColIndex("records");
+constexpr int kFramesPerSec = kProtocolParseStatsTable.ColIndex("frames_per_sec");
+
+}  // namespace protocol_parse_stats_idx
+
+}  // namespace stirling
+}  // namespace px
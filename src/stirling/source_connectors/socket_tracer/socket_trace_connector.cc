@@ -55,6 +55,10 @@ DEFINE_uint32(
     std::chrono::minutes(10) / px::stirling::SocketTraceConnector::kSamplingPeriod,
     "Ratio of how frequently conn_stats_table is populated relative to the base sampling period");
 
+DEFINE_bool(stirling_enable_conn_aggregation, false,
+            "If true, the socket tracer aggregates per-process, per-protocol traffic and request "
+            "latency histograms inside the kernel, and reports them in the conn_agg_stats table.");
+
 DEFINE_bool(stirling_enable_periodic_bpf_map_cleanup, true,
             "Disable periodic BPF map cleanup (for testing)");
 
@@ -194,7 +198,15 @@ Status SocketTraceConnector::InitImpl() {
         "timestamps in a way that matches how /proc/stat does it");
   }
 
-  PL_RETURN_IF_ERROR(InitBPFProgram(socket_trace_bcc_script));
+  std::vector<std::string> defines;
+  if (FLAGS_stirling_enable_conn_aggregation) {
+    defines.push_back("-DENABLE_CONN_AGGREGATION");
+  }
+  PL_RETURN_IF_ERROR(InitBPFProgram(socket_trace_bcc_script, defines));
+  if (FLAGS_stirling_enable_conn_aggregation) {
+    conn_agg_stats_map_ = std::make_unique<ebpf::BPFHashTable<conn_agg_key_t, conn_agg_stats_t>>(
+        GetHashTable<conn_agg_key_t, conn_agg_stats_t>("conn_agg_stats_map"));
+  }
   PL_RETURN_IF_ERROR(AttachKProbes(kProbeSpecs));
   LOG(INFO) << absl::Substitute("Number of kprobes deployed = $0", kProbeSpecs.size());
   LOG(INFO) << "Probes successfully deployed.";
@@ -389,6 +401,25 @@ void SocketTraceConnector::TransferDataImpl(ConnectorContext* ctx,
     TransferConnStats(ctx, conn_stats_table);
   }
 
+  DataTable* conn_agg_stats_table = data_tables[kConnAggStatsTableNum];
+  if (conn_agg_stats_table != nullptr && conn_agg_stats_map_ != nullptr &&
+      sampling_freq_mgr_.count() % FLAGS_stirling_conn_stats_sampling_ratio == 0) {
+    TransferConnAggStats(ctx, conn_agg_stats_table);
+  }
+
+  DataTable* protocol_parse_stats_table = data_tables[kProtocolParseStatsTableNum];
+  if (protocol_parse_stats_table != nullptr &&
+      sampling_freq_mgr_.count() % FLAGS_stirling_conn_stats_sampling_ratio == 0) {
+    TransferProtocolParseStats(ctx, protocol_parse_stats_table);
+  }
+  // Without a subscriber the stats are never transferred, so don't accumulate them. The next
+  // subscription starts over, as on the first transfer.
+  collect_protocol_parse_stats_ = protocol_parse_stats_table != nullptr;
+  if (!collect_protocol_parse_stats_) {
+    protocol_parse_stats_.clear();
+    protocol_parse_stats_time_ = {};
+  }
+
   if ((sampling_freq_mgr_.count() + 1) % FLAGS_stirling_socket_tracer_stats_logging_ratio == 0) {
     conn_trackers_mgr_.ComputeProtocolStats();
     LOG(INFO) << "ConnTracker statistics: " << conn_trackers_mgr_.StatsString();
@@ -409,9 +440,10 @@ void SocketTraceConnector::TransferDataImpl(ConnectorContext* ctx,
     DataTable* data_table = data_tables[i];
 
     // Ensure records are within the time window, in order to ensure the order between record
-    // batches. Exception: conn_stats table does not need cutoff time, because its timestamps
+    // batches. Exception: the stats tables do not need cutoff time, because their timestamps
     // are assigned artificially.
-    if (i != kConnStatsTableNum && data_table != nullptr) {
+    if (i != kConnStatsTableNum && i != kConnAggStatsTableNum &&
+        i != kProtocolParseStatsTableNum && data_table != nullptr) {
       data_table->SetConsumeRecordsCutoffTime(perf_buffer_drain_time_);
     }
   }
@@ -1005,6 +1037,11 @@ void SocketTraceConnector::TransferStream(ConnectorContext* ctx, ConnTracker* tr
       AppendMessage(ctx, *tracker, std::move(record), data_table);
     }
 
+    ConnTracker::ProcessingCost cost = tracker->ConsumeProcessingCost();
+    if (collect_protocol_parse_stats_) {
+      protocol_parse_stats_[{tracker->conn_id().upid, tracker->protocol()}] += cost;
+    }
+
     auto expiry_timestamp =
         iteration_time_ - std::chrono::seconds(FLAGS_messages_expiration_duration_secs);
     tracker->Cleanup<TProtocolTraits>(FLAGS_messages_size_limit_bytes, expiry_timestamp);
@@ -1073,5 +1110,82 @@ void SocketTraceConnector::TransferConnStats(ConnectorContext* ctx, DataTable* d
   }
 }
 
+void SocketTraceConnector::TransferConnAggStats(ConnectorContext* ctx, DataTable* data_table) {
+  namespace idx = ::px::stirling::conn_agg_stats_idx;
+
+  absl::flat_hash_set<md::UPID> upids = ctx->GetUPIDs();
+  uint64_t time = CurrentTimeNS();
+
+  std::vector<std::pair<conn_agg_key_t, conn_agg_stats_t>> snapshot =
+      conn_agg_stats_map_->get_table_offline();
+
+  for (const auto& record : conn_agg_stats_.Update(snapshot)) {
+    md::UPID upid(ctx->GetASID(), record.key.upid.pid, record.key.upid.start_time_ticks);
+
+    DataTable::RecordBuilder<&kConnAggStatsTable> r(data_table, time);
+    r.Append<idx::kTime>(time);
+    r.Append<idx::kUPID>(upid.value());
+    r.Append<idx::kRole>(record.key.role);
+    r.Append<idx::kProtocol>(record.key.protocol);
+    r.Append<idx::kBytesSent>(record.bytes_sent);
+    r.Append<idx::kBytesRecv>(record.bytes_recv);
+    r.Append<idx::kNumRequests>(record.num_requests);
+    r.Append<idx::kLatencyP50>(record.latency_p50_ns);
+    r.Append<idx::kLatencyP90>(record.latency_p90_ns);
+    r.Append<idx::kLatencyP99>(record.latency_p99_ns);
+  }
+
+  // Remove the entries of processes that have exited. Their final stats were reported above.
+  const auto& sysconfig = system::Config::GetInstance();
+  for (const auto& [key, stats] : snapshot) {
+    md::UPID upid(ctx->GetASID(), key.upid.pid, key.upid.start_time_ticks);
+    if (upids.contains(upid)) {
+      continue;
+    }
+    std::filesystem::path pid_file = sysconfig.proc_path() / std::to_string(key.upid.pid);
+    if (!fs::Exists(pid_file).ok()) {
+      conn_agg_stats_map_->remove_value(key);
+      conn_agg_stats_.Erase(key);
+    }
+  }
+}
+
+void SocketTraceConnector::TransferProtocolParseStats(ConnectorContext* ctx,
+                                                      DataTable* data_table) {
+  namespace idx = ::px::stirling::protocol_parse_stats_idx;
+
+  uint64_t time = CurrentTimeNS();
+
+  // The first transfer has no well-defined interval, so it only starts the clock.
+  bool first_transfer = protocol_parse_stats_time_.time_since_epoch().count() == 0;
+  double interval_secs =
+      std::chrono::duration<double>(iteration_time_ - protocol_parse_stats_time_).count();
+  protocol_parse_stats_time_ = iteration_time_;
+
+  if (!first_transfer && interval_secs > 0) {
+    for (const auto& [key, cost] : protocol_parse_stats_) {
+      const auto& [upid_key, protocol] = key;
+      if (cost.bytes == 0 && cost.frames == 0 && cost.records == 0) {
+        continue;
+      }
+
+      md::UPID upid(ctx->GetASID(), upid_key.pid, upid_key.start_time_ticks);
+
+      DataTable::RecordBuilder<&kProtocolParseStatsTable> r(data_table, time);
+      r.Append<idx::kTime>(time);
+      r.Append<idx::kUPID>(upid.value());
+      r.Append<idx::kProtocol>(protocol);
+      r.Append<idx::kParseTime>(cost.parse_ns);
+      r.Append<idx::kStitchTime>(cost.stitch_ns);
+      r.Append<idx::kBytes>(cost.bytes);
+      r.Append<idx::kFrames>(cost.frames);
+      r.Append<idx::kRecords>(cost.records);
+      r.Append<idx::kFramesPerSec>(cost.frames / interval_secs);
+    }
+  }
+
+  protocol_parse_stats_.clear();
+}
+
 }  // namespace stirling
 }  // namespace px
@@ -38,6 +38,7 @@
 
 #include "src/stirling/core/source_connector.h"
 #include "src/stirling/source_connectors/socket_tracer/bcc_bpf_intf/socket_trace.hpp"
+#include "src/stirling/source_connectors/socket_tracer/conn_agg_stats.h"
 #include "src/stirling/source_connectors/socket_tracer/conn_stats.h"
 #include "src/stirling/source_connectors/socket_tracer/conn_tracker.h"
 #include "src/stirling/source_connectors/socket_tracer/conn_trackers_manager.h"
@@ -48,6 +49,7 @@
 #include "src/stirling/utils/proc_tracker.h"
 
 DECLARE_uint32(stirling_conn_stats_sampling_ratio);
+DECLARE_bool(stirling_enable_conn_aggregation);
 DECLARE_bool(stirling_enable_periodic_bpf_map_cleanup);
 DECLARE_string(perf_buffer_events_output_path);
 DECLARE_bool(stirling_enable_http_tracing);
@@ -72,7 +74,8 @@ class SocketTraceConnector : public SourceConnector, public bpf_tools::BCCWrappe
   static constexpr std::string_view kName = "socket_tracer";
   static constexpr auto kTables =
       MakeArray(kConnStatsTable, kHTTPTable, kMySQLTable, kCQLTable, kPGSQLTable, kDNSTable,
-                kRedisTable, kNATSTable, kKafkaTable);
+                kRedisTable, kNATSTable, kKafkaTable, kConnAggStatsTable,
+                kProtocolParseStatsTable);
 
   static constexpr uint32_t kConnStatsTableNum = TableNum(kTables, kConnStatsTable);
   static constexpr uint32_t kHTTPTableNum = TableNum(kTables, kHTTPTable);
@@ -83,6 +86,9 @@ class SocketTraceConnector : public SourceConnector, public bpf_tools::BCCWrappe
   static constexpr uint32_t kRedisTableNum = TableNum(kTables, kRedisTable);
   static constexpr uint32_t kNATSTableNum = TableNum(kTables, kNATSTable);
   static constexpr uint32_t kKafkaTableNum = TableNum(kTables, kKafkaTable);
+  static constexpr uint32_t kConnAggStatsTableNum = TableNum(kTables, kConnAggStatsTable);
+  static constexpr uint32_t kProtocolParseStatsTableNum =
+      TableNum(kTables, kProtocolParseStatsTable);
 
   static constexpr auto kSamplingPeriod = std::chrono::milliseconds{200};
   // TODO(yzhao): This is not used right now. Eventually use this to control data push frequency.
@@ -252,6 +258,8 @@ class SocketTraceConnector : public SourceConnector, public bpf_tools::BCCWrappe
   // Transfer of messages to the data table.
   void TransferStreams(ConnectorContext* ctx, uint32_t table_num, DataTable* data_table);
   void TransferConnStats(ConnectorContext* ctx, DataTable* data_table);
+  void TransferConnAggStats(ConnectorContext* ctx, DataTable* data_table);
+  void TransferProtocolParseStats(ConnectorContext* ctx, DataTable* data_table);
 
   template <typename TProtocolTraits>
   void TransferStream(ConnectorContext* ctx, ConnTracker* tracker, DataTable* data_table);
@@ -280,6 +288,18 @@ class SocketTraceConnector : public SourceConnector, public bpf_tools::BCCWrappe
 
   ConnStats conn_stats_;
 
+  // Only set when --stirling_enable_conn_aggregation is on.
+  std::unique_ptr<ebpf::BPFHashTable<conn_agg_key_t, conn_agg_stats_t>> conn_agg_stats_map_;
+  ConnAggStats conn_agg_stats_;
+
+  // Processing cost of each (process, protocol), accumulated since the last transfer of the
+  // protocol_parse_stats table at protocol_parse_stats_time_. Only collected while the table is
+  // subscribed to.
+  bool collect_protocol_parse_stats_ = false;
+  absl::flat_hash_map<std::pair<upid_t, traffic_protocol_t>, ConnTracker::ProcessingCost>
+      protocol_parse_stats_;
+  std::chrono::time_point<std::chrono::steady_clock> protocol_parse_stats_time_;
+
   absl::flat_hash_set<int> pids_to_trace_disable_;
 
   struct TransferSpec {
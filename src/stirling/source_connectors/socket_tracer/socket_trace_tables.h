@@ -18,7 +18,9 @@
 
 #pragma once
 
+#include "src/stirling/source_connectors/socket_tracer/conn_agg_stats_table.h"
 #include "src/stirling/source_connectors/socket_tracer/conn_stats_table.h"
+#include "src/stirling/source_connectors/socket_tracer/protocol_parse_stats_table.h"
 
 // PROTOCOL_LIST: Requires update on new protocols.
 #include "src/stirling/source_connectors/socket_tracer/cass_table.h"
@@ -22,8 +22,10 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <atomic>
 #include <filesystem>
 #include <map>
+#include <thread>
 
 #include "src/common/base/base.h"
 #include "src/common/base/utils.h"
@@ -42,6 +44,9 @@ DEFINE_bool(stirling_rescan_for_dlopen, false,
 DEFINE_double(stirling_rescan_exp_backoff_factor, 2.0,
               "Exponential backoff factor used in decided how often to rescan binaries for "
               "dynamically loaded libraries");
+DEFINE_int32(stirling_uprobe_analysis_threads, 4,
+             "The number of threads used to analyze new Go binaries for uprobe deployment. "
+             "The threads are started for each batch of new binaries, up to 16 of them.");
 
 namespace px {
 namespace stirling {
@@ -72,12 +77,12 @@ void UProbeManager::Init(bool enable_http2_tracing, bool disable_self_probing) {
 
 void UProbeManager::NotifyMMapEvent(upid_t upid) { upids_with_mmap_.insert(upid); }
 
-StatusOr<int> UProbeManager::AttachUProbeTmpl(const ArrayView<UProbeTmpl>& probe_tmpls,
-                                              const std::string& binary,
-                                              obj_tools::ElfReader* elf_reader) {
+StatusOr<std::vector<bpf_tools::UProbeSpec>> UProbeManager::ResolveUProbeTmpls(
+    const ArrayView<UProbeTmpl>& probe_tmpls, const std::string& binary,
+    obj_tools::ElfReader* elf_reader) {
   using bpf_tools::BPFProbeAttachType;
 
-  int uprobe_count = 0;
+  std::vector<bpf_tools::UProbeSpec> specs;
   for (const auto& tmpl : probe_tmpls) {
     bpf_tools::UProbeSpec spec = {binary,
                                   /*symbol*/ {},
@@ -98,8 +103,7 @@ StatusOr<int> UProbeManager::AttachUProbeTmpl(const ArrayView<UProbeTmpl>& probe
         case BPFProbeAttachType::kEntry:
         case BPFProbeAttachType::kReturn: {
           spec.symbol = symbol_info.name;
-          PL_RETURN_IF_ERROR(bcc_->AttachUProbe(spec));
-          ++uprobe_count;
+          specs.push_back(spec);
           break;
         }
         case BPFProbeAttachType::kReturnInsts: {
@@ -116,8 +120,7 @@ StatusOr<int> UProbeManager::AttachUProbeTmpl(const ArrayView<UProbeTmpl>& probe
           for (const uint64_t& addr : ret_inst_addrs) {
             spec.attach_type = BPFProbeAttachType::kEntry;
             spec.address = addr;
-            PL_RETURN_IF_ERROR(bcc_->AttachUProbe(spec));
-            ++uprobe_count;
+            specs.push_back(spec);
           }
           break;
         }
@@ -126,50 +129,39 @@ StatusOr<int> UProbeManager::AttachUProbeTmpl(const ArrayView<UProbeTmpl>& probe
       }
     }
   }
-  return uprobe_count;
+  return specs;
 }
 
-Status UProbeManager::UpdateOpenSSLSymAddrs(std::filesystem::path libcrypto_path, uint32_t pid) {
-  PL_ASSIGN_OR_RETURN(struct openssl_symaddrs_t symaddrs, OpenSSLSymAddrs(libcrypto_path));
-
-  openssl_symaddrs_map_->UpdateValue(pid, symaddrs);
-
-  return Status::OK();
-}
-
-Status UProbeManager::UpdateGoCommonSymAddrs(ElfReader* elf_reader, DwarfReader* dwarf_reader,
-                                             const std::vector<int32_t>& pids) {
-  PL_ASSIGN_OR_RETURN(struct go_common_symaddrs_t symaddrs,
-                      GoCommonSymAddrs(elf_reader, dwarf_reader));
-
-  for (auto& pid : pids) {
-    go_common_symaddrs_map_->UpdateValue(pid, symaddrs);
+StatusOr<int> UProbeManager::AttachUProbeSpecs(const std::vector<bpf_tools::UProbeSpec>& specs,
+                                               const std::string& binary) {
+  for (auto spec : specs) {
+    spec.binary_path = binary;
+    PL_RETURN_IF_ERROR(bcc_->AttachUProbe(spec));
   }
+  return specs.size();
+}
 
-  return Status::OK();
+StatusOr<int> UProbeManager::AttachUProbeTmpl(const ArrayView<UProbeTmpl>& probe_tmpls,
+                                              const std::string& binary,
+                                              obj_tools::ElfReader* elf_reader) {
+  PL_ASSIGN_OR_RETURN(std::vector<bpf_tools::UProbeSpec> specs,
+                      ResolveUProbeTmpls(probe_tmpls, binary, elf_reader));
+  return AttachUProbeSpecs(specs, binary);
 }
 
-Status UProbeManager::UpdateGoHTTP2SymAddrs(ElfReader* elf_reader, DwarfReader* dwarf_reader,
-                                            const std::vector<int32_t>& pids) {
-  PL_ASSIGN_OR_RETURN(struct go_http2_symaddrs_t symaddrs,
-                      GoHTTP2SymAddrs(elf_reader, dwarf_reader));
+Status UProbeManager::UpdateOpenSSLSymAddrs(std::filesystem::path libcrypto_path, uint32_t pid) {
+  PL_ASSIGN_OR_RETURN(struct openssl_symaddrs_t symaddrs, OpenSSLSymAddrs(libcrypto_path));
 
-  for (auto& pid : pids) {
-    go_http2_symaddrs_map_->UpdateValue(pid, symaddrs);
-  }
+  openssl_symaddrs_map_->UpdateValue(pid, symaddrs);
 
   return Status::OK();
 }
 
-Status UProbeManager::UpdateGoTLSSymAddrs(ElfReader* elf_reader, DwarfReader* dwarf_reader,
-                                          const std::vector<int32_t>& pids) {
-  PL_ASSIGN_OR_RETURN(struct go_tls_symaddrs_t symaddrs, GoTLSSymAddrs(elf_reader, dwarf_reader));
-
+void UProbeManager::UpdateGoCommonSymAddrs(const GoBinaryAnalysis& analysis,
+                                           const std::vector<int32_t>& pids) {
   for (auto& pid : pids) {
-    go_tls_symaddrs_map_->UpdateValue(pid, symaddrs);
+    go_common_symaddrs_map_->UpdateValue(pid, analysis.common_symaddrs);
   }
-
-  return Status::OK();
 }
 
 Status UProbeManager::UpdateNodeTLSWrapSymAddrs(int32_t pid, const std::filesystem::path& node_exe,
@@ -364,17 +356,18 @@ StatusOr<int> UProbeManager::AttachNodeJsOpenSSLUprobes(uint32_t pid) {
 }
 
 StatusOr<int> UProbeManager::AttachGoTLSUProbes(const std::string& binary,
-                                                obj_tools::ElfReader* elf_reader,
-                                                obj_tools::DwarfReader* dwarf_reader,
+                                                const GoBinaryAnalysis& analysis,
                                                 const std::vector<int32_t>& pids) {
   // Step 1: Update BPF symbols_map on all new PIDs.
-  Status s = UpdateGoTLSSymAddrs(elf_reader, dwarf_reader, pids);
-  if (!s.ok()) {
+  if (!analysis.tls_symaddrs.has_value()) {
     // Doesn't appear to be a binary with the mandatory symbols.
     // Might not even be a golang binary.
     // Either way, not of interest to probe.
     return 0;
   }
+  for (auto& pid : pids) {
+    go_tls_symaddrs_map_->UpdateValue(pid, analysis.tls_symaddrs.value());
+  }
 
   // Step 2: Deploy uprobes on all new binaries.
   auto result = go_tls_probed_binaries_.insert(binary);
@@ -382,7 +375,8 @@ StatusOr<int> UProbeManager::AttachGoTLSUProbes(const std::string& binary,
     // This is not a new binary, so nothing more to do.
     return 0;
   }
-  return AttachUProbeTmpl(kGoTLSUProbeTmpls, binary, elf_reader);
+  PL_RETURN_IF_ERROR(analysis.tls_probes.status());
+  return AttachUProbeSpecs(analysis.tls_probes.ValueOrDie(), binary);
 }
 
 // TODO(oazizi/yzhao): Should HTTP uprobes use a different set of perf buffers than the kprobes?
@@ -390,14 +384,15 @@ StatusOr<int> UProbeManager::AttachGoTLSUProbes(const std::string& binary,
 // cleanly. For example, right now, enabling uprobe & kprobe simultaneously can crash Stirling,
 // because of the mixed & duplicate data events from these 2 sources.
 StatusOr<int> UProbeManager::AttachGoHTTP2Probes(const std::string& binary,
-                                                 obj_tools::ElfReader* elf_reader,
-                                                 obj_tools::DwarfReader* dwarf_reader,
+                                                 const GoBinaryAnalysis& analysis,
                                                  const std::vector<int32_t>& pids) {
   // Step 1: Update BPF symaddrs for this binary.
-  Status s = UpdateGoHTTP2SymAddrs(elf_reader, dwarf_reader, pids);
-  if (!s.ok()) {
+  if (!analysis.http2_symaddrs.has_value()) {
     return 0;
   }
+  for (auto& pid : pids) {
+    go_http2_symaddrs_map_->UpdateValue(pid, analysis.http2_symaddrs.value());
+  }
 
   // Step 2: Deploy uprobes on all new binaries.
   auto result = go_http2_probed_binaries_.insert(binary);
@@ -405,7 +400,8 @@ StatusOr<int> UProbeManager::AttachGoHTTP2Probes(const std::string& binary,
     // This is not a new binary, so nothing more to do.
     return 0;
   }
-  return AttachUProbeTmpl(kHTTP2ProbeTmpls, binary, elf_reader);
+  PL_RETURN_IF_ERROR(analysis.http2_probes.status());
+  return AttachUProbeSpecs(analysis.http2_probes.ValueOrDie(), binary);
 }
 
 namespace {
@@ -505,12 +501,120 @@ int UProbeManager::DeployOpenSSLUProbes(const absl::flat_hash_set<md::UPID>& pid
   return uprobe_count;
 }
 
+std::shared_ptr<const UProbeManager::GoBinaryAnalysis> UProbeManager::AnalyzeGoBinary(
+    const std::string& binary) {
+  // Read binary's symbols.
+  StatusOr<std::unique_ptr<ElfReader>> elf_reader_status = ElfReader::Create(binary);
+  if (!elf_reader_status.ok()) {
+    LOG(WARNING) << absl::Substitute(
+        "Cannot analyze binary $0 for uprobe deployment. "
+        "If file is under /var/lib, container may have terminated. "
+        "Message = $1",
+        binary, elf_reader_status.msg());
+    return nullptr;
+  }
+  std::unique_ptr<ElfReader> elf_reader = elf_reader_status.ConsumeValueOrDie();
+
+  // Avoid going passed this point if not a golang program.
+  // The DwarfReader is memory intensive, and the remaining probes are Golang specific.
+  if (!IsGoExecutable(elf_reader.get())) {
+    return nullptr;
+  }
+
+  // Instances of the same binary in different containers have different paths, but the same
+  // build ID. Those can reuse the previous analysis, and skip the DWARF parsing below.
+  const std::string build_id(elf_reader->build_id());
+  if (!build_id.empty()) {
+    absl::MutexLock lock(&go_binary_analysis_cache_mutex_);
+    auto iter = go_binary_analysis_cache_.find(build_id);
+    if (iter != go_binary_analysis_cache_.end()) {
+      VLOG(1) << absl::Substitute("Reusing analysis of build ID $0 for binary $1", build_id,
+                                  binary);
+      return iter->second;
+    }
+  }
+
+  StatusOr<std::unique_ptr<DwarfReader>> dwarf_reader_status = DwarfReader::Create(binary);
+  if (!dwarf_reader_status.ok()) {
+    VLOG(1) << absl::Substitute(
+        "Failed to get binary $0 debug symbols. Cannot deploy uprobes. "
+        "Message = $1",
+        binary, dwarf_reader_status.msg());
+    return nullptr;
+  }
+  std::unique_ptr<DwarfReader> dwarf_reader = dwarf_reader_status.ConsumeValueOrDie();
+
+  auto analysis = std::make_shared<GoBinaryAnalysis>();
+
+  StatusOr<struct go_common_symaddrs_t> common_symaddrs_status =
+      GoCommonSymAddrs(elf_reader.get(), dwarf_reader.get());
+  if (!common_symaddrs_status.ok()) {
+    VLOG(1) << absl::Substitute(
+        "Golang binary $0 does not have the mandatory symbols (e.g. TCPConn).", binary);
+    return nullptr;
+  }
+  analysis->common_symaddrs = common_symaddrs_status.ConsumeValueOrDie();
+
+  StatusOr<struct go_tls_symaddrs_t> tls_symaddrs_status =
+      GoTLSSymAddrs(elf_reader.get(), dwarf_reader.get());
+  if (tls_symaddrs_status.ok()) {
+    analysis->tls_symaddrs = tls_symaddrs_status.ConsumeValueOrDie();
+    analysis->tls_probes = ResolveUProbeTmpls(kGoTLSUProbeTmpls, binary, elf_reader.get());
+  }
+
+  if (cfg_enable_http2_tracing_) {
+    StatusOr<struct go_http2_symaddrs_t> http2_symaddrs_status =
+        GoHTTP2SymAddrs(elf_reader.get(), dwarf_reader.get());
+    if (http2_symaddrs_status.ok()) {
+      analysis->http2_symaddrs = http2_symaddrs_status.ConsumeValueOrDie();
+      analysis->http2_probes = ResolveUProbeTmpls(kHTTP2ProbeTmpls, binary, elf_reader.get());
+    }
+  }
+
+  if (!build_id.empty()) {
+    absl::MutexLock lock(&go_binary_analysis_cache_mutex_);
+    if (go_binary_analysis_cache_.size() >= kMaxGoBinaryAnalysisCacheSize) {
+      go_binary_analysis_cache_.clear();
+    }
+    go_binary_analysis_cache_[build_id] = analysis;
+  }
+
+  return analysis;
+}
+
+std::vector<std::shared_ptr<const UProbeManager::GoBinaryAnalysis>>
+UProbeManager::AnalyzeGoBinaries(const std::vector<std::string>& binaries, int num_threads) {
+  std::vector<std::shared_ptr<const GoBinaryAnalysis>> analyses(binaries.size());
+  std::atomic<size_t> next_binary_idx = 0;
+  auto analyze_binaries = [&]() {
+    for (size_t i = next_binary_idx++; i < binaries.size(); i = next_binary_idx++) {
+      analyses[i] = AnalyzeGoBinary(binaries[i]);
+    }
+  };
+
+  // The threads are started for this call only, and joined before returning.
+  const size_t num_threads_to_use = std::min<size_t>(
+      std::clamp(num_threads, 1, kMaxGoBinaryAnalysisThreads), binaries.size());
+  std::vector<std::thread> analysis_threads;
+  // This thread also does its share of the work.
+  for (size_t i = 1; i < num_threads_to_use; ++i) {
+    analysis_threads.emplace_back(analyze_binaries);
+  }
+  analyze_binaries();
+  for (auto& thread : analysis_threads) {
+    thread.join();
+  }
+
+  return analyses;
+}
+
 int UProbeManager::DeployGoUProbes(const absl::flat_hash_set<md::UPID>& pids) {
   int uprobe_count = 0;
 
   static int32_t kPID = getpid();
 
-  for (const auto& [binary, pid_vec] : ConvertPIDsListToMap(pids, &fp_resolver_)) {
+  std::vector<std::pair<std::string, std::vector<int32_t>>> binaries;
+  for (auto& [binary, pid_vec] : ConvertPIDsListToMap(pids, &fp_resolver_)) {
     // Don't bother rescanning binaries that have been scanned before to avoid unnecessary work.
     if (!scanned_binaries_.insert(binary).second) {
       continue;
@@ -524,45 +628,32 @@ int UProbeManager::DeployGoUProbes(const absl::flat_hash_set<md::UPID>& pids) {
       }
     }
 
-    // Read binary's symbols.
-    StatusOr<std::unique_ptr<ElfReader>> elf_reader_status = ElfReader::Create(binary);
-    if (!elf_reader_status.ok()) {
-      LOG(WARNING) << absl::Substitute(
-          "Cannot analyze binary $0 for uprobe deployment. "
-          "If file is under /var/lib, container may have terminated. "
-          "Message = $1",
-          binary, elf_reader_status.msg());
-      continue;
-    }
-    std::unique_ptr<ElfReader> elf_reader = elf_reader_status.ConsumeValueOrDie();
+    binaries.emplace_back(binary, std::move(pid_vec));
+  }
 
-    // Avoid going passed this point if not a golang program.
-    // The DwarfReader is memory intensive, and the remaining probes are Golang specific.
-    if (!IsGoExecutable(elf_reader.get())) {
-      continue;
-    }
+  // Analyzing the binaries is the expensive part, and only reads the binaries, so it is done on
+  // several threads. Attaching the uprobes and updating the BPF maps is done afterwards on this
+  // thread, because BCCWrapper and the BPF map wrappers are not thread-safe.
+  std::vector<std::string> binary_paths;
+  binary_paths.reserve(binaries.size());
+  for (const auto& [binary, pid_vec] : binaries) {
+    binary_paths.push_back(binary);
+  }
+  std::vector<std::shared_ptr<const GoBinaryAnalysis>> analyses =
+      AnalyzeGoBinaries(binary_paths, FLAGS_stirling_uprobe_analysis_threads);
 
-    StatusOr<std::unique_ptr<DwarfReader>> dwarf_reader_status = DwarfReader::Create(binary);
-    if (!dwarf_reader_status.ok()) {
-      VLOG(1) << absl::Substitute(
-          "Failed to get binary $0 debug symbols. Cannot deploy uprobes. "
-          "Message = $1",
-          binary, dwarf_reader_status.msg());
+  for (const auto& [idx, binary_and_pids] : Enumerate(binaries)) {
+    const auto& [binary, pid_vec] = binary_and_pids;
+    const std::shared_ptr<const GoBinaryAnalysis>& analysis = analyses[idx];
+    if (analysis == nullptr) {
       continue;
     }
-    std::unique_ptr<DwarfReader> dwarf_reader = dwarf_reader_status.ConsumeValueOrDie();
 
-    Status s = UpdateGoCommonSymAddrs(elf_reader.get(), dwarf_reader.get(), pid_vec);
-    if (!s.ok()) {
-      VLOG(1) << absl::Substitute(
-          "Golang binary $0 does not have the mandatory symbols (e.g. TCPConn).", binary);
-      continue;
-    }
+    UpdateGoCommonSymAddrs(*analysis, pid_vec);
 
     // GoTLS Probes.
     {
-      StatusOr<int> attach_status =
-          AttachGoTLSUProbes(binary, elf_reader.get(), dwarf_reader.get(), pid_vec);
+      StatusOr<int> attach_status = AttachGoTLSUProbes(binary, *analysis, pid_vec);
       if (!attach_status.ok()) {
         LOG_FIRST_N(WARNING, 10) << absl::Substitute("Failed to attach GoTLS Uprobes to $0: $1",
                                                      binary, attach_status.ToString());
@@ -573,8 +664,7 @@ int UProbeManager::DeployGoUProbes(const absl::flat_hash_set<md::UPID>& pids) {
 
     // Go HTTP2 Probes.
     if (cfg_enable_http2_tracing_) {
-      StatusOr<int> attach_status =
-          AttachGoHTTP2Probes(binary, elf_reader.get(), dwarf_reader.get(), pid_vec);
+      StatusOr<int> attach_status = AttachGoHTTP2Probes(binary, *analysis, pid_vec);
       if (!attach_status.ok()) {
         LOG_FIRST_N(WARNING, 10) << absl::Substitute("Failed to attach HTTP2 Uprobes to $0: $1",
                                                      binary, attach_status.ToString());
@@ -20,6 +20,7 @@
 
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -39,6 +40,7 @@
 
 DECLARE_bool(stirling_rescan_for_dlopen);
 DECLARE_double(stirling_rescan_exp_backoff_factor);
+DECLARE_int32(stirling_uprobe_analysis_threads);
 
 namespace px {
 namespace stirling {
@@ -357,21 +359,57 @@ class UProbeManager {
    */
   int DeployGoUProbes(const absl::flat_hash_set<md::UPID>& pids);
 
+  // The result of analyzing a Go binary for uprobe deployment. It only depends on the contents of
+  // the binary, so it is shared by all instances of the same binary, even if they are at different
+  // paths (e.g. in different containers).
+  struct GoBinaryAnalysis {
+    struct go_common_symaddrs_t common_symaddrs;
+
+    // Only set if the binary uses Go TLS or a Go HTTP2 library, respectively.
+    std::optional<struct go_tls_symaddrs_t> tls_symaddrs;
+    std::optional<struct go_http2_symaddrs_t> http2_symaddrs;
+
+    // The uprobes to attach, or the error from resolving them. Their binary path is replaced with
+    // the path of each instance when attaching.
+    StatusOr<std::vector<bpf_tools::UProbeSpec>> tls_probes = std::vector<bpf_tools::UProbeSpec>{};
+    StatusOr<std::vector<bpf_tools::UProbeSpec>> http2_probes =
+        std::vector<bpf_tools::UProbeSpec>{};
+  };
+
+  /**
+   * Analyzes a Go binary: resolves the symbol addresses and the uprobes used for Go tracing.
+   * The result is cached by the build ID of the binary, so later analyses of the same binary skip
+   * the ELF symbol lookups and DWARF parsing. Thread-safe.
+   *
+   * @param binary The path to the binary.
+   * @return The analysis, or nullptr if the binary is not a Go binary that can be traced.
+   */
+  std::shared_ptr<const GoBinaryAnalysis> AnalyzeGoBinary(const std::string& binary);
+
+  /**
+   * Analyzes the Go binaries with AnalyzeGoBinary(). Up to num_threads threads, including the
+   * calling thread, are used; they are started by this call and joined before it returns.
+   *
+   * @param binaries The paths to the binaries.
+   * @param num_threads The number of threads to use, capped to kMaxGoBinaryAnalysisThreads.
+   * @return The analysis of each binary, in the same order as binaries.
+   */
+  std::vector<std::shared_ptr<const GoBinaryAnalysis>> AnalyzeGoBinaries(
+      const std::vector<std::string>& binaries, int num_threads);
+
   /**
    * Attaches the required probes for Go HTTP2 tracing to the specified binary, if it is a
    * compatible Go binary.
    *
    * @param binary The path to the binary on which to deploy Go HTTP2 probes.
-   * @param elf_reader ELF reader for the binary.
-   * @param dwarf_reader DWARF reader for the binary.
+   * @param analysis The analysis of the binary.
    * @param pids The list of PIDs that are new instances of the binary. Used to populate symbol
    *             addresses.
    * @return The number of uprobes deployed, or error. It is not considered an error if the binary
    *         is not a Go binary or doesn't use a Go HTTP2 library; instead the return value will be
    *         zero.
    */
-  StatusOr<int> AttachGoHTTP2Probes(const std::string& binary, obj_tools::ElfReader* elf_reader,
-                                    obj_tools::DwarfReader* dwarf_reader,
+  StatusOr<int> AttachGoHTTP2Probes(const std::string& binary, const GoBinaryAnalysis& analysis,
                                     const std::vector<int32_t>& pids);
 
   /**
@@ -379,16 +417,14 @@ class UProbeManager {
    * Go binary.
    *
    * @param binary The path to the binary on which to deploy Go HTTP2 probes.
-   * @param elf_reader ELF reader for the binary.
-   * @param dwarf_reader DWARF reader for the binary.
+   * @param analysis The analysis of the binary.
    * @param pids The list of PIDs that are new instances of the binary. Used to populate symbol
    *             addresses.
    * @return The number of uprobes deployed, or error. It is not an error if the binary
    *         is not a Go binary or doesn't use Go TLS; instead the return value will be zero.
    */
-  StatusOr<int> AttachGoTLSUProbes(const std::string& binary, obj_tools::ElfReader* elf_reader,
-                                   obj_tools::DwarfReader* dwarf_reader,
-                                   const std::vector<int32_t>& new_pids);
+  StatusOr<int> AttachGoTLSUProbes(const std::string& binary, const GoBinaryAnalysis& analysis,
+                                   const std::vector<int32_t>& pids);
 
   /**
    * Attaches the required probes for OpenSSL tracing to the specified PID, if it uses OpenSSL.
@@ -410,6 +446,29 @@ class UProbeManager {
    */
   StatusOr<int> AttachNodeJsOpenSSLUprobes(uint32_t pid);
 
+  /**
+   * Resolves probe templates into the uprobe specs to attach. Finds all symbol matches as
+   * specified in the templates, and produces a spec per matching symbol, or per return instruction
+   * for kReturnInsts templates. Does not attach anything, so it can run outside of the deployment
+   * thread.
+   *
+   * @param probe_tmpls Array of probe templates to process.
+   * @param binary The binary to uprobe.
+   * @param elf_reader Pointer to an elf reader for the binary. Used to find symbol matches.
+   * @return The uprobe specs, or error. No symbol matches is not considered an error.
+   */
+  static StatusOr<std::vector<bpf_tools::UProbeSpec>> ResolveUProbeTmpls(
+      const ArrayView<UProbeTmpl>& probe_tmpls, const std::string& binary,
+      obj_tools::ElfReader* elf_reader);
+
+  /**
+   * Attaches the uprobe specs to the specified binary.
+   *
+   * @return Number of uprobes deployed, or error if uprobes failed to deploy.
+   */
+  StatusOr<int> AttachUProbeSpecs(const std::vector<bpf_tools::UProbeSpec>& specs,
+                                  const std::string& binary);
+
   /**
    * Helper function that calls BCCWrapper.AttachUprobe() from a probe template.
    * Among other things, it finds all symbol matches as specified in the template,
@@ -428,14 +487,7 @@ class UProbeManager {
   absl::flat_hash_set<md::UPID> PIDsToRescanForUProbes();
 
   Status UpdateOpenSSLSymAddrs(std::filesystem::path container_lib, uint32_t pid);
-  Status UpdateGoCommonSymAddrs(obj_tools::ElfReader* elf_reader,
-                                obj_tools::DwarfReader* dwarf_reader,
-                                const std::vector<int32_t>& pids);
-  Status UpdateGoHTTP2SymAddrs(obj_tools::ElfReader* elf_reader,
-                               obj_tools::DwarfReader* dwarf_reader,
-                               const std::vector<int32_t>& pids);
-  Status UpdateGoTLSSymAddrs(obj_tools::ElfReader* elf_reader, obj_tools::DwarfReader* dwarf_reader,
-                             const std::vector<int32_t>& pids);
+  void UpdateGoCommonSymAddrs(const GoBinaryAnalysis& analysis, const std::vector<int32_t>& pids);
   Status UpdateNodeTLSWrapSymAddrs(int32_t pid, const std::filesystem::path& node_exe,
                                    const SemVer& ver);
 
@@ -479,6 +531,16 @@ class UProbeManager {
   absl::flat_hash_set<std::string> go_tls_probed_binaries_;
   absl::flat_hash_set<std::string> nodejs_binaries_;
 
+  // Go binary analyses keyed by build ID. Populated by AnalyzeGoBinary().
+  // TODO(oazizi): Like the sets above, entries of deleted binaries are never cleaned up. Bounded by
+  //               kMaxGoBinaryAnalysisCacheSize instead.
+  static constexpr size_t kMaxGoBinaryAnalysisCacheSize = 1024;
+  // Upper bound on the threads started by each call to AnalyzeGoBinaries().
+  static constexpr int kMaxGoBinaryAnalysisThreads = 16;
+  absl::Mutex go_binary_analysis_cache_mutex_;
+  absl::flat_hash_map<std::string, std::shared_ptr<const GoBinaryAnalysis>>
+      go_binary_analysis_cache_ ABSL_GUARDED_BY(go_binary_analysis_cache_mutex_);
+
   // BPF maps through which the addresses of symbols for a given pid are communicated to uprobes.
   std::unique_ptr<UserSpaceManagedBPFMap<uint32_t, struct openssl_symaddrs_t>>
       openssl_symaddrs_map_;
@@ -489,6 +551,10 @@ class UProbeManager {
   std::unique_ptr<UserSpaceManagedBPFMap<uint32_t, struct go_tls_symaddrs_t>> go_tls_symaddrs_map_;
   std::unique_ptr<UserSpaceManagedBPFMap<uint32_t, struct node_tlswrap_symaddrs_t>>
       node_tlswrap_symaddrs_map_;
+
+  FRIEND_TEST(UProbeManagerTest, AnalyzeGoBinaryCachesByBuildID);
+  FRIEND_TEST(UProbeManagerTest, AnalyzeGoBinaryRejectsNonGoBinaries);
+  FRIEND_TEST(UProbeManagerTest, ParallelAnalysisMatchesSerial);
 };
 
 }  // namespace stirling
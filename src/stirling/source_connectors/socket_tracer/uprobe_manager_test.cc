@@ -0,0 +1,150 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/stirling/source_connectors/socket_tracer/uprobe_manager.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <absl/strings/substitute.h>
+
+#include "src/common/fs/fs_wrapper.h"
+#include "src/common/testing/temp_dir.h"
+#include "src/common/testing/testing.h"
+
+namespace px {
+namespace stirling {
+
+using ::testing::SizeIs;
+
+constexpr std::string_view kTestGo1_16Binary =
+    "src/stirling/obj_tools/testdata/go/test_go_1_16_binary";
+constexpr std::string_view kTestGo1_17Binary =
+    "src/stirling/obj_tools/testdata/go/test_go_1_17_binary";
+constexpr std::string_view kGoGRPCServer =
+    "src/stirling/testing/demo_apps/go_grpc_tls_pl/server/server_/server";
+constexpr std::string_view kTestGo1_16BuildID =
+    "dFcePuw7dDYwj11OZzmq/UKfX80Tu_Wn5QhKg7-ml/yVQY8EJXhjK7ugZZAeyM/POf6a2Kz2v2rf5f7LoyR";
+
+template <typename T>
+std::string_view Bytes(const T& x) {
+  return std::string_view(reinterpret_cast<const char*>(&x), sizeof(T));
+}
+
+std::vector<std::string> ProbeStrings(const StatusOr<std::vector<bpf_tools::UProbeSpec>>& probes) {
+  std::vector<std::string> strs;
+  if (!probes.ok()) {
+    strs.push_back(probes.ToString());
+    return strs;
+  }
+  for (const auto& probe : probes.ValueOrDie()) {
+    strs.push_back(probe.ToString());
+  }
+  return strs;
+}
+
+// The manager is not initialized, because analyzing binaries doesn't need BCC or the BPF maps.
+TEST(UProbeManagerTest, AnalyzeGoBinaryCachesByBuildID) {
+  UProbeManager mgr(/*bcc*/ nullptr);
+  mgr.cfg_enable_http2_tracing_ = true;
+
+  // A copy of the binary at another path, like another container's instance of it.
+  px::testing::TempDir temp_dir;
+  const std::filesystem::path binary_copy = temp_dir.path() / "test_go_binary";
+  ASSERT_OK(fs::Copy(px::testing::TestFilePath(kTestGo1_16Binary), binary_copy));
+
+  // The test binaries don't use the net package, so they can't be traced and their analysis is
+  // not cached; seed the cache to observe the lookups instead.
+  auto cached = std::make_shared<UProbeManager::GoBinaryAnalysis>();
+  {
+    absl::MutexLock lock(&mgr.go_binary_analysis_cache_mutex_);
+    mgr.go_binary_analysis_cache_[std::string(kTestGo1_16BuildID)] = cached;
+  }
+
+  // Hit: the same build ID at a different path reuses the analysis.
+  EXPECT_EQ(mgr.AnalyzeGoBinary(binary_copy.string()), cached);
+
+  // Miss: another build ID is analyzed.
+  EXPECT_EQ(mgr.AnalyzeGoBinary(px::testing::TestFilePath(kTestGo1_17Binary)), nullptr);
+
+  absl::MutexLock lock(&mgr.go_binary_analysis_cache_mutex_);
+  EXPECT_THAT(mgr.go_binary_analysis_cache_, SizeIs(1));
+}
+
+TEST(UProbeManagerTest, AnalyzeGoBinaryRejectsNonGoBinaries) {
+  UProbeManager mgr(/*bcc*/ nullptr);
+  mgr.cfg_enable_http2_tracing_ = true;
+
+  EXPECT_EQ(mgr.AnalyzeGoBinary("/bogus"), nullptr);
+  EXPECT_EQ(mgr.AnalyzeGoBinary("/proc/self/exe"), nullptr);
+}
+
+TEST(UProbeManagerTest, ParallelAnalysisMatchesSerial) {
+  const std::vector<std::string> binaries = {
+      px::testing::BazelBinTestFilePath(kGoGRPCServer),
+      px::testing::TestFilePath(kTestGo1_16Binary),
+      px::testing::BazelBinTestFilePath(kGoGRPCServer),
+      px::testing::TestFilePath(kTestGo1_17Binary),
+  };
+
+  // Separate managers, so that the parallel analysis doesn't reuse the serial one's cache.
+  UProbeManager serial_mgr(/*bcc*/ nullptr);
+  serial_mgr.cfg_enable_http2_tracing_ = true;
+  UProbeManager parallel_mgr(/*bcc*/ nullptr);
+  parallel_mgr.cfg_enable_http2_tracing_ = true;
+
+  auto serial = serial_mgr.AnalyzeGoBinaries(binaries, /*num_threads*/ 1);
+  auto parallel = parallel_mgr.AnalyzeGoBinaries(binaries, /*num_threads*/ 4);
+
+  ASSERT_THAT(serial, SizeIs(binaries.size()));
+  ASSERT_THAT(parallel, SizeIs(binaries.size()));
+  // Only the gRPC server uses the net package.
+  ASSERT_NE(serial[0], nullptr);
+  EXPECT_EQ(serial[1], nullptr);
+  EXPECT_EQ(serial[3], nullptr);
+
+  for (size_t i = 0; i < binaries.size(); ++i) {
+    SCOPED_TRACE(absl::Substitute("binary #$0: $1", i, binaries[i]));
+    ASSERT_EQ(serial[i] == nullptr, parallel[i] == nullptr);
+    if (serial[i] == nullptr) {
+      continue;
+    }
+    const UProbeManager::GoBinaryAnalysis& expected = *serial[i];
+    const UProbeManager::GoBinaryAnalysis& actual = *parallel[i];
+
+    EXPECT_EQ(Bytes(actual.common_symaddrs), Bytes(expected.common_symaddrs));
+    ASSERT_EQ(actual.tls_symaddrs.has_value(), expected.tls_symaddrs.has_value());
+    if (expected.tls_symaddrs.has_value()) {
+      EXPECT_EQ(Bytes(actual.tls_symaddrs.value()), Bytes(expected.tls_symaddrs.value()));
+    }
+    ASSERT_EQ(actual.http2_symaddrs.has_value(), expected.http2_symaddrs.has_value());
+    if (expected.http2_symaddrs.has_value()) {
+      EXPECT_EQ(Bytes(actual.http2_symaddrs.value()), Bytes(expected.http2_symaddrs.value()));
+    }
+    EXPECT_EQ(ProbeStrings(actual.tls_probes), ProbeStrings(expected.tls_probes));
+    EXPECT_EQ(ProbeStrings(actual.http2_probes), ProbeStrings(expected.http2_probes));
+  }
+  EXPECT_TRUE(serial[0]->tls_symaddrs.has_value());
+}
+
+}  // namespace stirling
+}  // namespace px
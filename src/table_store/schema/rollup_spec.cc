@@ -0,0 +1,128 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/table_store/schema/rollup_spec.h"
+
+namespace px {
+namespace table_store {
+namespace schema {
+
+namespace {
+constexpr char kTimeColumn[] = "time_";
+}  // namespace
+
+StatusOr<Relation> RollupSpec::RollupRelation(const Relation& source_relation) const {
+  if (bucket_ns <= 0) {
+    return error::InvalidArgument("Rollup $0 needs a positive time bucket, got $1.", name,
+                                  bucket_ns);
+  }
+  if (!source_relation.HasColumn(kTimeColumn) ||
+      source_relation.GetColumnType(kTimeColumn) != types::DataType::TIME64NS) {
+    return error::InvalidArgument("Rollup $0 needs a $1 column in table $2.", name, kTimeColumn,
+                                  source_table);
+  }
+
+  Relation relation;
+  relation.AddColumn(types::DataType::TIME64NS, kTimeColumn, types::ST_NONE,
+                     "The start of the time bucket");
+  for (const auto& col : group_by) {
+    if (!source_relation.HasColumn(col) || col == kTimeColumn) {
+      return error::InvalidArgument("Rollup $0 can't group by column $1 of table $2.", name, col,
+                                    source_table);
+    }
+    relation.AddColumn(source_relation.GetColumnType(col), col,
+                       source_relation.GetColumnSemanticType(col),
+                       source_relation.GetColumnDesc(col));
+  }
+  for (const auto& agg : aggregates) {
+    if (!source_relation.HasColumn(agg.input_column)) {
+      return error::InvalidArgument("Rollup $0 aggregates column $1, which table $2 doesn't have.",
+                                    name, agg.input_column, source_table);
+    }
+    if (relation.HasColumn(agg.output_column)) {
+      return error::InvalidArgument("Rollup $0 has more than one column $1.", name,
+                                    agg.output_column);
+    }
+    types::DataType input_type = source_relation.GetColumnType(agg.input_column);
+    types::SemanticType input_semantic_type =
+        source_relation.GetColumnSemanticType(agg.input_column);
+    if (agg.kind == RollupAggregate::Kind::kCount) {
+      relation.AddColumn(types::DataType::INT64, agg.output_column, types::ST_NONE);
+      continue;
+    }
+    if (input_type != types::DataType::INT64 && input_type != types::DataType::FLOAT64 &&
+        input_type != types::DataType::TIME64NS) {
+      return error::InvalidArgument("Rollup $0 can't $1 column $2 of type $3.", name,
+                                    RollupAggregateFuncName(agg.kind), agg.input_column,
+                                    types::ToString(input_type));
+    }
+    // Sums of times are durations, so they are kept as integers.
+    if (agg.kind == RollupAggregate::Kind::kSum && input_type == types::DataType::TIME64NS) {
+      input_type = types::DataType::INT64;
+    }
+    relation.AddColumn(input_type, agg.output_column, input_semantic_type);
+  }
+  return relation;
+}
+
+const RollupAggregate* RollupSpec::FindAggregate(RollupAggregate::Kind kind,
+                                                 const std::string& input_column) const {
+  for (const auto& agg : aggregates) {
+    // All the counts are the same, as the columns have no nulls.
+    if (agg.kind == kind &&
+        (kind == RollupAggregate::Kind::kCount || agg.input_column == input_column)) {
+      return &agg;
+    }
+  }
+  return nullptr;
+}
+
+std::string_view RollupAggregateFuncName(RollupAggregate::Kind kind) {
+  switch (kind) {
+    case RollupAggregate::Kind::kCount:
+      return "count";
+    case RollupAggregate::Kind::kSum:
+      return "sum";
+    case RollupAggregate::Kind::kMin:
+      return "min";
+    case RollupAggregate::Kind::kMax:
+      return "max";
+  }
+  return "";
+}
+
+const std::vector<RollupSpec>& DefaultRollupSpecs() {
+  using Kind = RollupAggregate::Kind;
+  static const auto* specs = new std::vector<RollupSpec>{
+      // The request rate, errors and latencies of each process, for the long-range dashboards.
+      {"http_events_rollup_10s",
+       "http_events",
+       {"upid", "trace_role", "req_method", "resp_status"},
+       10LL * 1000 * 1000 * 1000,
+       {{Kind::kCount, "latency", "count"},
+        {Kind::kSum, "latency", "latency_sum"},
+        {Kind::kMin, "latency", "latency_min"},
+        {Kind::kMax, "latency", "latency_max"}},
+       64 * 1024 * 1024},
+  };
+  return *specs;
+}
+
+}  // namespace schema
+}  // namespace table_store
+}  // namespace px
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "src/common/base/base.h"
+#include "src/table_store/schema/relation.h"
+
+namespace px {
+namespace table_store {
+namespace schema {
+
+/**
+ * RollupAggregate is one aggregate that a rollup keeps for each of its groups.
+ */
+struct RollupAggregate {
+  enum class Kind { kCount, kSum, kMin, kMax };
+
+  Kind kind;
+  // The column of the source table to aggregate.
+  std::string input_column;
+  // The column of the rollup table that holds the aggregate.
+  std::string output_column;
+};
+
+/**
+ * RollupSpec declares a rollup: a derived table that holds the aggregates of a source table,
+ * grouped by some of its columns and by time bucket. Rollups are much smaller than their source,
+ * so they keep a longer history.
+ *
+ * The rollup table has a time_ column with the start of each bucket, then the group columns, then
+ * the aggregates. A bucket and group can have several rows, which must be aggregated again
+ * (counts are summed) when reading the rollup.
+ */
+struct RollupSpec {
+  // The name of the rollup table.
+  std::string name;
+  std::string source_table;
+  std::vector<std::string> group_by;
+  int64_t bucket_ns;
+  std::vector<RollupAggregate> aggregates;
+  // The bytes that the rollup table holds, which sets its retention.
+  int64_t max_table_size;
+
+  /**
+   * @brief Checks the spec against the relation of the source table, and returns the relation
+   * of the rollup table.
+   */
+  StatusOr<Relation> RollupRelation(const Relation& source_relation) const;
+
+  const RollupAggregate* FindAggregate(RollupAggregate::Kind kind,
+                                       const std::string& input_column) const;
+};
+
+/**
+ * The longest that the agents take to write a bucket to the rollup table once it has passed: they
+ * flush their rollups every minute, and the rows of the source table can arrive a little late.
+ * Readers read the more recent buckets from the source table instead.
+ */
+inline constexpr int64_t kRollupMaxFlushDelayNs = 2 * 60 * 1000 * 1000 * 1000LL;
+
+/**
+ * How long after a bucket ends the agents wait for its late rows before flushing it, if no newer
+ * bucket flushed it already. Rows that arrive for a bucket after it's flushed are not rolled up.
+ */
+inline constexpr int64_t kRollupFlushGraceNs = 30 * 1000 * 1000 * 1000LL;
+
+/**
+ * @return the name of the UDA that aggregates the values of the given kind of aggregate, which is
+ * also the UDA that aggregates them again when reading the rollup (except for count, which is
+ * summed).
+ */
+std::string_view RollupAggregateFuncName(RollupAggregate::Kind kind);
+
+/**
+ * @return the rollups that the agents keep for the tables that they collect. The planner answers
+ * the queries that match one of them from its table.
+ */
+const std::vector<RollupSpec>& DefaultRollupSpecs();
+
+}  // namespace schema
+}  // namespace table_store
+}  // namespace px
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/common/testing/testing.h"
+#include "src/table_store/schema/rollup_spec.h"
+
+namespace px {
+namespace table_store {
+namespace schema {
+
+using Kind = RollupAggregate::Kind;
+
+class RollupSpecTest : public ::testing::Test {
+ protected:
+  Relation source_{{types::TIME64NS, types::STRING, types::INT64, types::TIME64NS},
+                   {"time_", "service", "latency", "resp_time"}};
+};
+
+TEST_F(RollupSpecTest, rollup_relation) {
+  RollupSpec spec{"rollup",
+                  "source",
+                  {"service"},
+                  1000,
+                  {{Kind::kCount, "latency", "count"},
+                   {Kind::kSum, "latency", "latency_sum"},
+                   {Kind::kMax, "latency", "latency_max"},
+                   {Kind::kSum, "resp_time", "resp_time_sum"},
+                   {Kind::kMin, "resp_time", "resp_time_min"}},
+                  1024};
+  ASSERT_OK_AND_ASSIGN(Relation relation, spec.RollupRelation(source_));
+  EXPECT_EQ(Relation({types::TIME64NS, types::STRING, types::INT64, types::INT64, types::INT64,
+                      types::INT64, types::TIME64NS},
+                     {"time_", "service", "count", "latency_sum", "latency_max", "resp_time_sum",
+                      "resp_time_min"}),
+            relation);
+
+  EXPECT_EQ("count", spec.FindAggregate(Kind::kCount, "resp_time")->output_column);
+  EXPECT_EQ("resp_time_sum", spec.FindAggregate(Kind::kSum, "resp_time")->output_column);
+  EXPECT_EQ(nullptr, spec.FindAggregate(Kind::kMin, "latency"));
+}
+
+TEST_F(RollupSpecTest, invalid_specs) {
+  RollupSpec spec{"rollup", "source", {"service"}, 0, {}, 1024};
+  EXPECT_NOT_OK(spec.RollupRelation(source_));
+
+  spec.bucket_ns = 1000;
+  spec.group_by = {"pod"};
+  EXPECT_NOT_OK(spec.RollupRelation(source_));
+
+  spec.group_by = {"service"};
+  spec.aggregates = {{Kind::kSum, "service", "service_sum"}};
+  EXPECT_NOT_OK(spec.RollupRelation(source_));
+
+  spec.aggregates = {{Kind::kSum, "latency", "service"}};
+  EXPECT_NOT_OK(spec.RollupRelation(source_));
+
+  spec.aggregates = {{Kind::kSum, "latency", "latency_sum"}};
+  EXPECT_OK(spec.RollupRelation(source_));
+  EXPECT_NOT_OK(spec.RollupRelation(Relation({types::STRING}, {"service"})));
+}
+
+}  // namespace schema
+}  // namespace table_store
+}  // namespace px
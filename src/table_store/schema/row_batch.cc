@@ -18,8 +18,11 @@
 
 #include <arrow/array.h>
 #include <algorithm>
+#include <functional>
 #include <memory>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include <absl/strings/str_format.h>
@@ -140,10 +143,11 @@ void CopyIntoOutputPB(table_store::schemapb::Column* output_column, arrow::Array
 
 template <DataType T>
 Status CopyFromInputPB(std::shared_ptr<arrow::Array>* output_column,
-                       const table_store::schemapb::Column& input_column) {
+                       const table_store::schemapb::Column& input_column,
+                       arrow::MemoryPool* mem_pool) {
   CHECK_NOTNULL(output_column);
 
-  auto builder = MakeArrowBuilder(T, arrow::default_memory_pool());
+  auto builder = MakeArrowBuilder(T, mem_pool);
   auto input_data = GetPBDataColumn<T>(input_column);
   PL_RETURN_IF_ERROR(builder->Reserve(input_data.data_size()));
 
@@ -158,6 +162,66 @@ Status CopyFromInputPB(std::shared_ptr<arrow::Array>* output_column,
   return Status::OK();
 }
 
+/**
+ * An arrow buffer over the values of a repeated proto field, which it owns. The field's memory is
+ * reported to reserve_fn, if given, for as long as the buffer holds it.
+ */
+template <typename TValue>
+class RepeatedFieldBuffer : public arrow::Buffer {
+ public:
+  RepeatedFieldBuffer(std::unique_ptr<google::protobuf::RepeatedField<TValue>> field,
+                      std::function<void(int64_t bytes)> reserve_fn)
+      : arrow::Buffer(reinterpret_cast<const uint8_t*>(field->data()),
+                      field->size() * sizeof(TValue)),
+        field_(std::move(field)),
+        reserve_fn_(std::move(reserve_fn)),
+        reserved_bytes_(field_->SpaceUsedExcludingSelfLong()) {
+    if (reserve_fn_) {
+      reserve_fn_(reserved_bytes_);
+    }
+  }
+  ~RepeatedFieldBuffer() override {
+    if (reserve_fn_) {
+      reserve_fn_(-reserved_bytes_);
+    }
+  }
+
+ private:
+  std::unique_ptr<google::protobuf::RepeatedField<TValue>> field_;
+  std::function<void(int64_t bytes)> reserve_fn_;
+  int64_t reserved_bytes_;
+};
+
+template <DataType T>
+inline constexpr bool kProtoLayoutMatchesArrow =
+    T == DataType::INT64 || T == DataType::TIME64NS || T == DataType::FLOAT64;
+
+// Moves the values of a fixed-width column out of the proto into an arrow array, or copies them
+// for the other types (whose proto layout differs from arrow's).
+template <DataType T>
+Status TakeFromInputPB(std::shared_ptr<arrow::Array>* output_column,
+                       table_store::schemapb::Column* input_column, arrow::MemoryPool* mem_pool,
+                       const std::function<void(int64_t bytes)>& reserve_fn) {
+  if constexpr (kProtoLayoutMatchesArrow<T>) {
+    auto input_data = GetMutablePBDataColumn<T>(input_column)->mutable_data();
+    if (input_data->empty()) {
+      return CopyFromInputPB<T>(output_column, *input_column, mem_pool);
+    }
+    using TValue = typename std::remove_pointer_t<decltype(input_data)>::value_type;
+    auto field = std::make_unique<google::protobuf::RepeatedField<TValue>>();
+    // Swapping only exchanges the pointers, unless the proto lives in an arena.
+    field->Swap(input_data);
+    int64_t length = field->size();
+    auto buffer = std::make_shared<RepeatedFieldBuffer<TValue>>(std::move(field), reserve_fn);
+    *output_column = arrow::MakeArray(arrow::ArrayData::Make(types::DataTypeToArrowType(T), length,
+                                                             {nullptr, std::move(buffer)},
+                                                             /*null_count*/ 0));
+    return Status::OK();
+  } else {
+    return CopyFromInputPB<T>(output_column, *input_column, mem_pool);
+  }
+}
+
 Status RowBatch::ToProto(table_store::schemapb::RowBatchData* proto) const {
   proto->set_num_rows(num_rows_);
   proto->set_eow(eow_);
@@ -198,7 +262,7 @@ StatusOr<DataType> ProtoDataType(const table_store::schemapb::Column& proto) {
 }
 
 StatusOr<std::unique_ptr<RowBatch>> RowBatch::FromProto(
-    const table_store::schemapb::RowBatchData& proto) {
+    const table_store::schemapb::RowBatchData& proto, arrow::MemoryPool* mem_pool) {
   std::vector<DataType> types(proto.cols_size());
   std::vector<std::shared_ptr<arrow::Array>> data_columns(proto.cols_size());
 
@@ -206,7 +270,8 @@ StatusOr<std::unique_ptr<RowBatch>> RowBatch::FromProto(
     PL_ASSIGN_OR_RETURN(types[i], ProtoDataType(proto.cols(i)));
     std::shared_ptr<arrow::Array> output_array;
 
-#define TYPE_CASE(_dt_) PL_RETURN_IF_ERROR(CopyFromInputPB<_dt_>(&data_columns[i], proto.cols(i)));
+#define TYPE_CASE(_dt_) \
+  PL_RETURN_IF_ERROR(CopyFromInputPB<_dt_>(&data_columns[i], proto.cols(i), mem_pool));
     PL_SWITCH_FOREACH_DATATYPE(types[i], TYPE_CASE);
 #undef TYPE_CASE
   }
@@ -223,6 +288,34 @@ StatusOr<std::unique_ptr<RowBatch>> RowBatch::FromProto(
   return output_rb;
 }
 
+StatusOr<std::unique_ptr<RowBatch>> RowBatch::FromMutableProto(
+    table_store::schemapb::RowBatchData* proto, arrow::MemoryPool* mem_pool,
+    std::function<void(int64_t bytes)> reserve_fn) {
+  std::vector<DataType> types(proto->cols_size());
+  std::vector<std::shared_ptr<arrow::Array>> data_columns(proto->cols_size());
+
+  for (auto i = 0; i < proto->cols_size(); ++i) {
+    PL_ASSIGN_OR_RETURN(types[i], ProtoDataType(proto->cols(i)));
+
+#define TYPE_CASE(_dt_)                                                                  \
+  PL_RETURN_IF_ERROR(                                                                    \
+      TakeFromInputPB<_dt_>(&data_columns[i], proto->mutable_cols(i), mem_pool, reserve_fn));
+    PL_SWITCH_FOREACH_DATATYPE(types[i], TYPE_CASE);
+#undef TYPE_CASE
+  }
+
+  RowDescriptor desc(types);
+  auto output_rb = std::make_unique<RowBatch>(desc, proto->num_rows());
+  output_rb->set_eow(proto->eow());
+  output_rb->set_eos(proto->eos());
+
+  for (auto i = 0; i < proto->cols_size(); ++i) {
+    PL_RETURN_IF_ERROR(output_rb->AddColumn(data_columns[i]));
+  }
+
+  return output_rb;
+}
+
 StatusOr<std::unique_ptr<RowBatch>> RowBatch::FromColumnBuilders(
     const RowDescriptor& desc, bool eow, bool eos,
     std::vector<std::unique_ptr<arrow::ArrayBuilder>>* builders) {
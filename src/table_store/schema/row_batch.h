@@ -19,7 +19,9 @@
 #pragma once
 
 #include <arrow/array.h>
+#include <arrow/memory_pool.h>
 #include <arrow/type.h>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -51,7 +53,20 @@ class RowBatch {
 
   Status ToProto(table_store::schemapb::RowBatchData* row_batch_proto) const;
   static StatusOr<std::unique_ptr<RowBatch>> FromProto(
-      const table_store::schemapb::RowBatchData& row_batch_proto);
+      const table_store::schemapb::RowBatchData& row_batch_proto,
+      arrow::MemoryPool* mem_pool = arrow::default_memory_pool());
+
+  /**
+   * Like FromProto, but takes the values of the fixed-width columns (INT64, TIME64NS and FLOAT64)
+   * out of the proto without copying them, so they are cleared from row_batch_proto. The other
+   * columns are copied into buffers allocated from mem_pool. Since the taken values aren't
+   * allocated from mem_pool, they are reported to reserve_fn instead, if given: with their size
+   * when they are taken, and with its negation once the batch's last reference to them is gone.
+   */
+  static StatusOr<std::unique_ptr<RowBatch>> FromMutableProto(
+      table_store::schemapb::RowBatchData* row_batch_proto,
+      arrow::MemoryPool* mem_pool = arrow::default_memory_pool(),
+      std::function<void(int64_t bytes)> reserve_fn = nullptr);
 
   static StatusOr<std::unique_ptr<RowBatch>> FromColumnBuilders(
       const RowDescriptor& desc, bool eow, bool eos,
@@ -179,6 +179,41 @@ TEST_F(RowBatchTest, to_from_proto) {
   EXPECT_TRUE(differ.Compare(input_proto, output_proto));
 }
 
+TEST_F(RowBatchTest, from_mutable_proto) {
+  table_store::schemapb::RowBatchData input_proto;
+  ASSERT_TRUE(google::protobuf::TextFormat::MergeFromString(kTestRowBatchProto, &input_proto));
+  table_store::schemapb::RowBatchData proto = input_proto;
+
+  ASSERT_OK_AND_ASSIGN(auto rb, RowBatch::FromMutableProto(&proto));
+  EXPECT_TRUE(rb->eow());
+  EXPECT_FALSE(rb->eos());
+  EXPECT_EQ(3, rb->num_rows());
+  // The int64 values were moved out of the proto, the others were copied.
+  EXPECT_EQ(0, proto.cols(1).int64_data().data_size());
+  EXPECT_EQ(3, proto.cols(2).string_data().data_size());
+
+  table_store::schemapb::RowBatchData output_proto;
+  EXPECT_OK(rb->ToProto(&output_proto));
+
+  google::protobuf::util::MessageDifferencer differ;
+  EXPECT_TRUE(differ.Compare(input_proto, output_proto));
+}
+
+TEST_F(RowBatchTest, from_mutable_proto_reserves_taken_values) {
+  table_store::schemapb::RowBatchData proto;
+  ASSERT_TRUE(google::protobuf::TextFormat::MergeFromString(kTestRowBatchProto, &proto));
+
+  int64_t reserved_bytes = 0;
+  {
+    ASSERT_OK_AND_ASSIGN(auto rb, RowBatch::FromMutableProto(
+                                      &proto, arrow::default_memory_pool(),
+                                      [&](int64_t bytes) { reserved_bytes += bytes; }));
+    // Only the int64 column is taken, the others are allocated from the pool.
+    EXPECT_GE(reserved_bytes, 3 * static_cast<int64_t>(sizeof(int64_t)));
+  }
+  EXPECT_EQ(0, reserved_bytes);
+}
+
 TEST_F(RowBatchTest, with_zero_rows) {
   bool eow = true;
   bool eos = false;
@@ -0,0 +1,163 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/table_store/table/compaction_pool.h"
+
+#include <absl/container/flat_hash_set.h>
+#include <absl/time/time.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace px {
+namespace table_store {
+
+namespace {
+// The weight of the latest ingest rate in the moving average.
+constexpr double kIngestRateAlpha = 0.5;
+}  // namespace
+
+void CompactionPool::SetTables(const std::vector<std::shared_ptr<Table>>& tables) {
+  absl::MutexLock lock(&lock_);
+  absl::flat_hash_set<const Table*> table_set;
+  for (const auto& table : tables) {
+    table_set.insert(table.get());
+    if (!tables_.contains(table.get())) {
+      TableState state;
+      state.table = table;
+      state.next_run = Clock::now();
+      tables_[table.get()] = std::move(state);
+    }
+  }
+  // A table that's being compacted when it's removed is dropped once its compaction is done.
+  for (auto it = tables_.begin(); it != tables_.end();) {
+    if (!table_set.contains(it->first)) {
+      tables_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+  cond_.SignalAll();
+}
+
+void CompactionPool::Start() {
+  {
+    absl::MutexLock lock(&lock_);
+    if (!stopped_) {
+      return;
+    }
+    stopped_ = false;
+  }
+  for (int64_t i = 0; i < options_.num_threads; ++i) {
+    threads_.emplace_back(&CompactionPool::RunWorker, this);
+  }
+}
+
+void CompactionPool::Stop() {
+  {
+    absl::MutexLock lock(&lock_);
+    stopped_ = true;
+    cond_.SignalAll();
+  }
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+  threads_.clear();
+}
+
+std::chrono::nanoseconds CompactionPool::TimeUntilNextCompaction(const Table* table) const {
+  absl::MutexLock lock(&lock_);
+  auto it = tables_.find(table);
+  if (it == tables_.end()) {
+    return std::chrono::nanoseconds(-1);
+  }
+  return std::max(std::chrono::nanoseconds(0), it->second.next_run - Clock::now());
+}
+
+void CompactionPool::RunWorker() {
+  lock_.Lock();
+  while (!stopped_) {
+    // Pick the table that's due the soonest, and that no other thread is compacting.
+    TableState* next = nullptr;
+    for (auto& [table, state] : tables_) {
+      if (!state.running && (next == nullptr || state.next_run < next->next_run)) {
+        next = &state;
+      }
+    }
+    auto now = Clock::now();
+    if (next == nullptr || next->next_run > now) {
+      auto wait = next == nullptr ? options_.max_period : next->next_run - now;
+      cond_.WaitWithTimeout(&lock_, absl::FromChrono(wait));
+      continue;
+    }
+
+    next->running = true;
+    std::shared_ptr<Table> table = next->table;
+    lock_.Unlock();
+
+    auto stats_before = table->GetTableStats();
+    auto status = table->CompactHotToCold(mem_pool_);
+    LOG_IF(ERROR, !status.ok()) << status.msg();
+    auto stats_after = table->GetTableStats();
+
+    lock_.Lock();
+    auto it = tables_.find(table.get());
+    if (it == tables_.end()) {
+      // The table was removed from the pool while it was being compacted.
+      continue;
+    }
+    it->second.running = false;
+    ScheduleNextRunLocked(&it->second, stats_before.hot_bytes, stats_after.hot_bytes, Clock::now());
+    cond_.SignalAll();
+  }
+  lock_.Unlock();
+}
+
+void CompactionPool::ScheduleNextRunLocked(TableState* state, int64_t hot_bytes_before,
+                                           int64_t hot_bytes_after, Clock::time_point now) {
+  if (state->last_run != Clock::time_point()) {
+    std::chrono::duration<double> elapsed = now - state->last_run;
+    if (elapsed.count() > 0) {
+      double rate =
+          std::max<int64_t>(0, hot_bytes_before - state->hot_bytes_after_run) / elapsed.count();
+      if (state->ingest_rate == 0) {
+        state->ingest_rate = rate;
+      } else {
+        state->ingest_rate = kIngestRateAlpha * rate + (1 - kIngestRateAlpha) * state->ingest_rate;
+      }
+    }
+  }
+  state->last_run = now;
+  state->hot_bytes_after_run = hot_bytes_after;
+
+  std::chrono::duration<double> min_period = options_.min_period;
+  std::chrono::duration<double> max_period = options_.max_period;
+  std::chrono::duration<double> period = max_period;
+  if (hot_bytes_after >= options_.target_hot_bytes) {
+    // The compaction was capped, so the table still has a backlog.
+    period = min_period;
+  } else if (state->ingest_rate > 0) {
+    period = std::chrono::duration<double>(
+        (options_.target_hot_bytes - hot_bytes_after) / state->ingest_rate);
+  }
+  period = std::clamp(period, min_period, max_period);
+  state->next_run = now + std::chrono::duration_cast<Clock::duration>(period);
+}
+
+}  // namespace table_store
+}  // namespace px
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/synchronization/mutex.h>
+#include <arrow/memory_pool.h>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "src/common/base/base.h"
+#include "src/table_store/table/table.h"
+
+namespace px {
+namespace table_store {
+
+/**
+ * CompactionPool compacts tables (see Table::CompactHotToCold) on a dedicated pool of threads, so
+ * that tables are compacted in parallel, and off the thread that owns the TableStore.
+ *
+ * Each table is compacted on its own cadence, which adapts to how fast data is written to it: the
+ * pool estimates each table's ingest rate from how much its hot data grew between two compactions,
+ * and schedules the next compaction for when the table should hold target_hot_bytes of hot data
+ * again, within [min_period, max_period]. A table that still holds more than that after a
+ * compaction (because compactions are capped at Table::kMaxBatchesPerCompactionCall batches) is
+ * compacted again after min_period.
+ */
+class CompactionPool : public NotCopyable {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Options {
+    int64_t num_threads = 2;
+    std::chrono::milliseconds min_period = std::chrono::milliseconds(100);
+    std::chrono::milliseconds max_period = std::chrono::minutes(1);
+    int64_t target_hot_bytes = 1024 * 1024;
+  };
+
+  CompactionPool(arrow::MemoryPool* mem_pool, Options options)
+      : mem_pool_(mem_pool), options_(options) {}
+  ~CompactionPool() { Stop(); }
+
+  /**
+   * Sets the tables to compact. The tables that are new to the pool are compacted right away, and
+   * the tables that are no longer passed in stop being compacted.
+   */
+  void SetTables(const std::vector<std::shared_ptr<Table>>& tables);
+
+  /**
+   * Starts the threads of the pool.
+   */
+  void Start();
+
+  /**
+   * Stops the threads of the pool, waiting for the compactions in progress to finish.
+   */
+  void Stop();
+
+  /**
+   * @return the time until the next compaction of the table, or -1 if the pool doesn't compact it.
+   */
+  std::chrono::nanoseconds TimeUntilNextCompaction(const Table* table) const;
+
+ private:
+  struct TableState {
+    std::shared_ptr<Table> table;
+    bool running = false;
+    Clock::time_point next_run;
+    // The hot bytes left by the last compaction and when it finished, to estimate the ingest rate.
+    Clock::time_point last_run;
+    int64_t hot_bytes_after_run = 0;
+    // A moving average of the bytes written to the table per second.
+    double ingest_rate = 0;
+  };
+
+  void RunWorker();
+  void ScheduleNextRunLocked(TableState* state, int64_t hot_bytes_before, int64_t hot_bytes_after,
+                             Clock::time_point now) ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  arrow::MemoryPool* mem_pool_;
+  const Options options_;
+
+  mutable absl::Mutex lock_;
+  // Signaled when the tables change or the pool stops.
+  absl::CondVar cond_;
+  bool stopped_ ABSL_GUARDED_BY(lock_) = true;
+  absl::flat_hash_map<const Table*, TableState> tables_ ABSL_GUARDED_BY(lock_);
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace table_store
+}  // namespace px
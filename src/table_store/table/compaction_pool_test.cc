@@ -0,0 +1,114 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "src/common/testing/testing.h"
+#include "src/table_store/table/compaction_pool.h"
+
+namespace px {
+namespace table_store {
+
+namespace {
+
+// The bytes of each batch written below.
+constexpr int64_t kBatchBytes = 4 * sizeof(int64_t);
+
+std::shared_ptr<Table> TestTable() {
+  schema::Relation rel({types::DataType::TIME64NS}, {"time_"});
+  // Every batch below is compacted into its own cold batch.
+  return std::make_shared<Table>(rel, 1024 * 1024, kBatchBytes);
+}
+
+void WriteBatch(Table* table) {
+  auto wrapper_batch = std::make_unique<types::ColumnWrapperRecordBatch>();
+  auto col_wrapper = std::make_shared<types::Time64NSValueColumnWrapper>(0);
+  col_wrapper->AppendFromVector(std::vector<types::Time64NSValue>{1, 2, 3, 4});
+  wrapper_batch->push_back(col_wrapper);
+  EXPECT_OK(table->TransferRecordBatch(std::move(wrapper_batch)));
+}
+
+// Polls until the condition holds, or fails after a few seconds.
+template <typename TCondition>
+void WaitFor(TCondition condition) {
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (!condition()) {
+    ASSERT_LT(std::chrono::steady_clock::now(), deadline);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+}  // namespace
+
+TEST(CompactionPoolTest, compacts_tables_in_background) {
+  CompactionPool::Options options;
+  options.num_threads = 2;
+  options.min_period = std::chrono::milliseconds(1);
+  options.max_period = std::chrono::milliseconds(10);
+  CompactionPool pool(arrow::default_memory_pool(), options);
+
+  std::vector<std::shared_ptr<Table>> tables{TestTable(), TestTable(), TestTable()};
+  pool.SetTables(tables);
+  pool.Start();
+  for (const auto& table : tables) {
+    WriteBatch(table.get());
+    WriteBatch(table.get());
+  }
+  WaitFor([&tables]() {
+    for (const auto& table : tables) {
+      if (table->GetTableStats().compacted_batches < 2) {
+        return false;
+      }
+    }
+    return true;
+  });
+  pool.Stop();
+
+  for (const auto& table : tables) {
+    auto stats = table->GetTableStats();
+    EXPECT_EQ(0, stats.hot_bytes);
+    EXPECT_EQ(0, stats.compaction_lag_ns);
+    EXPECT_EQ(2 * kBatchBytes, stats.cold_bytes);
+  }
+}
+
+TEST(CompactionPoolTest, idle_tables_wait_max_period) {
+  CompactionPool::Options options;
+  options.num_threads = 1;
+  options.min_period = std::chrono::milliseconds(1);
+  options.max_period = std::chrono::hours(1);
+  CompactionPool pool(arrow::default_memory_pool(), options);
+
+  auto table = TestTable();
+  pool.SetTables({table});
+  // New tables are compacted right away.
+  EXPECT_EQ(std::chrono::nanoseconds(0), pool.TimeUntilNextCompaction(table.get()));
+  pool.Start();
+  // Nothing is written to the table, so it's next compacted after the maximum period.
+  WaitFor([&]() { return pool.TimeUntilNextCompaction(table.get()) > std::chrono::minutes(30); });
+
+  pool.SetTables({});
+  EXPECT_EQ(std::chrono::nanoseconds(-1), pool.TimeUntilNextCompaction(table.get()));
+  pool.Stop();
+}
+
+}  // namespace table_store
+}  // namespace px
@@ -0,0 +1,293 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/table_store/table/rollup.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "src/shared/types/type_utils.h"
+
+namespace px {
+namespace table_store {
+
+using schema::RollupAggregate;
+
+namespace {
+
+constexpr char kTimeColumn[] = "time_";
+
+template <types::DataType DT>
+void AppendKeyValue(const types::ColumnWrapper& col, size_t row, std::string* key) {
+  using ValueType = typename types::DataTypeTraits<DT>::value_type;
+  ValueType val = col.GetNoTypeCheck<ValueType>(row);
+  if constexpr (DT == types::DataType::STRING) {
+    // Strings are prefixed with their size, so that consecutive values can't run into each other.
+    uint64_t size = val.size();
+    key->append(reinterpret_cast<const char*>(&size), sizeof(size));
+    key->append(val);
+  } else {
+    key->append(reinterpret_cast<const char*>(&val.val), sizeof(val.val));
+  }
+}
+
+template <types::DataType DT>
+void AppendValue(const types::ColumnWrapper& src, size_t row, types::ColumnWrapper* dst) {
+  using ValueType = typename types::DataTypeTraits<DT>::value_type;
+  dst->AppendNoTypeCheck<ValueType>(src.GetNoTypeCheck<ValueType>(row));
+}
+
+int64_t GetIntValue(const types::ColumnWrapper& col, size_t row) {
+  if (col.data_type() == types::DataType::TIME64NS) {
+    return col.GetNoTypeCheck<types::Time64NSValue>(row).val;
+  }
+  return col.GetNoTypeCheck<types::Int64Value>(row).val;
+}
+
+}  // namespace
+
+StatusOr<std::unique_ptr<Rollup>> Rollup::Create(const schema::RollupSpec& spec,
+                                                 const schema::Relation& source_relation) {
+  PL_ASSIGN_OR_RETURN(schema::Relation relation, spec.RollupRelation(source_relation));
+
+  std::vector<int64_t> group_col_idxs;
+  for (const auto& col : spec.group_by) {
+    group_col_idxs.push_back(source_relation.GetColumnIndex(col));
+  }
+  std::vector<AggregateInfo> aggregates;
+  for (const auto& agg : spec.aggregates) {
+    aggregates.push_back({agg.kind, source_relation.GetColumnIndex(agg.input_column),
+                          source_relation.GetColumnType(agg.input_column),
+                          relation.GetColumnType(agg.output_column)});
+  }
+  return std::unique_ptr<Rollup>(new Rollup(spec, std::move(relation),
+                                            source_relation.GetColumnIndex(kTimeColumn),
+                                            std::move(group_col_idxs), std::move(aggregates)));
+}
+
+Rollup::Rollup(const schema::RollupSpec& spec, schema::Relation relation, int64_t time_col_idx,
+               std::vector<int64_t> group_col_idxs, std::vector<AggregateInfo> aggregates)
+    : spec_(spec),
+      relation_(std::move(relation)),
+      time_col_idx_(time_col_idx),
+      group_col_idxs_(std::move(group_col_idxs)),
+      aggregates_(std::move(aggregates)) {
+  // The group columns follow the time column in the rollup relation.
+  for (size_t i = 0; i < group_col_idxs_.size(); ++i) {
+    group_values_.push_back(types::ColumnWrapper::Make(relation_.GetColumnType(i + 1), 0));
+  }
+}
+
+Rollup::Group* Rollup::FindOrAddGroup(const types::ColumnWrapperRecordBatch& record_batch,
+                                      size_t row, int64_t bucket) {
+  key_buffer_.assign(reinterpret_cast<const char*>(&bucket), sizeof(bucket));
+  for (int64_t col_idx : group_col_idxs_) {
+    const auto& col = *record_batch[col_idx];
+#define TYPE_CASE(_dt_) AppendKeyValue<_dt_>(col, row, &key_buffer_)
+    PL_SWITCH_FOREACH_DATATYPE(col.data_type(), TYPE_CASE);
+#undef TYPE_CASE
+  }
+
+  auto [it, inserted] = groups_index_.try_emplace(key_buffer_, groups_.size());
+  if (!inserted) {
+    return &groups_[it->second];
+  }
+
+  Group group{key_buffer_, bucket, std::vector<AggregateValue>(aggregates_.size())};
+  for (const auto& [i, agg] : Enumerate(aggregates_)) {
+    bool is_float = agg.output_type == types::DataType::FLOAT64;
+    switch (agg.kind) {
+      case RollupAggregate::Kind::kCount:
+      case RollupAggregate::Kind::kSum:
+        if (is_float) {
+          group.values[i].float_val = 0;
+        } else {
+          group.values[i].int_val = 0;
+        }
+        break;
+      case RollupAggregate::Kind::kMin:
+        if (is_float) {
+          group.values[i].float_val = std::numeric_limits<double>::infinity();
+        } else {
+          group.values[i].int_val = std::numeric_limits<int64_t>::max();
+        }
+        break;
+      case RollupAggregate::Kind::kMax:
+        if (is_float) {
+          group.values[i].float_val = -std::numeric_limits<double>::infinity();
+        } else {
+          group.values[i].int_val = std::numeric_limits<int64_t>::min();
+        }
+        break;
+    }
+  }
+  groups_.push_back(std::move(group));
+
+  for (const auto& [i, col_idx] : Enumerate(group_col_idxs_)) {
+    const auto& col = *record_batch[col_idx];
+#define TYPE_CASE(_dt_) AppendValue<_dt_>(col, row, group_values_[i].get())
+    PL_SWITCH_FOREACH_DATATYPE(col.data_type(), TYPE_CASE);
+#undef TYPE_CASE
+  }
+  return &groups_.back();
+}
+
+void Rollup::UpdateAggregates(const types::ColumnWrapperRecordBatch& record_batch, size_t row,
+                              Group* group) {
+  for (const auto& [i, agg] : Enumerate(aggregates_)) {
+    AggregateValue& value = group->values[i];
+    if (agg.kind == RollupAggregate::Kind::kCount) {
+      ++value.int_val;
+      continue;
+    }
+    const auto& col = *record_batch[agg.input_col_idx];
+    if (agg.input_type == types::DataType::FLOAT64) {
+      double val = col.GetNoTypeCheck<types::Float64Value>(row).val;
+      switch (agg.kind) {
+        case RollupAggregate::Kind::kSum:
+          value.float_val += val;
+          break;
+        case RollupAggregate::Kind::kMin:
+          value.float_val = std::min(value.float_val, val);
+          break;
+        case RollupAggregate::Kind::kMax:
+          value.float_val = std::max(value.float_val, val);
+          break;
+        default:
+          break;
+      }
+      continue;
+    }
+    int64_t val = GetIntValue(col, row);
+    switch (agg.kind) {
+      case RollupAggregate::Kind::kSum:
+        value.int_val += val;
+        break;
+      case RollupAggregate::Kind::kMin:
+        value.int_val = std::min(value.int_val, val);
+        break;
+      case RollupAggregate::Kind::kMax:
+        value.int_val = std::max(value.int_val, val);
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+Status Rollup::Update(const types::ColumnWrapperRecordBatch& record_batch) {
+  const auto& time_col = record_batch.at(time_col_idx_);
+  if (time_col->data_type() != types::DataType::TIME64NS) {
+    return error::Internal("Column $0 of the source of rollup $1 is not a time column.",
+                           time_col_idx_, spec_.name);
+  }
+  const auto& times = static_cast<const types::Time64NSValueColumnWrapper&>(*time_col);
+  for (size_t row = 0; row < times.Size(); ++row) {
+    int64_t time = times[row].val;
+    // Round down, including for times before the epoch.
+    int64_t bucket = time - ((time % spec_.bucket_ns) + spec_.bucket_ns) % spec_.bucket_ns;
+    if (bucket < flushed_before_bucket_) {
+      ++late_rows_dropped_;
+      continue;
+    }
+    latest_bucket_ = std::max(latest_bucket_, bucket);
+    UpdateAggregates(record_batch, row, FindOrAddGroup(record_batch, row, bucket));
+  }
+  return Status::OK();
+}
+
+std::unique_ptr<types::ColumnWrapperRecordBatch> Rollup::Flush(bool all) {
+  if (all) {
+    return FlushBefore(latest_bucket_ == std::numeric_limits<int64_t>::min() ? latest_bucket_
+                                                                             : latest_bucket_ + 1);
+  }
+  return FlushBefore(latest_bucket_);
+}
+
+std::unique_ptr<types::ColumnWrapperRecordBatch> Rollup::FlushEndedBefore(int64_t time_ns) {
+  // A bucket has ended by time_ns if it starts at or before time_ns - bucket_ns.
+  int64_t ended_before_bucket = time_ns - spec_.bucket_ns + 1;
+  return FlushBefore(std::max(latest_bucket_, ended_before_bucket));
+}
+
+std::unique_ptr<types::ColumnWrapperRecordBatch> Rollup::FlushBefore(int64_t bucket) {
+  flushed_before_bucket_ = std::max(flushed_before_bucket_, bucket);
+  std::vector<size_t> flushed;
+  std::vector<size_t> kept;
+  for (const auto& [i, group] : Enumerate(groups_)) {
+    if (group.bucket < bucket) {
+      flushed.push_back(i);
+    } else {
+      kept.push_back(i);
+    }
+  }
+  if (flushed.empty()) {
+    return nullptr;
+  }
+  // The groups are in the order they were first seen, which isn't the order of their buckets when
+  // rows arrive out of order.
+  std::stable_sort(flushed.begin(), flushed.end(),
+                   [this](size_t a, size_t b) { return groups_[a].bucket < groups_[b].bucket; });
+
+  auto record_batch = std::make_unique<types::ColumnWrapperRecordBatch>();
+  auto time_col = types::ColumnWrapper::Make(types::DataType::TIME64NS, 0);
+  time_col->Reserve(flushed.size());
+  for (size_t idx : flushed) {
+    time_col->Append<types::Time64NSValue>(groups_[idx].bucket);
+  }
+  record_batch->push_back(std::move(time_col));
+  for (const auto& col : group_values_) {
+    record_batch->push_back(col->CopyIndexes(flushed));
+  }
+  for (const auto& [i, agg] : Enumerate(aggregates_)) {
+    auto col = types::ColumnWrapper::Make(agg.output_type, 0);
+    col->Reserve(flushed.size());
+    for (size_t idx : flushed) {
+      const AggregateValue& value = groups_[idx].values[i];
+      switch (agg.output_type) {
+        case types::DataType::FLOAT64:
+          col->Append<types::Float64Value>(value.float_val);
+          break;
+        case types::DataType::TIME64NS:
+          col->Append<types::Time64NSValue>(value.int_val);
+          break;
+        default:
+          col->Append<types::Int64Value>(value.int_val);
+          break;
+      }
+    }
+    record_batch->push_back(std::move(col));
+  }
+
+  // Keep the open groups, with their values, at the front.
+  std::vector<Group> kept_groups;
+  kept_groups.reserve(kept.size());
+  groups_index_.clear();
+  for (size_t idx : kept) {
+    groups_index_[groups_[idx].key] = kept_groups.size();
+    kept_groups.push_back(std::move(groups_[idx]));
+  }
+  groups_ = std::move(kept_groups);
+  for (auto& col : group_values_) {
+    col = col->MoveIndexes(kept);
+  }
+  return record_batch;
+}
+
+}  // namespace table_store
+}  // namespace px
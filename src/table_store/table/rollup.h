@@ -0,0 +1,131 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <absl/container/flat_hash_map.h>
+
+#include "src/common/base/base.h"
+#include "src/shared/types/column_wrapper.h"
+#include "src/table_store/schema/relation.h"
+#include "src/table_store/schema/rollup_spec.h"
+
+namespace px {
+namespace table_store {
+
+/**
+ * Rollup incrementally aggregates the rows appended to a table, as declared by a RollupSpec.
+ *
+ * The rows are aggregated by time bucket and group. Once a newer bucket is seen, or a bucket has
+ * ended long enough ago (see FlushEndedBefore), the groups of the older buckets are complete and
+ * are flushed as rows of the rollup table, ordered by bucket. Rows that arrive late for a bucket
+ * that was flushed already are dropped, so that the time column of the rollup table stays sorted,
+ * as the table's time index requires.
+ *
+ * Not thread-safe: the table store updates rollups from the thread that appends the data.
+ */
+class Rollup : public NotCopyable {
+ public:
+  static StatusOr<std::unique_ptr<Rollup>> Create(const schema::RollupSpec& spec,
+                                                  const schema::Relation& source_relation);
+
+  const schema::RollupSpec& spec() const { return spec_; }
+  const schema::Relation& relation() const { return relation_; }
+
+  /**
+   * Aggregates the rows of a record batch of the source table.
+   */
+  Status Update(const types::ColumnWrapperRecordBatch& record_batch);
+
+  /**
+   * @brief Removes the complete groups, or all the groups if all is set, and returns them as a
+   * record batch of the rollup table. Once all the groups are flushed, the rows of the buckets
+   * seen so far are dropped, so all is meant for when the rollup is done, e.g. at shutdown.
+   *
+   * @return the rows of the flushed groups, or nullptr if there were none.
+   */
+  std::unique_ptr<types::ColumnWrapperRecordBatch> Flush(bool all = false);
+
+  /**
+   * @brief Like Flush(), but also flushes the groups of the buckets that ended at or before
+   * time_ns, even if no newer bucket was seen.
+   */
+  std::unique_ptr<types::ColumnWrapperRecordBatch> FlushEndedBefore(int64_t time_ns);
+
+  size_t num_open_groups() const { return groups_.size(); }
+  // The rows that were dropped because their bucket was flushed already.
+  int64_t late_rows_dropped() const { return late_rows_dropped_; }
+
+ private:
+  struct AggregateInfo {
+    schema::RollupAggregate::Kind kind;
+    int64_t input_col_idx;
+    types::DataType input_type;
+    types::DataType output_type;
+  };
+
+  // The value of one aggregate of a group, an int64 or a float64 depending on the output type.
+  union AggregateValue {
+    int64_t int_val;
+    double float_val;
+  };
+
+  struct Group {
+    // The encoded bucket and group columns, which key groups_index_.
+    std::string key;
+    int64_t bucket;
+    std::vector<AggregateValue> values;
+  };
+
+  Rollup(const schema::RollupSpec& spec, schema::Relation relation, int64_t time_col_idx,
+         std::vector<int64_t> group_col_idxs, std::vector<AggregateInfo> aggregates);
+
+  Group* FindOrAddGroup(const types::ColumnWrapperRecordBatch& record_batch, size_t row,
+                        int64_t bucket);
+  void UpdateAggregates(const types::ColumnWrapperRecordBatch& record_batch, size_t row,
+                        Group* group);
+  // Flushes the groups of the buckets before the given one.
+  std::unique_ptr<types::ColumnWrapperRecordBatch> FlushBefore(int64_t bucket);
+
+  const schema::RollupSpec spec_;
+  const schema::Relation relation_;
+  const int64_t time_col_idx_;
+  const std::vector<int64_t> group_col_idxs_;
+  const std::vector<AggregateInfo> aggregates_;
+
+  // The open groups, and their index in groups_ by key. The values of the group columns of the
+  // i-th group are the i-th values of group_values_.
+  std::vector<Group> groups_;
+  absl::flat_hash_map<std::string, size_t> groups_index_;
+  types::ColumnWrapperRecordBatch group_values_;
+  // The latest bucket seen: the groups of the older buckets are complete.
+  int64_t latest_bucket_ = std::numeric_limits<int64_t>::min();
+  // The buckets before this one were flushed, and their late rows are dropped.
+  int64_t flushed_before_bucket_ = std::numeric_limits<int64_t>::min();
+  int64_t late_rows_dropped_ = 0;
+  // Reused to encode the group keys.
+  std::string key_buffer_;
+};
+
+}  // namespace table_store
+}  // namespace px
@@ -0,0 +1,173 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "src/common/testing/testing.h"
+#include "src/table_store/table/rollup.h"
+
+namespace px {
+namespace table_store {
+
+using schema::RollupAggregate;
+using types::ColumnWrapperRecordBatch;
+
+class RollupTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    schema::RollupSpec spec{"rollup",
+                            "source",
+                            {"service"},
+                            100,
+                            {{RollupAggregate::Kind::kCount, "latency", "count"},
+                             {RollupAggregate::Kind::kSum, "latency", "latency_sum"},
+                             {RollupAggregate::Kind::kMax, "latency", "latency_max"},
+                             {RollupAggregate::Kind::kMin, "value", "value_min"}},
+                            1024};
+    ASSERT_OK_AND_ASSIGN(rollup_, Rollup::Create(spec, source_));
+  }
+
+  std::unique_ptr<ColumnWrapperRecordBatch> MakeBatch(std::vector<types::Time64NSValue> times,
+                                                      std::vector<types::StringValue> services,
+                                                      std::vector<types::Int64Value> latencies,
+                                                      std::vector<types::Float64Value> values) {
+    auto batch = std::make_unique<ColumnWrapperRecordBatch>();
+    auto time_col = std::make_shared<types::Time64NSValueColumnWrapper>(0);
+    time_col->AppendFromVector(times);
+    auto service_col = std::make_shared<types::StringValueColumnWrapper>(0);
+    service_col->AppendFromVector(services);
+    auto latency_col = std::make_shared<types::Int64ValueColumnWrapper>(0);
+    latency_col->AppendFromVector(latencies);
+    auto value_col = std::make_shared<types::Float64ValueColumnWrapper>(0);
+    value_col->AppendFromVector(values);
+    batch->push_back(time_col);
+    batch->push_back(service_col);
+    batch->push_back(latency_col);
+    batch->push_back(value_col);
+    return batch;
+  }
+
+  template <typename TValueType>
+  static std::vector<TValueType> Values(const types::ColumnWrapper& col) {
+    std::vector<TValueType> values;
+    for (size_t i = 0; i < col.Size(); ++i) {
+      values.push_back(col.Get<TValueType>(i));
+    }
+    return values;
+  }
+
+  schema::Relation source_{
+      {types::TIME64NS, types::STRING, types::INT64, types::FLOAT64},
+      {"time_", "service", "latency", "value"},
+  };
+  std::unique_ptr<Rollup> rollup_;
+};
+
+TEST_F(RollupTest, relation) {
+  EXPECT_EQ(schema::Relation(
+                {types::TIME64NS, types::STRING, types::INT64, types::INT64, types::INT64,
+                 types::FLOAT64},
+                {"time_", "service", "count", "latency_sum", "latency_max", "value_min"}),
+            rollup_->relation());
+}
+
+TEST_F(RollupTest, flushes_complete_buckets) {
+  ASSERT_OK(rollup_->Update(*MakeBatch({10, 20, 50, 90}, {"a", "b", "a", "a"}, {1, 2, 3, 4},
+                                       {1.5, 2.5, 0.5, 3.5})));
+  EXPECT_EQ(2, rollup_->num_open_groups());
+  // The latest bucket might still get rows.
+  EXPECT_EQ(nullptr, rollup_->Flush());
+
+  ASSERT_OK(rollup_->Update(*MakeBatch({110, 150}, {"a", "b"}, {5, 6}, {1.0, 2.0})));
+  auto batch = rollup_->Flush();
+  ASSERT_NE(nullptr, batch);
+  ASSERT_EQ(6, batch->size());
+  EXPECT_THAT(Values<types::Time64NSValue>(*batch->at(0)), ::testing::ElementsAre(0, 0));
+  EXPECT_THAT(Values<types::StringValue>(*batch->at(1)), ::testing::ElementsAre("a", "b"));
+  EXPECT_THAT(Values<types::Int64Value>(*batch->at(2)), ::testing::ElementsAre(3, 1));
+  EXPECT_THAT(Values<types::Int64Value>(*batch->at(3)), ::testing::ElementsAre(8, 2));
+  EXPECT_THAT(Values<types::Int64Value>(*batch->at(4)), ::testing::ElementsAre(4, 2));
+  EXPECT_THAT(Values<types::Float64Value>(*batch->at(5)), ::testing::ElementsAre(0.5, 2.5));
+  EXPECT_EQ(2, rollup_->num_open_groups());
+
+  batch = rollup_->Flush(/*all*/ true);
+  ASSERT_NE(nullptr, batch);
+  EXPECT_THAT(Values<types::Time64NSValue>(*batch->at(0)), ::testing::ElementsAre(100, 100));
+  EXPECT_THAT(Values<types::StringValue>(*batch->at(1)), ::testing::ElementsAre("a", "b"));
+  EXPECT_THAT(Values<types::Int64Value>(*batch->at(2)), ::testing::ElementsAre(1, 1));
+  EXPECT_EQ(0, rollup_->num_open_groups());
+}
+
+TEST_F(RollupTest, late_rows_of_flushed_buckets_are_dropped) {
+  ASSERT_OK(rollup_->Update(*MakeBatch({10, 110}, {"a", "a"}, {1, 2}, {1.0, 1.0})));
+  ASSERT_NE(nullptr, rollup_->Flush());
+
+  // The bucket of the late row was flushed already.
+  ASSERT_OK(rollup_->Update(*MakeBatch({20}, {"a"}, {3}, {1.0})));
+  EXPECT_EQ(nullptr, rollup_->Flush());
+  EXPECT_EQ(1, rollup_->late_rows_dropped());
+  EXPECT_EQ(1, rollup_->num_open_groups());
+}
+
+TEST_F(RollupTest, flushes_out_of_order_rows_by_bucket) {
+  // The groups are first seen newest bucket first.
+  ASSERT_OK(rollup_->Update(
+      *MakeBatch({250, 130, 20, 140, 30}, {"a", "a", "b", "a", "a"}, {1, 2, 3, 4, 5},
+                 {1.0, 1.0, 1.0, 1.0, 1.0})));
+  auto batch = rollup_->Flush();
+  ASSERT_NE(nullptr, batch);
+  EXPECT_THAT(Values<types::Time64NSValue>(*batch->at(0)), ::testing::ElementsAre(0, 0, 100));
+  EXPECT_THAT(Values<types::StringValue>(*batch->at(1)), ::testing::ElementsAre("b", "a", "a"));
+  EXPECT_THAT(Values<types::Int64Value>(*batch->at(3)), ::testing::ElementsAre(3, 5, 6));
+
+  // Late rows for the flushed buckets are dropped, rows for the open bucket still count.
+  ASSERT_OK(rollup_->Update(
+      *MakeBatch({50, 210, 199}, {"a", "a", "b"}, {1, 2, 3}, {1.0, 1.0, 1.0})));
+  EXPECT_EQ(2, rollup_->late_rows_dropped());
+  batch = rollup_->Flush(/*all*/ true);
+  ASSERT_NE(nullptr, batch);
+  EXPECT_THAT(Values<types::Time64NSValue>(*batch->at(0)), ::testing::ElementsAre(200));
+  EXPECT_THAT(Values<types::Int64Value>(*batch->at(2)), ::testing::ElementsAre(2));
+}
+
+TEST_F(RollupTest, flushes_ended_buckets) {
+  ASSERT_OK(rollup_->Update(*MakeBatch({110, 120}, {"a", "a"}, {1, 2}, {1.0, 1.0})));
+  // The bucket is the latest one, and hasn't ended yet.
+  EXPECT_EQ(nullptr, rollup_->FlushEndedBefore(199));
+  auto batch = rollup_->FlushEndedBefore(200);
+  ASSERT_NE(nullptr, batch);
+  EXPECT_THAT(Values<types::Time64NSValue>(*batch->at(0)), ::testing::ElementsAre(100));
+  EXPECT_THAT(Values<types::Int64Value>(*batch->at(2)), ::testing::ElementsAre(2));
+
+  // The bucket was written, so its late rows are dropped.
+  ASSERT_OK(rollup_->Update(*MakeBatch({150, 210}, {"a", "a"}, {3, 4}, {1.0, 1.0})));
+  EXPECT_EQ(1, rollup_->late_rows_dropped());
+  EXPECT_EQ(1, rollup_->num_open_groups());
+}
+
+TEST_F(RollupTest, invalid_spec) {
+  schema::RollupSpec spec{"rollup", "source", {"pod"}, 100, {}, 1024};
+  EXPECT_NOT_OK(Rollup::Create(spec, source_));
+}
+
+}  // namespace table_store
+}  // namespace px
@@ -0,0 +1,380 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/table_store/table/spill_store.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <system_error>
+
+#include <arrow/buffer.h>
+#include <absl/strings/str_format.h>
+#include "src/common/fs/fs_wrapper.h"
+#include "src/shared/types/type_utils.h"
+
+namespace px {
+namespace table_store {
+
+namespace {
+
+constexpr char kSegmentMagic[8] = {'P', 'X', 'S', 'P', 'I', 'L', 'L', '\0'};
+constexpr uint32_t kSegmentVersion = 1;
+constexpr char kTempFileExtension[] = ".tmp";
+// Arrow arrays have at most a validity bitmap, an offsets buffer and a data buffer.
+constexpr size_t kMaxColumnBuffers = 3;
+
+struct SegmentHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t num_columns;
+  int64_t first_row_id;
+  int64_t last_row_id;
+  int64_t first_time;
+  int64_t last_time;
+};
+
+struct BufferLocation {
+  // The offset of the buffer in the file, or -1 if the array doesn't have this buffer.
+  int64_t offset;
+  int64_t size;
+};
+
+struct ColumnHeader {
+  int32_t data_type;
+  uint32_t num_buffers;
+  int64_t length;
+  int64_t null_count;
+  int64_t array_offset;
+  BufferLocation buffers[kMaxColumnBuffers];
+};
+
+/**
+ * An arrow buffer over a read-only memory mapping, which is unmapped when the buffer is destroyed.
+ */
+class MappedBuffer : public arrow::Buffer {
+ public:
+  MappedBuffer(const uint8_t* data, int64_t size) : arrow::Buffer(data, size) {}
+  ~MappedBuffer() override { munmap(const_cast<uint8_t*>(data()), size()); }
+};
+
+int64_t AlignUp(int64_t offset) {
+  constexpr int64_t kAlignment = SpillSegment::kBufferAlignment;
+  return (offset + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+std::filesystem::path SegmentPath(const std::filesystem::path& dir, int64_t first_row_id) {
+  // Zero-padded so that the segment files sort in the order of their rows.
+  return dir / absl::StrFormat("%020d%s", first_row_id, SpillSegment::kFileExtension);
+}
+
+Status SyncFile(const std::filesystem::path& path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return error::System("Failed to open spill segment $0. Message: $1", path.string(),
+                         std::strerror(errno));
+  }
+  int ret = fsync(fd);
+  int fsync_errno = errno;
+  close(fd);
+  if (ret != 0) {
+    return error::System("Failed to sync spill segment $0. Message: $1", path.string(),
+                         std::strerror(fsync_errno));
+  }
+  return Status::OK();
+}
+
+}  // namespace
+
+StatusOr<std::unique_ptr<SpillSegment>> SpillSegment::Write(
+    const std::filesystem::path& dir, const schema::Relation& relation,
+    const std::vector<ArrowArrayPtr>& columns, RowIDInterval row_ids, TimeInterval time) {
+  if (columns.size() != relation.NumColumns()) {
+    return error::InvalidArgument("Expected $0 columns to spill, got $1.", relation.NumColumns(),
+                                  columns.size());
+  }
+  int64_t num_rows = row_ids.second - row_ids.first + 1;
+
+  SegmentHeader header;
+  std::memcpy(header.magic, kSegmentMagic, sizeof(kSegmentMagic));
+  header.version = kSegmentVersion;
+  header.num_columns = columns.size();
+  header.first_row_id = row_ids.first;
+  header.last_row_id = row_ids.second;
+  header.first_time = time.first;
+  header.last_time = time.second;
+
+  std::vector<ColumnHeader> column_headers(columns.size());
+  int64_t offset = sizeof(SegmentHeader) + columns.size() * sizeof(ColumnHeader);
+  for (const auto& [col_idx, col] : Enumerate(columns)) {
+    const auto& buffers = col->data()->buffers;
+    if (col->length() != num_rows) {
+      return error::InvalidArgument("Column $0 has $1 rows, expected $2.", col_idx, col->length(),
+                                    num_rows);
+    }
+    if (buffers.size() > kMaxColumnBuffers) {
+      return error::Unimplemented("Column $0 has $1 buffers, spilling supports at most $2.",
+                                  col_idx, buffers.size(), kMaxColumnBuffers);
+    }
+    ColumnHeader& col_header = column_headers[col_idx];
+    col_header.data_type = relation.GetColumnType(col_idx);
+    col_header.num_buffers = buffers.size();
+    col_header.length = col->length();
+    col_header.null_count = col->null_count();
+    col_header.array_offset = col->offset();
+    for (const auto& [buf_idx, buf] : Enumerate(buffers)) {
+      if (buf == nullptr) {
+        col_header.buffers[buf_idx] = {-1, 0};
+        continue;
+      }
+      offset = AlignUp(offset);
+      col_header.buffers[buf_idx] = {offset, buf->size()};
+      offset += buf->size();
+    }
+  }
+
+  // The segment is written to a temporary file first, so that a crash mid-write never leaves a
+  // partial segment to be reattached.
+  auto path = SegmentPath(dir, row_ids.first);
+  auto tmp_path = path;
+  tmp_path += kTempFileExtension;
+  {
+    std::ofstream ofs(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!ofs) {
+      return error::System("Failed to open spill segment $0.", tmp_path.string());
+    }
+    ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    ofs.write(reinterpret_cast<const char*>(column_headers.data()),
+              column_headers.size() * sizeof(ColumnHeader));
+    int64_t pos = sizeof(SegmentHeader) + columns.size() * sizeof(ColumnHeader);
+    static constexpr char kPadding[kBufferAlignment] = {};
+    for (const auto& [col_idx, col] : Enumerate(columns)) {
+      for (const auto& [buf_idx, buf] : Enumerate(col->data()->buffers)) {
+        if (buf == nullptr) {
+          continue;
+        }
+        const BufferLocation& location = column_headers[col_idx].buffers[buf_idx];
+        ofs.write(kPadding, location.offset - pos);
+        ofs.write(reinterpret_cast<const char*>(buf->data()), buf->size());
+        pos = location.offset + buf->size();
+      }
+    }
+    ofs.close();
+    if (!ofs) {
+      std::error_code ec;
+      std::filesystem::remove(tmp_path, ec);
+      return error::System("Failed to write spill segment $0.", tmp_path.string());
+    }
+  }
+  // The data must be on disk before the rename makes the segment visible, or a crash could leave a
+  // complete-looking segment with missing data.
+  Status sync_status = SyncFile(tmp_path);
+  if (!sync_status.ok()) {
+    std::error_code ec;
+    std::filesystem::remove(tmp_path, ec);
+    return sync_status;
+  }
+  std::error_code ec;
+  std::filesystem::rename(tmp_path, path, ec);
+  if (ec) {
+    std::filesystem::remove(tmp_path, ec);
+    return error::System("Failed to rename spill segment $0. Message: $1", tmp_path.string(),
+                         ec.message());
+  }
+  return Load(path, relation);
+}
+
+StatusOr<std::unique_ptr<SpillSegment>> SpillSegment::Load(const std::filesystem::path& path,
+                                                           const schema::Relation& relation) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return error::System("Failed to open spill segment $0. Message: $1", path.string(),
+                         std::strerror(errno));
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    return error::System("Failed to stat spill segment $0. Message: $1", path.string(),
+                         std::strerror(errno));
+  }
+  int64_t file_size = st.st_size;
+  if (file_size < static_cast<int64_t>(sizeof(SegmentHeader))) {
+    close(fd);
+    return error::InvalidArgument("Spill segment $0 is truncated.", path.string());
+  }
+  void* addr = mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+  // The mapping holds its own reference to the file.
+  close(fd);
+  if (addr == MAP_FAILED) {
+    return error::System("Failed to map spill segment $0. Message: $1", path.string(),
+                         std::strerror(errno));
+  }
+  auto mapping = std::make_shared<MappedBuffer>(static_cast<const uint8_t*>(addr), file_size);
+
+  SegmentHeader header;
+  std::memcpy(&header, mapping->data(), sizeof(header));
+  if (std::memcmp(header.magic, kSegmentMagic, sizeof(kSegmentMagic)) != 0 ||
+      header.version != kSegmentVersion) {
+    return error::InvalidArgument("$0 is not a spill segment of version $1.", path.string(),
+                                  kSegmentVersion);
+  }
+  if (header.num_columns != relation.NumColumns()) {
+    return error::InvalidArgument("Spill segment $0 has $1 columns, expected $2.", path.string(),
+                                  header.num_columns, relation.NumColumns());
+  }
+  int64_t headers_size = sizeof(SegmentHeader) + header.num_columns * sizeof(ColumnHeader);
+  if (file_size < headers_size) {
+    return error::InvalidArgument("Spill segment $0 is truncated.", path.string());
+  }
+
+  auto segment = std::unique_ptr<SpillSegment>(new SpillSegment());
+  segment->path_ = path;
+  segment->row_ids_ = {header.first_row_id, header.last_row_id};
+  segment->time_ = {header.first_time, header.last_time};
+  segment->bytes_ = file_size;
+  for (size_t col_idx = 0; col_idx < header.num_columns; ++col_idx) {
+    ColumnHeader col_header;
+    std::memcpy(&col_header,
+                mapping->data() + sizeof(SegmentHeader) + col_idx * sizeof(ColumnHeader),
+                sizeof(col_header));
+    auto data_type = relation.GetColumnType(col_idx);
+    if (col_header.data_type != data_type) {
+      return error::InvalidArgument("Spill segment $0 has type $1 for column $2, expected $3.",
+                                    path.string(), col_header.data_type, col_idx,
+                                    types::ToString(data_type));
+    }
+    if (col_header.num_buffers > kMaxColumnBuffers ||
+        col_header.length != segment->num_rows()) {
+      return error::InvalidArgument("Spill segment $0 has an invalid header for column $1.",
+                                    path.string(), col_idx);
+    }
+    std::vector<std::shared_ptr<arrow::Buffer>> buffers;
+    for (size_t buf_idx = 0; buf_idx < col_header.num_buffers; ++buf_idx) {
+      const BufferLocation& location = col_header.buffers[buf_idx];
+      if (location.offset == -1) {
+        buffers.push_back(nullptr);
+        continue;
+      }
+      if (location.offset < headers_size || location.size < 0 ||
+          location.offset + location.size > file_size) {
+        return error::InvalidArgument("Spill segment $0 is truncated.", path.string());
+      }
+      buffers.push_back(arrow::SliceBuffer(mapping, location.offset, location.size));
+    }
+    auto array = arrow::MakeArray(
+        arrow::ArrayData::Make(types::DataTypeToArrowType(data_type), col_header.length,
+                               std::move(buffers), col_header.null_count,
+                               col_header.array_offset));
+    // The buffers are only checked to be in the file. Their contents, eg. the string offsets,
+    // could still point anywhere, so they're checked before the arrays are read.
+    auto validate_status = array->ValidateFull();
+    if (!validate_status.ok()) {
+      return error::InvalidArgument("Spill segment $0 has an invalid column $1: $2", path.string(),
+                                    col_idx, validate_status.ToString());
+    }
+    segment->columns_.push_back(std::move(array));
+  }
+  return segment;
+}
+
+StatusOr<std::unique_ptr<SpillStore>> SpillStore::Open(const std::filesystem::path& dir,
+                                                       const schema::Relation& relation,
+                                                       int64_t max_bytes) {
+  PL_RETURN_IF_ERROR(fs::CreateDirectories(dir));
+  auto store = std::unique_ptr<SpillStore>(new SpillStore(dir, max_bytes));
+
+  std::vector<std::filesystem::path> paths;
+  std::error_code ec;
+  for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+    const auto& path = entry.path();
+    if (path.extension() == SpillSegment::kFileExtension) {
+      paths.push_back(path);
+    } else if (path.extension() == kTempFileExtension) {
+      // Left behind by a write that didn't finish.
+      PL_RETURN_IF_ERROR(fs::Remove(path));
+    }
+  }
+  if (ec) {
+    return error::System("Failed to list spill directory $0. Message: $1", dir.string(),
+                         ec.message());
+  }
+  std::sort(paths.begin(), paths.end());
+
+  for (const auto& path : paths) {
+    auto segment_or_s = SpillSegment::Load(path, relation);
+    if (!segment_or_s.ok()) {
+      LOG(WARNING) << absl::Substitute("Removing spill segment $0: $1", path.string(),
+                                       segment_or_s.status().msg());
+      PL_RETURN_IF_ERROR(fs::Remove(path));
+      continue;
+    }
+    auto segment = segment_or_s.ConsumeValueOrDie();
+    if (!store->row_ids_.empty() && segment->row_ids().first <= store->row_ids_.back().second) {
+      LOG(WARNING) << absl::Substitute("Removing spill segment $0, which overlaps $1.",
+                                       path.string(), store->segments_.back()->path().string());
+      PL_RETURN_IF_ERROR(fs::Remove(path));
+      continue;
+    }
+    store->Append(std::move(segment));
+  }
+  store->ExpireSegments();
+  return store;
+}
+
+Status SpillStore::Add(std::unique_ptr<SpillSegment> segment) {
+  if (!row_ids_.empty() && segment->row_ids().first <= row_ids_.back().second) {
+    return error::InvalidArgument(
+        "Spill segment starting at row $0 doesn't come after the last spilled row $1.",
+        segment->row_ids().first, row_ids_.back().second);
+  }
+  Append(std::move(segment));
+  ExpireSegments();
+  return Status::OK();
+}
+
+void SpillStore::Append(std::unique_ptr<SpillSegment> segment) {
+  row_ids_.push_back(segment->row_ids());
+  time_.PushBack(segment->time().first, segment->time().second);
+  bytes_ += segment->bytes();
+  segments_.push_back(std::move(segment));
+}
+
+void SpillStore::ExpireSegments() {
+  while (bytes_ > max_bytes_ && !segments_.empty()) {
+    // Queries still reading the segment keep its mapping, so the file can be removed right away.
+    // The segment is expired even if its file can't be removed, so that the store stays within its
+    // size. A file left behind is expired again when the store is next opened.
+    auto s = fs::Remove(segments_.front()->path());
+    LOG_IF(WARNING, !s.ok()) << absl::Substitute("Failed to remove spill segment $0: $1",
+                                                 segments_.front()->path().string(), s.msg());
+    bytes_ -= segments_.front()->bytes();
+    segments_.pop_front();
+    row_ids_.pop_front();
+    time_.PopFront();
+    ++segments_expired_;
+  }
+}
+
+}  // namespace table_store
+}  // namespace px
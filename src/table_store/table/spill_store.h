@@ -0,0 +1,148 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <arrow/array.h>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "src/common/base/base.h"
+#include "src/table_store/schema/relation.h"
+#include "src/table_store/table/time_index.h"
+
+namespace px {
+namespace table_store {
+
+/**
+ * SpillSegment is a batch of a table's rows that was written to disk. The segment file is
+ * memory-mapped and its columns are arrow arrays over the mapping, so reading a segment doesn't
+ * copy it into memory, and the mapping stays valid for as long as any of its arrays is referenced
+ * (even if the segment has since been expired and its file removed).
+ *
+ * The segment file holds a header with the row identifiers and the time range of the batch, then a
+ * header per column with the location of each of its arrow buffers, then the buffers themselves,
+ * each aligned to kBufferAlignment so that they can be used in place.
+ */
+class SpillSegment : public NotCopyable {
+ public:
+  using ArrowArrayPtr = std::shared_ptr<arrow::Array>;
+  using RowIDInterval = std::pair<int64_t, int64_t>;
+  using TimeInterval = std::pair<int64_t, int64_t>;
+
+  static constexpr char kFileExtension[] = ".seg";
+  static constexpr int64_t kBufferAlignment = 64;
+
+  /**
+   * Writes the given columns to a new segment file in dir, and maps it.
+   * @param dir the directory to write the segment to.
+   * @param relation the relation of the columns.
+   * @param columns the arrow arrays of the batch, one per column of the relation.
+   * @param row_ids the unique identifiers of the first and last rows of the batch.
+   * @param time the first and last timestamps of the batch, or {-1, -1} if it has no time column.
+   */
+  static StatusOr<std::unique_ptr<SpillSegment>> Write(const std::filesystem::path& dir,
+                                                       const schema::Relation& relation,
+                                                       const std::vector<ArrowArrayPtr>& columns,
+                                                       RowIDInterval row_ids, TimeInterval time);
+
+  /**
+   * Maps an existing segment file, checking that it holds valid columns of the given relation.
+   */
+  static StatusOr<std::unique_ptr<SpillSegment>> Load(const std::filesystem::path& path,
+                                                      const schema::Relation& relation);
+
+  const std::filesystem::path& path() const { return path_; }
+  const std::vector<ArrowArrayPtr>& columns() const { return columns_; }
+  RowIDInterval row_ids() const { return row_ids_; }
+  TimeInterval time() const { return time_; }
+  int64_t num_rows() const { return row_ids_.second - row_ids_.first + 1; }
+  // The size of the segment file.
+  int64_t bytes() const { return bytes_; }
+
+ private:
+  SpillSegment() = default;
+
+  std::filesystem::path path_;
+  std::vector<ArrowArrayPtr> columns_;
+  RowIDInterval row_ids_;
+  TimeInterval time_;
+  int64_t bytes_ = 0;
+};
+
+/**
+ * SpillStore is the on-disk tier of a Table: the batches that are expired from the table's cold
+ * storage are added to it as segments (see SpillSegment), oldest first, and the oldest segments
+ * are removed once the store holds more than its maximum number of bytes. Since the segments are
+ * files, a store opened on the directory of a previous run reattaches the segments it left.
+ *
+ * SpillStore is not thread-safe; Table synchronizes access to it.
+ */
+class SpillStore : public NotCopyable {
+ public:
+  using RowIDInterval = SpillSegment::RowIDInterval;
+  using TimeInterval = SpillSegment::TimeInterval;
+
+  /**
+   * Opens the store in the given directory, creating the directory if needed. The segments already
+   * in the directory are reattached, except for those that don't match the relation (e.g. if the
+   * table's schema changed since they were written), which are removed.
+   */
+  static StatusOr<std::unique_ptr<SpillStore>> Open(const std::filesystem::path& dir,
+                                                    const schema::Relation& relation,
+                                                    int64_t max_bytes);
+
+  const std::filesystem::path& dir() const { return dir_; }
+
+  /**
+   * Adds a segment written to dir() by SpillSegment::Write, then removes the oldest segments until
+   * the store fits in its maximum number of bytes. The segment must hold rows after those of all
+   * the segments in the store. On error, the store is left unchanged.
+   */
+  Status Add(std::unique_ptr<SpillSegment> segment);
+
+  int64_t NumSegments() const { return segments_.size(); }
+  const SpillSegment& segment(int64_t index) const { return *segments_[index]; }
+  const std::deque<RowIDInterval>& row_ids() const { return row_ids_; }
+  const TimeIndex& time() const { return time_; }
+  int64_t bytes() const { return bytes_; }
+  int64_t segments_expired() const { return segments_expired_; }
+
+ private:
+  SpillStore(std::filesystem::path dir, int64_t max_bytes)
+      : dir_(std::move(dir)), max_bytes_(max_bytes) {}
+
+  void Append(std::unique_ptr<SpillSegment> segment);
+  void ExpireSegments();
+
+  const std::filesystem::path dir_;
+  const int64_t max_bytes_;
+
+  std::deque<std::unique_ptr<SpillSegment>> segments_;
+  // The row identifiers and time ranges of the segments, kept separately for binary searches.
+  std::deque<RowIDInterval> row_ids_;
+  TimeIndex time_;
+  int64_t bytes_ = 0;
+  int64_t segments_expired_ = 0;
+};
+
+}  // namespace table_store
+}  // namespace px
@@ -0,0 +1,204 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <arrow/array.h>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/common/testing/temp_dir.h"
+#include "src/common/testing/testing.h"
+#include "src/shared/types/arrow_adapter.h"
+#include "src/table_store/table/spill_store.h"
+
+namespace px {
+namespace table_store {
+
+namespace {
+
+schema::Relation TestRelation() {
+  return schema::Relation(
+      {types::DataType::TIME64NS, types::DataType::STRING, types::DataType::BOOLEAN},
+      {"time_", "name", "ok"});
+}
+
+std::vector<std::shared_ptr<arrow::Array>> TestColumns(
+    const std::vector<types::Time64NSValue>& time, const std::vector<types::StringValue>& name,
+    const std::vector<types::BoolValue>& ok) {
+  return {types::ToArrow(time, arrow::default_memory_pool()),
+          types::ToArrow(name, arrow::default_memory_pool()),
+          types::ToArrow(ok, arrow::default_memory_pool())};
+}
+
+}  // namespace
+
+TEST(SpillStoreTest, write_and_load_segment) {
+  px::testing::TempDir dir;
+  auto columns = TestColumns({1, 2, 3}, {"a", "bb", ""}, {true, false, true});
+  ASSERT_OK_AND_ASSIGN(auto segment,
+                       SpillSegment::Write(dir.path(), TestRelation(), columns, {10, 12}, {1, 3}));
+  EXPECT_EQ(segment->row_ids(), std::make_pair(int64_t{10}, int64_t{12}));
+  EXPECT_EQ(segment->time(), std::make_pair(int64_t{1}, int64_t{3}));
+  EXPECT_EQ(segment->num_rows(), 3);
+  EXPECT_EQ(segment->bytes(), std::filesystem::file_size(segment->path()));
+  ASSERT_EQ(segment->columns().size(), 3);
+  for (size_t i = 0; i < columns.size(); ++i) {
+    EXPECT_TRUE(segment->columns()[i]->Equals(columns[i]));
+  }
+
+  ASSERT_OK_AND_ASSIGN(auto loaded, SpillSegment::Load(segment->path(), TestRelation()));
+  EXPECT_EQ(loaded->row_ids(), segment->row_ids());
+  for (size_t i = 0; i < columns.size(); ++i) {
+    EXPECT_TRUE(loaded->columns()[i]->Equals(columns[i]));
+  }
+}
+
+TEST(SpillStoreTest, columns_outlive_segment) {
+  px::testing::TempDir dir;
+  auto columns = TestColumns({1, 2}, {"abc", "def"}, {true, true});
+  std::shared_ptr<arrow::Array> name_col;
+  {
+    ASSERT_OK_AND_ASSIGN(auto segment,
+                         SpillSegment::Write(dir.path(), TestRelation(), columns, {0, 1}, {1, 2}));
+    name_col = segment->columns()[1];
+    std::filesystem::remove(segment->path());
+  }
+  EXPECT_TRUE(name_col->Equals(columns[1]));
+}
+
+TEST(SpillStoreTest, load_rejects_other_relation) {
+  px::testing::TempDir dir;
+  auto columns = TestColumns({1}, {"a"}, {true});
+  ASSERT_OK_AND_ASSIGN(auto segment,
+                       SpillSegment::Write(dir.path(), TestRelation(), columns, {0, 0}, {1, 1}));
+
+  schema::Relation other_types(
+      {types::DataType::TIME64NS, types::DataType::INT64, types::DataType::BOOLEAN},
+      {"time_", "name", "ok"});
+  EXPECT_NOT_OK(SpillSegment::Load(segment->path(), other_types));
+  schema::Relation fewer_columns({types::DataType::TIME64NS}, {"time_"});
+  EXPECT_NOT_OK(SpillSegment::Load(segment->path(), fewer_columns));
+}
+
+TEST(SpillStoreTest, load_rejects_invalid_columns) {
+  px::testing::TempDir dir;
+  auto columns = TestColumns({100, 200}, {"a", "bb"}, {true, false});
+  std::filesystem::path path;
+  {
+    ASSERT_OK_AND_ASSIGN(auto segment, SpillSegment::Write(dir.path(), TestRelation(), columns,
+                                                           {10, 11}, {100, 200}));
+    path = segment->path();
+  }
+
+  // Point the last string offset past the end of the string data.
+  std::string contents;
+  {
+    std::ifstream ifs(path, std::ios::binary);
+    contents.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+  }
+  const std::string offsets("\x00\x00\x00\x00\x01\x00\x00\x00\x03\x00\x00\x00", 12);
+  auto pos = contents.find(offsets);
+  ASSERT_NE(std::string::npos, pos);
+  contents[pos + 8] = 0x7f;
+  {
+    std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+    ofs.write(contents.data(), contents.size());
+  }
+
+  EXPECT_NOT_OK(SpillSegment::Load(path, TestRelation()));
+  // The store skips and removes the segment, rather than failing to open.
+  ASSERT_OK_AND_ASSIGN(auto store, SpillStore::Open(dir.path(), TestRelation(), 1024 * 1024));
+  EXPECT_EQ(store->NumSegments(), 0);
+  EXPECT_FALSE(std::filesystem::exists(path));
+}
+
+TEST(SpillStoreTest, reopen_reattaches_segments) {
+  px::testing::TempDir dir;
+  {
+    ASSERT_OK_AND_ASSIGN(auto store, SpillStore::Open(dir.path(), TestRelation(), 1024 * 1024));
+    ASSERT_OK_AND_ASSIGN(auto segment0,
+                         SpillSegment::Write(dir.path(), TestRelation(),
+                                             TestColumns({1, 2}, {"a", "b"}, {true, false}),
+                                             {0, 1}, {1, 2}));
+    ASSERT_OK(store->Add(std::move(segment0)));
+    ASSERT_OK_AND_ASSIGN(auto segment1,
+                         SpillSegment::Write(dir.path(), TestRelation(),
+                                             TestColumns({3}, {"c"}, {true}), {2, 2}, {3, 3}));
+    ASSERT_OK(store->Add(std::move(segment1)));
+    // Segments must be added in the order of their rows.
+    ASSERT_OK_AND_ASSIGN(auto old_segment,
+                         SpillSegment::Write(dir.path(), TestRelation(),
+                                             TestColumns({0}, {"z"}, {true}), {1, 1}, {0, 0}));
+    EXPECT_NOT_OK(store->Add(std::move(old_segment)));
+  }
+
+  // A write that didn't finish is cleaned up.
+  auto tmp_path = dir.path() / "00000000000000000003.seg.tmp";
+  { std::ofstream ofs(tmp_path); }
+
+  ASSERT_OK_AND_ASSIGN(auto store, SpillStore::Open(dir.path(), TestRelation(), 1024 * 1024));
+  ASSERT_EQ(store->NumSegments(), 2);
+  EXPECT_EQ(store->row_ids()[0], std::make_pair(int64_t{0}, int64_t{1}));
+  EXPECT_EQ(store->row_ids()[1], std::make_pair(int64_t{2}, int64_t{2}));
+  EXPECT_EQ(store->time()[1], std::make_pair(int64_t{3}, int64_t{3}));
+  EXPECT_TRUE(store->segment(1).columns()[1]->Equals(
+      types::ToArrow(std::vector<types::StringValue>{"c"}, arrow::default_memory_pool())));
+  EXPECT_FALSE(std::filesystem::exists(tmp_path));
+
+  // Segments of another schema are removed.
+  schema::Relation other_relation({types::DataType::TIME64NS}, {"time_"});
+  ASSERT_OK_AND_ASSIGN(auto other_store, SpillStore::Open(dir.path(), other_relation, 1024));
+  EXPECT_EQ(other_store->NumSegments(), 0);
+  EXPECT_TRUE(std::filesystem::is_empty(dir.path()));
+}
+
+TEST(SpillStoreTest, expires_oldest_segments) {
+  px::testing::TempDir dir;
+  std::vector<std::filesystem::path> paths;
+  int64_t segment_bytes = 0;
+  {
+    ASSERT_OK_AND_ASSIGN(auto segment,
+                         SpillSegment::Write(dir.path(), TestRelation(),
+                                             TestColumns({1}, {"a"}, {true}), {0, 0}, {1, 1}));
+    segment_bytes = segment->bytes();
+    std::filesystem::remove(segment->path());
+  }
+
+  // Fits two segments.
+  ASSERT_OK_AND_ASSIGN(auto store,
+                       SpillStore::Open(dir.path(), TestRelation(), 2 * segment_bytes + 1));
+  for (int64_t i = 0; i < 3; ++i) {
+    ASSERT_OK_AND_ASSIGN(auto segment,
+                         SpillSegment::Write(dir.path(), TestRelation(),
+                                             TestColumns({i}, {"a"}, {true}), {i, i}, {i, i}));
+    paths.push_back(segment->path());
+    ASSERT_OK(store->Add(std::move(segment)));
+  }
+  EXPECT_EQ(store->NumSegments(), 2);
+  EXPECT_EQ(store->segments_expired(), 1);
+  EXPECT_EQ(store->bytes(), 2 * segment_bytes);
+  EXPECT_EQ(store->row_ids().front(), std::make_pair(int64_t{1}, int64_t{1}));
+  EXPECT_FALSE(std::filesystem::exists(paths[0]));
+  EXPECT_TRUE(std::filesystem::exists(paths[1]));
+}
+
+}  // namespace table_store
+}  // namespace px
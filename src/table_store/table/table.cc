@@ -17,11 +17,13 @@
  */
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstddef>
 #include <iterator>
 #include <memory>
 #include <string>
+#include <system_error>
 #include <variant>
 #include <vector>
 
@@ -228,65 +230,66 @@ static inline bool IntervalComparatorLowerBound(const std::pair<int64_t, int64_t
   return interval.second < val;
 }
 
-static inline bool IntervalComparatorUpperBound(int64_t val,
-                                                const std::pair<int64_t, int64_t> interval) {
-  return val < interval.first;
+static inline int64_t ArrowTimeLowerBound(const arrow::Array* time_col, int64_t time) {
+  auto arr = static_cast<const arrow::Time64Array*>(time_col);
+  return TimeLowerBound(arr->raw_values(), arr->length(), time);
+}
+
+static inline int64_t ArrowTimeUpperBound(const arrow::Array* time_col, int64_t time) {
+  auto arr = static_cast<const arrow::Time64Array*>(time_col);
+  return TimeUpperBound(arr->raw_values(), arr->length(), time);
 }
 
 StatusOr<BatchSlice> Table::FindBatchSliceGreaterThanOrEqual(int64_t time,
-                                                             arrow::MemoryPool* mem_pool) const {
+                                                             arrow::MemoryPool*) const {
   if (time_col_idx_ == -1) {
     return error::InvalidArgument(
         "Cannot call FindBatchSliceGreaterThanOrEqual on table without a time column.");
   }
   absl::MutexLock gen_lock(&generation_lock_);
+  {
+    absl::MutexLock spill_lock(&spill_lock_);
+    if (spill_store_ != nullptr) {
+      auto index = spill_store_->time().FindFirstEndingAtOrAfter(time);
+      if (index != spill_store_->time().size()) {
+        const auto& segment = spill_store_->segment(index);
+        auto row_offset = ArrowTimeLowerBound(segment.columns()[time_col_idx_].get(), time);
+        return BatchSlice::Spilled(index, row_offset, segment.num_rows() - 1, generation_,
+                                   segment.row_ids().first + row_offset, segment.row_ids().second);
+      }
+    }
+  }
   {
     absl::MutexLock cold_lock(&cold_lock_);
-    auto it =
-        std::lower_bound(cold_time_.begin(), cold_time_.end(), time, IntervalComparatorLowerBound);
-    if (it != cold_time_.end()) {
-      auto index = std::distance(cold_time_.begin(), it);
+    auto index = cold_time_.FindFirstEndingAtOrAfter(time);
+    if (index != cold_time_.size()) {
       auto ring_index = RingIndexUnlocked(index);
-      auto time_col = cold_column_buffers_[time_col_idx_][ring_index];
-      auto row_offset = types::SearchArrowArrayGreaterThanOrEqual<types::DataType::TIME64NS>(
-          time_col.get(), time);
+      auto row_offset =
+          ArrowTimeLowerBound(cold_column_buffers_[time_col_idx_][ring_index].get(), time);
       auto row_ids = cold_row_ids_[index];
-      return BatchSlice::Cold(ring_index, row_offset, time_col->length() - 1, generation_,
-                              row_ids.first + row_offset, row_ids.second);
+      return BatchSlice::Cold(ring_index, row_offset, ColdBatchLengthUnlocked(ring_index) - 1,
+                              generation_, row_ids.first + row_offset, row_ids.second);
     }
   }
   // If the time wasn't found in the cold batches, we look in the hot batches.
   absl::MutexLock hot_lock(&hot_lock_);
-  auto it =
-      std::lower_bound(hot_time_.begin(), hot_time_.end(), time, IntervalComparatorLowerBound);
-  if (it == hot_time_.end()) {
+  auto index = hot_time_.FindFirstEndingAtOrAfter(time);
+  if (index == hot_time_.size()) {
     return BatchSlice::Invalid();
   }
-  auto index = std::distance(hot_time_.begin(), it);
-
-  ArrowArrayPtr time_col;
-  if (std::holds_alternative<RecordBatchWithCache>(hot_batches_[index])) {
-    auto record_batch_ptr = std::get_if<RecordBatchWithCache>(&hot_batches_[index]);
-    time_col = GetHotColumnUnlocked(record_batch_ptr, time_col_idx_, mem_pool);
-  } else {
-    auto row_batch = std::get<schema::RowBatch>(hot_batches_[index]);
-    time_col = row_batch.columns().at(time_col_idx_);
-  }
-
-  auto row_offset =
-      types::SearchArrowArrayGreaterThanOrEqual<types::DataType::TIME64NS>(time_col.get(), time);
+  auto row_offset = HotTimeLowerBoundUnlocked(index, time);
   auto row_ids = hot_row_ids_[index];
-  return BatchSlice::Hot(index, row_offset, time_col->length() - 1, generation_,
+  return BatchSlice::Hot(index, row_offset, HotBatchLengthUnlocked(index) - 1, generation_,
                          row_ids.first + row_offset, row_ids.second);
 }
 
 StatusOr<Table::StopPosition> Table::FindStopPositionForTime(int64_t time,
-                                                             arrow::MemoryPool* mem_pool) const {
+                                                             arrow::MemoryPool*) const {
   if (time_col_idx_ == -1) {
     return error::InvalidArgument(
         "Cannot call FindStopPositionForTime on table without a time column.");
   }
-  auto stop = FindStopTime(time, mem_pool);
+  auto stop = FindStopTime(time);
   if (stop == -1) {
     // If all the data is after the stop time then we return the first unique row identifier in the
     // table, which will cause no results to be returned.
@@ -300,6 +303,20 @@ schema::Relation Table::GetRelation() const { return rel_; }
 TableStats Table::GetTableStats() const {
   TableStats info;
   auto num_batches = NumBatches();
+  {
+    absl::MutexLock hot_lock(&hot_lock_);
+    info.compaction_lag_ns =
+        hot_write_times_.empty()
+            ? 0
+            : std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  std::chrono::steady_clock::now() - hot_write_times_.front())
+                  .count();
+  }
+  {
+    absl::MutexLock spill_lock(&spill_lock_);
+    info.spilled_bytes = spill_store_ == nullptr ? 0 : spill_store_->bytes();
+    info.spilled_batches = spill_store_ == nullptr ? 0 : spill_store_->NumSegments();
+  }
   absl::base_internal::SpinLockHolder lock(&stats_lock_);
 
   info.batches_added = batches_added_;
@@ -307,6 +324,7 @@ TableStats Table::GetTableStats() const {
   info.num_batches = num_batches;
   info.bytes = hot_bytes_ + cold_bytes_;
   info.cold_bytes = cold_bytes_;
+  info.hot_bytes = hot_bytes_;
   info.compacted_batches = compacted_batches_;
   info.max_table_size = max_table_size_;
 
@@ -319,11 +337,12 @@ Status Table::UpdateTimeRowIndices(types::ColumnWrapperRecordBatch* record_batch
   if (time_col_idx_ != -1) {
     auto first_time = record_batch->at(time_col_idx_)->Get<types::Time64NSValue>(0);
     auto last_time = record_batch->at(time_col_idx_)->Get<types::Time64NSValue>(batch_length - 1);
-    hot_time_.emplace_back(first_time.val, last_time.val);
+    hot_time_.PushBack(first_time.val, last_time.val);
   }
   auto first_row_id = next_row_id_;
   next_row_id_ += batch_length;
   hot_row_ids_.emplace_back(first_row_id, next_row_id_ - 1);
+  hot_write_times_.push_back(std::chrono::steady_clock::now());
   return Status::OK();
 }
 
@@ -347,11 +366,12 @@ Status Table::UpdateTimeRowIndices(const schema::RowBatch& rb) {
     auto first_time = types::GetValueFromArrowArray<types::DataType::TIME64NS>(time_col.get(), 0);
     auto last_time =
         types::GetValueFromArrowArray<types::DataType::TIME64NS>(time_col.get(), batch_length - 1);
-    hot_time_.emplace_back(first_time, last_time);
+    hot_time_.PushBack(first_time, last_time);
   }
   auto first_row_id = next_row_id_;
   next_row_id_ += batch_length;
   hot_row_ids_.emplace_back(first_row_id, next_row_id_ - 1);
+  hot_write_times_.push_back(std::chrono::steady_clock::now());
   return Status::OK();
 }
 
@@ -403,6 +423,7 @@ Status Table::CompactSingleBatch(arrow::MemoryPool* mem_pool) {
 
       it = hot_batches_.erase(it);
       hot_row_ids_.pop_front();
+      hot_write_times_.pop_front();
 
       if (time_col_idx_ != -1) {
         auto times = hot_time_.front();
@@ -410,7 +431,7 @@ Status Table::CompactSingleBatch(arrow::MemoryPool* mem_pool) {
           first_time = times.first;
         }
         last_time = times.second;
-        hot_time_.pop_front();
+        hot_time_.PopFront();
       }
     }
   }
@@ -423,7 +444,7 @@ Status Table::CompactSingleBatch(arrow::MemoryPool* mem_pool) {
     }
     cold_row_ids_.emplace_back(first_row_id, last_row_id);
     if (time_col_idx_ != -1) {
-      cold_time_.emplace_back(first_time, last_time);
+      cold_time_.PushBack(first_time, last_time);
     }
   }
   {
@@ -450,16 +471,105 @@ Status Table::CompactHotToCold(arrow::MemoryPool* mem_pool) {
   return Status::OK();
 }
 
+Status Table::EnableSpill(const std::filesystem::path& dir, int64_t max_spill_bytes) {
+  absl::MutexLock gen_lock(&generation_lock_);
+  absl::MutexLock spill_lock(&spill_lock_);
+  absl::MutexLock hot_lock(&hot_lock_);
+  if (spill_store_ != nullptr) {
+    return error::AlreadyExists("Spilling is already enabled for the table.");
+  }
+  if (next_row_id_ != 0) {
+    return error::FailedPrecondition(
+        "Spilling must be enabled before any data is written to the table.");
+  }
+  PL_ASSIGN_OR_RETURN(spill_store_, SpillStore::Open(dir, rel_, max_spill_bytes));
+  if (spill_store_->NumSegments() > 0) {
+    // New rows continue after the rows of the reattached segments.
+    next_row_id_ = spill_store_->row_ids().back().second + 1;
+  }
+  spill_dir_ = dir;
+  generation_++;
+  return Status::OK();
+}
+
+Status Table::SpillAll(arrow::MemoryPool* mem_pool) {
+  if (spill_dir_.empty()) {
+    return error::FailedPrecondition("Spilling is not enabled for the table.");
+  }
+  // Cold batches are spilled first, then each hot batch is compacted and spilled in turn, so the
+  // ring buffer never fills up.
+  while (true) {
+    PL_ASSIGN_OR_RETURN(bool spilled, ExpireCold());
+    if (spilled) {
+      continue;
+    }
+    {
+      absl::MutexLock hot_lock(&hot_lock_);
+      if (hot_batches_.empty()) {
+        return Status::OK();
+      }
+    }
+    PL_RETURN_IF_ERROR(CompactSingleBatch(mem_pool));
+  }
+}
+
 StatusOr<bool> Table::ExpireCold() {
+  // When spilling, the batch is written to disk before it's removed from cold storage, so that its
+  // rows stay readable throughout. The write happens without holding the generation lock, which
+  // is fine since only ExpireCold removes cold batches and it is only called by the writer.
+  // If the batch can't be spilled (e.g. the disk is full), it is expired without spilling it, so
+  // that a failing disk never stops the table from taking new data.
+  std::unique_ptr<SpillSegment> segment;
+  if (!spill_dir_.empty()) {
+    std::vector<ArrowArrayPtr> columns;
+    RowIDInterval row_ids;
+    TimeInterval time{-1, -1};
+    {
+      absl::MutexLock cold_lock(&cold_lock_);
+      if (RingSizeUnlocked() == 0) {
+        return false;
+      }
+      for (size_t col_idx = 0; col_idx < rel_.NumColumns(); col_idx++) {
+        columns.push_back(cold_column_buffers_[col_idx][ring_front_idx_]);
+      }
+      row_ids = cold_row_ids_.front();
+      if (time_col_idx_ != -1) time = cold_time_.front();
+    }
+    auto segment_or_s = SpillSegment::Write(spill_dir_, rel_, columns, row_ids, time);
+    if (segment_or_s.ok()) {
+      segment = segment_or_s.ConsumeValueOrDie();
+    } else {
+      LOG_EVERY_N(WARNING, 100) << absl::Substitute(
+          "Failed to spill rows $0 to $1, expiring them without spilling: $2", row_ids.first,
+          row_ids.second, segment_or_s.status().msg());
+    }
+  }
+
   int64_t rb_bytes = 0;
   {
     absl::MutexLock gen_lock(&generation_lock_);
+    absl::MutexLock spill_lock(&spill_lock_);
     absl::MutexLock cold_lock(&cold_lock_);
     if (RingSizeUnlocked() == 0) {
       return false;
     }
+    if (segment != nullptr) {
+      // Add either adds the segment or leaves the store unchanged, in which case its file is
+      // removed so that it isn't reattached after a restart either.
+      auto path = segment->path();
+      Status s = segment->row_ids() == cold_row_ids_.front()
+                     ? spill_store_->Add(std::move(segment))
+                     : error::Internal("Cold batch was expired while it was being spilled.");
+      if (!s.ok()) {
+        LOG_EVERY_N(WARNING, 100) << absl::Substitute(
+            "Failed to spill rows $0 to $1, expiring them without spilling: $2",
+            cold_row_ids_.front().first, cold_row_ids_.front().second, s.msg());
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+      }
+    }
     cold_row_ids_.pop_front();
-    if (time_col_idx_ != -1) cold_time_.pop_front();
+    if (time_col_idx_ != -1) cold_time_.PopFront();
 
     for (size_t col_idx = 0; col_idx < rel_.NumColumns(); col_idx++) {
 #define TYPE_CASE(_dt_) \
@@ -490,8 +600,9 @@ Status Table::ExpireHot() {
     if (hot_batches_.size() == 0) {
       return error::InvalidArgument("Failed to expire row batch, no row batches in table");
     }
-    if (time_col_idx_ != -1) hot_time_.pop_front();
+    if (time_col_idx_ != -1) hot_time_.PopFront();
     hot_row_ids_.pop_front();
+    hot_write_times_.pop_front();
     record_or_row_batch = std::move(hot_batches_.front());
     hot_batches_.pop_front();
     // Expire the first hot batch invalidates all hot indices, so we have to increase the
@@ -535,6 +646,16 @@ Status Table::AddBatchSliceToRowBatch(const BatchSlice& slice, const std::vector
   absl::MutexLock gen_lock(&generation_lock_);
   PL_RETURN_IF_ERROR(UpdateSliceUnlocked(slice));
   // After this point, as long as gen_lock is held, the unsafe properties of slice are valid.
+  if (slice.unsafe_is_spilled) {
+    absl::MutexLock spill_lock(&spill_lock_);
+    const auto& columns = spill_store_->segment(slice.unsafe_batch_index).columns();
+    for (auto col_idx : cols) {
+      auto arr = columns[col_idx]->Slice(slice.unsafe_row_start,
+                                         slice.unsafe_row_end + 1 - slice.unsafe_row_start);
+      PL_RETURN_IF_ERROR(output_rb->AddColumn(arr));
+    }
+    return Status::OK();
+  }
   if (!slice.unsafe_is_hot) {
     absl::MutexLock cold_lock(&cold_lock_);
     for (auto col_idx : cols) {
@@ -583,6 +704,17 @@ int64_t Table::NumBatches() const {
 
 BatchSlice Table::FirstBatch() const {
   absl::MutexLock gen_lock(&generation_lock_);
+  {
+    absl::MutexLock spill_lock(&spill_lock_);
+    if (spill_store_ != nullptr && spill_store_->NumSegments() > 0) {
+      return BatchSlice::Spilled(0, 0, spill_store_->segment(0).num_rows() - 1, generation_,
+                                 spill_store_->row_ids().front());
+    }
+  }
+  return FirstInMemoryBatchUnlocked();
+}
+
+BatchSlice Table::FirstInMemoryBatchUnlocked() const {
   {
     absl::MutexLock cold_lock(&cold_lock_);
     if (ring_back_idx_ != -1) {
@@ -616,6 +748,25 @@ BatchSlice Table::NextBatchWithoutStop(const BatchSlice& slice) const {
   if (!status.ok()) {
     return BatchSlice::Invalid();
   }
+  if (slice.unsafe_is_spilled) {
+    {
+      absl::MutexLock spill_lock(&spill_lock_);
+      auto batch_length = spill_store_->segment(slice.unsafe_batch_index).num_rows();
+      if (slice.unsafe_row_end < batch_length - 1) {
+        auto new_batch_size = batch_length - slice.unsafe_row_end;
+        return BatchSlice::Spilled(slice.unsafe_batch_index, slice.unsafe_row_end + 1,
+                                   batch_length - 1, generation_, slice.uniq_row_end_idx + 1,
+                                   slice.uniq_row_end_idx + new_batch_size - 1);
+      }
+      auto next_index = slice.unsafe_batch_index + 1;
+      if (next_index < spill_store_->NumSegments()) {
+        return BatchSlice::Spilled(next_index, 0, spill_store_->segment(next_index).num_rows() - 1,
+                                   generation_, spill_store_->row_ids()[next_index]);
+      }
+    }
+    // This is the last spilled batch, so continue with the batches in memory.
+    return FirstInMemoryBatchUnlocked();
+  }
   if (!slice.unsafe_is_hot) {
     absl::MutexLock cold_lock(&cold_lock_);
     auto batch_length = ColdBatchLengthUnlocked(slice.unsafe_batch_index);
@@ -662,41 +813,57 @@ BatchSlice Table::NextBatchWithoutStop(const BatchSlice& slice) const {
   return BatchSlice::Hot(next_index, 0, next_length - 1, generation_, hot_row_ids_[next_index]);
 }
 
-int64_t Table::FindStopTime(int64_t time, arrow::MemoryPool* mem_pool) const {
+int64_t Table::FindStopTime(int64_t time) const {
   absl::MutexLock gen_lock(&generation_lock_);
   {
     absl::MutexLock hot_lock(&hot_lock_);
-    auto it =
-        std::upper_bound(hot_time_.begin(), hot_time_.end(), time, IntervalComparatorUpperBound);
-    if (it != hot_time_.begin()) {
-      it--;
-      auto index = std::distance(hot_time_.begin(), it);
-      ArrowArrayPtr time_col;
-      if (std::holds_alternative<RecordBatchWithCache>(hot_batches_[index])) {
-        auto record_batch_ptr = std::get_if<RecordBatchWithCache>(&hot_batches_[index]);
-        time_col = GetHotColumnUnlocked(record_batch_ptr, time_col_idx_, mem_pool);
-      } else {
-        auto row_batch = std::get<schema::RowBatch>(hot_batches_[index]);
-        time_col = row_batch.columns().at(time_col_idx_);
-      }
-      auto row_offset =
-          types::SearchArrowArrayLessThanOrEqual<types::DataType::TIME64NS>(time_col.get(), time);
-      return hot_row_ids_[index].first + row_offset;
+    auto index = hot_time_.FindLastStartingAtOrBefore(time);
+    if (index != -1) {
+      // The batch starts at or before the time, so it has a row at or before the time.
+      return hot_row_ids_[index].first + HotTimeUpperBoundUnlocked(index, time) - 1;
     }
   }
-  absl::MutexLock cold_lock(&cold_lock_);
-  auto it =
-      std::upper_bound(cold_time_.begin(), cold_time_.end(), time, IntervalComparatorUpperBound);
-  if (it == cold_time_.begin()) {
+  {
+    absl::MutexLock cold_lock(&cold_lock_);
+    auto index = cold_time_.FindLastStartingAtOrBefore(time);
+    if (index != -1) {
+      auto time_col = cold_column_buffers_[time_col_idx_][RingIndexUnlocked(index)].get();
+      return cold_row_ids_[index].first + ArrowTimeUpperBound(time_col, time) - 1;
+    }
+  }
+  absl::MutexLock spill_lock(&spill_lock_);
+  if (spill_store_ == nullptr) {
     return -1;
   }
-  it--;
-  auto index = it - cold_time_.begin();
-  auto ring_index = RingIndexUnlocked(index);
-  auto time_col = cold_column_buffers_[time_col_idx_][ring_index];
-  auto row_offset =
-      types::SearchArrowArrayLessThanOrEqual<types::DataType::TIME64NS>(time_col.get(), time);
-  return cold_row_ids_[index].first + row_offset;
+  auto index = spill_store_->time().FindLastStartingAtOrBefore(time);
+  if (index == -1) {
+    return -1;
+  }
+  const auto& segment = spill_store_->segment(index);
+  return segment.row_ids().first +
+         ArrowTimeUpperBound(segment.columns()[time_col_idx_].get(), time) - 1;
+}
+
+int64_t Table::HotTimeLowerBoundUnlocked(int64_t index, int64_t time) const {
+  if (std::holds_alternative<RecordBatchWithCache>(hot_batches_[index])) {
+    const auto& col =
+        std::get<RecordBatchWithCache>(hot_batches_[index]).record_batch->at(time_col_idx_);
+    return TimeLowerBound(static_cast<const types::Time64NSValue*>(col->UnsafeRawData()),
+                          col->Size(), time);
+  }
+  const auto& row_batch = std::get<schema::RowBatch>(hot_batches_[index]);
+  return ArrowTimeLowerBound(row_batch.ColumnAt(time_col_idx_).get(), time);
+}
+
+int64_t Table::HotTimeUpperBoundUnlocked(int64_t index, int64_t time) const {
+  if (std::holds_alternative<RecordBatchWithCache>(hot_batches_[index])) {
+    const auto& col =
+        std::get<RecordBatchWithCache>(hot_batches_[index]).record_batch->at(time_col_idx_);
+    return TimeUpperBound(static_cast<const types::Time64NSValue*>(col->UnsafeRawData()),
+                          col->Size(), time);
+  }
+  const auto& row_batch = std::get<schema::RowBatch>(hot_batches_[index]);
+  return ArrowTimeUpperBound(row_batch.ColumnAt(time_col_idx_).get(), time);
 }
 
 int64_t Table::ColdBatchLengthUnlocked(int64_t index) const {
@@ -712,18 +879,6 @@ int64_t Table::HotBatchLengthUnlocked(int64_t index) const {
   }
 }
 
-Table::ArrowArrayPtr Table::GetHotColumnUnlocked(const RecordBatchWithCache* record_batch_ptr,
-                                                 int64_t col_idx,
-                                                 arrow::MemoryPool* mem_pool) const {
-  if (record_batch_ptr->cache_validity[col_idx]) {
-    return record_batch_ptr->arrow_cache[col_idx];
-  }
-  auto arrow_array_sptr = record_batch_ptr->record_batch->at(col_idx)->ConvertToArrow(mem_pool);
-  record_batch_ptr->arrow_cache[col_idx] = arrow_array_sptr;
-  record_batch_ptr->cache_validity[col_idx] = true;
-  return arrow_array_sptr;
-}
-
 BatchSlice Table::SliceIfPastStop(const BatchSlice& slice, int64_t stop_row_id) const {
   if (!slice.IsValid()) {
     return slice;
@@ -790,6 +945,28 @@ Status Table::UpdateSliceUnlocked(const BatchSlice& slice) const {
   if (slice.generation == generation_) {
     return Status::OK();
   }
+  {
+    absl::MutexLock spill_lock(&spill_lock_);
+    if (spill_store_ != nullptr) {
+      const auto& spill_row_ids = spill_store_->row_ids();
+      auto it = std::lower_bound(spill_row_ids.begin(), spill_row_ids.end(),
+                                 slice.uniq_row_start_idx, IntervalComparatorLowerBound);
+      if (it != spill_row_ids.end()) {
+        if (slice.uniq_row_end_idx < it->first) {
+          // All data in this slice has been expired from the table.
+          return error::InvalidArgument(
+              "Requested RowBatch Slice has already been expired from the table");
+        }
+        slice.unsafe_is_spilled = true;
+        slice.unsafe_is_hot = false;
+        slice.unsafe_batch_index = std::distance(spill_row_ids.begin(), it);
+        slice.unsafe_row_start = slice.uniq_row_start_idx - it->first;
+        slice.unsafe_row_end = slice.uniq_row_end_idx - it->first;
+        slice.generation = generation_;
+        return Status::OK();
+      }
+    }
+  }
   {
     absl::MutexLock cold_lock(&cold_lock_);
     auto it = std::lower_bound(cold_row_ids_.begin(), cold_row_ids_.end(), slice.uniq_row_start_idx,
@@ -803,6 +980,7 @@ Status Table::UpdateSliceUnlocked(const BatchSlice& slice) const {
       }
       auto vector_index = std::distance(cold_row_ids_.begin(), it);
       auto ring_index = RingIndexUnlocked(vector_index);
+      slice.unsafe_is_spilled = false;
       slice.unsafe_is_hot = false;
       slice.unsafe_batch_index = ring_index;
       slice.unsafe_row_start = slice.uniq_row_start_idx - it->first;
@@ -822,6 +1000,7 @@ Status Table::UpdateSliceUnlocked(const BatchSlice& slice) const {
     return error::InvalidArgument(
         "Requested RowBatch Slice has already been expired from the table");
   }
+  slice.unsafe_is_spilled = false;
   slice.unsafe_is_hot = true;
   slice.unsafe_batch_index = std::distance(hot_row_ids_.begin(), it);
   slice.unsafe_row_start = slice.uniq_row_start_idx - it->first;
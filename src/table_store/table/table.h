@@ -22,7 +22,9 @@
 #include <arrow/array.h>
 #include <arrow/record_batch.h>
 #include <algorithm>
+#include <chrono>
 #include <deque>
+#include <filesystem>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -39,6 +41,8 @@
 #include "src/table_store/schema/row_batch.h"
 #include "src/table_store/schema/row_descriptor.h"
 #include "src/table_store/schemapb/schema.pb.h"
+#include "src/table_store/table/spill_store.h"
+#include "src/table_store/table/time_index.h"
 
 DECLARE_int32(table_store_table_size_limit);
 
@@ -50,11 +54,17 @@ using RecordBatchSPtr = std::shared_ptr<arrow::RecordBatch>;
 struct TableStats {
   int64_t bytes;
   int64_t cold_bytes;
+  // The bytes in hot storage, which are waiting to be compacted.
+  int64_t hot_bytes;
+  // How long ago the oldest batch in hot storage was written, or 0 if there are no hot batches.
+  int64_t compaction_lag_ns;
   int64_t num_batches;
   int64_t batches_added;
   int64_t batches_expired;
   int64_t compacted_batches;
   int64_t max_table_size;
+  int64_t spilled_bytes;
+  int64_t spilled_batches;
 };
 
 struct BatchSlice {
@@ -68,6 +78,8 @@ struct BatchSlice {
   mutable int64_t generation = -1;
   int64_t uniq_row_start_idx = -1;
   int64_t uniq_row_end_idx = -1;
+  // Spilled slices index into the table's spill segments rather than its hot or cold batches.
+  mutable bool unsafe_is_spilled = false;
 
   int64_t Size() const { return uniq_row_end_idx - uniq_row_start_idx + 1; }
   bool IsValid() const { return uniq_row_start_idx != -1 && uniq_row_end_idx != -1; }
@@ -92,6 +104,17 @@ struct BatchSlice {
     return BatchSlice{true,       hot_index,          row_start,       row_end,
                       generation, uniq_row_start_idx, uniq_row_end_idx};
   }
+  static BatchSlice Spilled(int64_t segment_index, int64_t row_start, int64_t row_end,
+                            int64_t generation, std::pair<int64_t, int64_t> row_ids) {
+    return BatchSlice{false,      segment_index, row_start,      row_end,
+                      generation, row_ids.first, row_ids.second, true};
+  }
+  static BatchSlice Spilled(int64_t segment_index, int64_t row_start, int64_t row_end,
+                            int64_t generation, int64_t uniq_row_start_idx,
+                            int64_t uniq_row_end_idx) {
+    return BatchSlice{false,      segment_index,      row_start,        row_end,
+                      generation, uniq_row_start_idx, uniq_row_end_idx, true};
+  }
 };
 
 class ArrowArrayCompactor {
@@ -147,6 +170,13 @@ class ArrowArrayCompactor {
  * the arrow array in a cache with the hot batch so that future reads, before this batch is
  * transferred to cold, don't also need to convert to arrow.
  *
+ * Spill Scheme:
+ * Optionally (see EnableSpill), the batches expired from cold storage are spilled to segment files
+ * on local disk (see SpillStore) rather than dropped. Spilled data is older than all cold data, and
+ * is read through memory mappings, so it is read the same way as cold data. The spill tier has its
+ * own size limit, and since the segments are files they are reattached when the table is recreated
+ * after a restart.
+ *
  * Synchronization Scheme:
  * The hot and cold partitions are synchronized separately with spinlocks. Additionally, the
  * generation of the store is protected by a spinlock.
@@ -265,6 +295,9 @@ class Table : public NotCopyable {
 
   TableStats GetTableStats() const;
 
+  int64_t max_table_size() const { return max_table_size_; }
+  int64_t min_cold_batch_size() const { return min_cold_batch_size_; }
+
   /**
    * Gets the BatchSlice corresponding to the next batch after the given batch.
    * The BatchSlice will be cut short to ensure it doesn't extend past the given StopPosition.
@@ -307,6 +340,24 @@ class Table : public NotCopyable {
    */
   Status CompactHotToCold(arrow::MemoryPool* mem_pool);
 
+  /**
+   * Enables the spill tier. From then on, the batches expired from cold storage are written to
+   * segment files in the given directory, and the segments already in the directory (written by a
+   * previous instance of the table) are reattached. This must be called before any data is written
+   * to the table.
+   * @param dir the directory that holds the table's segment files.
+   * @param max_spill_bytes the maximum number of bytes of the segment files, past which the oldest
+   * segments are removed.
+   */
+  Status EnableSpill(const std::filesystem::path& dir, int64_t max_spill_bytes);
+
+  /**
+   * Moves all the data in memory to the spill tier, so that it's kept across a restart. Intended to
+   * be called on shutdown, once nothing writes to the table anymore.
+   * @param mem_pool arrow MemoryPool to be used for compacting the hot batches.
+   */
+  Status SpillAll(arrow::MemoryPool* mem_pool);
+
  private:
   Status ExpireRowBatches(int64_t row_batch_size);
 
@@ -343,12 +394,20 @@ class Table : public NotCopyable {
   // accessed on a hot write.
   int64_t next_row_id_ ABSL_GUARDED_BY(hot_lock_) = 0;
   std::deque<RowIDInterval> hot_row_ids_ ABSL_GUARDED_BY(hot_lock_);
-  std::deque<TimeInterval> hot_time_ ABSL_GUARDED_BY(hot_lock_);
+  TimeIndex hot_time_ ABSL_GUARDED_BY(hot_lock_);
+  // When each hot batch was written, to measure the compaction lag.
+  std::deque<std::chrono::steady_clock::time_point> hot_write_times_ ABSL_GUARDED_BY(hot_lock_);
   std::deque<RowIDInterval> cold_row_ids_ ABSL_GUARDED_BY(cold_lock_);
-  std::deque<TimeInterval> cold_time_ ABSL_GUARDED_BY(cold_lock_);
+  TimeIndex cold_time_ ABSL_GUARDED_BY(cold_lock_);
 
   int64_t time_col_idx_ = -1;
 
+  // The spill tier is locked after the generation and before the cold and hot partitions. The spill
+  // directory is only set by EnableSpill, before the table is used.
+  mutable absl::Mutex spill_lock_;
+  std::unique_ptr<SpillStore> spill_store_ ABSL_GUARDED_BY(spill_lock_);
+  std::filesystem::path spill_dir_;
+
   Status WriteHot(RecordBatchPtr record_batch);
   Status WriteHot(const schema::RowBatch& rb);
   Status UpdateTimeRowIndices(const schema::RowBatch& rb) ABSL_EXCLUSIVE_LOCKS_REQUIRED(hot_lock_);
@@ -362,9 +421,6 @@ class Table : public NotCopyable {
 
   Status AddBatchSliceToRowBatch(const BatchSlice& slice, const std::vector<int64_t>& cols,
                                  schema::RowBatch* output_rb, arrow::MemoryPool* mem_pool) const;
-  ArrowArrayPtr GetHotColumnUnlocked(const RecordBatchWithCache* record_batch_ptr, int64_t col_idx,
-                                     arrow::MemoryPool* mem_pool) const
-      ABSL_EXCLUSIVE_LOCKS_REQUIRED(hot_lock_);
 
   int64_t NumBatches() const;
   int64_t ColdBatchLengthUnlocked(int64_t ring_index) const
@@ -372,7 +428,13 @@ class Table : public NotCopyable {
   int64_t HotBatchLengthUnlocked(int64_t hot_index) const ABSL_EXCLUSIVE_LOCKS_REQUIRED(hot_lock_);
 
   // Returns the unique identifier of the last row less than or equal to the given time.
-  int64_t FindStopTime(int64_t time, arrow::MemoryPool* mem_pool) const;
+  int64_t FindStopTime(int64_t time) const;
+  // Return the offset of the first row at or after (resp. after) the time in the given hot batch,
+  // searching the time column in place.
+  int64_t HotTimeLowerBoundUnlocked(int64_t index, int64_t time) const
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(hot_lock_);
+  int64_t HotTimeUpperBoundUnlocked(int64_t index, int64_t time) const
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(hot_lock_);
 
   // Returns the index into cold_row_ids_ or cold_time_ given the ring buffer location.
   int64_t RingVectorIndexUnlocked(int64_t ring_index) const
@@ -387,6 +449,8 @@ class Table : public NotCopyable {
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(generation_lock_);
 
   BatchSlice NextBatchWithoutStop(const BatchSlice& slice) const;
+  // Returns the first batch in cold storage, or in hot storage if there are no cold batches.
+  BatchSlice FirstInMemoryBatchUnlocked() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(generation_lock_);
 };
 
 }  // namespace table_store
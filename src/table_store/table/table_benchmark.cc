@@ -19,14 +19,17 @@
 #include <absl/synchronization/barrier.h>
 #include <absl/synchronization/notification.h>
 #include <benchmark/benchmark.h>
+#include <algorithm>
 #include <chrono>
 #include <deque>
 #include <numeric>
 #include <random>
 #include <thread>
+#include <utility>
 #include "external/com_google_benchmark/_virtual_includes/benchmark/benchmark/benchmark.h"
 #include "src/shared/types/types.h"
 #include "src/table_store/table/table.h"
+#include "src/table_store/table/time_index.h"
 
 namespace px::table_store {
 
@@ -37,8 +40,12 @@ static inline std::unique_ptr<Table> MakeTable(int64_t max_size, int64_t compact
   return std::make_unique<Table>(rel, max_size, compaction_size);
 }
 
-static inline std::unique_ptr<types::ColumnWrapperRecordBatch> MakeHotBatch(int64_t batch_size) {
+static inline std::unique_ptr<types::ColumnWrapperRecordBatch> MakeHotBatch(
+    int64_t batch_size, int64_t start_time = 0, int64_t time_step = 0) {
   std::vector<types::Time64NSValue> col1_vals(batch_size, 0);
+  for (int64_t i = 0; i < batch_size; ++i) {
+    col1_vals[i] = start_time + i * time_step;
+  }
   std::vector<types::Float64Value> col2_vals(batch_size, 1.234);
 
   auto wrapper_batch = std::make_unique<types::ColumnWrapperRecordBatch>();
@@ -335,6 +342,79 @@ static void BM_TableThreaded(benchmark::State& state) {
   state.counters["Write"] = benchmark::Counter(write_average_time);
 }
 
+// Fills the table with small batches of increasing times, one time unit per row, and returns the
+// number of rows.
+static inline int64_t FillTableWithTimes(Table* table, int64_t num_batches, int64_t batch_length,
+                                         bool compact) {
+  for (int64_t i = 0; i < num_batches; ++i) {
+    auto batch = MakeHotBatch(batch_length, i * batch_length, 1);
+    PL_CHECK_OK(table->TransferRecordBatch(std::move(batch)));
+    if (compact) {
+      PL_CHECK_OK(table->CompactHotToCold(arrow::default_memory_pool()));
+    }
+  }
+  return num_batches * batch_length;
+}
+
+// NOLINTNEXTLINE : runtime/references.
+static void BM_TableFindTime(benchmark::State& state, bool cold) {
+  int64_t num_batches = state.range(0);
+  int64_t batch_length = 16;
+  int64_t batch_size = batch_length * sizeof(int64_t) + batch_length * sizeof(double);
+  // Leave room so that none of the batches expire.
+  auto table = MakeTable(2 * num_batches * batch_size, batch_size);
+  auto num_rows = FillTableWithTimes(table.get(), num_batches, batch_length, cold);
+
+  std::mt19937_64 rng(0);
+  std::uniform_int_distribution<int64_t> dist(0, num_rows - 1);
+  for (auto _ : state) {
+    auto time = dist(rng);
+    benchmark::DoNotOptimize(
+        table->FindBatchSliceGreaterThanOrEqual(time, arrow::default_memory_pool()));
+    benchmark::DoNotOptimize(table->FindStopPositionForTime(time, arrow::default_memory_pool()));
+  }
+}
+
+// NOLINTNEXTLINE : runtime/references.
+static void BM_TableFindTimeHot(benchmark::State& state) { BM_TableFindTime(state, false); }
+
+// NOLINTNEXTLINE : runtime/references.
+static void BM_TableFindTimeCold(benchmark::State& state) { BM_TableFindTime(state, true); }
+
+// NOLINTNEXTLINE : runtime/references.
+static void BM_TimeIndexLowerBound(benchmark::State& state) {
+  int64_t num_batches = state.range(0);
+  TimeIndex index;
+  for (int64_t i = 0; i < num_batches; ++i) {
+    index.PushBack(i * 16, i * 16 + 15);
+  }
+
+  std::mt19937_64 rng(0);
+  std::uniform_int_distribution<int64_t> dist(0, num_batches * 16 - 1);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(index.FindFirstEndingAtOrAfter(dist(rng)));
+  }
+}
+
+// The table's previous time index, for comparison.
+// NOLINTNEXTLINE : runtime/references.
+static void BM_DequeTimeIndexLowerBound(benchmark::State& state) {
+  int64_t num_batches = state.range(0);
+  std::deque<std::pair<int64_t, int64_t>> index;
+  for (int64_t i = 0; i < num_batches; ++i) {
+    index.emplace_back(i * 16, i * 16 + 15);
+  }
+
+  std::mt19937_64 rng(0);
+  std::uniform_int_distribution<int64_t> dist(0, num_batches * 16 - 1);
+  for (auto _ : state) {
+    auto time = dist(rng);
+    benchmark::DoNotOptimize(
+        std::lower_bound(index.begin(), index.end(), time,
+                         [](const auto& interval, int64_t t) { return interval.second < t; }));
+  }
+}
+
 BENCHMARK(BM_TableReadAllHot);
 BENCHMARK(BM_TableReadAllCold);
 BENCHMARK(BM_TableReadLastBatchAllHot)->Iterations(1000);
@@ -343,5 +423,9 @@ BENCHMARK(BM_TableWriteEmpty);
 BENCHMARK(BM_TableWriteFull);
 BENCHMARK(BM_TableCompaction);
 BENCHMARK(BM_TableThreaded)->UseManualTime()->Iterations(1);
+BENCHMARK(BM_TableFindTimeHot)->Range(64, 64 * 1024);
+BENCHMARK(BM_TableFindTimeCold)->Range(64, 64 * 1024);
+BENCHMARK(BM_TimeIndexLowerBound)->Range(64, 1024 * 1024);
+BENCHMARK(BM_DequeTimeIndexLowerBound)->Range(64, 1024 * 1024);
 
 }  // namespace px::table_store
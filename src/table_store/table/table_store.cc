@@ -20,6 +20,8 @@
 #include <utility>
 #include <vector>
 
+#include <absl/container/flat_hash_set.h>
+
 #include "src/table_store/table/table_store.h"
 
 namespace px {
@@ -56,6 +58,13 @@ StatusOr<Table*> TableStore::CreateNewTablet(uint64_t table_id, const types::Tab
 
 Status TableStore::AppendData(uint64_t table_id, types::TabletID tablet_id,
                               std::unique_ptr<px::types::ColumnWrapperRecordBatch> record_batch) {
+  PL_RETURN_IF_ERROR(UpdateRollups(table_id, *record_batch));
+  if (tablet_id == kDefaultTablet) {
+    auto partitioning_iter = id_to_partitioning_map_.find(table_id);
+    if (partitioning_iter != id_to_partitioning_map_.end()) {
+      return AppendPartitionedData(table_id, partitioning_iter->second, std::move(record_batch));
+    }
+  }
   Table* table = GetTable(table_id, tablet_id);
   // We create new tablets only if the table at `table_id` exists, otherwise errors out.
   if (table == nullptr) {
@@ -64,6 +73,182 @@ Status TableStore::AppendData(uint64_t table_id, types::TabletID tablet_id,
   return table->TransferRecordBatch(std::move(record_batch));
 }
 
+Status TableStore::AppendPartitionedData(
+    uint64_t table_id, const TablePartitioning& partitioning,
+    std::unique_ptr<px::types::ColumnWrapperRecordBatch> record_batch) {
+  const auto& key_col = record_batch->at(partitioning.key_col_idx);
+  if (key_col->data_type() != types::DataType::UINT128) {
+    return error::Internal("Partition key column $0 of table $1 is not a UINT128 column.",
+                           partitioning.key_col_idx, table_id);
+  }
+  const auto* keys = static_cast<const types::UInt128ValueColumnWrapper*>(key_col.get());
+
+  std::vector<std::vector<size_t>> partition_rows(partitioning.num_partitions);
+  for (size_t i = 0; i < keys->Size(); ++i) {
+    partition_rows[partitioning.Partition((*keys)[i].val)].push_back(i);
+  }
+
+  for (const auto& [partition, rows] : Enumerate(partition_rows)) {
+    if (rows.empty()) {
+      continue;
+    }
+    Table* tablet = GetTable(table_id, TablePartitioning::PartitionTablet(partition));
+    DCHECK(tablet != nullptr);
+    // Batches often come from a single process, in which case they are appended as is.
+    if (rows.size() == keys->Size()) {
+      return tablet->TransferRecordBatch(std::move(record_batch));
+    }
+    auto partition_batch = std::make_unique<px::types::ColumnWrapperRecordBatch>();
+    partition_batch->reserve(record_batch->size());
+    for (const auto& col : *record_batch) {
+      partition_batch->push_back(col->MoveIndexes(rows));
+    }
+    PL_RETURN_IF_ERROR(tablet->TransferRecordBatch(std::move(partition_batch)));
+  }
+  return Status::OK();
+}
+
+Status TableStore::PartitionTable(const std::string& table_name, const std::string& key_column,
+                                  int64_t num_partitions) {
+  if (num_partitions <= 0) {
+    return error::InvalidArgument("Table $0 needs at least one partition, got $1.", table_name,
+                                  num_partitions);
+  }
+  if (name_to_partitioning_map_.contains(table_name)) {
+    return error::AlreadyExists("Table $0 is already partitioned.", table_name);
+  }
+  auto relation_iter = name_to_relation_map_.find(table_name);
+  if (relation_iter == name_to_relation_map_.end()) {
+    return error::NotFound("Table $0 doesn't exist.", table_name);
+  }
+  const schema::Relation& relation = relation_iter->second;
+  if (!relation.HasColumn(key_column)) {
+    return error::NotFound("Table $0 has no column $1 to partition by.", table_name, key_column);
+  }
+  int64_t key_col_idx = relation.GetColumnIndex(key_column);
+  if (relation.GetColumnType(key_col_idx) != types::DataType::UINT128) {
+    return error::InvalidArgument("Table $0 can only be partitioned by a UINT128 column, not $1.",
+                                  table_name, key_column);
+  }
+
+  std::optional<uint64_t> table_id;
+  for (const auto& [id, table_info] : id_to_table_info_map_) {
+    if (table_info.table_name == table_name) {
+      table_id = id;
+    }
+  }
+
+  Table* default_tablet = GetTable(table_name);
+  DCHECK(default_tablet != nullptr);
+  int64_t max_table_size = default_tablet->max_table_size();
+  // A negative size is limitless, for the partitions too.
+  int64_t max_partition_size =
+      max_table_size < 0 ? max_table_size : max_table_size / num_partitions;
+
+  TablePartitioning partitioning{key_col_idx, num_partitions};
+  // All the partitions are created up front, so appending data never adds tablets.
+  for (int64_t i = 0; i < num_partitions; ++i) {
+    AddTable(std::make_shared<Table>(relation, max_partition_size,
+                                     default_tablet->min_cold_batch_size()),
+             table_name, table_id, TablePartitioning::PartitionTablet(i));
+  }
+  name_to_partitioning_map_[table_name] = partitioning;
+  if (table_id.has_value()) {
+    id_to_partitioning_map_[table_id.value()] = partitioning;
+  }
+  return Status::OK();
+}
+
+Status TableStore::UpdateRollups(uint64_t table_id,
+                                 const px::types::ColumnWrapperRecordBatch& record_batch) {
+  absl::MutexLock lock(&rollups_lock_);
+  auto rollups_iter = id_to_rollups_map_.find(table_id);
+  if (rollups_iter == id_to_rollups_map_.end()) {
+    return Status::OK();
+  }
+  for (auto& rollup_table : rollups_iter->second) {
+    PL_RETURN_IF_ERROR(rollup_table.rollup->Update(record_batch));
+    auto rollup_batch = rollup_table.rollup->Flush();
+    if (rollup_batch != nullptr) {
+      PL_RETURN_IF_ERROR(rollup_table.table->TransferRecordBatch(std::move(rollup_batch)));
+    }
+  }
+  return Status::OK();
+}
+
+Status TableStore::AddRollup(const schema::RollupSpec& spec) {
+  if (name_to_relation_map_.contains(spec.name)) {
+    return error::AlreadyExists("Table $0 already exists.", spec.name);
+  }
+  std::optional<uint64_t> source_table_id;
+  for (const auto& [id, table_info] : id_to_table_info_map_) {
+    if (table_info.table_name == spec.source_table) {
+      source_table_id = id;
+    }
+  }
+  if (!source_table_id.has_value()) {
+    return error::NotFound("Table $0 doesn't exist or has no id.", spec.source_table);
+  }
+  const schema::Relation& source_relation =
+      id_to_table_info_map_[source_table_id.value()].relation;
+  PL_ASSIGN_OR_RETURN(std::unique_ptr<Rollup> rollup, Rollup::Create(spec, source_relation));
+
+  auto table = std::make_shared<Table>(rollup->relation(), spec.max_table_size);
+  AddTable(table, spec.name);
+  absl::MutexLock lock(&rollups_lock_);
+  id_to_rollups_map_[source_table_id.value()].push_back({std::move(rollup), std::move(table)});
+  return Status::OK();
+}
+
+Status TableStore::FlushRollups(int64_t now_ns) {
+  return FlushRollups([now_ns](Rollup* rollup) {
+    return rollup->FlushEndedBefore(now_ns - schema::kRollupFlushGraceNs);
+  });
+}
+
+Status TableStore::FlushRollups(
+    const std::function<std::unique_ptr<types::ColumnWrapperRecordBatch>(Rollup*)>& flush) {
+  absl::MutexLock lock(&rollups_lock_);
+  for (auto& [table_id, rollup_tables] : id_to_rollups_map_) {
+    for (auto& rollup_table : rollup_tables) {
+      auto rollup_batch = flush(rollup_table.rollup.get());
+      if (rollup_batch != nullptr) {
+        PL_RETURN_IF_ERROR(rollup_table.table->TransferRecordBatch(std::move(rollup_batch)));
+      }
+    }
+  }
+  return Status::OK();
+}
+
+const TablePartitioning* TableStore::GetPartitioning(const std::string& table_name) const {
+  auto it = name_to_partitioning_map_.find(table_name);
+  if (it == name_to_partitioning_map_.end()) {
+    return nullptr;
+  }
+  return &it->second;
+}
+
+std::vector<types::TabletID> TableStore::GetPartitionTablets(
+    const std::string& table_name, const std::optional<std::vector<absl::uint128>>& keys) const {
+  const TablePartitioning* partitioning = GetPartitioning(table_name);
+  if (partitioning == nullptr) {
+    return {};
+  }
+  std::vector<bool> read_partition(partitioning->num_partitions, !keys.has_value());
+  if (keys.has_value()) {
+    for (const auto& key : keys.value()) {
+      read_partition[partitioning->Partition(key)] = true;
+    }
+  }
+  std::vector<types::TabletID> tablets;
+  for (int64_t i = 0; i < partitioning->num_partitions; ++i) {
+    if (read_partition[i]) {
+      tablets.push_back(TablePartitioning::PartitionTablet(i));
+    }
+  }
+  return tablets;
+}
+
 table_store::Table* TableStore::GetTable(const std::string& table_name,
                                          const types::TabletID& tablet_id) const {
   auto name_to_table_iter = name_to_table_map_.find(NameTablet{table_name, tablet_id});
@@ -151,13 +336,80 @@ Status TableStore::SchemaAsProto(schemapb::Schema* schema) const {
 
 std::vector<uint64_t> TableStore::GetTableIDs() const {
   std::vector<uint64_t> ids;
+  absl::flat_hash_set<uint64_t> seen;
   for (const auto& it : id_to_table_map_) {
-    ids.emplace_back(it.first.table_id_);
+    if (seen.insert(it.first.table_id_).second) {
+      ids.emplace_back(it.first.table_id_);
+    }
   }
   return ids;
 }
 
+TableStats TableStore::GetTableStats(uint64_t table_id) const {
+  TableStats stats{};
+  bool partitioned = id_to_partitioning_map_.contains(table_id);
+  for (const auto& [id_tablet, table] : id_to_table_map_) {
+    if (id_tablet.table_id_ != table_id) {
+      continue;
+    }
+    TableStats tablet_stats = table->GetTableStats();
+    stats.bytes += tablet_stats.bytes;
+    stats.cold_bytes += tablet_stats.cold_bytes;
+    stats.hot_bytes += tablet_stats.hot_bytes;
+    stats.compaction_lag_ns = std::max(stats.compaction_lag_ns, tablet_stats.compaction_lag_ns);
+    stats.num_batches += tablet_stats.num_batches;
+    stats.batches_added += tablet_stats.batches_added;
+    stats.batches_expired += tablet_stats.batches_expired;
+    stats.compacted_batches += tablet_stats.compacted_batches;
+    // The partitions split the size of the default tablet, which isn't filled anymore.
+    if (!partitioned || id_tablet.tablet_id_ != kDefaultTablet) {
+      stats.max_table_size += tablet_stats.max_table_size;
+    }
+    stats.spilled_bytes += tablet_stats.spilled_bytes;
+    stats.spilled_batches += tablet_stats.spilled_batches;
+  }
+  return stats;
+}
+
+Status TableStore::EnableSpill(const std::filesystem::path& spill_dir,
+                               int64_t max_bytes_per_table) {
+  absl::flat_hash_map<std::string, int64_t> num_tablets;
+  for (const auto& [name_tablet, table] : name_to_table_map_) {
+    ++num_tablets[name_tablet.name_];
+  }
+  for (const auto& [name_tablet, table] : name_to_table_map_) {
+    auto dir = spill_dir / name_tablet.name_;
+    if (!name_tablet.tablet_id_.empty()) {
+      dir /= name_tablet.tablet_id_;
+    }
+    // The limit is for the table as a whole, so that partitioning it doesn't multiply its spill.
+    PL_RETURN_IF_ERROR(
+        table->EnableSpill(dir, max_bytes_per_table / num_tablets[name_tablet.name_]));
+  }
+  return Status::OK();
+}
+
+Status TableStore::SpillAll(arrow::MemoryPool* mem_pool) {
+  // The groups the rollups still aggregate are written out so that they are spilled too.
+  PL_RETURN_IF_ERROR(FlushRollups([](Rollup* rollup) { return rollup->Flush(/*all*/ true); }));
+  for (const auto& [name_tablet, table] : name_to_table_map_) {
+    PL_RETURN_IF_ERROR(table->SpillAll(mem_pool));
+  }
+  return Status::OK();
+}
+
+std::vector<std::shared_ptr<Table>> TableStore::GetTables() const {
+  std::vector<std::shared_ptr<Table>> tables;
+  tables.reserve(name_to_table_map_.size());
+  for (const auto& [name_tablet, table] : name_to_table_map_) {
+    tables.push_back(table);
+  }
+  return tables;
+}
+
 Status TableStore::RunCompaction(arrow::MemoryPool* mem_pool) {
+  // Also bounds how far the rollups lag behind their source tables.
+  PL_RETURN_IF_ERROR(FlushRollups(CurrentTimeNS()));
   for (const auto& it : name_to_table_map_) {
     PL_RETURN_IF_ERROR(it.second->CompactHotToCold(mem_pool));
   }
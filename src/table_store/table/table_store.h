@@ -18,19 +18,28 @@
 
 #pragma once
 
+#include <filesystem>
+#include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include <absl/container/flat_hash_map.h>
+#include <absl/hash/hash.h>
+#include <absl/numeric/int128.h>
+#include <absl/strings/str_cat.h>
+#include <absl/synchronization/mutex.h>
 
 #include "src/common/base/base.h"
 #include "src/shared/types/column_wrapper.h"
 #include "src/shared/types/hash_utils.h"
 #include "src/table_store/schema/relation.h"
+#include "src/table_store/schema/rollup_spec.h"
 #include "src/table_store/schema/schema.h"
+#include "src/table_store/table/rollup.h"
 #include "src/table_store/table/table.h"
 #include "src/table_store/table/tablets_group.h"
 
@@ -73,6 +82,33 @@ struct TableInfo {
   schema::Relation relation;
 };
 
+// TablePartitioning describes how the rows of a partitioned table are spread over its tablets.
+struct TablePartitioning {
+  // The index of the UINT128 column (eg. upid) whose hash picks the partition of a row.
+  int64_t key_col_idx;
+  int64_t num_partitions;
+
+  int64_t Partition(absl::uint128 key) const {
+    return StableHash(key) % static_cast<uint64_t>(num_partitions);
+  }
+  // A fixed mix of the high and low words of the key (CityHash's Hash128to64). Unlike absl::Hash,
+  // which is seeded per process, it maps a key to the same partition across restarts, which the
+  // partition tablets reattached from spilled segments rely on. Changing it moves existing rows
+  // out of the partitions their keys are looked up in.
+  static uint64_t StableHash(absl::uint128 key) {
+    constexpr uint64_t kMul = 0x9ddfea08eb382d69ULL;
+    uint64_t a = (absl::Uint128Low64(key) ^ absl::Uint128High64(key)) * kMul;
+    a ^= (a >> 47);
+    uint64_t b = (absl::Uint128High64(key) ^ a) * kMul;
+    b ^= (b >> 47);
+    b *= kMul;
+    return b;
+  }
+  static types::TabletID PartitionTablet(int64_t partition) {
+    return absl::StrCat("partition_", partition);
+  }
+};
+
 /**
  * TableStore keeps track of the tables in our system.
  */
@@ -84,10 +120,18 @@ class TableStore {
 
   /**
    * Get table IDs returns a list of table ids available in the table store.
-   * @return vector of table ids.
+   * @return vector of table ids, each listed once however many tablets the table has.
    */
   std::vector<uint64_t> GetTableIDs() const;
 
+  /**
+   * @brief Gets the stats of a table, summed over all of its tablets.
+   *
+   * @param table_id: the table to get the stats of.
+   * @return TableStats: the stats, with compaction_lag_ns the largest lag of the tablets.
+   */
+  TableStats GetTableStats(uint64_t table_id) const;
+
   /**
    * Gets the table associated with the given name, grabbing the default tablet.
    *
@@ -152,6 +196,71 @@ class TableStore {
   Status AppendData(uint64_t table_id, types::TabletID tablet_id,
                     std::unique_ptr<px::types::ColumnWrapperRecordBatch> record_batch);
 
+  /**
+   * @brief Partitions the table into num_partitions tablets by the hash of key_column, which must
+   * be a UINT128 column such as upid. Data appended to the default tablet of the table is then
+   * spread over the partitions, so that readers that only need some keys can skip the other
+   * partitions. Should be called before the table receives data: the existing default tablet is
+   * kept, but not filled anymore.
+   *
+   * The partitions take the compacted batch size of the default tablet, and split its size limit
+   * evenly. Each partition expires its own rows once it holds its share, so the rows of keys that
+   * write more than the others are kept for less time than in the unpartitioned table.
+   *
+   * @param table_name: the table to partition.
+   * @param key_column: the column to partition the rows by.
+   * @param num_partitions: the number of partition tablets.
+   * @return Status: error if the table or column doesn't exist, or the table is already
+   * partitioned.
+   */
+  Status PartitionTable(const std::string& table_name, const std::string& key_column,
+                        int64_t num_partitions);
+
+  /**
+   * @return the partitioning of the table, or nullptr if the table isn't partitioned.
+   */
+  const TablePartitioning* GetPartitioning(const std::string& table_name) const;
+
+  /**
+   * @brief Gets the tablets of a partitioned table that can hold the rows with the given keys.
+   *
+   * @param table_name: the partitioned table.
+   * @param keys: the keys of the rows to read. Unset means all the rows.
+   * @return the tablets to read, or an empty vector if the table isn't partitioned.
+   */
+  std::vector<types::TabletID> GetPartitionTablets(
+      const std::string& table_name,
+      const std::optional<std::vector<absl::uint128>>& keys = std::nullopt) const;
+
+  /**
+   * @brief Adds a rollup of a table, as a new table named after the rollup. The rollup is
+   * updated with the data appended to the source table from then on.
+   *
+   * @param spec: the rollup, whose source table must have an id, as data is appended by id.
+   * @return Status: error if the spec doesn't fit the source table, or the rollup table exists.
+   */
+  Status AddRollup(const schema::RollupSpec& spec);
+
+  /**
+   * Writes the complete groups of the rollups to the rollup tables, including the groups of the
+   * buckets that ended at least kRollupFlushGraceNs before now_ns.
+   */
+  Status FlushRollups(int64_t now_ns);
+
+  /**
+   * Enables the spill tier (see Table::EnableSpill) of all the tables and tablets, each in its own
+   * directory under spill_dir, reattaching the data they spilled in a previous run. Must be called
+   * once the tables are added, before data is appended to them. The tablets of a table split
+   * max_bytes_per_table evenly.
+   */
+  Status EnableSpill(const std::filesystem::path& spill_dir, int64_t max_bytes_per_table);
+
+  /**
+   * Moves the in-memory data of all the tables to their spill tier, so that it's kept across a
+   * restart.
+   */
+  Status SpillAll(arrow::MemoryPool* mem_pool);
+
   Status SchemaAsProto(schemapb::Schema* schema) const;
 
   /**
@@ -165,9 +274,17 @@ class TableStore {
     return "";
   }
 
+  /**
+   * @return all the tables and tablets in the store, e.g. to compact them with a CompactionPool.
+   */
+  std::vector<std::shared_ptr<Table>> GetTables() const;
+
   Status RunCompaction(arrow::MemoryPool* mem_pool);
 
  private:
+  // Writes the batches returned by flush for each rollup to the rollup tables.
+  Status FlushRollups(
+      const std::function<std::unique_ptr<types::ColumnWrapperRecordBatch>(Rollup*)>& flush);
   void RegisterTableName(const std::string& table_name, const types::TabletID& tablet_id,
                          const schema::Relation& table_relation,
                          std::shared_ptr<table_store::Table> table);
@@ -184,6 +301,24 @@ class TableStore {
    */
   StatusOr<Table*> CreateNewTablet(uint64_t table_id, const types::TabletID& tablet_id);
 
+  /**
+   * Splits the record_batch by the partitioning of the table, and appends each part to its
+   * partition tablet.
+   */
+  Status AppendPartitionedData(uint64_t table_id, const TablePartitioning& partitioning,
+                               std::unique_ptr<px::types::ColumnWrapperRecordBatch> record_batch);
+
+  /**
+   * Aggregates the record_batch into the rollups of the table, and writes the complete groups
+   * to the rollup tables.
+   */
+  Status UpdateRollups(uint64_t table_id, const px::types::ColumnWrapperRecordBatch& record_batch);
+
+  struct RollupTable {
+    std::unique_ptr<Rollup> rollup;
+    std::shared_ptr<Table> table;
+  };
+
   // The default value for tablets, when tablet is not specified.
   inline static types::TabletID kDefaultTablet = "";
   // Map a name to a table.
@@ -197,6 +332,14 @@ class TableStore {
   absl::flat_hash_map<std::string, schema::Relation> name_to_relation_map_;
   // Mapping from id to name and relation pair for adding new tablets.
   absl::flat_hash_map<uint64_t, TableInfo> id_to_table_info_map_;
+  // The partitioning of the partitioned tables, by name and by id.
+  absl::flat_hash_map<std::string, TablePartitioning> name_to_partitioning_map_;
+  absl::flat_hash_map<uint64_t, TablePartitioning> id_to_partitioning_map_;
+  // The rollups of the tables, by the id of their source table. The lock is held while a rollup
+  // is updated or flushed, as appends and compaction run on different threads.
+  absl::flat_hash_map<uint64_t, std::vector<RollupTable>> id_to_rollups_map_
+      ABSL_GUARDED_BY(rollups_lock_);
+  absl::Mutex rollups_lock_;
 };
 
 }  // namespace table_store
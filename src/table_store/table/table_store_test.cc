@@ -276,6 +276,140 @@ TEST_F(TableStoreTabletsTest, add_tablet_on_append_data) {
   EXPECT_EQ(tablet2->GetTableStats().batches_added, 0);
 }
 
+int64_t NumRows(const Table* table) {
+  int64_t num_rows = 0;
+  for (const auto& rb : table->GetTableAsRecordBatches().ConsumeValueOrDie()) {
+    num_rows += rb->num_rows();
+  }
+  return num_rows;
+}
+
+TEST_F(TableStoreTest, partitioned_table) {
+  schema::Relation rel({types::DataType::UINT128, types::DataType::INT64}, {"upid", "value"});
+  auto table_store = TableStore();
+  uint64_t table_id = 123;
+  table_store.AddTable(Table::Create(rel), "a", table_id);
+  ASSERT_OK(table_store.PartitionTable("a", "upid", 4));
+  EXPECT_EQ(4, table_store.GetPartitionTablets("a").size());
+
+  std::vector<types::UInt128Value> upids = {{0, 1}, {0, 2}, {0, 1}, {0, 3}, {0, 1}};
+  auto batch = std::make_unique<types::ColumnWrapperRecordBatch>();
+  auto upid_col = std::make_shared<types::UInt128ValueColumnWrapper>(0);
+  upid_col->AppendFromVector(upids);
+  auto value_col = std::make_shared<types::Int64ValueColumnWrapper>(0);
+  value_col->AppendFromVector(std::vector<types::Int64Value>{1, 2, 3, 4, 5});
+  batch->push_back(upid_col);
+  batch->push_back(value_col);
+  EXPECT_OK(table_store.AppendData(table_id, "", std::move(batch)));
+
+  // The default tablet isn't filled anymore, the rows are in the partitions.
+  EXPECT_EQ(0, NumRows(table_store.GetTable("a")));
+  int64_t total_rows = 0;
+  int64_t total_bytes = 0;
+  for (const auto& tablet_id : table_store.GetPartitionTablets("a")) {
+    total_rows += NumRows(table_store.GetTable(table_id, tablet_id));
+    total_bytes += table_store.GetTable(table_id, tablet_id)->GetTableStats().bytes;
+  }
+  EXPECT_EQ(5, total_rows);
+  // The table is listed once, with the stats of all of its partitions.
+  EXPECT_THAT(table_store.GetTableIDs(), ::testing::ElementsAre(table_id));
+  EXPECT_LT(0, total_bytes);
+  EXPECT_EQ(total_bytes, table_store.GetTableStats(table_id).bytes);
+
+  // All rows of a upid are in the one partition it maps to.
+  auto tablets = table_store.GetPartitionTablets("a", std::vector<absl::uint128>{upids[0].val});
+  ASSERT_EQ(1, tablets.size());
+  EXPECT_LE(3, NumRows(table_store.GetTable("a", tablets[0])));
+  EXPECT_EQ(0, table_store.GetPartitionTablets("a", std::vector<absl::uint128>{}).size());
+}
+
+TEST_F(TableStoreTest, partitions_take_table_sizes) {
+  schema::Relation rel({types::DataType::UINT128, types::DataType::INT64}, {"upid", "value"});
+  auto table_store = TableStore();
+  uint64_t table_id = 123;
+  table_store.AddTable(std::make_shared<Table>(rel, 4096, 512), "a", table_id);
+  ASSERT_OK(table_store.PartitionTable("a", "upid", 4));
+  for (const auto& tablet_id : table_store.GetPartitionTablets("a")) {
+    Table* tablet = table_store.GetTable(table_id, tablet_id);
+    ASSERT_NE(nullptr, tablet);
+    // The partitions split the size limit of the table.
+    EXPECT_EQ(1024, tablet->max_table_size());
+    EXPECT_EQ(512, tablet->min_cold_batch_size());
+  }
+}
+
+TEST_F(TableStoreTest, partition_mapping_is_stable) {
+  // The partitions of keys must not change across restarts, since spilled partition tablets are
+  // reattached by partition.
+  EXPECT_EQ(0xb91445ce692f0ce5ULL, TablePartitioning::StableHash(absl::MakeUint128(0, 1)));
+  EXPECT_EQ(0x9a58a0ed69459580ULL,
+            TablePartitioning::StableHash(absl::MakeUint128((12ULL << 32) | 4567, 89012345)));
+
+  TablePartitioning partitioning{/*key_col_idx*/ 0, /*num_partitions*/ 4};
+  EXPECT_EQ(1, partitioning.Partition(absl::MakeUint128(0, 1)));
+  EXPECT_EQ(2, partitioning.Partition(absl::MakeUint128(0, 2)));
+  EXPECT_EQ(3, partitioning.Partition(absl::MakeUint128(0, 3)));
+  EXPECT_EQ(0, partitioning.Partition(absl::MakeUint128(1, 0)));
+  EXPECT_EQ(3, partitioning.Partition(absl::MakeUint128(~0ULL, ~0ULL)));
+}
+
+TEST_F(TableStoreTest, partition_table_errors) {
+  auto table_store = TableStore();
+  table_store.AddTable(table2, "b");
+  EXPECT_NOT_OK(table_store.PartitionTable("a", "upid", 4));
+  EXPECT_NOT_OK(table_store.PartitionTable("b", "upid", 4));
+  // Only UINT128 columns can be partitioned by.
+  EXPECT_NOT_OK(table_store.PartitionTable("b", "table2col1", 4));
+  EXPECT_EQ(nullptr, table_store.GetPartitioning("b"));
+  EXPECT_EQ(0, table_store.GetPartitionTablets("b").size());
+}
+
+TEST_F(TableStoreTest, rollup) {
+  schema::Relation rel({types::DataType::TIME64NS, types::DataType::INT64}, {"time_", "latency"});
+  auto table_store = TableStore();
+  uint64_t table_id = 123;
+  table_store.AddTable(Table::Create(rel), "a", table_id);
+  schema::RollupSpec spec{
+      "a_rollup", "a", {}, 100, {{schema::RollupAggregate::Kind::kCount, "latency", "count"}},
+      1024 * 1024};
+  ASSERT_OK(table_store.AddRollup(spec));
+  EXPECT_NOT_OK(table_store.AddRollup(spec));
+  EXPECT_EQ(1, table_store.GetRelationMap()->count("a_rollup"));
+
+  auto append = [&](std::vector<types::Time64NSValue> times) {
+    auto batch = std::make_unique<ColumnWrapperRecordBatch>();
+    auto time_col = std::make_shared<types::Time64NSValueColumnWrapper>(0);
+    time_col->AppendFromVector(times);
+    auto latency_col = std::make_shared<types::Int64ValueColumnWrapper>(times.size());
+    batch->push_back(time_col);
+    batch->push_back(latency_col);
+    return table_store.AppendData(table_id, "", std::move(batch));
+  };
+  ASSERT_OK(append({10, 20, 30}));
+  EXPECT_EQ(0, NumRows(table_store.GetTable("a_rollup")));
+  // A newer bucket completes the first one.
+  ASSERT_OK(append({110}));
+  EXPECT_EQ(4, NumRows(table_store.GetTable("a")));
+  EXPECT_EQ(1, NumRows(table_store.GetTable("a_rollup")));
+  // The latest bucket is flushed once it has ended and the grace period for late rows has passed.
+  ASSERT_OK(table_store.FlushRollups(schema::kRollupFlushGraceNs + 199));
+  EXPECT_EQ(1, NumRows(table_store.GetTable("a_rollup")));
+  ASSERT_OK(table_store.FlushRollups(schema::kRollupFlushGraceNs + 200));
+  EXPECT_EQ(2, NumRows(table_store.GetTable("a_rollup")));
+}
+
+TEST_F(TableStoreTest, rollup_errors) {
+  auto table_store = TableStore();
+  table_store.AddTable(table2, "b");
+  schema::RollupSpec spec{"b_rollup", "b", {}, 100, {}, 1024};
+  // The source table needs an id.
+  EXPECT_NOT_OK(table_store.AddRollup(spec));
+  table_store.AddTable(table1, "a", 1);
+  spec.source_table = "a";
+  // The source table needs a time_ column.
+  EXPECT_NOT_OK(table_store.AddRollup(spec));
+}
+
 using TableStoreTabletsDeathTest = TableStoreTabletsTest;
 TEST_F(TableStoreTabletsDeathTest, tablet_test) {
   auto table_store = TableStore();
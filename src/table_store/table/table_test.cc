@@ -20,9 +20,14 @@
 #include <arrow/array.h>
 #include <google/protobuf/text_format.h>
 #include <google/protobuf/util/message_differencer.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
 #include <random>
+#include <thread>
 #include <vector>
 
+#include "src/common/testing/temp_dir.h"
 #include "src/common/testing/testing.h"
 #include "src/shared/types/arrow_adapter.h"
 #include "src/table_store/schema/relation.h"
@@ -712,6 +717,152 @@ TEST(TableTest, find_batch_slice_greater_or_eq_w_compaction) {
   EXPECT_EQ(-1, batch_slice.uniq_row_end_idx);
 }
 
+TEST(TableTest, spill_expired_cold_batches) {
+  px::testing::TempDir spill_dir;
+  schema::Relation rel(std::vector<types::DataType>({types::DataType::TIME64NS}),
+                       std::vector<std::string>({"time_"}));
+  int64_t compaction_size = 4 * sizeof(int64_t);
+  auto write_batch = [](Table* table, std::vector<types::Time64NSValue> times) {
+    auto wrapper_batch = std::make_unique<types::ColumnWrapperRecordBatch>();
+    auto col_wrapper = std::make_shared<types::Time64NSValueColumnWrapper>(0);
+    col_wrapper->AppendFromVector(times);
+    wrapper_batch->push_back(col_wrapper);
+    EXPECT_OK(table->TransferRecordBatch(std::move(wrapper_batch)));
+    EXPECT_OK(table->CompactHotToCold(arrow::default_memory_pool()));
+  };
+  auto read_times = [](const Table& table) {
+    std::vector<int64_t> times;
+    for (auto slice = table.FirstBatch(); slice.IsValid(); slice = table.NextBatch(slice)) {
+      auto rb = table.GetRowBatchSlice(slice, {0}, arrow::default_memory_pool())
+                    .ConsumeValueOrDie();
+      for (int64_t i = 0; i < rb->num_rows(); ++i) {
+        times.push_back(
+            types::GetValueFromArrowArray<types::DataType::TIME64NS>(rb->ColumnAt(0).get(), i));
+      }
+    }
+    return times;
+  };
+
+  {
+    // The table holds two cold batches, so the third batch expires the first one to disk.
+    Table table(rel, 2 * compaction_size, compaction_size);
+    ASSERT_OK(table.EnableSpill(spill_dir.path(), 1024 * 1024));
+    write_batch(&table, {1, 2, 3, 4});
+    write_batch(&table, {5, 6, 7, 8});
+    write_batch(&table, {9, 10, 11, 12});
+
+    auto stats = table.GetTableStats();
+    EXPECT_EQ(1, stats.spilled_batches);
+    EXPECT_EQ(2 * compaction_size, stats.bytes);
+    EXPECT_EQ(std::vector<int64_t>({1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12}), read_times(table));
+
+    auto slice =
+        table.FindBatchSliceGreaterThanOrEqual(2, arrow::default_memory_pool()).ConsumeValueOrDie();
+    EXPECT_EQ(1, slice.uniq_row_start_idx);
+    EXPECT_EQ(3, slice.uniq_row_end_idx);
+    EXPECT_EQ(3,
+              table.FindStopPositionForTime(3, arrow::default_memory_pool()).ConsumeValueOrDie());
+
+    EXPECT_OK(table.SpillAll(arrow::default_memory_pool()));
+    EXPECT_EQ(3, table.GetTableStats().spilled_batches);
+    EXPECT_EQ(0, table.GetTableStats().bytes);
+  }
+
+  // A new table on the same directory reattaches the spilled batches, and continues their rows.
+  Table table(rel, 2 * compaction_size, compaction_size);
+  ASSERT_OK(table.EnableSpill(spill_dir.path(), 1024 * 1024));
+  EXPECT_EQ(12, table.End());
+  write_batch(&table, {13, 14, 15, 16});
+  EXPECT_EQ(std::vector<int64_t>({1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16}),
+            read_times(table));
+  auto slice =
+      table.FindBatchSliceGreaterThanOrEqual(13, arrow::default_memory_pool()).ConsumeValueOrDie();
+  EXPECT_EQ(12, slice.uniq_row_start_idx);
+
+  // Spilling has to be enabled before the table is written to.
+  Table written_table(rel, 2 * compaction_size, compaction_size);
+  write_batch(&written_table, {1, 2, 3, 4});
+  EXPECT_NOT_OK(written_table.EnableSpill(spill_dir.path(), 1024 * 1024));
+}
+
+TEST(TableTest, spill_failure_expires_without_spilling) {
+  px::testing::TempDir spill_dir;
+  schema::Relation rel(std::vector<types::DataType>({types::DataType::TIME64NS}),
+                       std::vector<std::string>({"time_"}));
+  int64_t compaction_size = 4 * sizeof(int64_t);
+  auto write_batch = [](Table* table, std::vector<types::Time64NSValue> times) {
+    auto wrapper_batch = std::make_unique<types::ColumnWrapperRecordBatch>();
+    auto col_wrapper = std::make_shared<types::Time64NSValueColumnWrapper>(0);
+    col_wrapper->AppendFromVector(times);
+    wrapper_batch->push_back(col_wrapper);
+    EXPECT_OK(table->TransferRecordBatch(std::move(wrapper_batch)));
+    EXPECT_OK(table->CompactHotToCold(arrow::default_memory_pool()));
+  };
+  auto read_times = [](const Table& table) {
+    std::vector<int64_t> times;
+    for (auto slice = table.FirstBatch(); slice.IsValid(); slice = table.NextBatch(slice)) {
+      auto rb = table.GetRowBatchSlice(slice, {0}, arrow::default_memory_pool())
+                    .ConsumeValueOrDie();
+      for (int64_t i = 0; i < rb->num_rows(); ++i) {
+        times.push_back(
+            types::GetValueFromArrowArray<types::DataType::TIME64NS>(rb->ColumnAt(0).get(), i));
+      }
+    }
+    return times;
+  };
+
+  Table table(rel, 2 * compaction_size, compaction_size);
+  auto dir = spill_dir.path() / "table";
+  ASSERT_OK(table.EnableSpill(dir, 1024 * 1024));
+  // Replace the spill directory with a file, so that no segment can be written to it. Unlike
+  // removing the directory's write permission, this also holds when the test runs as root.
+  std::filesystem::remove_all(dir);
+  { std::ofstream(dir) << "not a directory"; }
+
+  // The expired batches are dropped, and the table keeps taking new data.
+  write_batch(&table, {1, 2, 3, 4});
+  write_batch(&table, {5, 6, 7, 8});
+  write_batch(&table, {9, 10, 11, 12});
+  auto stats = table.GetTableStats();
+  EXPECT_EQ(0, stats.spilled_batches);
+  EXPECT_EQ(0, stats.spilled_bytes);
+  EXPECT_EQ(2 * compaction_size, stats.bytes);
+  EXPECT_EQ(std::vector<int64_t>({5, 6, 7, 8, 9, 10, 11, 12}), read_times(table));
+
+  // Spilling resumes once the directory is writable again.
+  std::filesystem::remove(dir);
+  std::filesystem::create_directories(dir);
+  write_batch(&table, {13, 14, 15, 16});
+  stats = table.GetTableStats();
+  EXPECT_EQ(1, stats.spilled_batches);
+  EXPECT_EQ(2 * compaction_size, stats.bytes);
+  EXPECT_EQ(std::vector<int64_t>({5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16}), read_times(table));
+}
+
+TEST(TableTest, compaction_lag_stats) {
+  schema::Relation rel(std::vector<types::DataType>({types::DataType::TIME64NS}),
+                       std::vector<std::string>({"time_"}));
+  int64_t batch_bytes = 4 * sizeof(int64_t);
+  Table table(rel, 128 * 1024, batch_bytes);
+  EXPECT_EQ(0, table.GetTableStats().compaction_lag_ns);
+
+  auto wrapper_batch = std::make_unique<types::ColumnWrapperRecordBatch>();
+  auto col_wrapper = std::make_shared<types::Time64NSValueColumnWrapper>(0);
+  col_wrapper->AppendFromVector(std::vector<types::Time64NSValue>{1, 2, 3, 4});
+  wrapper_batch->push_back(col_wrapper);
+  EXPECT_OK(table.TransferRecordBatch(std::move(wrapper_batch)));
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+  auto stats = table.GetTableStats();
+  EXPECT_EQ(batch_bytes, stats.hot_bytes);
+  EXPECT_GE(stats.compaction_lag_ns, 1000 * 1000);
+
+  EXPECT_OK(table.CompactHotToCold(arrow::default_memory_pool()));
+  stats = table.GetTableStats();
+  EXPECT_EQ(0, stats.hot_bytes);
+  EXPECT_EQ(0, stats.compaction_lag_ns);
+}
+
 TEST(TableTest, ToProto) {
   auto table = TestTable();
   table_store::schemapb::Table table_proto;
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "src/table_store/table/time_index.h"
+
+#include <algorithm>
+
+namespace px {
+namespace table_store {
+
+void TimeIndex::PopFront() {
+  ++head_;
+  if (head_ >= kMinCompactSize && 2 * head_ >= static_cast<int64_t>(first_times_.size())) {
+    first_times_.erase(first_times_.begin(), first_times_.begin() + head_);
+    last_times_.erase(last_times_.begin(), last_times_.begin() + head_);
+    head_ = 0;
+  }
+}
+
+int64_t TimeIndex::LowerBound(const std::vector<int64_t>& times, int64_t time) const {
+  const int64_t* begin = times.data() + head_;
+  int64_t n = size();
+  if (n == 0 || time <= begin[0]) {
+    return 0;
+  }
+  if (time > begin[n - 1]) {
+    return n;
+  }
+  // From here on begin[0] < time <= begin[n - 1], so n >= 2. The search keeps a window (lo, hi]
+  // that holds the result, i.e. begin[lo] < time <= begin[hi].
+  double first = begin[0];
+  double fraction = (time - first) / (begin[n - 1] - first);
+  int64_t guess = std::clamp<int64_t>(static_cast<int64_t>(fraction * (n - 1)), 0, n - 1);
+  int64_t lo;
+  int64_t hi;
+  int64_t step = 1;
+  if (begin[guess] < time) {
+    lo = guess;
+    hi = std::min(lo + step, n - 1);
+    while (begin[hi] < time) {
+      lo = hi;
+      step *= 2;
+      hi = std::min(lo + step, n - 1);
+    }
+  } else {
+    // begin[0] < time, so the guess isn't 0.
+    hi = guess;
+    lo = hi - step;
+    while (begin[lo] >= time) {
+      hi = lo;
+      step *= 2;
+      lo = std::max<int64_t>(hi - step, 0);
+    }
+  }
+  return lo + 1 + TimeLowerBound(begin + lo + 1, hi - lo, time);
+}
+
+}  // namespace table_store
+}  // namespace px
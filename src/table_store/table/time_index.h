@@ -0,0 +1,132 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "src/shared/types/types.h"
+
+namespace px {
+namespace table_store {
+
+namespace internal {
+
+inline int64_t TimeValue(int64_t time) { return time; }
+inline int64_t TimeValue(const types::Time64NSValue& time) { return time.val; }
+
+// Below this many times, the search scans the times rather than halving them further.
+constexpr int64_t kTimeScanSize = 32;
+
+}  // namespace internal
+
+/**
+ * Searches sorted times in place, e.g. the raw values of a time column.
+ * @return the index of the first time greater than or equal to the given time, or n if there is
+ * none.
+ */
+template <typename T>
+int64_t TimeLowerBound(const T* times, int64_t n, int64_t time) {
+  // Branchless binary search down to a small window...
+  const T* base = times;
+  while (n > internal::kTimeScanSize) {
+    int64_t half = n / 2;
+    base = internal::TimeValue(base[half]) < time ? base + half : base;
+    n -= half;
+  }
+  // ...which is scanned by counting the times that are smaller, a loop that compilers vectorize.
+  int64_t offset = base - times;
+  for (int64_t i = 0; i < n; ++i) {
+    offset += internal::TimeValue(base[i]) < time;
+  }
+  return offset;
+}
+
+/**
+ * @return the index of the first time greater than the given time, or n if there is none.
+ */
+template <typename T>
+int64_t TimeUpperBound(const T* times, int64_t n, int64_t time) {
+  if (time == std::numeric_limits<int64_t>::max()) {
+    return n;
+  }
+  return TimeLowerBound(times, n, time + 1);
+}
+
+/**
+ * TimeIndex holds the [first, last] time intervals of a table's batches, oldest first. Batches are
+ * added at the back and removed from the front, as they are in the table, and the intervals are
+ * kept in contiguous arrays so that searching them is cache friendly.
+ *
+ * Since the timestamps are monotonic and usually evenly spread, searches interpolate where the time
+ * should be, then widen a window around the guess exponentially until it brackets the time, and
+ * search that window. This takes a few probes for evenly spread timestamps, and O(log N) probes at
+ * worst.
+ */
+class TimeIndex {
+ public:
+  using TimeInterval = std::pair<int64_t, int64_t>;
+
+  void PushBack(int64_t first_time, int64_t last_time) {
+    first_times_.push_back(first_time);
+    last_times_.push_back(last_time);
+  }
+  void PopFront();
+
+  int64_t size() const { return first_times_.size() - head_; }
+  bool empty() const { return size() == 0; }
+  TimeInterval operator[](int64_t index) const {
+    return {first_times_[head_ + index], last_times_[head_ + index]};
+  }
+  TimeInterval front() const { return (*this)[0]; }
+  TimeInterval back() const { return (*this)[size() - 1]; }
+
+  /**
+   * @return the index of the first batch whose last time is greater than or equal to the given
+   * time, or size() if there is none.
+   */
+  int64_t FindFirstEndingAtOrAfter(int64_t time) const { return LowerBound(last_times_, time); }
+
+  /**
+   * @return the index of the last batch whose first time is less than or equal to the given time,
+   * or -1 if there is none.
+   */
+  int64_t FindLastStartingAtOrBefore(int64_t time) const {
+    if (time == std::numeric_limits<int64_t>::max()) {
+      return size() - 1;
+    }
+    return LowerBound(first_times_, time + 1) - 1;
+  }
+
+ private:
+  // Removed intervals are only erased from the front of the arrays once they make up half of them.
+  static constexpr int64_t kMinCompactSize = 1024;
+
+  int64_t LowerBound(const std::vector<int64_t>& times, int64_t time) const;
+
+  std::vector<int64_t> first_times_;
+  std::vector<int64_t> last_times_;
+  // The index of the oldest interval in the arrays.
+  int64_t head_ = 0;
+};
+
+}  // namespace table_store
+}  // namespace px
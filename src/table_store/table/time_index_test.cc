@@ -0,0 +1,115 @@
+/*
+ * Copyright 2018- The Pixie Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "src/common/testing/testing.h"
+#include "src/table_store/table/time_index.h"
+
+namespace px {
+namespace table_store {
+
+TEST(TimeIndexTest, time_bounds_match_std) {
+  std::mt19937_64 rng(42);
+  for (int64_t n : {0, 1, 2, 31, 32, 33, 100, 1000}) {
+    std::vector<types::Time64NSValue> times;
+    std::uniform_int_distribution<int64_t> dist(0, n);
+    for (int64_t i = 0; i < n; ++i) {
+      times.emplace_back(dist(rng));
+    }
+    std::sort(times.begin(), times.end(),
+              [](const auto& a, const auto& b) { return a.val < b.val; });
+    for (int64_t time = -1; time <= n + 1; ++time) {
+      auto lower = std::lower_bound(times.begin(), times.end(), time,
+                                    [](const auto& a, int64_t t) { return a.val < t; });
+      auto upper = std::upper_bound(times.begin(), times.end(), time,
+                                    [](int64_t t, const auto& a) { return t < a.val; });
+      EXPECT_EQ(lower - times.begin(), TimeLowerBound(times.data(), n, time));
+      EXPECT_EQ(upper - times.begin(), TimeUpperBound(times.data(), n, time));
+    }
+  }
+}
+
+TEST(TimeIndexTest, find_batches_match_std) {
+  std::mt19937_64 rng(7);
+  // Mix evenly spread batches with bursts and gaps, which interpolation guesses badly.
+  std::uniform_int_distribution<int64_t> gap(0, 3);
+  std::uniform_int_distribution<int64_t> burst(0, 100);
+  std::deque<std::pair<int64_t, int64_t>> expected;
+  TimeIndex index;
+  int64_t time = 0;
+  for (int64_t i = 0; i < 5000; ++i) {
+    int64_t first = time + gap(rng);
+    int64_t last = first + gap(rng) + (burst(rng) == 0 ? 100000 : 0);
+    expected.emplace_back(first, last);
+    index.PushBack(first, last);
+    time = last;
+  }
+  // Remove from the front to exercise the compaction of the arrays.
+  for (int64_t i = 0; i < 3000; ++i) {
+    expected.pop_front();
+    index.PopFront();
+  }
+  ASSERT_EQ(expected.size(), index.size());
+  EXPECT_EQ(expected.front(), index.front());
+  EXPECT_EQ(expected.back(), index.back());
+
+  std::uniform_int_distribution<int64_t> times(expected.front().first - 10,
+                                               expected.back().second + 10);
+  for (int64_t i = 0; i < 10000; ++i) {
+    int64_t t = times(rng);
+    auto ending = std::lower_bound(
+        expected.begin(), expected.end(), t,
+        [](const auto& interval, int64_t time) { return interval.second < time; });
+    auto starting = std::upper_bound(
+        expected.begin(), expected.end(), t,
+        [](int64_t time, const auto& interval) { return time < interval.first; });
+    EXPECT_EQ(ending - expected.begin(), index.FindFirstEndingAtOrAfter(t)) << t;
+    EXPECT_EQ(starting - expected.begin() - 1, index.FindLastStartingAtOrBefore(t)) << t;
+  }
+}
+
+TEST(TimeIndexTest, empty_and_extremes) {
+  TimeIndex index;
+  EXPECT_TRUE(index.empty());
+  EXPECT_EQ(0, index.FindFirstEndingAtOrAfter(10));
+  EXPECT_EQ(-1, index.FindLastStartingAtOrBefore(10));
+
+  index.PushBack(5, 10);
+  index.PushBack(10, 20);
+  EXPECT_EQ(0, index.FindFirstEndingAtOrAfter(std::numeric_limits<int64_t>::min()));
+  EXPECT_EQ(2, index.FindFirstEndingAtOrAfter(std::numeric_limits<int64_t>::max()));
+  EXPECT_EQ(-1, index.FindLastStartingAtOrBefore(4));
+  EXPECT_EQ(1, index.FindLastStartingAtOrBefore(10));
+  EXPECT_EQ(1, index.FindLastStartingAtOrBefore(std::numeric_limits<int64_t>::max()));
+
+  index.PopFront();
+  index.PopFront();
+  EXPECT_TRUE(index.empty());
+}
+
+}  // namespace table_store
+}  // namespace px
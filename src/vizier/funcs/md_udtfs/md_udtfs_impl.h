@@ -640,7 +640,9 @@ class GetDebugTableInfo final : public carnot::udf::UDTF<GetDebugTableInfo> {
         ColInfo("cold_size", types::DataType::INT64, types::PatternType::GENERAL,
                 "The number of bytes in cold storage"),
         ColInfo("max_table_size", types::DataType::INT64, types::PatternType::GENERAL,
-                "The maximum size of this table"));
+                "The maximum size of this table"),
+        ColInfo("compaction_lag_ns", types::DataType::INT64, types::PatternType::GENERAL,
+                "How long ago the oldest batch waiting for compaction was written"));
   }
   Status Init(FunctionContext*) {
     table_ids_ = table_store_->GetTableIDs();
@@ -653,8 +655,8 @@ class GetDebugTableInfo final : public carnot::udf::UDTF<GetDebugTableInfo> {
     }
 
     uint64_t selected_id = table_ids_[current_idx_];
-    const auto* table = table_store_->GetTable(selected_id);
-    auto info = table->GetTableStats();
+    // Partitioned tables hold their rows in their partition tablets, not the default one.
+    auto info = table_store_->GetTableStats(selected_id);
 
     rw->Append<IndexOf("asid")>(ctx->metadata_state()->asid());
     rw->Append<IndexOf("name")>(table_store_->GetTableName(selected_id));
@@ -666,6 +668,7 @@ class GetDebugTableInfo final : public carnot::udf::UDTF<GetDebugTableInfo> {
     rw->Append<IndexOf("size")>(info.bytes);
     rw->Append<IndexOf("cold_size")>(info.cold_bytes);
     rw->Append<IndexOf("max_table_size")>(info.max_table_size);
+    rw->Append<IndexOf("compaction_lag_ns")>(info.compaction_lag_ns);
 
     ++current_idx_;
     return static_cast<size_t>(current_idx_) < table_ids_.size();
@@ -56,6 +56,14 @@ px::StatusOr<std::string> GetHostname() {
 
 DEFINE_string(jwt_signing_key, gflags::StringFromEnv("PL_JWT_SIGNING_KEY", ""),
               "The JWT signing key for outgoing requests");
+DEFINE_int32(table_store_compaction_threads,
+             gflags::Int32FromEnv("PL_TABLE_STORE_COMPACTION_THREADS", 2),
+             "The number of threads that compact the tables in the background. 0 compacts them on "
+             "the agent's event loop instead.");
+DEFINE_int64(table_store_compaction_target_hot_bytes,
+             gflags::Int64FromEnv("PL_TABLE_STORE_COMPACTION_TARGET_HOT_BYTES", 1024 * 1024),
+             "The bytes of uncompacted data that a table should hold when it is next compacted. "
+             "The compaction cadence of each table adapts to its ingest rate to match it.");
 
 namespace px {
 namespace vizier {
@@ -185,6 +193,9 @@ Status Manager::Stop(std::chrono::milliseconds timeout) {
   stop_called_ = true;
 
   dispatcher_->Stop();
+  if (compaction_pool_ != nullptr) {
+    compaction_pool_->Stop();
+  }
   auto s = StopImpl(timeout);
 
   // Wait for a limited amount of time for main thread to stop processing.
@@ -310,11 +321,29 @@ Status Manager::PostRegisterHook(uint32_t asid) {
         std::bind(&Manager::NATSMessageHandler, this, std::placeholders::_1));
   }
 
+  // TODO(james): when we change ExecState::exec_mem_pool to not return just the default pool, we
+  // will need to figure out how to use the correct memory pool here, but for now we can just use
+  // the default pool.
+  if (FLAGS_table_store_compaction_threads > 0) {
+    table_store::CompactionPool::Options options;
+    options.num_threads = FLAGS_table_store_compaction_threads;
+    options.max_period = kTableStoreCompactionPeriod;
+    options.target_hot_bytes = FLAGS_table_store_compaction_target_hot_bytes;
+    compaction_pool_ =
+        std::make_unique<table_store::CompactionPool>(arrow::default_memory_pool(), options);
+    compaction_pool_->SetTables(table_store()->GetTables());
+    compaction_pool_->Start();
+  }
   tablestore_compaction_timer_ = dispatcher()->CreateTimer([this]() {
-    // TODO(james): when we change ExecState::exec_mem_pool to not return just the default pool, we
-    // will need to figure out how to use the correct memory pool here, but for now we can just use
-    // the default pool.
-    auto status = table_store()->RunCompaction(arrow::default_memory_pool());
+    Status status;
+    if (compaction_pool_ != nullptr) {
+      // The pool compacts the tables, so this only flushes the rollups and hands the pool the
+      // tables added since (e.g. by tracepoints).
+      status = table_store()->FlushRollups(CurrentTimeNS());
+      compaction_pool_->SetTables(table_store()->GetTables());
+    } else {
+      status = table_store()->RunCompaction(arrow::default_memory_pool());
+    }
     LOG_IF(ERROR, !status.ok()) << status.msg();
     if (tablestore_compaction_timer_) {
       tablestore_compaction_timer_->EnableTimer(kTableStoreCompactionPeriod);
@@ -31,6 +31,8 @@
 #include "src/common/event/nats.h"
 #include "src/common/uuid/uuid.h"
 #include "src/shared/metadata/metadata.h"
+#include "src/table_store/schema/rollup_spec.h"
+#include "src/table_store/table/compaction_pool.h"
 #include "src/vizier/funcs/context/vizier_context.h"
 #include "src/vizier/messages/messagespb/messages.pb.h"
 #include "src/vizier/services/agent/manager/chan_cache.h"
@@ -59,7 +61,16 @@ constexpr auto kChanCacheCleanupChansionPeriod = std::chrono::minutes(5);
  */
 constexpr auto kChanIdleGracePeriod = std::chrono::minutes(1);
 
+/**
+ * The period of table store compaction when it runs on the event loop, which is also the longest
+ * that the compaction pool waits between two compactions of a table.
+ */
 constexpr auto kTableStoreCompactionPeriod = std::chrono::minutes(1);
+// The rollups are flushed with each compaction, once their buckets are past the grace period, and
+// the planner relies on that to read them.
+static_assert(kTableStoreCompactionPeriod +
+                  std::chrono::nanoseconds(table_store::schema::kRollupFlushGraceNs) <
+              std::chrono::nanoseconds(table_store::schema::kRollupMaxFlushDelayNs));
 
 /**
  * Info tracks basic information about and agent such as:
@@ -229,6 +240,8 @@ class Manager : public px::NotCopyable {
 
   // Timer to manage table store compaction.
   px::event::TimerUPtr tablestore_compaction_timer_;
+  // Compacts the tables off the event loop, unless compaction threads are disabled.
+  std::unique_ptr<table_store::CompactionPool> compaction_pool_;
 };
 
 /**
@@ -21,6 +21,19 @@
 #include "src/vizier/services/agent/manager/exec.h"
 #include "src/vizier/services/agent/manager/manager.h"
 
+DEFINE_int64(table_store_upid_partitions,
+             gflags::Int64FromEnv("PL_TABLE_STORE_UPID_PARTITIONS", 0),
+             "The number of partitions (by upid) of the high-volume tables. 0 disables it.");
+DEFINE_bool(table_store_rollups, gflags::BoolFromEnv("PL_TABLE_STORE_ROLLUPS", false),
+            "Keep the time-bucketed rollups of the high-volume tables, which hold a longer history "
+            "for the queries that they can answer.");
+DEFINE_string(table_store_spill_dir, gflags::StringFromEnv("PL_TABLE_STORE_SPILL_DIR", ""),
+              "The local directory that the tables spill their expired data to, which is kept "
+              "across restarts. Empty disables spilling.");
+DEFINE_int64(table_store_spill_size_limit,
+             gflags::Int64FromEnv("PL_TABLE_STORE_SPILL_SIZE_LIMIT", 1024 * 1024 * 1024),
+             "The maximal size of the data that each table spills to disk.");
+
 namespace px {
 namespace vizier {
 namespace agent {
@@ -57,6 +70,11 @@ Status PEMManager::PostRegisterHookImpl() {
 
 Status PEMManager::StopImpl(std::chrono::milliseconds) {
   stirling_->Stop();
+  if (!FLAGS_table_store_spill_dir.empty()) {
+    // Nothing is appended to the tables anymore, so all their data can go to disk, to be
+    // reattached once the agent restarts.
+    PL_RETURN_IF_ERROR(table_store()->SpillAll(arrow::default_memory_pool()));
+  }
   return Status::OK();
 }
 
@@ -76,8 +94,33 @@ Status PEMManager::InitSchemas() {
     }
 
     table_store()->AddTable(std::move(table_ptr), relation_info.name, relation_info.id);
+    // The high-volume tables are usually queried for a few pods, so partitioning them by upid
+    // lets those queries only read the partitions that can hold their rows.
+    if (FLAGS_table_store_upid_partitions > 0 &&
+        (relation_info.name == "http_events" || relation_info.name == "conn_stats")) {
+      PL_RETURN_IF_ERROR(table_store()->PartitionTable(relation_info.name, "upid",
+                                                       FLAGS_table_store_upid_partitions));
+    }
     PL_RETURN_IF_ERROR(relation_info_manager()->AddRelationInfo(relation_info));
   }
+
+  if (FLAGS_table_store_rollups) {
+    for (const auto& spec : table_store::schema::DefaultRollupSpecs()) {
+      if (!relation_info_manager()->HasRelation(spec.source_table)) {
+        continue;
+      }
+      PL_RETURN_IF_ERROR(table_store()->AddRollup(spec));
+      // Rollup tables are only looked up by name, so their id is unused.
+      PL_RETURN_IF_ERROR(relation_info_manager()->AddRelationInfo(
+          RelationInfo(spec.name, /*id*/ 0, absl::Substitute("Rollup of $0", spec.source_table),
+                       table_store()->GetTable(spec.name)->GetRelation())));
+    }
+  }
+
+  if (!FLAGS_table_store_spill_dir.empty()) {
+    PL_RETURN_IF_ERROR(table_store()->EnableSpill(FLAGS_table_store_spill_dir,
+                                                  FLAGS_table_store_spill_size_limit));
+  }
   return Status::OK();
 }
 